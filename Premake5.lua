@@ -140,6 +140,12 @@ for k, v in pairs(DependenciesDebug) do ProjDebugLinks[k] = v end
 ProjReleaseLinks = { }
 for k, v in pairs(DependenciesRelease) do ProjDebugLinks[k] = v end
 
+-- Modules can't see each other's include directories by default, list any module headers a module needs here
+-- Modules still don't link against each other, so only header only code should be shared this way
+ModuleIncludes = {
+	BaseApplicationModule = { "GraphicsModule" }
+}
+
 -- This function handles creating the default project for a module, if no premake folder is given
 -- @param folderName The path to the module, as collected from os.matchdirs
 function CreateDefaultModule(folderName)
@@ -200,6 +206,13 @@ function CreateDefaultModule(folderName)
 		ProjIncludes[1] = path.join(relpath, "include")
 		-- Defines what directories we want to include
 		includedirs(ProjIncludes)
+		-- Other modules go after our own include directory, so that our headers win if the names clash
+		if ModuleIncludes[projName] ~= nil then
+			for k, v in pairs(ModuleIncludes[projName]) do
+				premake.info(" Including headers from module: " .. v)
+				includedirs { path.join("modules", v, "include") }
+			end
+		end
 
 		configuration "vs"
 	    	buildoptions { "/bigobj" }
@@ -358,6 +371,13 @@ function AddProjects(groupName, folders)
 				"_CRT_SECURE_NO_WARNINGS"
 			}
 
+			-- Tell the project where it's resources and the modules' resources really live, since the output directory
+			-- only has copies of them (ex: so that shaders can be hot reloaded from the originals)
+			defines {
+				"PROJECT_RES_DIR=\"" .. path.join(proj, "res") .. "\"",
+				"MODULES_DIR=\"" .. path.join(rootDir, "modules") .. "\""
+			}
+
 			-- We update the reserved include directory to be the project's source directory
 			ProjIncludes[1] = srcdir
 			-- Defines what directories we want to include
@@ -0,0 +1,100 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <entt.hpp>
+#include "LoggingBase.h"
+
+/// <summary>
+/// Maps between shared assets (meshes, materials, etc...) and stable IDs, so that things like saved scenes can
+/// refer to assets without storing them. IDs are a hash of the name the asset was added with, so the same name
+/// will always give the same ID between runs
+/// </summary>
+class AssetTable
+{
+public:
+	typedef uint64_t AssetId;
+	static constexpr AssetId NullId = 0;
+
+	AssetTable() = default;
+	~AssetTable() = default;
+
+	/// <summary>
+	/// Gets the ID that an asset with the given name will have
+	/// </summary>
+	static AssetId MakeId(const std::string& name) {
+		// FNV-1a, we never hand out 0 since that's the null ID
+		AssetId hash = 14695981039346656037ull;
+		for (char c : name) {
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 1099511628211ull;
+		}
+		return hash == NullId ? 1 : hash;
+	}
+
+	/// <summary>
+	/// Adds an asset to the table, replacing any asset that had the same name
+	/// </summary>
+	/// <typeparam name="T">The type of asset to add</typeparam>
+	/// <param name="name">A name that uniquely identifies the asset, ex: the path it was loaded from</param>
+	/// <param name="asset">The asset to add</param>
+	/// <returns>The ID of the asset</returns>
+	template <typename T>
+	AssetId Add(const std::string& name, const std::shared_ptr<T>& asset) {
+		LOG_ASSERT(asset != nullptr, "Cannot add a null asset!");
+		const AssetId id = MakeId(name);
+		auto it = _assets.find(id);
+		if (it != _assets.end()) {
+			_ids.erase(it->second.Asset.get());
+		}
+		_assets[id] = { asset, entt::type_info<T>::id() };
+		_ids[asset.get()] = id;
+		return id;
+	}
+
+	/// <summary>
+	/// Gets the ID of an asset, or NullId if the asset is null or was never added
+	/// </summary>
+	template <typename T>
+	AssetId GetId(const std::shared_ptr<T>& asset) const {
+		if (asset == nullptr) {
+			return NullId;
+		}
+		auto it = _ids.find(asset.get());
+		return it == _ids.end() ? NullId : it->second;
+	}
+
+	/// <summary>
+	/// Gets the asset with the given ID, or nullptr if there is no asset with that ID or it is not a T
+	/// </summary>
+	template <typename T>
+	std::shared_ptr<T> Get(AssetId id) const {
+		auto it = _assets.find(id);
+		if (it == _assets.end()) {
+			return nullptr;
+		}
+		if (it->second.Type != entt::type_info<T>::id()) {
+			LOG_WARN("Asset {} is not a {}", id, entt::type_info<T>::name());
+			return nullptr;
+		}
+		return std::static_pointer_cast<T>(it->second.Asset);
+	}
+
+	/// <summary>
+	/// Removes all the assets from the table
+	/// </summary>
+	void Clear() {
+		_assets.clear();
+		_ids.clear();
+	}
+
+	size_t Size() const { return _assets.size(); }
+
+private:
+	struct Entry {
+		std::shared_ptr<void> Asset;
+		entt::id_type         Type;
+	};
+	std::unordered_map<AssetId, Entry> _assets;
+	std::unordered_map<const void*, AssetId> _ids;
+};
\ No newline at end of file
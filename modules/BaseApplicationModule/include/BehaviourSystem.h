@@ -0,0 +1,173 @@
+#pragma once
+#include <vector>
+#include <type_traits>
+#include <entt.hpp>
+#include "IBehaviour.h"
+#include "Scene.h"
+
+/// <summary>
+/// A data-oriented alternative to BehaviourBinding. Each type of behaviour is stored by value in it's own component
+/// pool and updated one type at a time, so updates walk contiguous arrays instead of chasing pointers to objects
+/// scattered around the heap, and looking up a behaviour is a component lookup instead of a search over typeids
+/// </summary>
+/// <remarks>
+/// Any type with a bool Enabled member can be a behaviour. It only needs to declare the methods it uses out of
+/// OnLoad, Update, FixedUpdate, LateUpdate and RenderGUI, each taking the entt::handle the behaviour is bound to.
+/// Existing IBehaviour classes work as they are, the methods they override are called directly instead of through
+/// the vtable, and methods they don't override are skipped entirely.
+/// Behaviours are updated in the order their types were first bound or registered.
+/// </remarks>
+class BehaviourSystem
+{
+public:
+	/// <summary>
+	/// Registers a type of behaviour so it is updated by the system. This is done automatically the first time a
+	/// behaviour of the type is bound, but can be called ahead of time to control the order types are updated in
+	/// </summary>
+	template <typename T>
+	static void Register() {
+		const entt::id_type type = entt::type_info<T>::id();
+		for (const System& system : _systems) {
+			if (system.Type == type) {
+				return;
+			}
+		}
+		// Behaviours are components, so they can be stamped from prefabs like any other component
+		GameScene::RegisterComponentType<T>();
+
+		System system = { type };
+		if constexpr (_DeclaresUpdate<T>::value) {
+			system.Update = &_Run<T, Phase::Update>;
+		}
+		if constexpr (_DeclaresFixedUpdate<T>::value) {
+			system.FixedUpdate = &_Run<T, Phase::FixedUpdate>;
+		}
+		if constexpr (_DeclaresLateUpdate<T>::value) {
+			system.LateUpdate = &_Run<T, Phase::LateUpdate>;
+		}
+		if constexpr (_DeclaresRenderGUI<T>::value) {
+			system.RenderGUI = &_Run<T, Phase::RenderGUI>;
+		}
+		system.Has = [](const entt::registry& registry, entt::entity entity) {
+			return registry.has<T>(entity);
+		};
+		_systems.push_back(system);
+	}
+
+	/// <summary>
+	/// Binds a behaviour to the given entity, replacing any behaviour of the same type that was already bound
+	/// </summary>
+	/// <typeparam name="T">The type of behaviour to add</typeparam>
+	/// <param name="entity">The entity to add the behaviour to</param>
+	/// <param name="args">The arguments to forward to the behaviour's constructor</param>
+	/// <returns>The behaviour, this reference is only valid until another behaviour of the same type is added or removed</returns>
+	template <typename T, typename ... TArgs>
+	static T& Bind(entt::handle entity, TArgs&&... args) {
+		static const bool registered = (Register<T>(), true);
+		(void)registered;
+		T& behaviour = entity.emplace_or_replace<T>(std::forward<TArgs>(args)...);
+		if constexpr (_DeclaresOnLoad<T>::value) {
+			behaviour.T::OnLoad(entity);
+		}
+		return behaviour;
+	}
+	/// <summary>
+	/// Binds a behaviour to the given entity, setting it to disabled by default
+	/// </summary>
+	template <typename T, typename ... TArgs>
+	static T& BindDisabled(entt::handle entity, TArgs&&... args) {
+		T& behaviour = Bind<T>(entity, std::forward<TArgs>(args)...);
+		behaviour.Enabled = false;
+		return behaviour;
+	}
+
+	/// <summary>
+	/// Gets the behaviour of the given type from the entity, or nullptr if it doesn't have one
+	/// </summary>
+	template <typename T>
+	static T* Get(entt::handle entity) {
+		return entity.try_get<T>();
+	}
+	/// <summary>
+	/// Checks whether the entity has a behaviour of the given type
+	/// </summary>
+	template <typename T>
+	static bool Has(entt::handle entity) {
+		return entity.has<T>();
+	}
+	/// <summary>
+	/// Checks whether the entity has any behaviour that has been registered with the system
+	/// </summary>
+	static bool HasAny(const entt::registry& registry, entt::entity entity);
+
+	/// <summary>
+	/// Invokes Update on all the enabled behaviours in the registry
+	/// </summary>
+	static void Update(entt::registry& registry);
+	/// <summary>
+	/// Invokes FixedUpdate on all the enabled behaviours in the registry
+	/// </summary>
+	static void FixedUpdate(entt::registry& registry);
+	/// <summary>
+	/// Invokes LateUpdate on all the enabled behaviours in the registry
+	/// </summary>
+	static void LateUpdate(entt::registry& registry);
+	/// <summary>
+	/// Invokes RenderGUI on all the enabled behaviours in the registry
+	/// </summary>
+	static void RenderGUI(entt::registry& registry);
+
+private:
+	typedef void(*RunFunction)(entt::registry& registry);
+
+	/// <summary>
+	/// The functions that update one type of behaviour, these are null for methods the type doesn't declare
+	/// </summary>
+	struct System {
+		entt::id_type Type;
+		RunFunction   Update = nullptr;
+		RunFunction   FixedUpdate = nullptr;
+		RunFunction   LateUpdate = nullptr;
+		RunFunction   RenderGUI = nullptr;
+		bool(*Has)(const entt::registry& registry, entt::entity entity) = nullptr;
+	};
+	static std::vector<System> _systems;
+
+	enum class Phase {
+		Update,
+		FixedUpdate,
+		LateUpdate,
+		RenderGUI
+	};
+
+	template <typename T, Phase P>
+	static void _Run(entt::registry& registry) {
+		registry.view<T>().each([&registry](entt::entity entity, T& behaviour) {
+			if (behaviour.Enabled) {
+				const entt::handle handle(registry, entity);
+				// The calls are qualified so that they don't go through the vtable for IBehaviour types
+				if constexpr (P == Phase::Update) {
+					behaviour.T::Update(handle);
+				} else if constexpr (P == Phase::FixedUpdate) {
+					behaviour.T::FixedUpdate(handle);
+				} else if constexpr (P == Phase::LateUpdate) {
+					behaviour.T::LateUpdate(handle);
+				} else {
+					behaviour.T::RenderGUI(handle);
+				}
+			}
+		});
+	}
+
+	// Checks whether T declares the method itself, rather than not having it or inheriting the empty one from IBehaviour
+	template <typename T, typename = void> struct _DeclaresOnLoad : std::false_type { };
+	template <typename T> struct _DeclaresOnLoad<T, std::enable_if_t<std::is_same_v<decltype(&T::OnLoad), void(T::*)(entt::handle)>>> : std::true_type { };
+	template <typename T, typename = void> struct _DeclaresUpdate : std::false_type { };
+	template <typename T> struct _DeclaresUpdate<T, std::enable_if_t<std::is_same_v<decltype(&T::Update), void(T::*)(entt::handle)>>> : std::true_type { };
+	template <typename T, typename = void> struct _DeclaresFixedUpdate : std::false_type { };
+	template <typename T> struct _DeclaresFixedUpdate<T, std::enable_if_t<std::is_same_v<decltype(&T::FixedUpdate), void(T::*)(entt::handle)>>> : std::true_type { };
+	template <typename T, typename = void> struct _DeclaresLateUpdate : std::false_type { };
+	template <typename T> struct _DeclaresLateUpdate<T, std::enable_if_t<std::is_same_v<decltype(&T::LateUpdate), void(T::*)(entt::handle)>>> : std::true_type { };
+	template <typename T, typename = void> struct _DeclaresRenderGUI : std::false_type { };
+	template <typename T> struct _DeclaresRenderGUI<T, std::enable_if_t<std::is_same_v<decltype(&T::RenderGUI), void(T::*)(entt::handle)>>> : std::true_type { };
+};
\ No newline at end of file
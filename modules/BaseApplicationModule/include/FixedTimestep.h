@@ -0,0 +1,84 @@
+#pragma once
+#include <functional>
+#include <GLM/glm.hpp>
+#include <GLM/gtc/quaternion.hpp>
+
+class GameScene;
+
+/// <summary>
+/// Add to objects that are moved during fixed updates, so that they are drawn smoothly between fixed steps instead
+/// of only moving when a step runs. The transform of an interpolated object is overwritten every frame, so it
+/// should only be moved in FixedUpdate
+/// </summary>
+struct TransformInterpolation
+{
+	glm::vec3 PreviousPosition;
+	glm::quat PreviousRotation;
+	glm::vec3 PreviousScale;
+	glm::vec3 CurrentPosition;
+	glm::quat CurrentRotation;
+	glm::vec3 CurrentScale;
+	// False until the state has been captured from the transform
+	bool      IsInitialized = false;
+};
+
+/// <summary>
+/// Runs a simulation at a fixed rate, independent of the frame rate. Time from each frame is added to an
+/// accumulator, and as many fixed steps as fit in it are run, so the simulation always advances by the same amount
+/// per step no matter how fast frames are rendered. Leftover time is used to interpolate objects with a
+/// TransformInterpolation component between their last two steps
+/// </summary>
+class FixedTimestep
+{
+public:
+	/// <summary>
+	/// Invoked for each fixed step, with the size of the step in seconds
+	/// </summary>
+	typedef std::function<void(float stepSize)> StepFunction;
+
+	FixedTimestep(float stepSize = 1.0f / 50.0f, int maxStepsPerFrame = 5);
+	~FixedTimestep() = default;
+
+	/// <summary>
+	/// The length of a fixed step, in seconds
+	/// </summary>
+	float StepSize;
+	/// <summary>
+	/// The most steps that can run in a single frame. If a frame takes long enough to need more, the extra time is
+	/// dropped so that slow steps can't cause slower frames that need even more steps (the spiral of death)
+	/// </summary>
+	int   MaxStepsPerFrame;
+	/// <summary>
+	/// Whether objects with a TransformInterpolation are interpolated between steps, or left at their last step
+	/// </summary>
+	bool  Interpolate;
+
+	/// <summary>
+	/// Advances the simulation by a frame, running as many fixed steps as fit and then interpolating transforms
+	/// </summary>
+	/// <param name="scene">The scene to interpolate transforms in</param>
+	/// <param name="frameTime">The time since the last frame, in seconds</param>
+	/// <param name="step">The function that runs a single fixed step</param>
+	/// <returns>The number of steps that were run</returns>
+	int Update(GameScene& scene, float frameTime, const StepFunction& step);
+
+	/// <summary>
+	/// Gets how far between the last two steps we are, from 0 to 1
+	/// </summary>
+	float GetAlpha() const { return _alpha; }
+	/// <summary>
+	/// Gets the total number of steps that have been run
+	/// </summary>
+	uint64_t GetTotalSteps() const { return _totalSteps; }
+	/// <summary>
+	/// Gets the total amount of time that has been dropped to avoid the spiral of death, in seconds
+	/// </summary>
+	double GetDroppedTime() const { return _droppedTime; }
+
+private:
+	// Accumulated in double precision, so long sessions don't lose time to rounding
+	double   _accumulator;
+	double   _droppedTime;
+	float    _alpha;
+	uint64_t _totalSteps;
+};
\ No newline at end of file
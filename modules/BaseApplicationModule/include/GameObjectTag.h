@@ -1,39 +1,72 @@
 #pragma once
 #include <string>
+#include <unordered_map>
 #include <entt.hpp>
+#include <cereal/types/string.hpp>
+
+/// <summary>
+/// Stores a single copy of every game object name, so that tags only need to store the name's hash
+/// </summary>
+class NameTable
+{
+public:
+	/// <summary>
+	/// Adds a name to the table if it is not already in it
+	/// </summary>
+	/// <returns>The hash of the name, which can be passed to Get to get the name back</returns>
+	static uint32_t Intern(const std::string& name);
+	/// <summary>
+	/// Gets the name with the given hash, or an empty string if no name with that hash was interned
+	/// </summary>
+	static const std::string& Get(uint32_t hash);
+
+private:
+	// Names are never removed, the number of unique names in a game is small even when the number of objects isn't
+	static std::unordered_map<uint32_t, std::string> _names;
+};
 
 /// <summary>
 /// Represents information associated with a game object within our scene
 /// </summary>
 struct GameObjectTag
 {
-	std::string Name;
-	uint32_t    HashedName;
-	GameObjectTag() : Name(""), HashedName(""_hs) {}
-	GameObjectTag(const GameObjectTag& other) {
-		Name = other.Name;
-		HashedName = other.HashedName;
-	}
-	GameObjectTag(GameObjectTag&& other) noexcept {
-		Name = other.Name;
-		HashedName = other.HashedName;
-	}
-	GameObjectTag& operator=(GameObjectTag&& other) noexcept{
-		Name = other.Name;
-		HashedName = other.HashedName;
-		return *this;
-	}
-	GameObjectTag& operator=(const GameObjectTag& other) noexcept {
-		Name = other.Name;
-		HashedName = other.HashedName;
-		return *this;
-	}
-	~GameObjectTag() = default;
+	/// <summary>
+	/// A bitmask of user defined tags, see GameScene::FindWithTags
+	/// </summary>
+	uint32_t Tags = 0;
+	/// <summary>
+	/// The layer the object is on, from 0 to 31, see GameScene::FindInLayers
+	/// </summary>
+	uint32_t Layer = 0;
+
+	GameObjectTag() : _hashedName(""_hs) {}
+	GameObjectTag(const std::string& name) : _hashedName(NameTable::Intern(name)) {}
 	
-	GameObjectTag(const std::string& name) {
-		Name = name;
-		HashedName = entt::hashed_string::value(name.c_str());
+	/// <summary>
+	/// Gets the object's name. Objects are renamed with GameScene::SetName, so that the scene's name index stays up to date
+	/// </summary>
+	const std::string& GetName() const { return NameTable::Get(_hashedName); }
+	uint32_t GetHashedName() const { return _hashedName; }
+
+	/// <summary>
+	/// Gets the bit for the given layer, for building layer masks
+	/// </summary>
+	static constexpr uint32_t LayerBit(uint32_t layer) { return 1u << layer; }
+
+	template <class Archive>
+	void save(Archive& archive) const {
+		archive(GetName(), Tags, Layer);
+	}
+	template <class Archive>
+	void load(Archive& archive) {
+		std::string name;
+		archive(name, Tags, Layer);
+		_hashedName = NameTable::Intern(name);
 	}
 
-	// TODO: we could expand this in the future for properties that all game objects should have
+private:
+	friend class GameScene;
+	uint32_t _hashedName;
+	// Where the object is in it's scene's name index, maintained by the scene
+	uint32_t _nameIndexSlot = UINT32_MAX;
 };
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+#include <memory>
+#include <cstddef>
+#include <type_traits>
+#include <GLM/glm.hpp>
+#include <bullet/btBulletDynamicsCommon.h>
+
+/// <summary>
+/// Describes how an object moves in the physics simulation. Objects need a RigidBodyComponent, a ColliderComponent
+/// and a Transform to be simulated, the PhysicsSystem creates the Bullet body for them on it's next step
+/// </summary>
+/// <remarks>
+/// Rigid bodies are simulated in world space, so they should not be parented to other objects. Changing the
+/// settings of an object that is already simulated will not affect it's body, replace the component or call
+/// PhysicsSystem::Rebuild to apply new settings
+/// </remarks>
+struct RigidBodyComponent
+{
+	/// <summary>
+	/// The mass of the body in kilograms, a mass of 0 makes the body static
+	/// </summary>
+	float Mass = 1.0f;
+	float Friction = 0.5f;
+	float Restitution = 0.0f;
+	float LinearDamping = 0.0f;
+	float AngularDamping = 0.05f;
+	/// <summary>
+	/// Kinematic bodies are moved by their transform instead of the simulation, but still push dynamic bodies around
+	/// </summary>
+	bool  IsKinematic = false;
+
+	/// <summary>
+	/// Gets whether the body never moves, static bodies are never written back to their transforms
+	/// </summary>
+	bool IsStatic() const { return Mass <= 0.0f && !IsKinematic; }
+
+	template <class Archive>
+	void serialize(Archive& archive) {
+		archive(Mass, Friction, Restitution, LinearDamping, AngularDamping, IsKinematic);
+	}
+};
+
+/// <summary>
+/// The shape an object has in the physics simulation. Shapes are shared, so any number of objects can use the
+/// same collider without copying it (ex: when stamping prefabs). Colliders are not scaled by their transforms,
+/// sizes are always in world units
+/// </summary>
+/// <remarks>
+/// Colliders are saved with the scene as the ID of their shape in GameScene::Assets(), so shapes need to be added
+/// to the asset table as btCollisionShapes to be saved
+/// </remarks>
+struct ColliderComponent
+{
+	std::shared_ptr<btCollisionShape> Shape;
+
+	/// <summary>
+	/// Gets whether the collider is a triangle mesh, which can only be used by static and kinematic bodies
+	/// </summary>
+	bool IsTriangleMesh() const {
+		return Shape != nullptr && Shape->getShapeType() == TRIANGLE_MESH_SHAPE_PROXYTYPE;
+	}
+
+	/// <summary>
+	/// Creates a box collider centered on the object
+	/// </summary>
+	/// <param name="halfExtents">Half of the size of the box along each axis</param>
+	static ColliderComponent Box(const glm::vec3& halfExtents);
+	/// <summary>
+	/// Creates a sphere collider centered on the object
+	/// </summary>
+	static ColliderComponent Sphere(float radius);
+	/// <summary>
+	/// Creates a capsule collider centered on the object, running along the Z axis
+	/// </summary>
+	/// <param name="radius">The radius of the capsule</param>
+	/// <param name="height">The distance between the centers of the capsule's end caps</param>
+	static ColliderComponent Capsule(float radius, float height);
+	/// <summary>
+	/// Creates a collider with this collider's shape moved away from the object's origin, ex: for models whose
+	/// origin is at their base instead of their center
+	/// </summary>
+	/// <param name="offset">Where the center of the shape should be, relative to the object's origin</param>
+	ColliderComponent WithOffset(const glm::vec3& offset) const;
+
+	/// <summary>
+	/// Creates a collider that matches a triangle mesh exactly. The positions and indices are copied into the
+	/// collider, so they don't need to be kept around
+	/// </summary>
+	/// <param name="vertices">A pointer to the first vertex</param>
+	/// <param name="stride">The size of a vertex in bytes</param>
+	/// <param name="positionOffset">The offset of the vertex's position (a glm::vec3) in bytes</param>
+	/// <param name="vertexCount">The number of vertices</param>
+	/// <param name="indices">The triangle list's indices, or nullptr if every 3 vertices make a triangle</param>
+	/// <param name="indexCount">The number of indices</param>
+	static ColliderComponent TriangleMesh(const void* vertices, size_t stride, size_t positionOffset, size_t vertexCount, const uint32_t* indices, size_t indexCount);
+	/// <summary>
+	/// Creates a collider that matches the triangles in a MeshBuilder exactly, see the overload above
+	/// </summary>
+	/// <typeparam name="MeshBuilderType">The type of mesh builder, it's vertex type needs a Position member</typeparam>
+	template <typename MeshBuilderType>
+	static ColliderComponent TriangleMesh(const MeshBuilderType& mesh) {
+		typedef std::remove_const_t<std::remove_pointer_t<decltype(mesh.GetVertexDataPtr())>> VertType;
+		return TriangleMesh(mesh.GetVertexDataPtr(), sizeof(VertType), offsetof(VertType, Position), mesh.GetVertexCount(),
+			mesh.GetIndexCount() > 0 ? mesh.GetIndexDataPtr() : nullptr, mesh.GetIndexCount());
+	}
+};
\ No newline at end of file
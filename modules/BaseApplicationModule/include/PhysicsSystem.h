@@ -0,0 +1,154 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <entt.hpp>
+#include <GLM/glm.hpp>
+#include <GLM/gtc/quaternion.hpp>
+#include "PhysicsComponents.h"
+#include "Scene.h"
+
+/// <summary>
+/// Simulates the objects in a scene that have a RigidBodyComponent, ColliderComponent and Transform with Bullet
+/// </summary>
+/// <remarks>
+/// Step should be called at a fixed rate, ex: from a FixedTimestep, so the simulation behaves the same no matter
+/// the frame rate. Objects that move should have a TransformInterpolation to be drawn smoothly between steps.
+/// Bullet only reports bodies that are awake, so after a step the new positions of the active bodies are collected
+/// into a list and written to their transforms in one pass, and bodies that have gone to sleep cost nothing.
+/// The system must be destroyed before the scene it simulates
+/// </remarks>
+class PhysicsSystem final
+{
+public:
+	typedef std::shared_ptr<PhysicsSystem> sptr;
+	static inline sptr Create(GameScene& scene) {
+		return std::make_shared<PhysicsSystem>(scene);
+	}
+
+	PhysicsSystem(GameScene& scene);
+	~PhysicsSystem();
+
+	// We'll disallow moving and copying, since Bullet holds pointers back to us
+	PhysicsSystem(const PhysicsSystem& other) = delete;
+	PhysicsSystem(PhysicsSystem&& other) = delete;
+	PhysicsSystem& operator=(const PhysicsSystem& other) = delete;
+	PhysicsSystem& operator=(PhysicsSystem&& other) = delete;
+
+	/// <summary>
+	/// Registers the physics components with GameScene, so they can be stamped from prefabs and saved. This is
+	/// done when a system is created, but should be called first if prefabs with physics components are made before that
+	/// </summary>
+	static void RegisterComponentTypes();
+
+	void SetGravity(const glm::vec3& value);
+	glm::vec3 GetGravity() const;
+
+	/// <summary>
+	/// Advances the simulation by a single step, creating bodies for any new objects first and writing the results
+	/// back to the transforms of the bodies that moved
+	/// </summary>
+	/// <param name="stepSize">The length of the step in seconds, this should be the same every step</param>
+	void Step(float stepSize);
+
+	/// <summary>
+	/// Gets the Bullet body for an object, or nullptr if it doesn't have one yet. Use this to apply forces,
+	/// impulses or velocities, the body is created on the step after the object gets it's components
+	/// </summary>
+	btRigidBody* GetBody(entt::entity entity) const;
+	/// <summary>
+	/// Throws away an object's body so it is re-created from it's components on the next step, use this after
+	/// changing it's RigidBodyComponent or moving it's transform to teleport it
+	/// </summary>
+	void Rebuild(entt::entity entity);
+
+	btDiscreteDynamicsWorld* GetWorld() const { return _world.get(); }
+
+	/// <summary>
+	/// Gets the number of objects that have a body in the simulation
+	/// </summary>
+	uint32_t GetBodyCount() const;
+	/// <summary>
+	/// Gets the number of bodies that moved in the last step, these are the only ones written back to their transforms
+	/// </summary>
+	uint32_t GetActiveBodyCount() const { return _activeBodyCount; }
+	/// <summary>
+	/// Gets how long Bullet took to run the last step, in milliseconds
+	/// </summary>
+	float GetStepTime() const { return _stepTime; }
+	/// <summary>
+	/// Gets how long writing the last step's results to the transforms took, in milliseconds
+	/// </summary>
+	float GetSyncTime() const { return _syncTime; }
+
+private:
+	/// <summary>
+	/// Feeds the object's transform to Bullet, and queues the new transforms of bodies that moved
+	/// </summary>
+	class _MotionState : public btMotionState
+	{
+	public:
+		_MotionState(PhysicsSystem* system, entt::entity entity) : _system(system), _entity(entity) { }
+		virtual ~_MotionState() = default;
+
+		virtual void getWorldTransform(btTransform& worldTrans) const override;
+		virtual void setWorldTransform(const btTransform& worldTrans) override;
+
+	private:
+		PhysicsSystem* _system;
+		entt::entity   _entity;
+	};
+
+	/// <summary>
+	/// The Bullet objects for a simulated object. These are kept by the system instead of in the registry, so that
+	/// they are never stamped or saved along with the object
+	/// </summary>
+	struct PhysicsBody
+	{
+		PhysicsBody(PhysicsSystem* system, entt::entity entity) : MotionState(system, entity) { }
+
+		// The body holds a pointer to the motion state, so the bodies are kept in a map that never moves them
+		_MotionState                 MotionState;
+		std::unique_ptr<btRigidBody> Body;
+	};
+
+	/// <summary>
+	/// The new transform of a body that moved during a step
+	/// </summary>
+	struct SyncEntry
+	{
+		entt::entity Entity;
+		glm::vec3    Position;
+		glm::quat    Rotation;
+	};
+
+	GameScene& _scene;
+
+	// Declared in the order they need to be created in, so that they are destroyed in reverse
+	std::unique_ptr<btDefaultCollisionConfiguration>     _collisionConfig;
+	std::unique_ptr<btCollisionDispatcher>               _dispatcher;
+	std::unique_ptr<btBroadphaseInterface>               _broadphase;
+	std::unique_ptr<btSequentialImpulseConstraintSolver> _solver;
+	std::unique_ptr<btDiscreteDynamicsWorld>             _world;
+
+	std::unordered_map<entt::entity, PhysicsBody> _bodies;
+	// Objects that may need a body created, these are checked on the next step
+	std::vector<entt::entity> _pendingBodies;
+	std::vector<SyncEntry>    _syncQueue;
+
+	uint32_t _activeBodyCount = 0;
+	float    _stepTime = 0.0f;
+	float    _syncTime = 0.0f;
+
+	/// <summary>
+	/// Creates bodies for the pending objects that have all the components to be simulated
+	/// </summary>
+	void _CreatePendingBodies();
+	void _DestroyBody(entt::entity entity);
+	void _OnComponentAdded(entt::registry& registry, entt::entity entity);
+	void _OnComponentChanged(entt::registry& registry, entt::entity entity);
+	void _OnComponentRemoved(entt::registry& registry, entt::entity entity);
+
+	static void _ColliderSave(cereal::BinaryOutputArchive& archive, const entt::registry& registry, const std::vector<entt::entity>& entities, const SceneEntityMap& map);
+	static void _ColliderLoad(cereal::BinaryInputArchive& archive, entt::registry& registry, const std::vector<entt::entity>& entities, const SceneEntityMap& map);
+};
\ No newline at end of file
@@ -1,11 +1,68 @@
 #pragma once
 #include "entt.hpp"
 #include <Macros.h>
+#include <cereal/archives/binary.hpp>
+#include "SpatialIndex.h"
+#include "AssetTable.h"
+
+struct GameObjectTag;
 
 /// <summary>
 /// Represents a callback that may be used to customize how entity stamping works between registries
 /// </summary>
 typedef void(*StampFunction)(const entt::registry& from, const entt::entity src, entt::registry& to, const entt::entity dst);
+/// <summary>
+/// Represents a callback that may be used to customize how a component is stamped onto many entities at once
+/// </summary>
+typedef void(*BulkStampFunction)(const entt::registry& from, const entt::entity src, entt::registry& to, const std::vector<entt::entity>& dsts);
+
+/// <summary>
+/// Maps entities to and from their index within a saved scene, so that components which reference other entities
+/// (ex: a transform's parent) can be saved and loaded
+/// </summary>
+class SceneEntityMap
+{
+public:
+	static constexpr uint32_t NullIndex = UINT32_MAX;
+
+	/// <summary>
+	/// Gets the index of an entity within the saved scene, or NullIndex if the entity is null or was not saved
+	/// </summary>
+	uint32_t IndexOf(entt::entity entity) const {
+		if (entity == entt::null) {
+			return NullIndex;
+		}
+		const size_t slot = entt::to_integral(entity) & entt::entt_traits<entt::entity>::entity_mask;
+		if (slot >= _indices.size() || _indices[slot] == NullIndex) {
+			return NullIndex;
+		}
+		// The slot may have been saved for an older version of the entity
+		const uint32_t index = _indices[slot];
+		return _entities[index] == entity ? index : NullIndex;
+	}
+	/// <summary>
+	/// Gets the entity at the given index within the saved scene, or null if the index is out of range
+	/// </summary>
+	entt::entity EntityAt(uint32_t index) const {
+		return index < _entities.size() ? _entities[index] : entt::null;
+	}
+
+private:
+	friend class GameScene;
+	// Index to entity
+	std::vector<entt::entity> _entities;
+	// Entity slot to index, only filled in when saving
+	std::vector<uint32_t> _indices;
+};
+
+/// <summary>
+/// Represents a callback that writes a component for each of the given entities into a binary archive
+/// </summary>
+typedef void(*SaveFunction)(cereal::BinaryOutputArchive& archive, const entt::registry& registry, const std::vector<entt::entity>& entities, const SceneEntityMap& map);
+/// <summary>
+/// Represents a callback that reads a component for each of the given entities from a binary archive, and adds them to the entities
+/// </summary>
+typedef void(*LoadFunction)(cereal::BinaryInputArchive& archive, entt::registry& registry, const std::vector<entt::entity>& entities, const SceneEntityMap& map);
 
 typedef entt::handle GameObject;
 
@@ -22,10 +79,71 @@ public:
 	entt::handle CreateEntity(const std::string& name = "");
 	entt::handle CreateEntity(entt::entity prefab, const std::string& name = "");
 
+	/// <summary>
+	/// Creates many copies of a prefab at once. This is much faster than calling CreateEntity(prefab) in a loop,
+	/// since storage is reserved up front and components are copied one type at a time
+	/// </summary>
+	/// <param name="prefab">The prefab to copy, from Prefabs()</param>
+	/// <param name="count">The number of copies to create</param>
+	/// <param name="parent">An entity in this scene to parent the copies to, or null to leave them at the root</param>
+	/// <returns>The new entities</returns>
+	std::vector<entt::entity> CreateEntities(entt::entity prefab, size_t count, entt::entity parent = entt::null);
+	/// <summary>
+	/// Creates a copy of a prefab for each of the given positions, each position is added to the prefab's local position
+	/// </summary>
+	/// <param name="prefab">The prefab to copy, from Prefabs()</param>
+	/// <param name="positions">The positions to place the copies at, relative to the parent if one is given</param>
+	/// <param name="parent">An entity in this scene to parent the copies to, or null to leave them at the root</param>
+	/// <returns>The new entities, in the same order as positions</returns>
+	std::vector<entt::entity> CreateEntities(entt::entity prefab, const std::vector<glm::vec3>& positions, entt::entity parent = entt::null);
+
+	/// <summary>
+	/// Copies an entity in this scene into the prefab registry, so that it can be passed to CreateEntity and CreateEntities
+	/// </summary>
+	/// <param name="entity">The entity to make a prefab of</param>
+	/// <returns>The prefab's entity in Prefabs()</returns>
+	entt::entity CreatePrefab(entt::entity entity) const;
+
+	/// <summary>
+	/// Finds an object by name, this is a hash lookup so it is fine to call often
+	/// </summary>
+	/// <returns>A handle to the first object found with the name, or a null handle if there isn't one</returns>
 	entt::handle FindFirst(const std::string& name);
+	/// <summary>
+	/// Finds all the objects with the given name
+	/// </summary>
+	std::vector<entt::entity> FindAll(const std::string& name) const;
+	/// <summary>
+	/// Finds all the objects that have tags in the given mask
+	/// </summary>
+	/// <param name="tagMask">The tags to look for</param>
+	/// <param name="matchAll">True if objects need all of the tags in tagMask, false if they only need one of them</param>
+	std::vector<entt::entity> FindWithTags(uint32_t tagMask, bool matchAll = false) const;
+	/// <summary>
+	/// Finds all the objects on any of the layers in the given mask, see GameObjectTag::LayerBit
+	/// </summary>
+	std::vector<entt::entity> FindInLayers(uint32_t layerMask) const;
+	/// <summary>
+	/// Renames an object, keeping the name index up to date
+	/// </summary>
+	void SetName(entt::entity entity, const std::string& name);
 
 	entt::registry& Registry() { return _registry; }
 
+	/// <summary>
+	/// Gets the spatial index containing all objects in the scene with a SpatialProxy component
+	/// </summary>
+	SpatialIndex& Spatial() { return _spatialIndex; }
+	const SpatialIndex& Spatial() const { return _spatialIndex; }
+
+	/// <summary>
+	/// Updates the world bounds of all objects with a SpatialProxy in the spatial index, should be called after
+	/// world matrices have been updated for the frame. Objects are only re-inserted if they have moved outside of
+	/// their fattened bounds
+	/// </summary>
+	/// <returns>The number of objects that were re-inserted into the index</returns>
+	uint32_t UpdateSpatialIndex();
+
 	/// <summary>
 	/// Perform any tasks that should happen at the end of a loop, such as deleting queued objects
 	/// </summary>
@@ -44,22 +162,145 @@ public:
 	/// <param name="to">The destination registry to store the entity in</param>
 	/// <returns>A handle for the newly created entity</returns>
 	static entt::handle StampEntity(const entt::registry& from, entt::entity src, entt::registry& to);
+	/// <summary>
+	/// Creates count new entities in the <i>to</i> registry, copying the components from the <i>src</i> entity in the from registry
+	/// </summary>
+	/// <param name="from">The source registry to copy the object from</param>
+	/// <param name="src">The source entity within the <i>from</i> registry to copy</param>
+	/// <param name="to">The destination registry to store the entities in</param>
+	/// <param name="count">The number of copies to create</param>
+	/// <returns>The new entities</returns>
+	static std::vector<entt::entity> StampEntities(const entt::registry& from, entt::entity src, entt::registry& to, size_t count);
 
+	/// <summary>
+	/// Saves all the entities in the scene to a binary file. Only components with a registered type that can be
+	/// saved are written, either with a save override or by having a cereal serialize or save function
+	/// </summary>
+	/// <param name="path">The path of the file to write</param>
+	/// <param name="compress">True to gzip the scene data, smaller files at the cost of slower saves and loads</param>
+	/// <returns>True if the scene was saved</returns>
+	bool SaveBinary(const std::string& path, bool compress = true) const;
+	/// <summary>
+	/// Loads entities from a file written by SaveBinary, adding them to the scene. Assets referenced by the scene
+	/// are looked up in Assets(), so they should be added before loading
+	/// </summary>
+	/// <param name="path">The path of the file to read</param>
+	/// <returns>True if the scene was loaded, false if the file could not be read or contains unregistered components</returns>
+	bool LoadBinary(const std::string& path);
+
+	/// <summary>
+	/// Registers a component type, so that it can be stamped from prefabs and saved with the scene
+	/// </summary>
+	/// <typeparam name="Type">The type of component to register</typeparam>
+	/// <param name="stampOverride">Overrides how the component is copied between registries, or nullptr to copy it</param>
+	/// <param name="saveOverride">Overrides how the component is saved, or nullptr to use it's cereal serialization if it has any</param>
+	/// <param name="loadOverride">Overrides how the component is loaded, should be given along with saveOverride</param>
+	/// <param name="bulkStampOverride">
+	/// Overrides how the component is copied to many entities at once. If null, the component is copied to all of
+	/// them in one go, or if a stampOverride was given, stampOverride is called for each entity
+	/// </param>
 	template <typename Type>
-	static void RegisterComponentType(StampFunction stampOverride = nullptr) {
-		_stampFunctions[entt::type_info<Type>::id()] = stampOverride != nullptr ? stampOverride : &_DefaultComponentStamp<Type>;
+	static void RegisterComponentType(StampFunction stampOverride = nullptr, SaveFunction saveOverride = nullptr, LoadFunction loadOverride = nullptr,
+		BulkStampFunction bulkStampOverride = nullptr) {
+		ComponentTypeInfo& info = _componentTypes[entt::type_info<Type>::id()];
+		info.Name = std::string(entt::type_info<Type>::name());
+		info.Stamp = stampOverride != nullptr ? stampOverride : &_DefaultComponentStamp<Type>;
+		info.BulkStamp = bulkStampOverride != nullptr ? bulkStampOverride : (stampOverride != nullptr ? nullptr : &_DefaultComponentBulkStamp<Type>);
+		info.Save = saveOverride;
+		info.Load = loadOverride;
+		if constexpr (cereal::traits::is_output_serializable<Type, cereal::BinaryOutputArchive>::value &&
+			cereal::traits::is_input_serializable<Type, cereal::BinaryInputArchive>::value &&
+			std::is_default_constructible_v<Type>) {
+			if (saveOverride == nullptr && loadOverride == nullptr) {
+				info.Save = &_DefaultComponentSave<Type>;
+				info.Load = &_DefaultComponentLoad<Type>;
+			}
+		}
+		info.Collect = [](const entt::registry& registry, std::vector<entt::entity>& entities) {
+			const auto view = registry.view<const Type>();
+			entities.assign(view.begin(), view.end());
+		};
+		info.Reserve = [](entt::registry& registry, size_t count) {
+			registry.reserve<Type>(registry.size<Type>() + count);
+		};
 	}
 	static entt::registry& Prefabs() { return _prefabRegistry; }
+	/// <summary>
+	/// Gets the table of assets that components can refer to by ID when the scene is saved
+	/// </summary>
+	static AssetTable& Assets() { return _assets; }
 	
 private:
+	// Declared before the registry so that it outlives any proxy destruction callbacks
+	SpatialIndex _spatialIndex;
+	// Maps name hashes to the objects with that name, the objects' tags store where they are in their list
+	std::unordered_map<uint32_t, std::vector<entt::entity>> _nameIndex;
 	entt::registry _registry;
 	std::vector<entt::entity> _deletionQueue;
 
+	void _OnSpatialProxyDestroyed(entt::registry& registry, entt::entity entity);
+	void _OnTagConstructed(entt::registry& registry, entt::entity entity);
+	void _OnTagDestroyed(entt::registry& registry, entt::entity entity);
+	void _AddToNameIndex(entt::entity entity, GameObjectTag& tag);
+	void _RemoveFromNameIndex(const GameObjectTag& tag);
+	/// <summary>
+	/// Sorts the transforms by their depth in the hierarchy if they aren't already, so that parents are updated before their children
+	/// </summary>
+	void _SortTransformsIfNeeded();
+	std::vector<entt::entity> _CreateEntities(entt::entity prefab, size_t count, const glm::vec3* positions, entt::entity parent);
+
+	static void _SpatialProxyStamp(const entt::registry& from, const entt::entity src, entt::registry& to, const entt::entity dst);
+	static void _SpatialProxyBulkStamp(const entt::registry& from, const entt::entity src, entt::registry& to, const std::vector<entt::entity>& dsts);
+	static void _SpatialProxySave(cereal::BinaryOutputArchive& archive, const entt::registry& registry, const std::vector<entt::entity>& entities, const SceneEntityMap& map);
+	static void _SpatialProxyLoad(cereal::BinaryInputArchive& archive, entt::registry& registry, const std::vector<entt::entity>& entities, const SceneEntityMap& map);
+	static void _TransformStamp(const entt::registry& from, const entt::entity src, entt::registry& to, const entt::entity dst);
+	static void _TransformBulkStamp(const entt::registry& from, const entt::entity src, entt::registry& to, const std::vector<entt::entity>& dsts);
+	static void _TransformSave(cereal::BinaryOutputArchive& archive, const entt::registry& registry, const std::vector<entt::entity>& entities, const SceneEntityMap& map);
+	static void _TransformLoad(cereal::BinaryInputArchive& archive, entt::registry& registry, const std::vector<entt::entity>& entities, const SceneEntityMap& map);
+
+	/// <summary>
+	/// Everything we need to know to copy, save and load a type of component without knowing it's type
+	/// </summary>
+	struct ComponentTypeInfo {
+		std::string       Name;
+		StampFunction     Stamp = nullptr;
+		// Null if the component should be stamped one entity at a time
+		BulkStampFunction BulkStamp = nullptr;
+		// Save and Load are null for components that can't be saved
+		SaveFunction      Save = nullptr;
+		LoadFunction      Load = nullptr;
+		// Gets all the entities in a registry with the component
+		void(*Collect)(const entt::registry& registry, std::vector<entt::entity>& entities) = nullptr;
+		// Reserves room for count more of the component in a registry
+		void(*Reserve)(entt::registry& registry, size_t count) = nullptr;
+	};
+
 	static entt::registry _prefabRegistry;
-	static std::unordered_map<entt::id_type, StampFunction> _stampFunctions;
+	static AssetTable _assets;
+	static std::unordered_map<entt::id_type, ComponentTypeInfo> _componentTypes;
 
 	template <typename T>
 	static void _DefaultComponentStamp(const entt::registry& from, const entt::entity src, entt::registry& to, const entt::entity dst) {
 		to.emplace_or_replace<T>(dst, from.get<T>(src));
 	}
+	template <typename T>
+	static void _DefaultComponentBulkStamp(const entt::registry& from, const entt::entity src, entt::registry& to, const std::vector<entt::entity>& dsts) {
+		to.reserve<T>(to.size<T>() + dsts.size());
+		to.insert<T>(dsts.begin(), dsts.end(), from.get<T>(src));
+	}
+	template <typename T>
+	static void _DefaultComponentSave(cereal::BinaryOutputArchive& archive, const entt::registry& registry, const std::vector<entt::entity>& entities, const SceneEntityMap& map) {
+		for (entt::entity entity : entities) {
+			archive(registry.get<T>(entity));
+		}
+	}
+	template <typename T>
+	static void _DefaultComponentLoad(cereal::BinaryInputArchive& archive, entt::registry& registry, const std::vector<entt::entity>& entities, const SceneEntityMap& map) {
+		// Read everything first so that the components can be added in one go
+		std::vector<T> components(entities.size());
+		for (T& component : components) {
+			archive(component);
+		}
+		registry.insert<T>(entities.begin(), entities.end(), components.begin(), components.end());
+	}
 };
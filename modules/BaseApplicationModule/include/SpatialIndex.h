@@ -0,0 +1,204 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <entt.hpp>
+#include <GLM/glm.hpp>
+
+#include "Bounds.h"
+
+/// <summary>
+/// Attach to a game object to have it tracked by the scene's spatial index. The world space bounds
+/// are calculated from the local bounds and the object's transform whenever the index is updated
+/// </summary>
+struct SpatialProxy
+{
+	/// <summary>
+	/// The bounds of the object in it's local space (ex: the bounds of it's mesh)
+	/// </summary>
+	AxisAlignedBox LocalBounds;
+	/// <summary>
+	/// The ID of the object's leaf in the spatial index, or -1 if it has not been inserted yet
+	/// </summary>
+	int32_t        ProxyId = -1;
+
+	SpatialProxy() = default;
+	SpatialProxy(const AxisAlignedBox& localBounds) : LocalBounds(localBounds), ProxyId(-1) { }
+};
+
+/// <summary>
+/// Represents a ray used for querying the spatial index
+/// </summary>
+struct SpatialRay
+{
+	glm::vec3 Origin;
+	glm::vec3 Direction;
+	float     MaxDistance;
+
+	SpatialRay() : Origin(glm::vec3(0.0f)), Direction(glm::vec3(0.0f, 0.0f, -1.0f)), MaxDistance(FLT_MAX) { }
+	SpatialRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance = FLT_MAX) :
+		Origin(origin), Direction(direction), MaxDistance(maxDistance) { }
+};
+
+/// <summary>
+/// The result of a ray query against the spatial index
+/// </summary>
+struct SpatialRayHit
+{
+	entt::entity Entity   = entt::null;
+	/// <summary>
+	/// The distance along the ray where it enters the entity's bounds
+	/// </summary>
+	float        Distance = FLT_MAX;
+
+	bool IsHit() const { return Entity != entt::null; }
+};
+
+/// <summary>
+/// A dynamic bounding volume hierarchy (AABB tree) over entities. Leaves store bounds that are slightly larger
+/// than the object (fattened by a margin), so that objects making small movements do not need to be re-inserted.
+/// Moved leaves are removed and re-inserted using a surface area heuristic, and the tree is kept balanced with
+/// rotations, so the cost of an update scales with the number of objects that moved rather than the scene size
+/// </summary>
+class SpatialIndex final
+{
+public:
+	SpatialIndex(float margin = 0.1f);
+	~SpatialIndex() = default;
+
+	SpatialIndex(const SpatialIndex& other) = delete;
+	SpatialIndex(SpatialIndex&& other) = delete;
+	SpatialIndex& operator=(const SpatialIndex& other) = delete;
+	SpatialIndex& operator=(SpatialIndex&& other) = delete;
+
+	/// <summary>
+	/// Inserts a new leaf into the tree
+	/// </summary>
+	/// <param name="bounds">The world space bounds of the object</param>
+	/// <param name="entity">The entity that the leaf represents</param>
+	/// <returns>The ID of the new leaf</returns>
+	int32_t CreateProxy(const AxisAlignedBox& bounds, entt::entity entity);
+	/// <summary>
+	/// Removes a leaf from the tree
+	/// </summary>
+	void DestroyProxy(int32_t proxyId);
+	/// <summary>
+	/// Updates the bounds of a leaf. If the new bounds still fit in the leaf's fattened bounds this does nothing
+	/// </summary>
+	/// <param name="proxyId">The ID of the leaf to move</param>
+	/// <param name="bounds">The new world space bounds of the object</param>
+	/// <returns>True if the leaf was re-inserted into the tree</returns>
+	bool MoveProxy(int32_t proxyId, const AxisAlignedBox& bounds);
+
+	/// <summary>
+	/// Gets the (fattened) bounds stored for the given leaf
+	/// </summary>
+	const AxisAlignedBox& GetFatBounds(int32_t proxyId) const { return _nodes[proxyId].Bounds; }
+	/// <summary>
+	/// Gets the entity stored in the given leaf
+	/// </summary>
+	entt::entity GetEntity(int32_t proxyId) const { return _nodes[proxyId].Entity; }
+	/// <summary>
+	/// Gets the number of leaves in the tree
+	/// </summary>
+	uint32_t GetProxyCount() const { return _proxyCount; }
+	/// <summary>
+	/// Gets the height of the tree, where a tree with a single leaf has a height of 0
+	/// </summary>
+	int32_t GetHeight() const { return _root == NullNode ? 0 : _nodes[_root].Height; }
+
+	/// <summary>
+	/// Discards the tree structure and rebuilds it from the current leaves with a top-down median split. This
+	/// produces a better tree than incremental insertion, and is faster when most objects have moved
+	/// </summary>
+	void Rebuild();
+	/// <summary>
+	/// Removes all leaves from the tree, and resets the proxy ID of every SpatialProxy in the registry that owned
+	/// them so they are re-inserted on the next update
+	/// </summary>
+	/// <param name="registry">The registry containing the SpatialProxy components for the leaves</param>
+	void Clear(entt::registry& registry);
+
+	/// <summary>
+	/// Finds all entities whose bounds overlap the given box
+	/// </summary>
+	/// <param name="bounds">The world space box to query</param>
+	/// <param name="results">The list to append results to</param>
+	void QueryBox(const AxisAlignedBox& bounds, std::vector<entt::entity>& results) const;
+	/// <summary>
+	/// Finds all entities whose bounds overlap the given sphere
+	/// </summary>
+	void QuerySphere(const glm::vec3& center, float radius, std::vector<entt::entity>& results) const;
+	/// <summary>
+	/// Finds all entities whose bounds are at least partially inside the frustum described by the given view-projection matrix
+	/// </summary>
+	void QueryFrustum(const glm::mat4& viewProjection, std::vector<entt::entity>& results) const;
+	/// <summary>
+	/// Finds the closest entity whose bounds are intersected by the given ray
+	/// </summary>
+	SpatialRayHit Raycast(const SpatialRay& ray) const;
+	/// <summary>
+	/// Finds all entities whose bounds are intersected by the given ray, in no particular order
+	/// </summary>
+	void RaycastAll(const SpatialRay& ray, std::vector<SpatialRayHit>& results) const;
+
+	/// <summary>
+	/// Performs a batch of box queries, sharing a single traversal stack between them
+	/// </summary>
+	/// <param name="boxes">The boxes to query</param>
+	/// <param name="count">The number of boxes to query</param>
+	/// <param name="results">Receives one list of results per box, resized to count</param>
+	void QueryBoxes(const AxisAlignedBox* boxes, size_t count, std::vector<std::vector<entt::entity>>& results) const;
+	/// <summary>
+	/// Performs a batch of sphere queries, sharing a single traversal stack between them
+	/// </summary>
+	void QuerySpheres(const BoundingSphere* spheres, size_t count, std::vector<std::vector<entt::entity>>& results) const;
+	/// <summary>
+	/// Performs a batch of closest-hit ray queries, sharing a single traversal stack between them
+	/// </summary>
+	/// <param name="rays">The rays to cast</param>
+	/// <param name="count">The number of rays to cast</param>
+	/// <param name="hits">An array of at least count elements to receive the closest hit for each ray</param>
+	void RaycastBatch(const SpatialRay* rays, size_t count, SpatialRayHit* hits) const;
+
+	/// <summary>
+	/// Extracts the 6 normalized frustum planes from a view-projection matrix, where xyz is the inward facing normal
+	/// </summary>
+	static void ExtractFrustumPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6]);
+
+	static constexpr int32_t NullNode = -1;
+
+private:
+	struct Node {
+		// For leaves this is the fattened bounds of the object, for branches it contains both children
+		AxisAlignedBox Bounds;
+		entt::entity   Entity;
+		// The parent for nodes in the tree, or the next free node for nodes in the free list
+		int32_t        Parent;
+		int32_t        Child1;
+		int32_t        Child2;
+		// 0 for leaves, -1 for free nodes
+		int32_t        Height;
+
+		bool IsLeaf() const { return Child1 == NullNode; }
+	};
+
+	std::vector<Node> _nodes;
+	int32_t  _root;
+	int32_t  _freeList;
+	uint32_t _proxyCount;
+	float    _margin;
+
+	// Reused between queries to avoid allocating during traversal
+	mutable std::vector<int32_t> _stack;
+
+	int32_t _AllocateNode();
+	void _FreeNode(int32_t node);
+	void _InsertLeaf(int32_t leaf);
+	void _RemoveLeaf(int32_t leaf);
+	int32_t _Balance(int32_t node);
+	int32_t _BuildTopDown(int32_t* leaves, size_t count);
+
+	void _QueryBox(const AxisAlignedBox& bounds, std::vector<entt::entity>& results) const;
+	void _QuerySphere(const glm::vec3& center, float radius, std::vector<entt::entity>& results) const;
+	SpatialRayHit _Raycast(const SpatialRay& ray) const;
+};
\ No newline at end of file
@@ -1,16 +1,26 @@
 #pragma once
+#include <chrono>
 
 class Timing
 {
 public:
+	typedef std::chrono::high_resolution_clock Clock;
+
 	static Timing& Instance() {
 		static Timing instance;
 		return instance;
 	}
 
+	// Gets the number of milliseconds since the given time point, for timing bits of code (ex: in benchmarks)
+	static double ElapsedMs(const Clock::time_point& start) {
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
 	double CurrentFrame;
 	double LastFrame;
 	float  DeltaTime;
+	// The length of a fixed step in seconds, for use in FixedUpdate, see FixedTimestep
+	float  FixedTimeStep = 1.0f / 50.0f;
 
 protected:
 	Timing() = default;
@@ -203,6 +203,9 @@ public:
 	int GetHierarchyDepth() const { return _hierarchyDepth; }
 
 private:
+	// The scene needs to restore transforms directly when loading, see GameScene::LoadBinary
+	friend class GameScene;
+
 	mutable bool _isLocalDirty;
 	mutable glm::mat4 _localTransform;
 	mutable glm::mat3 _normalMatrix;
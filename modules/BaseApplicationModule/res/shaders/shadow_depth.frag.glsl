@@ -0,0 +1,5 @@
+#version 410
+
+// Shadow maps only need depth, which is written for us
+void main() {
+}
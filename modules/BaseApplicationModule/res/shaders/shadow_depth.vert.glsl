@@ -0,0 +1,10 @@
+#version 410
+
+layout(location = 0) in vec3 inPosition;
+
+// The light's view-projection for the cascade, multiplied with the model matrix
+uniform mat4 u_ModelViewProjection;
+
+void main() {
+	gl_Position = u_ModelViewProjection * vec4(inPosition, 1.0);
+}
@@ -15,6 +15,16 @@ uniform mat4 u_View;
 uniform mat4 u_Model;
 uniform mat3 u_NormalMatrix;
 uniform vec3 u_LightPos;
+// Set for meshes that store their normals as 2 component octahedral encoded values (see VertexPacking)
+// Quantized positions are handled by folding the mesh's dequantization transform into u_Model
+uniform bool u_OctahedralNormals;
+
+vec3 OctDecode(vec2 f) {
+	vec3 n = vec3(f.x, f.y, 1.0 - abs(f.x) - abs(f.y));
+	float t = max(-n.z, 0.0);
+	n.xy += mix(vec2(t), vec2(-t), greaterThanEqual(n.xy, vec2(0.0)));
+	return normalize(n);
+}
 
 
 void main() {
@@ -26,7 +36,8 @@ void main() {
 	outPos = (u_Model * vec4(inPosition, 1.0)).xyz;
 
 	// Normals
-	outNormal = u_NormalMatrix * inNormal;
+	vec3 normal = u_OctahedralNormals ? OctDecode(inNormal.xy) : inNormal;
+	outNormal = u_NormalMatrix * normal;
 
 	// Pass our UV coords to the fragment shader
 	outUV = inUV;
@@ -0,0 +1,44 @@
+#include "BehaviourSystem.h"
+
+std::vector<BehaviourSystem::System> BehaviourSystem::_systems;
+
+bool BehaviourSystem::HasAny(const entt::registry& registry, entt::entity entity) {
+	for (const System& system : _systems) {
+		if (system.Has(registry, entity)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void BehaviourSystem::Update(entt::registry& registry) {
+	for (const System& system : _systems) {
+		if (system.Update != nullptr) {
+			system.Update(registry);
+		}
+	}
+}
+
+void BehaviourSystem::FixedUpdate(entt::registry& registry) {
+	for (const System& system : _systems) {
+		if (system.FixedUpdate != nullptr) {
+			system.FixedUpdate(registry);
+		}
+	}
+}
+
+void BehaviourSystem::LateUpdate(entt::registry& registry) {
+	for (const System& system : _systems) {
+		if (system.LateUpdate != nullptr) {
+			system.LateUpdate(registry);
+		}
+	}
+}
+
+void BehaviourSystem::RenderGUI(entt::registry& registry) {
+	for (const System& system : _systems) {
+		if (system.RenderGUI != nullptr) {
+			system.RenderGUI(registry);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "FixedTimestep.h"
+
+#include <cmath>
+#include "Scene.h"
+#include "Timing.h"
+#include "Transform.h"
+
+FixedTimestep::FixedTimestep(float stepSize, int maxStepsPerFrame) :
+	StepSize(stepSize),
+	MaxStepsPerFrame(maxStepsPerFrame),
+	Interpolate(true),
+	_accumulator(0.0),
+	_droppedTime(0.0),
+	_alpha(0.0f),
+	_totalSteps(0)
+{ }
+
+int FixedTimestep::Update(GameScene& scene, float frameTime, const StepFunction& step) {
+	auto view = scene.Registry().view<Transform, TransformInterpolation>();
+	Timing::Instance().FixedTimeStep = StepSize;
+
+	_accumulator += frameTime;
+	int steps = 0;
+	if (_accumulator >= StepSize) {
+		// The transforms are holding the interpolated state from last frame, put back the state from the last step
+		view.each([](Transform& transform, TransformInterpolation& state) {
+			if (state.IsInitialized) {
+				transform.SetLocalPosition(state.CurrentPosition);
+				transform.SetLocalRotation(state.CurrentRotation);
+				transform.SetLocalScale(state.CurrentScale);
+			}
+		});
+
+		while (_accumulator >= StepSize && steps < MaxStepsPerFrame) {
+			view.each([](Transform& transform, TransformInterpolation& state) {
+				state.PreviousPosition = transform.GetLocalPosition();
+				state.PreviousRotation = transform.GetLocalRotationQuat();
+				state.PreviousScale = transform.GetLocalScale();
+			});
+			step(StepSize);
+			_accumulator -= StepSize;
+			steps++;
+			_totalSteps++;
+		}
+
+		// We couldn't keep up, drop the time we'd need to catch up on but keep the partial step for interpolation
+		if (_accumulator >= StepSize) {
+			const double dropped = _accumulator - std::fmod(_accumulator, (double)StepSize);
+			_droppedTime += dropped;
+			_accumulator -= dropped;
+		}
+
+		view.each([](Transform& transform, TransformInterpolation& state) {
+			state.CurrentPosition = transform.GetLocalPosition();
+			state.CurrentRotation = transform.GetLocalRotationQuat();
+			state.CurrentScale = transform.GetLocalScale();
+			state.IsInitialized = true;
+		});
+	}
+
+	_alpha = static_cast<float>(_accumulator / StepSize);
+	if (Interpolate) {
+		const float alpha = _alpha;
+		view.each([alpha](Transform& transform, TransformInterpolation& state) {
+			if (state.IsInitialized) {
+				transform.SetLocalPosition(glm::mix(state.PreviousPosition, state.CurrentPosition, alpha));
+				transform.SetLocalRotation(glm::slerp(state.PreviousRotation, state.CurrentRotation, alpha));
+				transform.SetLocalScale(glm::mix(state.PreviousScale, state.CurrentScale, alpha));
+			}
+		});
+	}
+	return steps;
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#include "GameObjectTag.h"
+
+#include "LoggingBase.h"
+
+std::unordered_map<uint32_t, std::string> NameTable::_names;
+
+uint32_t NameTable::Intern(const std::string& name) {
+	const uint32_t hash = entt::hashed_string::value(name.c_str());
+	auto it = _names.find(hash);
+	if (it == _names.end()) {
+		_names.emplace(hash, name);
+	} else if (it->second != name) {
+		LOG_WARN("Names \"{}\" and \"{}\" have the same hash, they will be treated as the same name", it->second, name);
+	}
+	return hash;
+}
+
+const std::string& NameTable::Get(uint32_t hash) {
+	static const std::string empty;
+	auto it = _names.find(hash);
+	return it == _names.end() ? empty : it->second;
+}
\ No newline at end of file
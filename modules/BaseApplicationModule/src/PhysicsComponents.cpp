@@ -0,0 +1,94 @@
+#include "PhysicsComponents.h"
+
+#include <vector>
+#include <cstring>
+#include "LoggingBase.h"
+
+namespace {
+	/// <summary>
+	/// Bullet's triangle meshes only reference their data, so this owns it for as long as the shape is in use.
+	/// The shape is handed out through a shared_ptr that shares ownership of the whole thing
+	/// </summary>
+	struct TriangleMeshData
+	{
+		std::vector<glm::vec3> Positions;
+		std::vector<int>       Indices;
+		std::unique_ptr<btTriangleIndexVertexArray> Mesh;
+		std::unique_ptr<btBvhTriangleMeshShape>     Shape;
+	};
+
+	/// <summary>
+	/// Compound shapes only reference their children, so this keeps the child alive for as long as the compound is
+	/// </summary>
+	struct OffsetShapeData
+	{
+		std::shared_ptr<btCollisionShape> Child;
+		std::unique_ptr<btCompoundShape>  Shape;
+	};
+}
+
+ColliderComponent ColliderComponent::Box(const glm::vec3& halfExtents) {
+	return { std::shared_ptr<btCollisionShape>(new btBoxShape(btVector3(halfExtents.x, halfExtents.y, halfExtents.z))) };
+}
+
+ColliderComponent ColliderComponent::Sphere(float radius) {
+	return { std::shared_ptr<btCollisionShape>(new btSphereShape(radius)) };
+}
+
+ColliderComponent ColliderComponent::Capsule(float radius, float height) {
+	return { std::shared_ptr<btCollisionShape>(new btCapsuleShapeZ(radius, height)) };
+}
+
+ColliderComponent ColliderComponent::WithOffset(const glm::vec3& offset) const {
+	LOG_ASSERT(Shape != nullptr, "Cannot offset a collider without a shape!");
+	std::shared_ptr<OffsetShapeData> data = std::make_shared<OffsetShapeData>();
+	data->Child = Shape;
+	data->Shape = std::make_unique<btCompoundShape>(false, 1);
+	data->Shape->addChildShape(btTransform(btQuaternion::getIdentity(), btVector3(offset.x, offset.y, offset.z)), Shape.get());
+
+	btCollisionShape* shape = data->Shape.get();
+	return { std::shared_ptr<btCollisionShape>(std::move(data), shape) };
+}
+
+ColliderComponent ColliderComponent::TriangleMesh(const void* vertices, size_t stride, size_t positionOffset, size_t vertexCount, const uint32_t* indices, size_t indexCount) {
+	LOG_ASSERT(vertices != nullptr || vertexCount == 0, "Vertices cannot be null!");
+	std::shared_ptr<TriangleMeshData> data = std::make_shared<TriangleMeshData>();
+
+	// Pull the positions out of the vertices, so Bullet gets them tightly packed and we don't hold onto anything else
+	data->Positions.resize(vertexCount);
+	const uint8_t* vertex = static_cast<const uint8_t*>(vertices) + positionOffset;
+	for (size_t ix = 0; ix < vertexCount; ix++, vertex += stride) {
+		memcpy(&data->Positions[ix], vertex, sizeof(glm::vec3));
+	}
+
+	if (indices != nullptr) {
+		data->Indices.assign(indices, indices + indexCount - (indexCount % 3));
+	} else {
+		data->Indices.resize(vertexCount - (vertexCount % 3));
+		for (size_t ix = 0; ix < data->Indices.size(); ix++) {
+			data->Indices[ix] = static_cast<int>(ix);
+		}
+	}
+	if (data->Indices.empty()) {
+		LOG_WARN("Cannot create a triangle mesh collider without any triangles");
+		return { nullptr };
+	}
+
+	btIndexedMesh mesh;
+	mesh.m_numTriangles = static_cast<int>(data->Indices.size() / 3);
+	mesh.m_triangleIndexBase = reinterpret_cast<const unsigned char*>(data->Indices.data());
+	mesh.m_triangleIndexStride = 3 * sizeof(int);
+	mesh.m_numVertices = static_cast<int>(data->Positions.size());
+	mesh.m_vertexBase = reinterpret_cast<const unsigned char*>(data->Positions.data());
+	mesh.m_vertexStride = sizeof(glm::vec3);
+	mesh.m_indexType = PHY_INTEGER;
+	mesh.m_vertexType = PHY_FLOAT;
+
+	data->Mesh = std::make_unique<btTriangleIndexVertexArray>();
+	data->Mesh->addIndexedMesh(mesh, PHY_INTEGER);
+	// Builds a quantized BVH over the triangles up front, so collisions only test the triangles near a body
+	data->Shape = std::make_unique<btBvhTriangleMeshShape>(data->Mesh.get(), true);
+
+	btCollisionShape* shape = data->Shape.get();
+	return { std::shared_ptr<btCollisionShape>(std::move(data), shape) };
+}
\ No newline at end of file
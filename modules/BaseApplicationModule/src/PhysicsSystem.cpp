@@ -0,0 +1,210 @@
+#include "PhysicsSystem.h"
+
+#include <chrono>
+#include "Transform.h"
+#include "LoggingBase.h"
+
+void PhysicsSystem::_MotionState::getWorldTransform(btTransform& worldTrans) const {
+	const Transform& transform = _system->_scene.Registry().get<Transform>(_entity);
+	const glm::vec3& position = transform.GetLocalPosition();
+	const glm::quat& rotation = transform.GetLocalRotationQuat();
+	worldTrans.setOrigin(btVector3(position.x, position.y, position.z));
+	worldTrans.setRotation(btQuaternion(rotation.x, rotation.y, rotation.z, rotation.w));
+}
+
+void PhysicsSystem::_MotionState::setWorldTransform(const btTransform& worldTrans) {
+	// Bullet calls this while it's walking it's own bodies, so we just note the result and apply them all afterwards
+	const btVector3& origin = worldTrans.getOrigin();
+	const btQuaternion rotation = worldTrans.getRotation();
+	_system->_syncQueue.push_back({
+		_entity,
+		glm::vec3(origin.x(), origin.y(), origin.z()),
+		glm::quat(rotation.w(), rotation.x(), rotation.y(), rotation.z())
+	});
+}
+
+PhysicsSystem::PhysicsSystem(GameScene& scene) :
+	_scene(scene)
+{
+	RegisterComponentTypes();
+
+	_collisionConfig = std::make_unique<btDefaultCollisionConfiguration>();
+	_dispatcher = std::make_unique<btCollisionDispatcher>(_collisionConfig.get());
+	_broadphase = std::make_unique<btDbvtBroadphase>();
+	_solver = std::make_unique<btSequentialImpulseConstraintSolver>();
+	_world = std::make_unique<btDiscreteDynamicsWorld>(_dispatcher.get(), _broadphase.get(), _solver.get(), _collisionConfig.get());
+	// Our scenes are Z up
+	_world->setGravity(btVector3(0.0f, 0.0f, -9.81f));
+
+	// We find out about new objects as their components are added, so we only look at the ones that changed each step
+	entt::registry& registry = _scene.Registry();
+	registry.on_construct<RigidBodyComponent>().connect<&PhysicsSystem::_OnComponentAdded>(*this);
+	registry.on_construct<ColliderComponent>().connect<&PhysicsSystem::_OnComponentAdded>(*this);
+	registry.on_update<RigidBodyComponent>().connect<&PhysicsSystem::_OnComponentChanged>(*this);
+	registry.on_update<ColliderComponent>().connect<&PhysicsSystem::_OnComponentChanged>(*this);
+	registry.on_destroy<RigidBodyComponent>().connect<&PhysicsSystem::_OnComponentRemoved>(*this);
+	registry.on_destroy<ColliderComponent>().connect<&PhysicsSystem::_OnComponentRemoved>(*this);
+
+	// Anything that was already in the scene gets a body on the first step
+	auto view = registry.view<RigidBodyComponent, ColliderComponent>();
+	_pendingBodies.assign(view.begin(), view.end());
+}
+
+PhysicsSystem::~PhysicsSystem() {
+	entt::registry& registry = _scene.Registry();
+	registry.on_construct<RigidBodyComponent>().disconnect<&PhysicsSystem::_OnComponentAdded>(*this);
+	registry.on_construct<ColliderComponent>().disconnect<&PhysicsSystem::_OnComponentAdded>(*this);
+	registry.on_update<RigidBodyComponent>().disconnect<&PhysicsSystem::_OnComponentChanged>(*this);
+	registry.on_update<ColliderComponent>().disconnect<&PhysicsSystem::_OnComponentChanged>(*this);
+	registry.on_destroy<RigidBodyComponent>().disconnect<&PhysicsSystem::_OnComponentRemoved>(*this);
+	registry.on_destroy<ColliderComponent>().disconnect<&PhysicsSystem::_OnComponentRemoved>(*this);
+
+	// Take all our bodies out of the world before it goes away
+	for (auto& [entity, body] : _bodies) {
+		if (body.Body != nullptr) {
+			_world->removeRigidBody(body.Body.get());
+		}
+	}
+	_bodies.clear();
+}
+
+void PhysicsSystem::RegisterComponentTypes() {
+	GameScene::RegisterComponentType<RigidBodyComponent>();
+	GameScene::RegisterComponentType<ColliderComponent>(nullptr, &_ColliderSave, &_ColliderLoad);
+}
+
+void PhysicsSystem::SetGravity(const glm::vec3& value) {
+	_world->setGravity(btVector3(value.x, value.y, value.z));
+}
+
+glm::vec3 PhysicsSystem::GetGravity() const {
+	const btVector3 gravity = _world->getGravity();
+	return glm::vec3(gravity.x(), gravity.y(), gravity.z());
+}
+
+void PhysicsSystem::Step(float stepSize) {
+	using clock = std::chrono::high_resolution_clock;
+
+	_CreatePendingBodies();
+
+	// We do our own fixed stepping, so we let Bullet take exactly one step of the size we're given
+	auto start = clock::now();
+	_syncQueue.clear();
+	_world->stepSimulation(stepSize, 0);
+	auto end = clock::now();
+	_stepTime = std::chrono::duration<float, std::milli>(end - start).count();
+
+	// Only the bodies that were awake were queued, write them all to their transforms in one go
+	entt::registry& registry = _scene.Registry();
+	for (const SyncEntry& entry : _syncQueue) {
+		Transform& transform = registry.get<Transform>(entry.Entity);
+		transform.SetLocalPosition(entry.Position);
+		transform.SetLocalRotation(entry.Rotation);
+	}
+	_activeBodyCount = static_cast<uint32_t>(_syncQueue.size());
+	_syncTime = std::chrono::duration<float, std::milli>(clock::now() - end).count();
+}
+
+btRigidBody* PhysicsSystem::GetBody(entt::entity entity) const {
+	auto it = _bodies.find(entity);
+	return it != _bodies.end() ? it->second.Body.get() : nullptr;
+}
+
+void PhysicsSystem::Rebuild(entt::entity entity) {
+	_DestroyBody(entity);
+	_pendingBodies.push_back(entity);
+}
+
+uint32_t PhysicsSystem::GetBodyCount() const {
+	return static_cast<uint32_t>(_bodies.size());
+}
+
+void PhysicsSystem::_CreatePendingBodies() {
+	if (_pendingBodies.empty()) {
+		return;
+	}
+	entt::registry& registry = _scene.Registry();
+	_bodies.reserve(_bodies.size() + _pendingBodies.size());
+
+	for (entt::entity entity : _pendingBodies) {
+		// Objects can be queued more than once, or lose their components before we get to them
+		if (!registry.valid(entity) || _bodies.count(entity) > 0 || !registry.has<RigidBodyComponent, ColliderComponent, Transform>(entity)) {
+			continue;
+		}
+		const RigidBodyComponent& settings = registry.get<RigidBodyComponent>(entity);
+		const ColliderComponent& collider = registry.get<ColliderComponent>(entity);
+		if (collider.Shape == nullptr) {
+			LOG_WARN("Object {} has a collider without a shape, it will not be simulated", entt::to_integral(entity));
+			continue;
+		}
+		if (registry.get<Transform>(entity).GetHierarchyDepth() > 0) {
+			LOG_WARN("Object {} has a rigid body but also has a parent, rigid bodies are simulated in world space", entt::to_integral(entity));
+		}
+
+		float mass = settings.IsKinematic ? 0.0f : settings.Mass;
+		if (mass > 0.0f && collider.IsTriangleMesh()) {
+			LOG_WARN("Triangle mesh colliders can only be used on static or kinematic bodies, object {} will be static", entt::to_integral(entity));
+			mass = 0.0f;
+		}
+		btVector3 inertia(0.0f, 0.0f, 0.0f);
+		if (mass > 0.0f) {
+			collider.Shape->calculateLocalInertia(mass, inertia);
+		}
+
+		PhysicsBody& body = _bodies.try_emplace(entity, this, entity).first->second;
+		btRigidBody::btRigidBodyConstructionInfo info(mass, &body.MotionState, collider.Shape.get(), inertia);
+		info.m_friction = settings.Friction;
+		info.m_restitution = settings.Restitution;
+		info.m_linearDamping = settings.LinearDamping;
+		info.m_angularDamping = settings.AngularDamping;
+		body.Body = std::make_unique<btRigidBody>(info);
+		if (settings.IsKinematic) {
+			// Kinematic bodies read their transform every step, so they can't be allowed to fall asleep
+			body.Body->setCollisionFlags(body.Body->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
+			body.Body->setActivationState(DISABLE_DEACTIVATION);
+		}
+		_world->addRigidBody(body.Body.get());
+	}
+	_pendingBodies.clear();
+}
+
+void PhysicsSystem::_DestroyBody(entt::entity entity) {
+	auto it = _bodies.find(entity);
+	if (it != _bodies.end()) {
+		if (it->second.Body != nullptr) {
+			_world->removeRigidBody(it->second.Body.get());
+		}
+		_bodies.erase(it);
+	}
+}
+
+void PhysicsSystem::_OnComponentAdded(entt::registry& registry, entt::entity entity) {
+	_pendingBodies.push_back(entity);
+}
+
+void PhysicsSystem::_OnComponentChanged(entt::registry& registry, entt::entity entity) {
+	Rebuild(entity);
+}
+
+void PhysicsSystem::_OnComponentRemoved(entt::registry& registry, entt::entity entity) {
+	_DestroyBody(entity);
+}
+
+void PhysicsSystem::_ColliderSave(cereal::BinaryOutputArchive& archive, const entt::registry& registry, const std::vector<entt::entity>& entities, const SceneEntityMap& map) {
+	for (entt::entity entity : entities) {
+		const ColliderComponent& collider = registry.get<ColliderComponent>(entity);
+		const AssetTable::AssetId id = GameScene::Assets().GetId(collider.Shape);
+		if (id == AssetTable::NullId && collider.Shape != nullptr) {
+			LOG_WARN("Collider shape for object {} is not in the asset table, it will be saved without a shape", entt::to_integral(entity));
+		}
+		archive(id);
+	}
+}
+
+void PhysicsSystem::_ColliderLoad(cereal::BinaryInputArchive& archive, entt::registry& registry, const std::vector<entt::entity>& entities, const SceneEntityMap& map) {
+	AssetTable::AssetId id;
+	for (entt::entity entity : entities) {
+		archive(id);
+		registry.emplace<ColliderComponent>(entity).Shape = GameScene::Assets().Get<btCollisionShape>(id);
+	}
+}
\ No newline at end of file
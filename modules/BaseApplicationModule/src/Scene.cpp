@@ -1,17 +1,71 @@
 #include "Scene.h"
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <cereal/types/string.hpp>
+#include <gzip/compress.hpp>
+#include <gzip/decompress.hpp>
+
 #include "Transform.h"
 #include "GameObjectTag.h"
 #include "LoggingBase.h"
 
 entt::registry GameScene::_prefabRegistry;
-std::unordered_map<entt::id_type, StampFunction> GameScene::_stampFunctions;
+AssetTable GameScene::_assets;
+std::unordered_map<entt::id_type, GameScene::ComponentTypeInfo> GameScene::_componentTypes;
+
+/// <summary>
+/// Written at the start of binary scene files, followed by the scene data
+/// </summary>
+struct SceneFileHeader
+{
+	char     Magic[4];
+	uint32_t Version;
+	uint32_t Flags;
+	uint32_t Reserved;
+	// The size of the scene data once it has been decompressed
+	uint64_t DataSize;
+};
+static const char     SCENE_FILE_MAGIC[4] = { 'S', 'C', 'N', 'B' };
+static const uint32_t SCENE_FILE_VERSION = 1;
+static const uint32_t SCENE_FLAG_COMPRESSED = 1 << 0;
+
+/// <summary>
+/// Lets us read an archive straight out of the loaded file, instead of copying it into a stringstream
+/// </summary>
+class MemoryStreamBuffer : public std::streambuf
+{
+public:
+	MemoryStreamBuffer(char* data, size_t size) {
+		setg(data, data, data + size);
+	}
+};
+
+/// <summary>
+/// The parts of a transform that are saved, the matrices are re-calculated after loading
+/// </summary>
+struct SavedTransform
+{
+	glm::quat Rotation;
+	glm::vec3 RotationEulerDeg;
+	glm::vec3 Position;
+	glm::vec3 Scale;
+	uint32_t  Parent;
+	int32_t   HierarchyDepth;
+};
 
 GameScene::GameScene(const std::string& name) {
 	Name = name;
 
-	RegisterComponentType<Transform>();
+	RegisterComponentType<Transform>(&_TransformStamp, &_TransformSave, &_TransformLoad, &_TransformBulkStamp);
 	RegisterComponentType<GameObjectTag>();
+	RegisterComponentType<SpatialProxy>(&_SpatialProxyStamp, &_SpatialProxySave, &_SpatialProxyLoad, &_SpatialProxyBulkStamp);
+
+	_registry.on_destroy<SpatialProxy>().connect<&GameScene::_OnSpatialProxyDestroyed>(*this);
+	_registry.on_construct<GameObjectTag>().connect<&GameScene::_OnTagConstructed>(*this);
+	_registry.on_destroy<GameObjectTag>().connect<&GameScene::_OnTagDestroyed>(*this);
 }
 
 entt::handle GameScene::CreateEntity(const std::string& name) {
@@ -30,25 +84,421 @@ entt::handle GameScene::CreateEntity(entt::entity prefab, const std::string& nam
 	return entt::handle(_registry, instance);
 }
 
+std::vector<entt::entity> GameScene::CreateEntities(entt::entity prefab, size_t count, entt::entity parent) {
+	return _CreateEntities(prefab, count, nullptr, parent);
+}
+
+std::vector<entt::entity> GameScene::CreateEntities(entt::entity prefab, const std::vector<glm::vec3>& positions, entt::entity parent) {
+	return _CreateEntities(prefab, positions.size(), positions.data(), parent);
+}
+
+std::vector<entt::entity> GameScene::_CreateEntities(entt::entity prefab, size_t count, const glm::vec3* positions, entt::entity parent) {
+	LOG_ASSERT(_prefabRegistry.valid(prefab), "Entity is not a valid prefab! You may need to call CreatePrefab(entity_id) first!");
+	LOG_ASSERT(parent == entt::null || _registry.has<Transform>(parent), "Parent entity must be in this scene and have a transform component");
+
+	std::vector<entt::entity> instances = StampEntities(_prefabRegistry, prefab, _registry, count);
+	if ((positions == nullptr && parent == entt::null) || !_prefabRegistry.has<Transform>(prefab)) {
+		return instances;
+	}
+
+	// We set the parent directly instead of with SetParent, which would walk and re-sort the whole scene for each copy
+	const int depth = parent != entt::null ? _registry.get<Transform>(parent)._hierarchyDepth + 1 : 0;
+	for (size_t ix = 0; ix < count; ix++) {
+		Transform& transform = _registry.get<Transform>(instances[ix]);
+		if (positions != nullptr) {
+			transform._position += positions[ix];
+			transform._isLocalDirty = true;
+		}
+		transform._parent = parent;
+		transform._hierarchyDepth = depth;
+	}
+	if (parent != entt::null) {
+		_SortTransformsIfNeeded();
+	}
+	return instances;
+}
+
+entt::entity GameScene::CreatePrefab(entt::entity entity) const {
+	LOG_ASSERT(_registry.valid(entity), "Entity is not in this scene!");
+	return StampEntity(_registry, entity, _prefabRegistry).entity();
+}
+
 entt::handle GameScene::FindFirst(const std::string& name)
 {
-	entt::entity result = entt::null;
-	uint32_t hash = entt::hashed_string::value(name.c_str());
-	const auto view = _registry.view<GameObjectTag>();
-	
-	for(const entt::entity& entity : view) {
-		const GameObjectTag& tag = _registry.get<GameObjectTag>(entity);
-		if (tag.HashedName == hash && tag.Name == name) {
-			return entt::handle(_registry, entity);
-		}
+	auto it = _nameIndex.find(entt::hashed_string::value(name.c_str()));
+	if (it != _nameIndex.end()) {
+		return entt::handle(_registry, it->second.front());
 	}
 	return entt::handle(_registry, entt::null);
 }
 
+std::vector<entt::entity> GameScene::FindAll(const std::string& name) const {
+	auto it = _nameIndex.find(entt::hashed_string::value(name.c_str()));
+	return it != _nameIndex.end() ? it->second : std::vector<entt::entity>();
+}
+
+std::vector<entt::entity> GameScene::FindWithTags(uint32_t tagMask, bool matchAll) const {
+	std::vector<entt::entity> result;
+	_registry.view<const GameObjectTag>().each([&](entt::entity entity, const GameObjectTag& tag) {
+		const uint32_t matched = tag.Tags & tagMask;
+		if (matchAll ? matched == tagMask : matched != 0) {
+			result.push_back(entity);
+		}
+	});
+	return result;
+}
+
+std::vector<entt::entity> GameScene::FindInLayers(uint32_t layerMask) const {
+	std::vector<entt::entity> result;
+	_registry.view<const GameObjectTag>().each([&](entt::entity entity, const GameObjectTag& tag) {
+		if (GameObjectTag::LayerBit(tag.Layer) & layerMask) {
+			result.push_back(entity);
+		}
+	});
+	return result;
+}
+
+void GameScene::SetName(entt::entity entity, const std::string& name) {
+	GameObjectTag& tag = _registry.get<GameObjectTag>(entity);
+	_RemoveFromNameIndex(tag);
+	tag._hashedName = NameTable::Intern(name);
+	_AddToNameIndex(entity, tag);
+}
+
 entt::handle GameScene::StampEntity(const entt::registry& from, entt::entity src, entt::registry& to) {
 	entt::entity dst = to.create();
 	from.visit(src, [&from, &to, src, dst](const auto type_id) {
-		_stampFunctions[type_id](from, src, to, dst);
+		_componentTypes[type_id].Stamp(from, src, to, dst);
 	});
 	return entt::handle(to, dst);
 }
+
+std::vector<entt::entity> GameScene::StampEntities(const entt::registry& from, entt::entity src, entt::registry& to, size_t count) {
+	std::vector<entt::entity> dsts(count);
+	to.reserve(to.size() + count);
+	to.create(dsts.begin(), dsts.end());
+	// One lookup per component type, instead of one per component per copy
+	from.visit(src, [&from, &to, src, &dsts](const auto type_id) {
+		auto it = _componentTypes.find(type_id);
+		LOG_ASSERT(it != _componentTypes.end(), "Prefab has a component that was not registered with RegisterComponentType!");
+		const ComponentTypeInfo& info = it->second;
+		if (info.BulkStamp != nullptr) {
+			info.BulkStamp(from, src, to, dsts);
+		} else {
+			for (entt::entity dst : dsts) {
+				info.Stamp(from, src, to, dst);
+			}
+		}
+	});
+	return dsts;
+}
+
+bool GameScene::SaveBinary(const std::string& path, bool compress) const {
+	// Number the entities in the order they were created, so that they are re-created in the same order
+	SceneEntityMap map;
+	map._entities.reserve(_registry.alive());
+	_registry.each([&](entt::entity entity) {
+		map._entities.push_back(entity);
+	});
+	std::reverse(map._entities.begin(), map._entities.end());
+	for (uint32_t ix = 0; ix < map._entities.size(); ix++) {
+		const size_t slot = entt::to_integral(map._entities[ix]) & entt::entt_traits<entt::entity>::entity_mask;
+		if (slot >= map._indices.size()) {
+			map._indices.resize(slot + 1, SceneEntityMap::NullIndex);
+		}
+		map._indices[slot] = ix;
+	}
+
+	// Collect the entities for each type of component that we can save
+	struct ComponentBlock {
+		entt::id_type             Type;
+		const ComponentTypeInfo*  Info;
+		std::vector<entt::entity> Entities;
+	};
+	std::vector<ComponentBlock> blocks;
+	for (const auto& [type, info] : _componentTypes) {
+		ComponentBlock block = { type, &info };
+		info.Collect(_registry, block.Entities);
+		if (block.Entities.empty()) {
+			continue;
+		}
+		if (info.Save == nullptr) {
+			LOG_WARN("Skipping {} {} components while saving \"{}\", the type cannot be saved", block.Entities.size(), info.Name, path);
+			continue;
+		}
+		blocks.push_back(std::move(block));
+	}
+
+	// The type table comes first, so that loading can make sure it knows all the types before creating anything
+	std::ostringstream stream(std::ios::binary);
+	{
+		cereal::BinaryOutputArchive archive(stream);
+		archive(static_cast<uint32_t>(map._entities.size()), static_cast<uint32_t>(blocks.size()));
+		for (const ComponentBlock& block : blocks) {
+			archive(block.Type, block.Info->Name, static_cast<uint32_t>(block.Entities.size()));
+		}
+		std::vector<uint32_t> indices;
+		for (const ComponentBlock& block : blocks) {
+			indices.resize(block.Entities.size());
+			for (size_t ix = 0; ix < block.Entities.size(); ix++) {
+				indices[ix] = map.IndexOf(block.Entities[ix]);
+			}
+			archive(cereal::binary_data(indices.data(), indices.size() * sizeof(uint32_t)));
+			block.Info->Save(archive, _registry, block.Entities, map);
+		}
+	}
+	std::string data = stream.str();
+
+	SceneFileHeader header = { };
+	memcpy(header.Magic, SCENE_FILE_MAGIC, sizeof(header.Magic));
+	header.Version = SCENE_FILE_VERSION;
+	header.DataSize = data.size();
+	if (compress) {
+		// Favor speed here, most of the size savings come from the first levels of compression anyways
+		data = gzip::compress(data.data(), data.size(), Z_BEST_SPEED);
+		header.Flags |= SCENE_FLAG_COMPRESSED;
+	}
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file) {
+		LOG_ERROR("Failed to open \"{}\" for writing", path);
+		return false;
+	}
+	file.write(reinterpret_cast<const char*>(&header), sizeof(SceneFileHeader));
+	file.write(data.data(), data.size());
+	return file.good();
+}
+
+bool GameScene::LoadBinary(const std::string& path) {
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file) {
+		LOG_ERROR("Failed to open scene file \"{}\"", path);
+		return false;
+	}
+	const size_t fileSize = file.tellg();
+	file.seekg(0);
+
+	SceneFileHeader header = { };
+	if (fileSize < sizeof(SceneFileHeader) || !file.read(reinterpret_cast<char*>(&header), sizeof(SceneFileHeader)) ||
+		memcmp(header.Magic, SCENE_FILE_MAGIC, sizeof(header.Magic)) != 0) {
+		LOG_ERROR("\"{}\" is not a scene file", path);
+		return false;
+	}
+	if (header.Version != SCENE_FILE_VERSION) {
+		LOG_ERROR("Scene file \"{}\" has version {}, expected {}", path, header.Version, SCENE_FILE_VERSION);
+		return false;
+	}
+	std::string data(fileSize - sizeof(SceneFileHeader), '\0');
+	file.read(&data[0], data.size());
+	if (header.Flags & SCENE_FLAG_COMPRESSED) {
+		try {
+			data = gzip::decompress(data.data(), data.size());
+		}
+		catch (const std::exception& e) {
+			LOG_ERROR("Failed to decompress scene file \"{}\": {}", path, e.what());
+			return false;
+		}
+	}
+	if (data.size() != header.DataSize) {
+		LOG_ERROR("Scene file \"{}\" is truncated", path);
+		return false;
+	}
+
+	MemoryStreamBuffer buffer(&data[0], data.size());
+	std::istream stream(&buffer);
+	SceneEntityMap map;
+	try {
+		cereal::BinaryInputArchive archive(stream);
+
+		struct ComponentBlock {
+			entt::id_type            Type;
+			std::string              Name;
+			uint32_t                 Count;
+			const ComponentTypeInfo* Info;
+		};
+		uint32_t entityCount = 0, blockCount = 0;
+		archive(entityCount, blockCount);
+		std::vector<ComponentBlock> blocks(blockCount);
+		for (ComponentBlock& block : blocks) {
+			archive(block.Type, block.Name, block.Count);
+			auto it = _componentTypes.find(block.Type);
+			if (it == _componentTypes.end() || it->second.Load == nullptr) {
+				LOG_ERROR("Scene file \"{}\" contains {} components, which are not registered for loading", path, block.Name);
+				return false;
+			}
+			block.Info = &it->second;
+		}
+
+		// Create all the entities up front, so that components can refer to entities that are loaded later on
+		map._entities.resize(entityCount);
+		_registry.reserve(_registry.size() + entityCount);
+		_registry.create(map._entities.begin(), map._entities.end());
+
+		std::vector<uint32_t> indices;
+		std::vector<entt::entity> entities;
+		for (const ComponentBlock& block : blocks) {
+			indices.resize(block.Count);
+			entities.resize(block.Count);
+			archive(cereal::binary_data(indices.data(), indices.size() * sizeof(uint32_t)));
+			for (size_t ix = 0; ix < indices.size(); ix++) {
+				if (indices[ix] >= entityCount) {
+					LOG_ERROR("Scene file \"{}\" contains an invalid entity index", path);
+					_registry.destroy(map._entities.begin(), map._entities.end());
+					return false;
+				}
+				entities[ix] = map._entities[indices[ix]];
+			}
+			block.Info->Reserve(_registry, block.Count);
+			block.Info->Load(archive, _registry, entities, map);
+		}
+	}
+	catch (const cereal::Exception& e) {
+		LOG_ERROR("Failed to read scene file \"{}\": {}", path, e.what());
+		// Don't leave a half loaded scene behind
+		_registry.destroy(map._entities.begin(), map._entities.end());
+		return false;
+	}
+
+	// We sort once here instead of every time a parent is set
+	_SortTransformsIfNeeded();
+	return true;
+}
+
+uint32_t GameScene::UpdateSpatialIndex() {
+	uint32_t moved = 0;
+	_registry.view<Transform, SpatialProxy>().each([&](entt::entity entity, const Transform& transform, SpatialProxy& proxy) {
+		const AxisAlignedBox worldBounds = proxy.LocalBounds.Transformed(transform.WorldTransform());
+		if (proxy.ProxyId == SpatialIndex::NullNode) {
+			proxy.ProxyId = _spatialIndex.CreateProxy(worldBounds, entity);
+			moved++;
+		} else if (_spatialIndex.MoveProxy(proxy.ProxyId, worldBounds)) {
+			moved++;
+		}
+	});
+	return moved;
+}
+
+void GameScene::_SortTransformsIfNeeded() {
+	const auto compareDepth = [](const Transform& l, const Transform& r) {
+		return l.GetHierarchyDepth() < r.GetHierarchyDepth();
+	};
+	// Views iterate their storage back to front, so the raw array is in the opposite order to what we sort for
+	const auto transforms = _registry.view<Transform>();
+	const auto begin = std::make_reverse_iterator(transforms.raw() + transforms.size());
+	const auto end = std::make_reverse_iterator(transforms.raw());
+	if (!std::is_sorted(begin, end, compareDepth)) {
+		_registry.sort<Transform>(compareDepth);
+	}
+}
+
+void GameScene::_OnSpatialProxyDestroyed(entt::registry& registry, entt::entity entity) {
+	const SpatialProxy& proxy = registry.get<SpatialProxy>(entity);
+	if (proxy.ProxyId != SpatialIndex::NullNode) {
+		_spatialIndex.DestroyProxy(proxy.ProxyId);
+	}
+}
+
+void GameScene::_OnTagConstructed(entt::registry& registry, entt::entity entity) {
+	_AddToNameIndex(entity, registry.get<GameObjectTag>(entity));
+}
+
+void GameScene::_OnTagDestroyed(entt::registry& registry, entt::entity entity) {
+	_RemoveFromNameIndex(registry.get<GameObjectTag>(entity));
+}
+
+void GameScene::_AddToNameIndex(entt::entity entity, GameObjectTag& tag) {
+	std::vector<entt::entity>& entities = _nameIndex[tag._hashedName];
+	tag._nameIndexSlot = static_cast<uint32_t>(entities.size());
+	entities.push_back(entity);
+}
+
+void GameScene::_RemoveFromNameIndex(const GameObjectTag& tag) {
+	// Swap the last object with the same name into our slot, so removing is constant time even with lots of duplicates
+	auto it = _nameIndex.find(tag._hashedName);
+	LOG_ASSERT(it != _nameIndex.end() && tag._nameIndexSlot < it->second.size(), "Object is missing from the name index!");
+	std::vector<entt::entity>& entities = it->second;
+	const entt::entity moved = entities.back();
+	entities[tag._nameIndexSlot] = moved;
+	_registry.get<GameObjectTag>(moved)._nameIndexSlot = tag._nameIndexSlot;
+	entities.pop_back();
+	if (entities.empty()) {
+		_nameIndex.erase(it);
+	}
+}
+
+void GameScene::_SpatialProxyStamp(const entt::registry& from, const entt::entity src, entt::registry& to, const entt::entity dst) {
+	// The proxy ID belongs to the source scene's index, so the copy needs to be inserted into it's new scene separately
+	to.emplace_or_replace<SpatialProxy>(dst, from.get<SpatialProxy>(src).LocalBounds);
+}
+
+void GameScene::_SpatialProxyBulkStamp(const entt::registry& from, const entt::entity src, entt::registry& to, const std::vector<entt::entity>& dsts) {
+	to.reserve<SpatialProxy>(to.size<SpatialProxy>() + dsts.size());
+	to.insert<SpatialProxy>(dsts.begin(), dsts.end(), SpatialProxy{ from.get<SpatialProxy>(src).LocalBounds });
+}
+
+void GameScene::_TransformStamp(const entt::registry& from, const entt::entity src, entt::registry& to, const entt::entity dst) {
+	// The copy needs to point at it's new entity, and the source's parent is in the wrong registry, so the copy starts at the root
+	Transform& transform = to.emplace_or_replace<Transform>(dst, from.get<Transform>(src));
+	transform._gameObject = entt::handle(to, dst);
+	transform._parent = entt::null;
+	transform._hierarchyDepth = 0;
+}
+
+void GameScene::_TransformBulkStamp(const entt::registry& from, const entt::entity src, entt::registry& to, const std::vector<entt::entity>& dsts) {
+	const Transform& source = from.get<Transform>(src);
+	to.reserve<Transform>(to.size<Transform>() + dsts.size());
+	for (entt::entity dst : dsts) {
+		Transform& transform = to.emplace<Transform>(dst, source);
+		transform._gameObject = entt::handle(to, dst);
+		transform._parent = entt::null;
+		transform._hierarchyDepth = 0;
+	}
+}
+
+void GameScene::_SpatialProxySave(cereal::BinaryOutputArchive& archive, const entt::registry& registry, const std::vector<entt::entity>& entities, const SceneEntityMap& map) {
+	// Only the local bounds are saved, the proxies get inserted into the index on the next update
+	std::vector<AxisAlignedBox> bounds(entities.size());
+	for (size_t ix = 0; ix < entities.size(); ix++) {
+		bounds[ix] = registry.get<SpatialProxy>(entities[ix]).LocalBounds;
+	}
+	archive(cereal::binary_data(bounds.data(), bounds.size() * sizeof(AxisAlignedBox)));
+}
+
+void GameScene::_SpatialProxyLoad(cereal::BinaryInputArchive& archive, entt::registry& registry, const std::vector<entt::entity>& entities, const SceneEntityMap& map) {
+	std::vector<AxisAlignedBox> bounds(entities.size());
+	archive(cereal::binary_data(bounds.data(), bounds.size() * sizeof(AxisAlignedBox)));
+	for (size_t ix = 0; ix < entities.size(); ix++) {
+		registry.emplace<SpatialProxy>(entities[ix], bounds[ix]);
+	}
+}
+
+void GameScene::_TransformSave(cereal::BinaryOutputArchive& archive, const entt::registry& registry, const std::vector<entt::entity>& entities, const SceneEntityMap& map) {
+	std::vector<SavedTransform> transforms(entities.size());
+	for (size_t ix = 0; ix < entities.size(); ix++) {
+		const Transform& transform = registry.get<Transform>(entities[ix]);
+		SavedTransform& saved = transforms[ix];
+		saved.Rotation = transform._rotation;
+		saved.RotationEulerDeg = transform._rotationEulerDeg;
+		saved.Position = transform._position;
+		saved.Scale = transform._scale;
+		saved.Parent = map.IndexOf(transform._parent);
+		saved.HierarchyDepth = transform._hierarchyDepth;
+	}
+	archive(cereal::binary_data(transforms.data(), transforms.size() * sizeof(SavedTransform)));
+}
+
+void GameScene::_TransformLoad(cereal::BinaryInputArchive& archive, entt::registry& registry, const std::vector<entt::entity>& entities, const SceneEntityMap& map) {
+	std::vector<SavedTransform> transforms(entities.size());
+	archive(cereal::binary_data(transforms.data(), transforms.size() * sizeof(SavedTransform)));
+	for (size_t ix = 0; ix < entities.size(); ix++) {
+		const SavedTransform& saved = transforms[ix];
+		// We set the parent directly instead of with SetParent, which would walk and re-sort the whole scene for each object
+		Transform& transform = registry.emplace<Transform>(entities[ix], entt::handle(registry, entities[ix]));
+		transform._rotation = saved.Rotation;
+		transform._rotationEulerDeg = saved.RotationEulerDeg;
+		transform._position = saved.Position;
+		transform._scale = saved.Scale;
+		transform._parent = map.EntityAt(saved.Parent);
+		transform._hierarchyDepth = saved.HierarchyDepth;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,568 @@
+#include "SpatialIndex.h"
+
+#include <algorithm>
+#include "LoggingBase.h"
+
+#pragma region Helpers
+
+inline bool SphereOverlapsBox(const glm::vec3& center, float radius, const AxisAlignedBox& box) {
+	const glm::vec3 closest = glm::clamp(center, box.Min, box.Max);
+	const glm::vec3 offset = closest - center;
+	return glm::dot(offset, offset) <= radius * radius;
+}
+
+// Slab test, outputs the distance along the ray where it enters the box
+inline bool RayIntersectsBox(const glm::vec3& origin, const glm::vec3& invDir, float maxDistance, const AxisAlignedBox& box, float& enter) {
+	const glm::vec3 t1 = (box.Min - origin) * invDir;
+	const glm::vec3 t2 = (box.Max - origin) * invDir;
+	const glm::vec3 tMin = glm::min(t1, t2);
+	const glm::vec3 tMax = glm::max(t1, t2);
+	enter = glm::max(glm::max(tMin.x, tMin.y), glm::max(tMin.z, 0.0f));
+	const float exit = glm::min(glm::min(tMax.x, tMax.y), glm::min(tMax.z, maxDistance));
+	return enter <= exit;
+}
+
+inline glm::vec3 SafeInverse(const glm::vec3& dir) {
+	// Avoid 0 * inf = NaN in the slab test by nudging zero components
+	return glm::vec3(
+		1.0f / (dir.x != 0.0f ? dir.x : 1e-20f),
+		1.0f / (dir.y != 0.0f ? dir.y : 1e-20f),
+		1.0f / (dir.z != 0.0f ? dir.z : 1e-20f)
+	);
+}
+
+#pragma endregion
+
+SpatialIndex::SpatialIndex(float margin) :
+	_nodes(std::vector<Node>()),
+	_root(NullNode),
+	_freeList(NullNode),
+	_proxyCount(0),
+	_margin(margin),
+	_stack(std::vector<int32_t>())
+{ }
+
+#pragma region Tree Management
+
+int32_t SpatialIndex::_AllocateNode() {
+	int32_t result;
+	if (_freeList == NullNode) {
+		result = static_cast<int32_t>(_nodes.size());
+		_nodes.emplace_back();
+	} else {
+		result = _freeList;
+		_freeList = _nodes[result].Parent;
+	}
+	Node& node = _nodes[result];
+	node.Bounds = AxisAlignedBox();
+	node.Entity = entt::null;
+	node.Parent = NullNode;
+	node.Child1 = NullNode;
+	node.Child2 = NullNode;
+	node.Height = 0;
+	return result;
+}
+
+void SpatialIndex::_FreeNode(int32_t node) {
+	_nodes[node].Parent = _freeList;
+	_nodes[node].Height = -1;
+	_freeList = node;
+}
+
+int32_t SpatialIndex::CreateProxy(const AxisAlignedBox& bounds, entt::entity entity) {
+	const int32_t result = _AllocateNode();
+	_nodes[result].Bounds = AxisAlignedBox(bounds.Min - glm::vec3(_margin), bounds.Max + glm::vec3(_margin));
+	_nodes[result].Entity = entity;
+	_InsertLeaf(result);
+	_proxyCount++;
+	return result;
+}
+
+void SpatialIndex::DestroyProxy(int32_t proxyId) {
+	LOG_ASSERT(proxyId >= 0 && proxyId < (int32_t)_nodes.size() && _nodes[proxyId].IsLeaf() && _nodes[proxyId].Height == 0, "Invalid proxy ID {}", proxyId);
+	_RemoveLeaf(proxyId);
+	_FreeNode(proxyId);
+	_proxyCount--;
+}
+
+bool SpatialIndex::MoveProxy(int32_t proxyId, const AxisAlignedBox& bounds) {
+	LOG_ASSERT(proxyId >= 0 && proxyId < (int32_t)_nodes.size() && _nodes[proxyId].IsLeaf() && _nodes[proxyId].Height == 0, "Invalid proxy ID {}", proxyId);
+	const AxisAlignedBox& fat = _nodes[proxyId].Bounds;
+	// If the object is still inside it's fat bounds, and the fat bounds have not become much too large, we can skip the update
+	if (fat.Contains(bounds)) {
+		const AxisAlignedBox loose = AxisAlignedBox(bounds.Min - glm::vec3(_margin * 4.0f), bounds.Max + glm::vec3(_margin * 4.0f));
+		if (loose.Contains(fat)) {
+			return false;
+		}
+	}
+
+	_RemoveLeaf(proxyId);
+	_nodes[proxyId].Bounds = AxisAlignedBox(bounds.Min - glm::vec3(_margin), bounds.Max + glm::vec3(_margin));
+	_InsertLeaf(proxyId);
+	return true;
+}
+
+void SpatialIndex::_InsertLeaf(int32_t leaf) {
+	if (_root == NullNode) {
+		_root = leaf;
+		_nodes[leaf].Parent = NullNode;
+		return;
+	}
+
+	// Walk down the tree to find the best sibling for the new leaf, using the surface area heuristic
+	const AxisAlignedBox leafBounds = _nodes[leaf].Bounds;
+	int32_t index = _root;
+	while (!_nodes[index].IsLeaf()) {
+		const Node& node = _nodes[index];
+		const float area = node.Bounds.GetSurfaceArea();
+		const float combinedArea = AxisAlignedBox::Union(node.Bounds, leafBounds).GetSurfaceArea();
+
+		// Cost of creating a new parent for this node and the new leaf
+		const float cost = 2.0f * combinedArea;
+		// Minimum cost of pushing the leaf further down the tree
+		const float inheritanceCost = 2.0f * (combinedArea - area);
+
+		float childCost[2];
+		const int32_t children[2] = { node.Child1, node.Child2 };
+		for (int ix = 0; ix < 2; ix++) {
+			const Node& child = _nodes[children[ix]];
+			const float unionArea = AxisAlignedBox::Union(child.Bounds, leafBounds).GetSurfaceArea();
+			childCost[ix] = (child.IsLeaf() ? unionArea : unionArea - child.Bounds.GetSurfaceArea()) + inheritanceCost;
+		}
+
+		if (cost < childCost[0] && cost < childCost[1]) {
+			break;
+		}
+		index = childCost[0] < childCost[1] ? children[0] : children[1];
+	}
+	const int32_t sibling = index;
+
+	// Create a new parent for the sibling and the leaf (note that this may re-allocate the node list)
+	const int32_t oldParent = _nodes[sibling].Parent;
+	const int32_t newParent = _AllocateNode();
+	_nodes[newParent].Parent = oldParent;
+	_nodes[newParent].Bounds = AxisAlignedBox::Union(leafBounds, _nodes[sibling].Bounds);
+	_nodes[newParent].Height = _nodes[sibling].Height + 1;
+	_nodes[newParent].Child1 = sibling;
+	_nodes[newParent].Child2 = leaf;
+	_nodes[sibling].Parent = newParent;
+	_nodes[leaf].Parent = newParent;
+
+	if (oldParent != NullNode) {
+		if (_nodes[oldParent].Child1 == sibling) {
+			_nodes[oldParent].Child1 = newParent;
+		} else {
+			_nodes[oldParent].Child2 = newParent;
+		}
+	} else {
+		_root = newParent;
+	}
+
+	// Walk back up the tree, fixing heights and bounds
+	index = _nodes[leaf].Parent;
+	while (index != NullNode) {
+		index = _Balance(index);
+		Node& node = _nodes[index];
+		node.Height = 1 + glm::max(_nodes[node.Child1].Height, _nodes[node.Child2].Height);
+		node.Bounds = AxisAlignedBox::Union(_nodes[node.Child1].Bounds, _nodes[node.Child2].Bounds);
+		index = node.Parent;
+	}
+}
+
+void SpatialIndex::_RemoveLeaf(int32_t leaf) {
+	if (leaf == _root) {
+		_root = NullNode;
+		return;
+	}
+
+	const int32_t parent = _nodes[leaf].Parent;
+	const int32_t grandParent = _nodes[parent].Parent;
+	const int32_t sibling = _nodes[parent].Child1 == leaf ? _nodes[parent].Child2 : _nodes[parent].Child1;
+
+	if (grandParent != NullNode) {
+		// Replace the parent with the sibling, and discard the parent
+		if (_nodes[grandParent].Child1 == parent) {
+			_nodes[grandParent].Child1 = sibling;
+		} else {
+			_nodes[grandParent].Child2 = sibling;
+		}
+		_nodes[sibling].Parent = grandParent;
+		_FreeNode(parent);
+
+		int32_t index = grandParent;
+		while (index != NullNode) {
+			index = _Balance(index);
+			Node& node = _nodes[index];
+			node.Height = 1 + glm::max(_nodes[node.Child1].Height, _nodes[node.Child2].Height);
+			node.Bounds = AxisAlignedBox::Union(_nodes[node.Child1].Bounds, _nodes[node.Child2].Bounds);
+			index = node.Parent;
+		}
+	} else {
+		_root = sibling;
+		_nodes[sibling].Parent = NullNode;
+		_FreeNode(parent);
+	}
+}
+
+int32_t SpatialIndex::_Balance(int32_t iA) {
+	Node* A = &_nodes[iA];
+	if (A->IsLeaf() || A->Height < 2) {
+		return iA;
+	}
+
+	const int32_t iB = A->Child1;
+	const int32_t iC = A->Child2;
+	Node* B = &_nodes[iB];
+	Node* C = &_nodes[iC];
+	const int32_t balance = C->Height - B->Height;
+
+	// Rotate C up
+	if (balance > 1) {
+		const int32_t iF = C->Child1;
+		const int32_t iG = C->Child2;
+		Node* F = &_nodes[iF];
+		Node* G = &_nodes[iG];
+
+		C->Child1 = iA;
+		C->Parent = A->Parent;
+		A->Parent = iC;
+		if (C->Parent != NullNode) {
+			if (_nodes[C->Parent].Child1 == iA) {
+				_nodes[C->Parent].Child1 = iC;
+			} else {
+				_nodes[C->Parent].Child2 = iC;
+			}
+		} else {
+			_root = iC;
+		}
+
+		if (F->Height > G->Height) {
+			C->Child2 = iF;
+			A->Child2 = iG;
+			G->Parent = iA;
+			A->Bounds = AxisAlignedBox::Union(B->Bounds, G->Bounds);
+			C->Bounds = AxisAlignedBox::Union(A->Bounds, F->Bounds);
+			A->Height = 1 + glm::max(B->Height, G->Height);
+			C->Height = 1 + glm::max(A->Height, F->Height);
+		} else {
+			C->Child2 = iG;
+			A->Child2 = iF;
+			F->Parent = iA;
+			A->Bounds = AxisAlignedBox::Union(B->Bounds, F->Bounds);
+			C->Bounds = AxisAlignedBox::Union(A->Bounds, G->Bounds);
+			A->Height = 1 + glm::max(B->Height, F->Height);
+			C->Height = 1 + glm::max(A->Height, G->Height);
+		}
+		return iC;
+	}
+
+	// Rotate B up
+	if (balance < -1) {
+		const int32_t iD = B->Child1;
+		const int32_t iE = B->Child2;
+		Node* D = &_nodes[iD];
+		Node* E = &_nodes[iE];
+
+		B->Child1 = iA;
+		B->Parent = A->Parent;
+		A->Parent = iB;
+		if (B->Parent != NullNode) {
+			if (_nodes[B->Parent].Child1 == iA) {
+				_nodes[B->Parent].Child1 = iB;
+			} else {
+				_nodes[B->Parent].Child2 = iB;
+			}
+		} else {
+			_root = iB;
+		}
+
+		if (D->Height > E->Height) {
+			B->Child2 = iD;
+			A->Child1 = iE;
+			E->Parent = iA;
+			A->Bounds = AxisAlignedBox::Union(C->Bounds, E->Bounds);
+			B->Bounds = AxisAlignedBox::Union(A->Bounds, D->Bounds);
+			A->Height = 1 + glm::max(C->Height, E->Height);
+			B->Height = 1 + glm::max(A->Height, D->Height);
+		} else {
+			B->Child2 = iE;
+			A->Child1 = iD;
+			D->Parent = iA;
+			A->Bounds = AxisAlignedBox::Union(C->Bounds, D->Bounds);
+			B->Bounds = AxisAlignedBox::Union(A->Bounds, E->Bounds);
+			A->Height = 1 + glm::max(C->Height, D->Height);
+			B->Height = 1 + glm::max(A->Height, E->Height);
+		}
+		return iB;
+	}
+
+	return iA;
+}
+
+void SpatialIndex::Rebuild() {
+	if (_root == NullNode) {
+		return;
+	}
+
+	// Collect all the leaves, and move all the branches into the free list
+	std::vector<int32_t> leaves;
+	leaves.reserve(_proxyCount);
+	for (int32_t ix = 0; ix < (int32_t)_nodes.size(); ix++) {
+		if (_nodes[ix].Height == 0) {
+			leaves.push_back(ix);
+		} else if (_nodes[ix].Height > 0) {
+			_FreeNode(ix);
+		}
+	}
+
+	_root = _BuildTopDown(leaves.data(), leaves.size());
+	_nodes[_root].Parent = NullNode;
+}
+
+int32_t SpatialIndex::_BuildTopDown(int32_t* leaves, size_t count) {
+	if (count == 1) {
+		return leaves[0];
+	}
+
+	// Split along the longest axis of the leaf centers, at the median
+	AxisAlignedBox centerBounds;
+	for (size_t ix = 0; ix < count; ix++) {
+		centerBounds.Encapsulate(_nodes[leaves[ix]].Bounds.GetCenter());
+	}
+	const glm::vec3 size = centerBounds.Max - centerBounds.Min;
+	const int axis = (size.x > size.y && size.x > size.z) ? 0 : (size.y > size.z ? 1 : 2);
+
+	const size_t mid = count / 2;
+	std::nth_element(leaves, leaves + mid, leaves + count, [&](int32_t l, int32_t r) {
+		return _nodes[l].Bounds.Min[axis] + _nodes[l].Bounds.Max[axis] < _nodes[r].Bounds.Min[axis] + _nodes[r].Bounds.Max[axis];
+	});
+
+	const int32_t child1 = _BuildTopDown(leaves, mid);
+	const int32_t child2 = _BuildTopDown(leaves + mid, count - mid);
+
+	const int32_t result = _AllocateNode();
+	Node& node = _nodes[result];
+	node.Child1 = child1;
+	node.Child2 = child2;
+	node.Bounds = AxisAlignedBox::Union(_nodes[child1].Bounds, _nodes[child2].Bounds);
+	node.Height = 1 + glm::max(_nodes[child1].Height, _nodes[child2].Height);
+	_nodes[child1].Parent = result;
+	_nodes[child2].Parent = result;
+	return result;
+}
+
+void SpatialIndex::Clear(entt::registry& registry) {
+	registry.view<SpatialProxy>().each([](SpatialProxy& proxy) {
+		proxy.ProxyId = NullNode;
+	});
+	_nodes.clear();
+	_root = NullNode;
+	_freeList = NullNode;
+	_proxyCount = 0;
+}
+
+#pragma endregion
+
+#pragma region Queries
+
+void SpatialIndex::ExtractFrustumPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6]) {
+	// Gribb/Hartmann plane extraction, GLM matrices are column major so we build the rows first
+	const glm::vec4 row0 = glm::vec4(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+	const glm::vec4 row1 = glm::vec4(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+	const glm::vec4 row2 = glm::vec4(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+	const glm::vec4 row3 = glm::vec4(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+	planes[0] = row3 + row0;
+	planes[1] = row3 - row0;
+	planes[2] = row3 + row1;
+	planes[3] = row3 - row1;
+	planes[4] = row3 + row2;
+	planes[5] = row3 - row2;
+	for (int ix = 0; ix < 6; ix++) {
+		planes[ix] /= glm::length(glm::vec3(planes[ix]));
+	}
+}
+
+void SpatialIndex::_QueryBox(const AxisAlignedBox& bounds, std::vector<entt::entity>& results) const {
+	_stack.clear();
+	_stack.push_back(_root);
+	while (!_stack.empty()) {
+		const Node& node = _nodes[_stack.back()];
+		_stack.pop_back();
+		if (!node.Bounds.Overlaps(bounds)) {
+			continue;
+		}
+		if (node.IsLeaf()) {
+			results.push_back(node.Entity);
+		} else {
+			_stack.push_back(node.Child1);
+			_stack.push_back(node.Child2);
+		}
+	}
+}
+
+void SpatialIndex::_QuerySphere(const glm::vec3& center, float radius, std::vector<entt::entity>& results) const {
+	_stack.clear();
+	_stack.push_back(_root);
+	while (!_stack.empty()) {
+		const Node& node = _nodes[_stack.back()];
+		_stack.pop_back();
+		if (!SphereOverlapsBox(center, radius, node.Bounds)) {
+			continue;
+		}
+		if (node.IsLeaf()) {
+			results.push_back(node.Entity);
+		} else {
+			_stack.push_back(node.Child1);
+			_stack.push_back(node.Child2);
+		}
+	}
+}
+
+SpatialRayHit SpatialIndex::_Raycast(const SpatialRay& ray) const {
+	SpatialRayHit result;
+	const glm::vec3 invDir = SafeInverse(ray.Direction);
+	float maxDistance = ray.MaxDistance;
+
+	_stack.clear();
+	_stack.push_back(_root);
+	while (!_stack.empty()) {
+		const Node& node = _nodes[_stack.back()];
+		_stack.pop_back();
+
+		float enter;
+		// We shrink the max distance as we find hits, so any nodes further than our closest hit get skipped
+		if (!RayIntersectsBox(ray.Origin, invDir, maxDistance, node.Bounds, enter)) {
+			continue;
+		}
+		if (node.IsLeaf()) {
+			result.Entity = node.Entity;
+			result.Distance = enter;
+			maxDistance = enter;
+		} else {
+			_stack.push_back(node.Child1);
+			_stack.push_back(node.Child2);
+		}
+	}
+	return result;
+}
+
+void SpatialIndex::QueryBox(const AxisAlignedBox& bounds, std::vector<entt::entity>& results) const {
+	if (_root != NullNode) {
+		_QueryBox(bounds, results);
+	}
+}
+
+void SpatialIndex::QuerySphere(const glm::vec3& center, float radius, std::vector<entt::entity>& results) const {
+	if (_root != NullNode) {
+		_QuerySphere(center, radius, results);
+	}
+}
+
+void SpatialIndex::QueryFrustum(const glm::mat4& viewProjection, std::vector<entt::entity>& results) const {
+	if (_root == NullNode) {
+		return;
+	}
+
+	glm::vec4 planes[6];
+	ExtractFrustumPlanes(viewProjection, planes);
+
+	// Each stack entry is a node index followed by a mask of the planes it still needs to be tested against. Once a
+	// node is fully inside a plane, all of it's children are as well
+	_stack.clear();
+	_stack.push_back(_root);
+	_stack.push_back(0x3F);
+	while (!_stack.empty()) {
+		int32_t mask = _stack.back(); _stack.pop_back();
+		const Node& node = _nodes[_stack.back()]; _stack.pop_back();
+
+		const glm::vec3 center = node.Bounds.GetCenter();
+		const glm::vec3 extents = node.Bounds.GetExtents();
+		bool outside = false;
+		for (int ix = 0; ix < 6 && mask != 0; ix++) {
+			if ((mask & (1 << ix)) == 0) {
+				continue;
+			}
+			const glm::vec3 normal = glm::vec3(planes[ix]);
+			const float dist = glm::dot(normal, center) + planes[ix].w;
+			const float radius = glm::dot(glm::abs(normal), extents);
+			if (dist < -radius) {
+				outside = true;
+				break;
+			}
+			if (dist >= radius) {
+				mask &= ~(1 << ix);
+			}
+		}
+		if (outside) {
+			continue;
+		}
+
+		if (node.IsLeaf()) {
+			results.push_back(node.Entity);
+		} else {
+			_stack.push_back(node.Child1);
+			_stack.push_back(mask);
+			_stack.push_back(node.Child2);
+			_stack.push_back(mask);
+		}
+	}
+}
+
+SpatialRayHit SpatialIndex::Raycast(const SpatialRay& ray) const {
+	return _root != NullNode ? _Raycast(ray) : SpatialRayHit();
+}
+
+void SpatialIndex::RaycastAll(const SpatialRay& ray, std::vector<SpatialRayHit>& results) const {
+	if (_root == NullNode) {
+		return;
+	}
+	const glm::vec3 invDir = SafeInverse(ray.Direction);
+
+	_stack.clear();
+	_stack.push_back(_root);
+	while (!_stack.empty()) {
+		const Node& node = _nodes[_stack.back()];
+		_stack.pop_back();
+
+		float enter;
+		if (!RayIntersectsBox(ray.Origin, invDir, ray.MaxDistance, node.Bounds, enter)) {
+			continue;
+		}
+		if (node.IsLeaf()) {
+			SpatialRayHit& hit = results.emplace_back();
+			hit.Entity = node.Entity;
+			hit.Distance = enter;
+		} else {
+			_stack.push_back(node.Child1);
+			_stack.push_back(node.Child2);
+		}
+	}
+}
+
+void SpatialIndex::QueryBoxes(const AxisAlignedBox* boxes, size_t count, std::vector<std::vector<entt::entity>>& results) const {
+	results.resize(count);
+	for (size_t ix = 0; ix < count; ix++) {
+		results[ix].clear();
+		if (_root != NullNode) {
+			_QueryBox(boxes[ix], results[ix]);
+		}
+	}
+}
+
+void SpatialIndex::QuerySpheres(const BoundingSphere* spheres, size_t count, std::vector<std::vector<entt::entity>>& results) const {
+	results.resize(count);
+	for (size_t ix = 0; ix < count; ix++) {
+		results[ix].clear();
+		if (_root != NullNode) {
+			_QuerySphere(spheres[ix].Center, spheres[ix].Radius, results[ix]);
+		}
+	}
+}
+
+void SpatialIndex::RaycastBatch(const SpatialRay* rays, size_t count, SpatialRayHit* hits) const {
+	for (size_t ix = 0; ix < count; ix++) {
+		hits[ix] = _root != NullNode ? _Raycast(rays[ix]) : SpatialRayHit();
+	}
+}
+
+#pragma endregion
\ No newline at end of file
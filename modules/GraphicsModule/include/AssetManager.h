@@ -0,0 +1,269 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include <deque>
+#include <future>
+#include <functional>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <exception>
+
+#include "Shader.h"
+#include "Texture2D.h"
+#include "TextureCubeMap.h"
+#include "VertexArrayObject.h"
+#include "MeshSimplifier.h"
+#include "VertexTypes.h"
+#include "Logging.h"
+
+/// <summary>
+/// The kinds of assets that the asset manager knows how to load
+/// </summary>
+enum class AssetType
+{
+	Texture2D,
+	TextureCubeMap,
+	Mesh,
+	Shader,
+	Count
+};
+
+/// <summary>
+/// Loads assets by path, handing out the same shared pointer every time an asset is asked for instead of loading it
+/// again. Files are read and decoded on worker threads, and the results are uploaded to the GPU on the main thread
+/// by Update (or while waiting on a load)
+/// </summary>
+/// <remarks>
+/// An asset is referenced while anything outside of the manager holds a shared pointer to it. Once nothing does,
+/// it stays loaded (so it can be handed out again for free) until the manager goes over it's memory budget, then
+/// the unreferenced assets that were asked for the longest time ago are dropped first.
+/// The manager may only be used from the thread that created it, since that is the thread with the OpenGL context
+/// </remarks>
+class AssetManager final
+{
+public:
+	typedef std::shared_ptr<AssetManager> sptr;
+	static inline sptr Create(uint32_t threadCount = 0) {
+		return std::make_shared<AssetManager>(threadCount);
+	}
+
+	template <typename T>
+	using Future = std::shared_future<std::shared_ptr<T>>;
+
+	/// <summary>
+	/// How many assets of a type are loaded, and how much memory they take up
+	/// </summary>
+	struct TypeStats
+	{
+		uint32_t Count = 0;
+		/// <summary>
+		/// The GPU memory used by the loaded assets, in bytes
+		/// </summary>
+		size_t   Bytes = 0;
+		/// <summary>
+		/// The number of requests that were handed an asset that was already loaded or loading
+		/// </summary>
+		uint32_t Hits = 0;
+		uint32_t Misses = 0;
+		uint32_t Evictions = 0;
+	};
+
+	/// <summary>
+	/// Creates a new asset manager, this should be done on the thread that owns the OpenGL context
+	/// </summary>
+	/// <param name="threadCount">The number of worker threads to load with, or 0 to use one less than the number of hardware threads</param>
+	AssetManager(uint32_t threadCount = 0);
+	~AssetManager();
+
+	// We'll disallow moving and copying, since we own threads
+	AssetManager(const AssetManager& other) = delete;
+	AssetManager(AssetManager&& other) = delete;
+	AssetManager& operator=(const AssetManager& other) = delete;
+	AssetManager& operator=(AssetManager&& other) = delete;
+
+	/// <summary>
+	/// Assets that nothing else references are evicted while the total memory used is over this many bytes
+	/// </summary>
+	size_t MemoryBudget;
+
+	/// <summary>
+	/// Starts loading a texture from an image file, or returns the existing load if the file was already asked for
+	/// </summary>
+	Future<Texture2D> LoadTextureAsync(const std::string& path);
+	/// <summary>
+	/// Starts loading a cube map from 6 images, see TextureCubeMapData::LoadFromImages for how the files are named
+	/// </summary>
+	Future<TextureCubeMap> LoadCubeMapAsync(const std::string& path);
+	/// <summary>
+	/// Starts loading a mesh from an OBJ file. The same file loaded with different settings is a different asset
+	/// </summary>
+	/// <param name="path">The path to the OBJ file</param>
+	/// <param name="color">The vertex color to apply to the mesh</param>
+	/// <param name="lodSettings">The levels of detail to generate, these are generated on the worker thread as well</param>
+	/// <param name="compression">The vertex layout to store the mesh in on the GPU</param>
+	Future<VertexArrayObject> LoadMeshAsync(const std::string& path, const glm::vec4& color = glm::vec4(1.0f),
+		const MeshLodSettings& lodSettings = MeshLodSettings(), VertexCompression compression = VertexCompression::None);
+
+	Texture2D::sptr LoadTexture(const std::string& path) { return Wait(LoadTextureAsync(path)); }
+	TextureCubeMap::sptr LoadCubeMap(const std::string& path) { return Wait(LoadCubeMapAsync(path)); }
+	VertexArrayObject::sptr LoadMesh(const std::string& path, const glm::vec4& color = glm::vec4(1.0f),
+		const MeshLodSettings& lodSettings = MeshLodSettings(), VertexCompression compression = VertexCompression::None) {
+		return Wait(LoadMeshAsync(path, color, lodSettings, compression));
+	}
+	/// <summary>
+	/// Loads and links a shader from a vertex and fragment shader. Shaders are compiled by the driver on the main
+	/// thread, so this always loads right away
+	/// </summary>
+	Shader::sptr LoadShader(const std::string& vertexPath, const std::string& fragmentPath);
+
+	/// <summary>
+	/// Blocks until an asset has finished loading, uploading any other assets that finish in the mean time. If the
+	/// load failed, the exception it failed with is thrown
+	/// </summary>
+	template <typename T>
+	std::shared_ptr<T> Wait(const Future<T>& future) {
+		LOG_ASSERT(std::this_thread::get_id() == _mainThread, "Assets can only be waited on from the thread that created the asset manager!");
+		while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			_FinishLoads(true);
+		}
+		return future.get();
+	}
+
+	/// <summary>
+	/// Uploads any assets that the workers have finished loading, and evicts unreferenced assets if we are over
+	/// budget. Should be called once a frame
+	/// </summary>
+	void Update();
+
+	/// <summary>
+	/// Evicts unreferenced assets until the total memory used is at most targetBytes
+	/// </summary>
+	/// <param name="targetBytes">The memory to get under, in bytes. Passing 0 evicts every unreferenced asset</param>
+	/// <returns>The number of assets that were evicted</returns>
+	uint32_t EvictUnused(size_t targetBytes = 0);
+
+	/// <summary>
+	/// Gets the number of references to an asset held outside of the manager (including the one passed in), or -1
+	/// if the asset was not loaded by this manager
+	/// </summary>
+	template <typename T>
+	long GetRefCount(const std::shared_ptr<T>& asset) const {
+		return _IsManaged(asset.get()) ? asset.use_count() - 1 : -1;
+	}
+
+	const TypeStats& GetStats(AssetType type) const { return _stats[(int)type]; }
+	/// <summary>
+	/// Gets the GPU memory used by every loaded asset, in bytes
+	/// </summary>
+	size_t GetTotalMemory() const { return _totalBytes; }
+	/// <summary>
+	/// Gets the number of assets that have been asked for but haven't finished loading
+	/// </summary>
+	uint32_t GetPendingCount() const { return _pendingCount; }
+
+	static const char* GetTypeName(AssetType type);
+
+protected:
+	// What a worker produces, and what the main thread turns it into
+	typedef std::function<std::shared_ptr<void>()> ReadFunc;
+	typedef std::function<std::shared_ptr<void>(const std::shared_ptr<void>&, size_t&)> FinishFunc;
+
+	struct Entry
+	{
+		AssetType Type;
+		// A Future<T> for the type of asset, handed out to everyone who asks for it
+		std::shared_ptr<void>      Future;
+		// Completes the future, dropped once the asset is loaded
+		std::function<void(const std::shared_ptr<void>&, std::exception_ptr)> Resolve;
+		// The loaded asset, the only strong reference is in the future's shared state so this tells us who else has it
+		std::weak_ptr<void>        Asset;
+		size_t                     Bytes = 0;
+		uint64_t                   LastRequested = 0;
+		bool                       IsLoaded = false;
+	};
+
+	struct Job
+	{
+		std::string        Key;
+		ReadFunc           Read;
+		FinishFunc         Finish;
+		// Filled in by the worker
+		std::shared_ptr<void> Data;
+		std::exception_ptr    Error;
+	};
+
+	std::thread::id _mainThread;
+	std::unordered_map<std::string, Entry> _entries;
+	TypeStats _stats[(int)AssetType::Count];
+	size_t    _totalBytes = 0;
+	uint32_t  _pendingCount = 0;
+	uint64_t  _clock = 0;
+
+	std::vector<std::thread> _threads;
+	std::mutex               _mutex;
+	std::condition_variable  _wake;
+	std::condition_variable  _done;
+	std::deque<Job>          _queue;
+	std::deque<Job>          _finished;
+	bool                     _quit = false;
+
+	void _WorkerLoop();
+	bool _IsManaged(const void* asset) const;
+	// Uploads the finished loads, if block is set and nothing has finished this waits until something does
+	void _FinishLoads(bool block);
+	void _Complete(Entry& entry, const std::shared_ptr<void>& asset, size_t bytes, std::exception_ptr error, const std::string& key);
+
+	// Gets the existing future for an asset, or creates the entry and queues it's load
+	template <typename T>
+	Future<T> _Load(AssetType type, const std::string& key, ReadFunc read, FinishFunc finish) {
+		LOG_ASSERT(std::this_thread::get_id() == _mainThread, "Assets can only be loaded from the thread that created the asset manager!");
+		TypeStats& stats = _stats[(int)type];
+		auto it = _entries.find(key);
+		if (it != _entries.end()) {
+			stats.Hits++;
+			it->second.LastRequested = ++_clock;
+			return *std::static_pointer_cast<Future<T>>(it->second.Future);
+		}
+		stats.Misses++;
+
+		std::shared_ptr<std::promise<std::shared_ptr<T>>> promise = std::make_shared<std::promise<std::shared_ptr<T>>>();
+		Entry& entry = _entries[key];
+		entry.Type = type;
+		entry.Future = std::make_shared<Future<T>>(promise->get_future().share());
+		entry.Resolve = [promise](const std::shared_ptr<void>& asset, std::exception_ptr error) {
+			if (error) {
+				promise->set_exception(error);
+			} else {
+				promise->set_value(std::static_pointer_cast<T>(asset));
+			}
+		};
+		entry.LastRequested = ++_clock;
+		Future<T> result = *std::static_pointer_cast<Future<T>>(entry.Future);
+
+		// Anything without a read step is finished right away on this thread
+		if (!read) {
+			std::shared_ptr<void> asset;
+			size_t bytes = 0;
+			std::exception_ptr error;
+			try {
+				asset = finish(nullptr, bytes);
+			} catch (...) {
+				error = std::current_exception();
+			}
+			_Complete(entry, asset, bytes, error, key);
+			return result;
+		}
+
+		_pendingCount++;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_queue.push_back({ key, std::move(read), std::move(finish), nullptr, nullptr });
+		}
+		_wake.notify_one();
+		return result;
+	}
+};
\ No newline at end of file
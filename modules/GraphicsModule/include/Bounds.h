@@ -0,0 +1,112 @@
+#pragma once
+#include <cfloat>
+#include <GLM/glm.hpp>
+
+/// <summary>
+/// An axis aligned bounding box, stored as it's minimum and maximum corners
+/// </summary>
+struct AxisAlignedBox
+{
+	glm::vec3 Min;
+	glm::vec3 Max;
+
+	/// <summary>
+	/// Creates an empty (inverted) box, that will snap to the first point added to it
+	/// </summary>
+	AxisAlignedBox() : Min(glm::vec3(FLT_MAX)), Max(glm::vec3(-FLT_MAX)) { }
+	AxisAlignedBox(const glm::vec3& min, const glm::vec3& max) : Min(min), Max(max) { }
+
+	/// <summary>
+	/// Returns true if at least one point has been added to this box
+	/// </summary>
+	bool IsValid() const { return Min.x <= Max.x && Min.y <= Max.y && Min.z <= Max.z; }
+
+	/// <summary>
+	/// Grows this box to contain the given point
+	/// </summary>
+	void Encapsulate(const glm::vec3& point) {
+		Min = glm::min(Min, point);
+		Max = glm::max(Max, point);
+	}
+
+	/// <summary>
+	/// Grows this box to contain another box
+	/// </summary>
+	void Encapsulate(const AxisAlignedBox& other) {
+		Min = glm::min(Min, other.Min);
+		Max = glm::max(Max, other.Max);
+	}
+
+	/// <summary>
+	/// Returns true if the other box is entirely inside of this box
+	/// </summary>
+	bool Contains(const AxisAlignedBox& other) const {
+		return glm::all(glm::lessThanEqual(Min, other.Min)) && glm::all(glm::greaterThanEqual(Max, other.Max));
+	}
+	/// <summary>
+	/// Returns true if this box and the other box overlap
+	/// </summary>
+	bool Overlaps(const AxisAlignedBox& other) const {
+		return glm::all(glm::lessThanEqual(Min, other.Max)) && glm::all(glm::greaterThanEqual(Max, other.Min));
+	}
+
+	/// <summary>
+	/// Gets the center point of the box
+	/// </summary>
+	glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+	/// <summary>
+	/// Gets the half-size of the box along each axis
+	/// </summary>
+	glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+	/// <summary>
+	/// Gets the surface area of the box, used as the cost metric when building bounding volume hierarchies
+	/// </summary>
+	float GetSurfaceArea() const {
+		const glm::vec3 size = Max - Min;
+		return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+
+	/// <summary>
+	/// Gets the smallest box that contains both of the given boxes
+	/// </summary>
+	static AxisAlignedBox Union(const AxisAlignedBox& a, const AxisAlignedBox& b) {
+		return AxisAlignedBox(glm::min(a.Min, b.Min), glm::max(a.Max, b.Max));
+	}
+
+	/// <summary>
+	/// Gets the smallest axis aligned box that contains this box after it has been transformed by the given matrix
+	/// </summary>
+	/// <param name="transform">The affine transformation to apply (ex: an object's world transform)</param>
+	AxisAlignedBox Transformed(const glm::mat4& transform) const {
+		// Transform the center, and project the extents onto each world axis (Arvo's method)
+		const glm::vec3 center  = glm::vec3(transform * glm::vec4(GetCenter(), 1.0f));
+		const glm::vec3 extents = GetExtents();
+		const glm::vec3 worldExtents =
+			glm::abs(glm::vec3(transform[0])) * extents.x +
+			glm::abs(glm::vec3(transform[1])) * extents.y +
+			glm::abs(glm::vec3(transform[2])) * extents.z;
+		return AxisAlignedBox(center - worldExtents, center + worldExtents);
+	}
+};
+
+/// <summary>
+/// A bounding sphere, stored as a center and radius
+/// </summary>
+struct BoundingSphere
+{
+	glm::vec3 Center;
+	float     Radius;
+
+	BoundingSphere() : Center(glm::vec3(0.0f)), Radius(0.0f) { }
+	BoundingSphere(const glm::vec3& center, float radius) : Center(center), Radius(radius) { }
+
+	/// <summary>
+	/// Gets a sphere that contains this sphere after it has been transformed by the given matrix. Non-uniform
+	/// scales will use the largest axis scale
+	/// </summary>
+	/// <param name="transform">The affine transformation to apply (ex: an object's world transform)</param>
+	BoundingSphere Transformed(const glm::mat4& transform) const {
+		const float scale = glm::max(glm::length(glm::vec3(transform[0])), glm::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+		return BoundingSphere(glm::vec3(transform * glm::vec4(Center, 1.0f)), Radius * scale);
+	}
+};
\ No newline at end of file
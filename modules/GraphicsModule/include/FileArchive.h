@@ -0,0 +1,165 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "VirtualFile.h"
+
+/// <summary>
+/// How an entry in a FileArchive is stored
+/// </summary>
+enum class ArchiveCompression : uint32_t
+{
+	/// <summary>
+	/// Stored as is, so opening the entry hands out a view straight into the mapped archive
+	/// </summary>
+	None = 0,
+	/// <summary>
+	/// Stored with gzip, and decompressed into a new buffer every time the entry is opened
+	/// </summary>
+	Gzip = 1
+};
+
+/// <summary>
+/// Describes how FileArchive::Build packs files
+/// </summary>
+struct ArchiveBuildSettings
+{
+	/// <summary>
+	/// True to gzip entries that compress well, entries that don't are stored as is
+	/// </summary>
+	bool     Compress;
+	/// <summary>
+	/// An entry is only stored compressed if it's compressed size is at most this fraction of it's original size, so
+	/// files that are already compressed (ex: PNGs and JPGs) are left uncompressed and can be mapped directly
+	/// </summary>
+	float    MinCompressionRatio;
+	/// <summary>
+	/// The alignment of each entry's data within the archive in bytes, must be a power of two. Entries are aligned
+	/// so that mapped data can be read in place (ex: as floats or uint32 indices)
+	/// </summary>
+	uint32_t Alignment;
+
+	ArchiveBuildSettings() :
+		Compress(true),
+		MinCompressionRatio(0.9f),
+		Alignment(64)
+	{ }
+};
+
+/// <summary>
+/// A single file containing many assets stored back to back, with an index at the end to find them by path.
+/// Archives are memory mapped, so opening an uncompressed entry doesn't read or copy anything, and only the pages
+/// that are actually touched are loaded from disk
+/// </summary>
+/// <remarks>
+/// Paths are stored relative to the folder the archive was built from, with forward slashes (ex: "images/grass.jpg").
+/// Archives can be read from any number of threads at once
+/// </remarks>
+class FileArchive final : public std::enable_shared_from_this<FileArchive>
+{
+public:
+	typedef std::shared_ptr<FileArchive> sptr;
+
+	/// <summary>
+	/// What the index knows about a single entry
+	/// </summary>
+	struct EntryInfo
+	{
+		std::string        Path;
+		ArchiveCompression Compression;
+		uint64_t           Offset;
+		/// <summary>
+		/// The number of bytes the entry takes up in the archive
+		/// </summary>
+		uint64_t           StoredSize;
+		uint64_t           Size;
+	};
+
+	/// <summary>
+	/// Converts a path into the form entries are stored under, with forward slashes and without any "." or ".." parts
+	/// </summary>
+	static std::string NormalizePath(const std::string& path);
+
+	/// <summary>
+	/// Opens and maps an archive, returning nullptr if the file can't be opened or is not an archive
+	/// </summary>
+	static sptr Open(const std::string& path);
+
+	/// <summary>
+	/// Packs every file under a folder into a new archive
+	/// </summary>
+	/// <param name="outputPath">The path of the archive to write</param>
+	/// <param name="rootDirectory">The folder to pack, entry paths are stored relative to this</param>
+	/// <param name="settings">How to pack the files</param>
+	/// <returns>True if the archive was written</returns>
+	static bool Build(const std::string& outputPath, const std::string& rootDirectory, const ArchiveBuildSettings& settings = ArchiveBuildSettings());
+
+	FileArchive();
+	~FileArchive();
+
+	// We'll disallow moving and copying, since we own the mapping
+	FileArchive(const FileArchive& other) = delete;
+	FileArchive(FileArchive&& other) = delete;
+	FileArchive& operator=(const FileArchive& other) = delete;
+	FileArchive& operator=(FileArchive&& other) = delete;
+
+	/// <summary>
+	/// Gets whether the archive has an entry for the given path
+	/// </summary>
+	bool Contains(const std::string& path) const { return _Find(path) >= 0; }
+	/// <summary>
+	/// Opens an entry, returning nullptr if there isn't one for the given path
+	/// </summary>
+	VirtualFile::sptr OpenFile(const std::string& path) const;
+
+	const std::string& GetPath() const { return _path; }
+	size_t GetEntryCount() const { return _entryCount; }
+	/// <summary>
+	/// Gets a description of every entry in the archive, in the order they are stored in the index
+	/// </summary>
+	std::vector<EntryInfo> GetEntries() const;
+
+protected:
+	// These are written to the file as is, so their layout must not change without bumping the version
+	struct Header
+	{
+		char     Magic[4];
+		uint32_t Version;
+		uint32_t EntryCount;
+		uint32_t Alignment;
+		uint64_t IndexOffset;
+	};
+	struct Entry
+	{
+		uint64_t PathHash;
+		uint64_t Offset;
+		uint64_t StoredSize;
+		uint64_t Size;
+		uint32_t PathOffset;
+		uint32_t PathLength;
+		uint32_t Compression;
+		uint32_t Reserved;
+	};
+
+	std::string    _path;
+	const uint8_t* _data = nullptr;
+	size_t         _size = 0;
+	// The entries are sorted by PathHash, so they can be binary searched
+	const Entry*   _entries = nullptr;
+	const char*    _paths = nullptr;
+	size_t         _entryCount = 0;
+
+	// Platform handles for the mapping
+	void*          _fileHandle = nullptr;
+	void*          _mappingHandle = nullptr;
+	int            _fileDescriptor = -1;
+
+	bool _Map(const std::string& path);
+	void _Unmap();
+	// Gets the index of the entry with the given path, or -1
+	int64_t _Find(const std::string& path) const;
+
+	static uint64_t _Hash(const std::string& path);
+};
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+#include "Bounds.h"
+
+/// <summary>
+/// Tests a large number of world-space bounding boxes against a camera frustum. Boxes are stored as
+/// structure-of-arrays so that they can be tested 4 at a time using SSE
+/// </summary>
+class FrustumCuller
+{
+public:
+	FrustumCuller() = default;
+	~FrustumCuller() = default;
+
+	/// <summary>
+	/// Removes all boxes from the culler, call once per frame before adding the frame's boxes
+	/// </summary>
+	void Clear();
+	/// <summary>
+	/// Reserves space for the given number of boxes
+	/// </summary>
+	void Reserve(size_t count);
+
+	/// <summary>
+	/// Adds a world-space bounding box to be culled. Invalid (empty) boxes are always treated as visible
+	/// </summary>
+	/// <param name="bounds">The world space bounds to test</param>
+	/// <returns>The index of the box, used to query the result with IsVisible</returns>
+	uint32_t Add(const AxisAlignedBox& bounds);
+
+	/// <summary>
+	/// Extracts the frustum planes from the given view-projection matrix and tests all boxes against them
+	/// </summary>
+	/// <param name="viewProjection">The combined view and projection matrix of the camera</param>
+	/// <returns>The number of visible boxes</returns>
+	uint32_t Cull(const glm::mat4& viewProjection);
+	/// <summary>
+	/// Tests all boxes against the given planes, where xyz is the inward facing normal and w is the distance. This
+	/// lets callers leave planes out, ex: the near plane of a shadow caster frustum
+	/// </summary>
+	/// <param name="planes">The planes to test against, see ExtractPlanes</param>
+	/// <param name="planeCount">The number of planes, up to 6</param>
+	/// <returns>The number of visible boxes</returns>
+	uint32_t Cull(const glm::vec4* planes, int planeCount);
+
+	/// <summary>
+	/// Gets whether the box with the given index passed the last call to Cull
+	/// </summary>
+	bool IsVisible(uint32_t index) const { return _visible[index] != 0; }
+	/// <summary>
+	/// Gets the number of boxes that were added to the culler
+	/// </summary>
+	uint32_t GetCount() const { return _count; }
+	/// <summary>
+	/// Gets the number of boxes that were visible in the last call to Cull
+	/// </summary>
+	uint32_t GetVisibleCount() const { return _visibleCount; }
+	/// <summary>
+	/// Gets the number of boxes that were outside of the frustum in the last call to Cull
+	/// </summary>
+	uint32_t GetCulledCount() const { return _count - _visibleCount; }
+
+	/// <summary>
+	/// Extracts the 6 normalized frustum planes (left, right, bottom, top, near, far) from a view-projection
+	/// matrix, where xyz is the inward facing normal and w is the distance
+	/// </summary>
+	static void ExtractPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6]);
+	/// <summary>
+	/// Tests a single box against the given frustum planes, returns true if any part of the box is inside
+	/// </summary>
+	static bool TestBox(const glm::vec4 planes[6], const AxisAlignedBox& bounds);
+
+private:
+	uint32_t _count = 0;
+	uint32_t _visibleCount = 0;
+
+	// Structure-of-arrays storage, padded to a multiple of 4 entries
+	std::vector<float>   _centerX, _centerY, _centerZ;
+	std::vector<float>   _extentX, _extentY, _extentZ;
+	std::vector<uint8_t> _visible;
+};
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include <VertexArrayObject.h>
+#include "MeshSimplifier.h"
 
 template <typename VertType>
 class MeshBuilder
@@ -81,17 +82,106 @@ public:
 	/// </summary>
 	size_t GetTriangleCount() const { return _indices.size() > 0 ? _indices.size() / 3 : _vertices.size() / 3; }
 
-	VertexArrayObject::sptr Bake() {
+	/// <summary>
+	/// Calculates the axis aligned box and bounding sphere that contain all vertices in this mesh
+	/// </summary>
+	/// <param name="box">Receives the axis aligned bounding box</param>
+	/// <param name="sphere">Receives the bounding sphere, centered on the box</param>
+	void CalculateBounds(AxisAlignedBox& box, BoundingSphere& sphere) const {
+		box = AxisAlignedBox();
+		for (const VertType& vert : _vertices) {
+			box.Encapsulate(vert.Position);
+		}
+		sphere = BoundingSphere(box.IsValid() ? box.GetCenter() : glm::vec3(0.0f), 0.0f);
+		float radiusSq = 0.0f;
+		for (const VertType& vert : _vertices) {
+			const glm::vec3 offset = vert.Position - sphere.Center;
+			radiusSq = glm::max(radiusSq, glm::dot(offset, offset));
+		}
+		sphere.Radius = glm::sqrt(radiusSq);
+	}
+
+	/// <summary>
+	/// Generates a chain of simplified index lists for this mesh, all referencing the existing vertices
+	/// </summary>
+	/// <param name="settings">The settings describing which levels to generate</param>
+	/// <param name="indices">Receives the index lists for every level, starting with the full detail mesh</param>
+	/// <param name="lods">Receives the range and error of each level within indices</param>
+	void GenerateLods(const MeshLodSettings& settings, std::vector<uint32_t>& indices, std::vector<VertexArrayObject::LodLevel>& lods) const {
+		indices = _indices;
+		lods.clear();
+		lods.push_back({ 0, static_cast<GLsizei>(_indices.size()), 0.0f });
+
+		AxisAlignedBox box;
+		BoundingSphere sphere;
+		CalculateBounds(box, sphere);
+
+		std::vector<uint32_t> simplified;
+		for (float target : settings.ErrorTargets) {
+			const VertexArrayObject::LodLevel& previous = lods.back();
+			if (previous.IndexCount / 3 < (GLsizei)settings.MinTriangleCount) {
+				break;
+			}
+			const float error = MeshSimplifier::Simplify(_vertices.data(), sizeof(VertType), offsetof(VertType, Position), _vertices.size(),
+				_indices, target * sphere.Radius, 0, simplified);
+			// Skip levels that don't remove enough triangles to be worth storing
+			if (simplified.empty() || simplified.size() > previous.IndexCount * settings.MaxTriangleRatio) {
+				continue;
+			}
+			lods.push_back({ static_cast<GLsizei>(indices.size()), static_cast<GLsizei>(simplified.size()), error });
+			indices.insert(indices.end(), simplified.begin(), simplified.end());
+		}
+	}
+
+	/// <summary>
+	/// Generates this mesh's LODs now and holds onto them, so that baking the mesh only has to upload them. This
+	/// does not touch OpenGL, so it can be called from a worker thread to take simplification off the main thread
+	/// </summary>
+	/// <param name="settings">The settings describing which levels to generate, these replace the settings passed to Bake</param>
+	void PrecomputeLods(const MeshLodSettings& settings) {
+		_lodIndices.clear();
+		_lods.clear();
+		if (!settings.ErrorTargets.empty() && !_indices.empty()) {
+			GenerateLods(settings, _lodIndices, _lods);
+		}
+		_hasPrecomputedLods = true;
+	}
+
+	/// <summary>
+	/// Uploads this mesh to the GPU
+	/// </summary>
+	/// <param name="lodSettings">If any error targets are specified, a chain of LODs will be generated and stored in the index buffer</param>
+	VertexArrayObject::sptr Bake(const MeshLodSettings& lodSettings = MeshLodSettings()) {
 		VertexBuffer::sptr vbo = VertexBuffer::Create();
 		vbo->LoadData(GetVertexDataPtr(), _vertices.size());
+		return _BakeWithVertices(vbo, VertType::V_DECL, lodSettings);
+	}
 
-		IndexBuffer::sptr ebo = IndexBuffer::Create();
-		ebo->LoadData(GetIndexDataPtr(), _indices.size());
+	/// <summary>
+	/// Uploads this mesh to the GPU, converting the vertices into a compact format
+	/// </summary>
+	/// <typeparam name="PackedType">The vertex type to store on the GPU, must provide a static Pack(const VertType&amp;, boundsMin, boundsSize)</typeparam>
+	/// <param name="lodSettings">If any error targets are specified, a chain of LODs will be generated and stored in the index buffer</param>
+	template <typename PackedType>
+	VertexArrayObject::sptr BakePacked(const MeshLodSettings& lodSettings = MeshLodSettings()) {
+		AxisAlignedBox box;
+		BoundingSphere sphere;
+		CalculateBounds(box, sphere);
+		const glm::vec3 boundsMin = box.IsValid() ? box.Min : glm::vec3(0.0f);
+		const glm::vec3 boundsSize = box.IsValid() ? box.Max - box.Min : glm::vec3(0.0f);
 
-		VertexArrayObject::sptr result = VertexArrayObject::Create();
-		result->AddVertexBuffer(vbo, VertType::V_DECL);
-		result->SetIndexBuffer(ebo);
+		std::vector<PackedType> packed;
+		packed.reserve(_vertices.size());
+		for (const VertType& vert : _vertices) {
+			packed.push_back(PackedType::Pack(vert, boundsMin, boundsSize));
+		}
 
+		VertexBuffer::sptr vbo = VertexBuffer::Create();
+		vbo->LoadData(packed.data(), packed.size());
+		VertexArrayObject::sptr result = _BakeWithVertices(vbo, PackedType::V_DECL, lodSettings);
+		if (PackedType::QUANTIZED_POSITION) {
+			result->SetPositionDequantization(boundsMin, boundsSize);
+		}
 		return result;
 	}
 	
@@ -112,7 +202,41 @@ public:
 	
 protected:
 	friend class MeshFactory;
+
+	// Creates the VAO for an already uploaded vertex buffer, and uploads our indices, bounds and LODs
+	VertexArrayObject::sptr _BakeWithVertices(const VertexBuffer::sptr& vbo, const std::vector<BufferAttribute>& decl, const MeshLodSettings& lodSettings) const {
+		std::vector<VertexArrayObject::LodLevel> lods;
+		IndexBuffer::sptr ebo = IndexBuffer::Create();
+		if (_hasPrecomputedLods && !_lods.empty()) {
+			lods = _lods;
+			ebo->LoadData(_lodIndices.data(), _lodIndices.size());
+		} else if (!_hasPrecomputedLods && !lodSettings.ErrorTargets.empty() && !_indices.empty()) {
+			std::vector<uint32_t> indices;
+			GenerateLods(lodSettings, indices, lods);
+			ebo->LoadData(indices.data(), indices.size());
+		} else {
+			ebo->LoadData(GetIndexDataPtr(), _indices.size());
+		}
+
+		VertexArrayObject::sptr result = VertexArrayObject::Create();
+		result->AddVertexBuffer(vbo, decl);
+		result->SetIndexBuffer(ebo);
+		if (lods.size() > 1) {
+			result->SetLods(lods);
+		}
+
+		AxisAlignedBox box;
+		BoundingSphere sphere;
+		CalculateBounds(box, sphere);
+		result->SetBounds(box, sphere);
+
+		return result;
+	}
 	
 	std::vector<VertType> _vertices;
 	std::vector<uint32_t> _indices;
+	// The LODs from PrecomputeLods, if it has been called
+	bool                                     _hasPrecomputedLods = false;
+	std::vector<uint32_t>                    _lodIndices;
+	std::vector<VertexArrayObject::LodLevel> _lods;
 };
@@ -0,0 +1,69 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/// <summary>
+/// Describes the chain of levels of detail to generate when baking a mesh
+/// </summary>
+struct MeshLodSettings
+{
+	/// <summary>
+	/// The maximum geometric error allowed for each level after the first, as a fraction of the mesh's bounding
+	/// sphere radius (ex: 0.01 allows vertices to move by roughly 1% of the mesh's size). Should be increasing
+	/// </summary>
+	std::vector<float> ErrorTargets;
+	/// <summary>
+	/// Levels will stop being generated once a level has fewer than this many triangles
+	/// </summary>
+	uint32_t           MinTriangleCount;
+	/// <summary>
+	/// A level is only kept if it has at most this fraction of the previous level's triangles, so that we
+	/// don't store levels that are nearly identical
+	/// </summary>
+	float              MaxTriangleRatio;
+
+	MeshLodSettings() :
+		ErrorTargets(std::vector<float>()),
+		MinTriangleCount(16),
+		MaxTriangleRatio(0.85f)
+	{ }
+	MeshLodSettings(const std::vector<float>& errorTargets) :
+		ErrorTargets(errorTargets),
+		MinTriangleCount(16),
+		MaxTriangleRatio(0.85f)
+	{ }
+
+	/// <summary>
+	/// Returns a set of settings that produces a typical 4 level chain
+	/// </summary>
+	static MeshLodSettings Default() { return MeshLodSettings({ 0.005f, 0.02f, 0.05f }); }
+};
+
+/// <summary>
+/// Simplifies triangle meshes using edge collapses ordered by quadric error (Garland-Heckbert). Collapses are
+/// half-edge collapses, so the simplified mesh only references vertices from the source mesh, allowing all
+/// levels of detail to share a single vertex buffer
+/// </summary>
+class MeshSimplifier
+{
+public:
+	/// <summary>
+	/// Simplifies an indexed triangle mesh
+	/// </summary>
+	/// <param name="vertices">A pointer to the first vertex, vertices must be made up entirely of floats</param>
+	/// <param name="vertexStride">The size of a single vertex, in bytes</param>
+	/// <param name="positionOffset">The offset of the vec3 position within a vertex, in bytes</param>
+	/// <param name="vertexCount">The number of vertices</param>
+	/// <param name="indices">The triangle list to simplify</param>
+	/// <param name="targetError">The maximum error (object space distance) that a collapse may introduce</param>
+	/// <param name="targetIndexCount">Simplification will stop once the result has this many indices or fewer</param>
+	/// <param name="result">Receives the simplified triangle list</param>
+	/// <returns>The largest error introduced by a collapse, in object space units</returns>
+	static float Simplify(const void* vertices, size_t vertexStride, size_t positionOffset, size_t vertexCount,
+		const std::vector<uint32_t>& indices, float targetError, size_t targetIndexCount, std::vector<uint32_t>& result);
+
+protected:
+	MeshSimplifier() = default;
+	~MeshSimplifier() = default;
+};
@@ -4,7 +4,28 @@
 class ObjLoader
 {
 public:
-	static VertexArrayObject::sptr LoadFromFile(const std::string& filename, const glm::vec4& inColor = glm::vec4(1.0f));
+	/// <summary>
+	/// Loads a mesh from an OBJ file
+	/// </summary>
+	/// <param name="filename">The path to the file to load</param>
+	/// <param name="inColor">The vertex color to apply to the mesh</param>
+	/// <param name="lodSettings">The levels of detail to generate for the mesh, none by default</param>
+	/// <param name="compression">The vertex layout to store the mesh in on the GPU</param>
+	static VertexArrayObject::sptr LoadFromFile(const std::string& filename, const glm::vec4& inColor = glm::vec4(1.0f), const MeshLodSettings& lodSettings = MeshLodSettings(), VertexCompression compression = VertexCompression::None);
+
+	/// <summary>
+	/// Parses an OBJ file into a mesh builder without touching OpenGL, so it can be called from any thread
+	/// </summary>
+	/// <param name="filename">The path to the file to load</param>
+	/// <param name="inColor">The vertex color to apply to the mesh</param>
+	static MeshBuilder<VertexPosNormTexCol> LoadMeshFromFile(const std::string& filename, const glm::vec4& inColor = glm::vec4(1.0f));
+	/// <summary>
+	/// Uploads a mesh loaded by LoadMeshFromFile to the GPU, this must be called on the thread that owns the OpenGL context
+	/// </summary>
+	/// <param name="mesh">The mesh to upload, if it's LODs were precomputed they are used instead of lodSettings</param>
+	/// <param name="lodSettings">The levels of detail to generate for the mesh, none by default</param>
+	/// <param name="compression">The vertex layout to store the mesh in on the GPU</param>
+	static VertexArrayObject::sptr Bake(MeshBuilder<VertexPosNormTexCol>& mesh, const MeshLodSettings& lodSettings = MeshLodSettings(), VertexCompression compression = VertexCompression::None);
 
 protected:
 	ObjLoader() = default;
@@ -6,7 +6,30 @@ class RendererComponent {
 public:
 	VertexArrayObject::sptr Mesh;
 	ShaderMaterial::sptr    Material;
+	// The world space bounds of the mesh, see UpdateWorldBounds
+	AxisAlignedBox          WorldBounds;
+	// Whether the renderer passed frustum culling this frame
+	bool                    IsVisible = true;
+	// The level of detail of the mesh to draw this frame
+	int                     LodLevel = 0;
+	// Whether the mesh is drawn into shadow maps
+	bool                    CastShadows = true;
 
-	RendererComponent& SetMesh(const VertexArrayObject::sptr& mesh) { Mesh = mesh; return *this; }
+	// Resets the world bounds as well, so that they are recalculated for the new mesh on the next UpdateWorldBounds
+	RendererComponent& SetMesh(const VertexArrayObject::sptr& mesh) { Mesh = mesh; WorldBounds = AxisAlignedBox(); return *this; }
 	RendererComponent& SetMaterial(const ShaderMaterial::sptr& material) { Material = material; return *this; }
+	RendererComponent& SetCastShadows(bool castShadows) { CastShadows = castShadows; return *this; }
+
+	// Recalculates WorldBounds for the given world transform, should be called once world matrices are updated (ex: when
+	// culling). Objects that haven't moved since the last call keep their bounds, so static scenery costs a compare
+	void UpdateWorldBounds(const glm::mat4& worldTransform) {
+		if (Mesh != nullptr && (!WorldBounds.IsValid() || worldTransform != _boundsTransform)) {
+			WorldBounds = Mesh->GetBounds().Transformed(worldTransform);
+			_boundsTransform = worldTransform;
+		}
+	}
+
+private:
+	// The world transform that WorldBounds was last calculated with
+	glm::mat4 _boundsTransform = glm::mat4(1.0f);
 };
\ No newline at end of file
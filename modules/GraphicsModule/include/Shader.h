@@ -3,13 +3,19 @@
 #include <memory>
 
 #include <string>               // for std::string
+#include <vector>               // for std::vector
 #include <unordered_map>        // for std::unordered_map
+#include <filesystem>           // for watching our source files
 #include <GLM/glm.hpp>          // for our GLM types
 #include <GLM/gtc/type_ptr.hpp> // for glm::value_ptr
 #include "Logging.h"            // for the logging functions
 
 /// <summary>
 /// This class will wrap around an OpenGL shader program
+/// 
+/// Shader parts are only compiled when the program is linked, so that programs can be loaded straight from the
+/// binary cache (see EnableBinaryCache) without compiling anything. Source loaded from files can use
+/// #include "file", which is resolved relative to the including file, and can be hot-reloaded (see EnableHotReload)
 /// </summary>
 class Shader final
 {
@@ -38,6 +44,7 @@ public:
 
 	/// <summary>
 	/// Loads a single shader stage into this shader object (ex: Vertex Shader or Fragment Shader)
+	/// Note that the stage is not compiled until Link is called, so compile errors are reported by Link
 	/// </summary>
 	/// <param name="source">The source code of the shader to load</param>
 	/// <param name="type">The stage to load (GL_VERTEX_SHADER or GL_FRAGMENT_SHADER)</param>
@@ -45,6 +52,7 @@ public:
 	bool LoadShaderPart(const char* source, GLenum type);
 	/// <summary>
 	/// Loads a single shader stage into this shader object (ex: Vertex Shader or Fragment Shader) from an external file (in res)
+	/// Any #include "file" directives are resolved relative to the including file, and each file is only included once
 	/// </summary>
 	/// <param name="path">The relative path to the file containing the source</param>
 	/// <param name="type">The stage to load (GL_VERTEX_SHADER or GL_FRAGMENT_SHADER)</param>
@@ -52,10 +60,25 @@ public:
 	bool LoadShaderPartFromFile(const char* path, GLenum type);
 
 	/// <summary>
-	/// Links the vertex and fragment shader, and allows this shader program to be used
+	/// Compiles and links all the loaded stages, and allows this shader program to be used
+	/// If the binary cache is enabled, a binary from an earlier run is used instead when the sources and driver match
 	/// </summary>
 	/// <returns>True if the linking was sucessful, false if otherwise</returns>
 	bool Link();
+	/// <summary>
+	/// Re-loads all the stages that came from files and re-links the program. The new program replaces the old one
+	/// only if it links, and keeps the values of any uniforms that were set on the old one
+	/// </summary>
+	/// <returns>True if the program was replaced, false if the old program was kept</returns>
+	bool Reload();
+	/// <summary>
+	/// Returns true if any of the files this shader was loaded from (including #included files) have changed since they were loaded
+	/// </summary>
+	bool HasSourceChanged() const;
+	/// <summary>
+	/// Returns true if the program was loaded from the binary cache the last time it was linked
+	/// </summary>
+	bool WasLoadedFromCache() const { return _loadedFromCache; }
 
 	/// <summary>
 	/// Binds this shader for use
@@ -70,6 +93,53 @@ public:
 	/// Gets the underlying OpenGL handle that this class is wrapping
 	/// </summary>
 	GLuint GetHandle() const { return _handle; }
+
+	/// <summary>
+	/// Enables caching linked program binaries in the given directory, programs with the same sources on the same
+	/// driver will be loaded from there on later runs instead of being compiled
+	/// </summary>
+	/// <param name="directory">The directory to store the binaries in, will be created if it does not exist</param>
+	static void EnableBinaryCache(const std::string& directory);
+	/// <summary>
+	/// Stops loading and storing program binaries
+	/// </summary>
+	static void DisableBinaryCache();
+	/// <summary>
+	/// Deletes all the binaries in the cache directory, so that every program is compiled next run
+	/// </summary>
+	static void ClearBinaryCache();
+	/// <summary>
+	/// Enables or disables watching the source files of every shader for changes, see PollHotReload
+	/// </summary>
+	/// <remarks>
+	/// By default the files are watched where they were loaded from, which is usually the copy of the res folder that
+	/// the build puts next to the executable, not the one in the project. Use AddHotReloadSourceDirectory to watch the
+	/// originals instead. Files that are read out of a mounted archive are never watched
+	/// </remarks>
+	static void EnableHotReload(bool enabled) { _hotReloadEnabled = enabled; }
+	static bool IsHotReloadEnabled() { return _hotReloadEnabled; }
+	/// <summary>
+	/// Adds a directory that shader files were copied from (ex: the project's res folder). Shader paths are looked up
+	/// in these directories first (in the order they were added), and any file found there is watched and reloaded
+	/// from there, rather than from the working directory or an archive
+	/// </summary>
+	/// <param name="directory">The directory to look for shader sources in</param>
+	static void AddHotReloadSourceDirectory(const std::string& directory);
+	/// <summary>
+	/// Reloads any shaders whose source files have changed, call once per frame. Files are only checked a few times a second
+	/// </summary>
+	/// <returns>The number of shaders that were reloaded</returns>
+	static int PollHotReload();
+
+	/// <summary>
+	/// Returns the total time spent loading and linking shaders, in milliseconds
+	/// </summary>
+	static double GetTotalLoadTime() { return _totalLoadTime; }
+	/// <summary>
+	/// Returns the number of programs linked from cached binaries and from source
+	/// </summary>
+	static uint32_t GetCacheHits() { return _cacheHits; }
+	static uint32_t GetCacheMisses() { return _cacheMisses; }
 	
 public:
 	int GetUniformLocation(const std::string& name);
@@ -117,11 +187,47 @@ public:
 	void SetUniform(int location, const glm::bvec4* value, int count = 1);
 	
 protected:
-	GLuint _vs;
-	GLuint _fs;
-	
+	/// <summary>
+	/// A single stage, with all it's includes already resolved
+	/// </summary>
+	struct ShaderPart {
+		GLenum                   Type;
+		std::string              Source;
+		// The file the stage came from (empty if it was loaded from a string) followed by everything it included,
+		// the index of each file is the source string number used by #line, so compile errors can be traced back
+		std::vector<std::string> Files;
+	};
+
 	GLuint _handle;
+	std::vector<ShaderPart> _parts;
+	// The last write time of every file in our parts, for hot reloading
+	std::vector<std::pair<std::string, std::filesystem::file_time_type>> _fileTimes;
+	bool _loadedFromCache;
 
 	std::unordered_map<std::string, int> _uniformLocs;
-	
+
+	/// <summary>
+	/// Compiles and links our parts into the given program, or loads it from the binary cache
+	/// </summary>
+	bool _LinkProgram(GLuint program);
+	bool _LoadFromCache(GLuint program, uint64_t hash);
+	void _StoreInCache(GLuint program, uint64_t hash);
+	/// <summary>
+	/// Hashes the sources of all our parts along with the driver, so binaries are never used on a different driver
+	/// </summary>
+	uint64_t _ComputeHash() const;
+	void _UpdateFileTimes();
+	/// <summary>
+	/// Gets the file to watch and reload from for a file we loaded, or an empty string if it should not be watched
+	/// </summary>
+	static std::string _ResolveWatchedPath(const std::string& path);
+
+	static std::string _cacheDirectory;
+	static bool        _hotReloadEnabled;
+	static std::vector<std::string> _hotReloadSourceDirectories;
+	static double      _totalLoadTime;
+	static uint32_t    _cacheHits;
+	static uint32_t    _cacheMisses;
+	// Every live shader, so that PollHotReload can find them
+	static std::vector<Shader*> _allShaders;
 };
\ No newline at end of file
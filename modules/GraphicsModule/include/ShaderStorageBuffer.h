@@ -0,0 +1,64 @@
+#pragma once
+#include "IBuffer.h"
+#include <memory>
+
+/// <summary>
+/// The shader storage buffer holds arrays of data that shaders read through buffer blocks, ex: lists of lights
+/// </summary>
+class ShaderStorageBuffer : public IBuffer
+{
+public:
+	typedef std::shared_ptr<ShaderStorageBuffer> sptr;
+	static inline sptr Create(GLenum usage = GL_DYNAMIC_DRAW) {
+		return std::make_shared<ShaderStorageBuffer>(usage);
+	}
+	
+public:
+	/// <summary>
+	/// Creates a new shader storage buffer, with the given usage. Data will still need to be uploaded before it can be used
+	/// </summary>
+	/// <param name="usage">The usage hint for the buffer, default is GL_DYNAMIC_DRAW</param>
+	ShaderStorageBuffer(GLenum usage = GL_DYNAMIC_DRAW) : IBuffer(GL_SHADER_STORAGE_BUFFER, usage) { }
+
+	/// <summary>
+	/// Re-allocates the buffer so that it can hold at least the given number of elements, discarding it's contents.
+	/// The buffer never shrinks, and grows by half again when it needs to, so a slowly growing buffer is not re-sized every frame.
+	/// Re-allocating every frame before uploading is intended, the driver hands us fresh memory instead of waiting for draws
+	/// from the last frame that are still reading the old contents
+	/// </summary>
+	/// <param name="elementSize">The size of a single element, in bytes</param>
+	/// <param name="elementCount">The number of elements the buffer needs to hold</param>
+	void Allocate(size_t elementSize, size_t elementCount) {
+		size_t capacity = elementCount > 0 ? elementCount : 1;
+		if (elementSize == _elementSize && capacity <= _elementCount) {
+			capacity = _elementCount;
+		} else if (elementSize == _elementSize) {
+			capacity = capacity + capacity / 2;
+		}
+		glNamedBufferData(_handle, elementSize * capacity, nullptr, _usage);
+		_elementSize = elementSize;
+		_elementCount = capacity;
+	}
+
+	/// <summary>
+	/// Uploads data into part of the buffer, without re-allocating it
+	/// </summary>
+	/// <param name="data">The data to upload</param>
+	/// <param name="offset">The offset into the buffer to start writing at, in bytes</param>
+	/// <param name="size">The number of bytes to upload</param>
+	void UpdateData(const void* data, size_t offset, size_t size) {
+		if (size > 0) {
+			glNamedBufferSubData(_handle, offset, size, data);
+		}
+	}
+
+	/// <summary>
+	/// Binds this buffer to an indexed binding point, matching layout(binding = N) in the shaders
+	/// </summary>
+	void BindBase(GLuint binding) const { glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, _handle); }
+
+	/// <summary>
+	/// Unbinds the current shader storage buffer
+	/// </summary>
+	static void UnBind() { IBuffer::UnBind(GL_SHADER_STORAGE_BUFFER); }
+};
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include "ITexture.h"
 #include "TextureEnums.h"
 #include "Texture2DData.h"
+#include "Texture2DMipChain.h"
+#include "TextureProcessor.h"
 
 struct Texture2DDescription
 {
@@ -19,6 +21,8 @@ struct Texture2DDescription
 	MagFilter      MagnificationFilter;
 	float          MaxAnisotropic;
 	bool           GenerateMipMaps;
+	// The number of mip levels to allocate, or 0 to allocate a full chain if GenerateMipMaps is set
+	uint32_t       MipLevels;
 
 	Texture2DDescription() :
 		Width(0), Height(0),
@@ -28,7 +32,8 @@ struct Texture2DDescription
 		MinificationFilter(MinFilter::NearestMipLinear),
 		MagnificationFilter(MagFilter::Linear),
 		MaxAnisotropic(-1.0f),
-		GenerateMipMaps(true)
+		GenerateMipMaps(true),
+		MipLevels(0)
 	{ }
 };
 
@@ -64,6 +69,12 @@ public:
 	/// </summary>
 	/// <param name="data">The texture data to upload into this texture</param>
 	void LoadData(const Texture2DData::sptr& data);
+	/// <summary>
+	/// Uploads a pre-built mip chain to this texture, level by level. The texture will be re-created
+	/// with the format and level count of the chain
+	/// </summary>
+	/// <param name="data">The mip chain to upload, as created by the TextureProcessor</param>
+	void LoadData(const Texture2DMipChain::sptr& data);
 
 	/// <summary>
 	/// Loads an image directly from a file
@@ -71,9 +82,18 @@ public:
 	/// <param name="path">The path to load the image from</param>
 	/// <returns>A pointer to the loaded image</returns>
 	static Texture2D::sptr LoadFromFile(const std::string& path);
+	/// <summary>
+	/// Loads an image through the texture cache, processing it into mip levels and compressing it on
+	/// the first run, and loading the processed texture directly on subsequent runs
+	/// </summary>
+	/// <param name="path">The path to load the image from</param>
+	/// <param name="settings">The settings to use for processing the image</param>
+	/// <returns>A pointer to the loaded image</returns>
+	static Texture2D::sptr LoadFromFileCached(const std::string& path, const TextureProcessSettings& settings = TextureProcessSettings());
 	
 	uint32_t GetWidth() const { return _description.Width; }
 	uint32_t GetHeight() const { return _description.Height; }
+	uint32_t GetMipLevels() const { return _levelCount; }
 	InternalFormat GetFormat() const { return _description.Format; }	
 	MinFilter GetMinFilter() const { return _description.MinificationFilter; }
 	MagFilter GetMagFilter() const { return _description.MagnificationFilter; }
@@ -90,6 +110,7 @@ public:
 	
 private:
 	Texture2DDescription _description;
+	uint32_t             _levelCount;
 
 	void _RecreateTexture();
 };
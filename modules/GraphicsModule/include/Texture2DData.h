@@ -1,6 +1,7 @@
 #pragma once
 #include <memory>
 #include <cstdint>
+#include <functional>
 
 #include "TextureEnums.h"
 
@@ -15,6 +16,10 @@ public:
 	Texture2DData& operator=(const Texture2DData& other) = delete;
 	Texture2DData& operator=(Texture2DData&& other) = delete;
 	typedef std::shared_ptr<Texture2DData> sptr;
+	/// <summary>
+	/// A function that will be invoked to free a buffer that has been adopted by texture data
+	/// </summary>
+	typedef std::function<void(void*)> DataDeleter;
 
 	std::string DebugName;
 
@@ -28,8 +33,26 @@ public:
 	/// <param name="sourceData">A pointer to the data to upload to this texture</param>
 	/// <param name="recommendedFormat">The recommended internal format to use when creating textures from this data</param>
 	Texture2DData(uint32_t width, uint32_t height, PixelFormat format, PixelType type, void* sourceData, InternalFormat recommendedFormat = InternalFormat::Unknown);
+	/// <summary>
+	/// Creates a new 2D texture data object that takes ownership of an existing buffer instead of copying it. The buffer
+	/// must be at least width * height * texel size bytes, and will be freed with the given deleter when the data is released
+	/// </summary>
+	/// <param name="width">The width of the texture, in pixels</param>
+	/// <param name="height">The height of the texture, in pixels</param>
+	/// <param name="format">The pixel format or layout of a pixel (ex: RGBA)</param>
+	/// <param name="type">The component type of the pixel (ex: uint8_t)</param>
+	/// <param name="data">The buffer to adopt, may not be null</param>
+	/// <param name="deleter">The function to free the buffer with, or nullptr if the buffer is owned elsewhere</param>
+	/// <param name="recommendedFormat">The recommended internal format to use when creating textures from this data</param>
+	Texture2DData(uint32_t width, uint32_t height, PixelFormat format, PixelType type, void* data, DataDeleter deleter, InternalFormat recommendedFormat = InternalFormat::Unknown);
 	~Texture2DData();
 
+	/// <summary>
+	/// Frees the underlying pixel data, keeping only the image's properties. Use this to drop the CPU copy
+	/// of an image once it has been uploaded to the GPU
+	/// </summary>
+	void ReleaseData();
+
 	/// <summary>
 	/// Loads image data from an external file
 	/// </summary>
@@ -67,6 +90,10 @@ public:
 	/// Gets a readonly copy of the underlying data in this image for upload
 	/// </summary>
 	const void* GetDataPtr() const { return _data; }
+	/// <summary>
+	/// Gets whether this object still holds pixel data (false after ReleaseData has been called)
+	/// </summary>
+	bool HasData() const { return _data != nullptr; }
 
 private:
 	uint32_t    _width, _height;
@@ -75,4 +102,5 @@ private:
 	PixelType   _type;
 	InternalFormat _recommendedFormat;
 	void* _data;
+	DataDeleter _deleter;
 };
\ No newline at end of file
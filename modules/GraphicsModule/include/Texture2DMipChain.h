@@ -0,0 +1,105 @@
+#pragma once
+#include <memory>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "TextureEnums.h"
+
+/// <summary>
+/// Stores a full chain of mip levels for a 2D texture, already in the format that it will be
+/// stored in on the GPU (ex: BC1 blocks or RGBA8 pixels). This is the output of the TextureProcessor,
+/// and can be saved to and loaded from our cache container format
+/// </summary>
+class Texture2DMipChain final
+{
+public:
+	Texture2DMipChain(const Texture2DMipChain& other) = delete;
+	Texture2DMipChain(Texture2DMipChain&& other) = delete;
+	Texture2DMipChain& operator=(const Texture2DMipChain& other) = delete;
+	Texture2DMipChain& operator=(Texture2DMipChain&& other) = delete;
+	typedef std::shared_ptr<Texture2DMipChain> sptr;
+
+	/// <summary>
+	/// Represents a single level in the mip chain
+	/// </summary>
+	struct MipLevel {
+		uint32_t Width;
+		uint32_t Height;
+		std::vector<uint8_t> Data;
+	};
+
+	std::string DebugName;
+
+	/// <summary>
+	/// Creates a new, empty mip chain
+	/// </summary>
+	/// <param name="format">The internal format that the levels are stored in</param>
+	/// <param name="pixelFormat">For uncompressed formats, the layout of a pixel in the levels (ignored for block compressed formats)</param>
+	Texture2DMipChain(InternalFormat format, PixelFormat pixelFormat = PixelFormat::RGBA);
+	~Texture2DMipChain() = default;
+
+	/// <summary>
+	/// Appends a new level to the end of the chain, returning a reference to it
+	/// </summary>
+	MipLevel& AddLevel(uint32_t width, uint32_t height, size_t dataSize);
+
+	/// <summary>
+	/// Gets the internal format that all levels in this chain are stored as
+	/// </summary>
+	InternalFormat GetFormat() const { return _format; }
+	/// <summary>
+	/// Gets the pixel layout for uncompressed chains
+	/// </summary>
+	PixelFormat GetPixelFormat() const { return _pixelFormat; }
+	/// <summary>
+	/// Gets whether this chain stores block compressed data
+	/// </summary>
+	bool IsCompressed() const { return IsBlockCompressed(_format); }
+	/// <summary>
+	/// Gets the width of the top level of the chain, in pixels
+	/// </summary>
+	uint32_t GetWidth() const { return _levels.empty() ? 0 : _levels[0].Width; }
+	/// <summary>
+	/// Gets the height of the top level of the chain, in pixels
+	/// </summary>
+	uint32_t GetHeight() const { return _levels.empty() ? 0 : _levels[0].Height; }
+	/// <summary>
+	/// Gets the number of levels in the chain
+	/// </summary>
+	uint32_t GetLevelCount() const { return static_cast<uint32_t>(_levels.size()); }
+	/// <summary>
+	/// Gets a single level from the chain, where level 0 is the full resolution image
+	/// </summary>
+	const MipLevel& GetLevel(uint32_t level) const { return _levels[level]; }
+	/// <summary>
+	/// Gets the total size of all levels in the chain, in bytes
+	/// </summary>
+	size_t GetTotalDataSize() const;
+
+	/// <summary>
+	/// Writes this chain to our binary texture container format
+	/// </summary>
+	/// <param name="path">The path of the file to write</param>
+	/// <param name="sourceStamp">A user value stored in the header, used to check if a cache is out of date</param>
+	/// <returns>True if the file was written, false if otherwise</returns>
+	bool SaveToFile(const std::string& path, uint64_t sourceStamp = 0) const;
+
+	/// <summary>
+	/// Loads a chain from our binary texture container format
+	/// </summary>
+	/// <param name="path">The path of the file to load</param>
+	/// <param name="sourceStamp">If non-null, receives the stamp that was stored when the file was saved</param>
+	/// <returns>The loaded chain, or nullptr if the file is missing or invalid</returns>
+	static Texture2DMipChain::sptr LoadFromFile(const std::string& path, uint64_t* sourceStamp = nullptr);
+
+	/// <summary>
+	/// Gets the number of bytes needed to store an image of the given size in the given format
+	/// </summary>
+	static size_t GetImageSize(uint32_t width, uint32_t height, InternalFormat format, PixelFormat pixelFormat);
+
+private:
+	InternalFormat        _format;
+	PixelFormat           _pixelFormat;
+	std::vector<MipLevel> _levels;
+};
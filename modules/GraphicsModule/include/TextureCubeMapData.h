@@ -24,7 +24,8 @@ ENUM(CubeMapFace, GLint,
 );
 
 /// <summary>
-/// Stores data required to upload texture data into OpenGL
+/// Stores data required to upload texture data into OpenGL. Each face is stored as a view over
+/// 2D texture data, so cube maps built from existing images do not need to copy them
 /// </summary>
 class TextureCubeMapData final
 {
@@ -47,7 +48,12 @@ public:
 	/// <param name="sourceData">A pointer to the data to upload to this texture</param>
 	/// <param name="recommendedFormat">The recommended internal format to use when creating textures from this data</param>
 	TextureCubeMapData(uint32_t size, PixelFormat format, PixelType type, void* sourceData, InternalFormat recommendedFormat = InternalFormat::Unknown);
-	~TextureCubeMapData();
+	/// <summary>
+	/// Creates a new cube map data object that references the given images as its faces, without copying them
+	/// </summary>
+	/// <param name="faces">The set of 6 images to use as faces, see CubeMapFace for the ordering. All faces must have the same size and format</param>
+	TextureCubeMapData(const std::vector<Texture2DData::sptr>& faces);
+	~TextureCubeMapData() = default;
 
 	/// <summary>
 	/// Loads a cubemap from a set of 6 images
@@ -71,12 +77,20 @@ public:
 	static TextureCubeMapData::sptr LoadFromImages(const std::string& rootImagePath);
 
 	/// <summary>
-	/// Loads 2D image data into this cubemap data for the given face. Dimensions and format must match the existing size and formats
+	/// Loads 2D image data into this cubemap data for the given face. Dimensions and format must match the existing size and formats.
+	/// The face will reference the given data rather than copying it
 	/// </summary>
 	/// <param name="data">The data to load into the face</param>
 	/// <param name="face">The face to load data into</param>
 	void LoadFaceData(const Texture2DData::sptr& data, CubeMapFace face);
 
+	/// <summary>
+	/// Drops this cube map's references to it's faces. A face's pixel data is only freed if nothing else holds a
+	/// reference to that face, so faces shared with other objects keep their data. Use this to drop the CPU copy of
+	/// the cube map once it has been uploaded to the GPU
+	/// </summary>
+	void ReleaseData();
+
 	/// <summary>
 	/// Gets the size of the texture (width/height of each individual image in the set)
 	/// </summary>
@@ -104,16 +118,16 @@ public:
 	/// <returns></returns>
 	size_t GetFaceDataSize() const { return _faceDataSize; }
 	/// <summary>
-	/// Gets a readonly copy of the underlying data in this image for upload
+	/// Gets a readonly copy of the data for a single face in this cube map
 	/// </summary>
-	const void* GetDataPtr() const { return _data; }
-
+	/// <param name="face">The face to get the data for</param>
+	/// <returns>A const pointer to the start of data for the given face, or nullptr if the face has no data</returns>
+	const void* GetFaceDataPtr(CubeMapFace face) const { return _faces[(size_t)face] != nullptr ? _faces[(size_t)face]->GetDataPtr() : nullptr; }
 	/// <summary>
-	/// Gets a readonly copy of the data for a single face in this cube map
+	/// Gets the 2D texture data backing a single face in this cube map, may be nullptr
 	/// </summary>
 	/// <param name="face">The face to get the data for</param>
-	/// <returns>A const pointer to the start of data for the given face</returns>
-	const void* GetFaceDataPtr(CubeMapFace face) const { return static_cast<char*>(_data) + (_faceDataSize * (size_t)face); }
+	const Texture2DData::sptr& GetFaceData(CubeMapFace face) const { return _faces[(size_t)face]; }
 
 private:
 	uint32_t    _size;
@@ -122,5 +136,5 @@ private:
 	PixelFormat _format;
 	PixelType   _type;
 	InternalFormat _recommendedFormat;
-	void* _data;
+	Texture2DData::sptr _faces[6];
 };
\ No newline at end of file
@@ -5,6 +5,17 @@
 #include "Logging.h"
 #include "glad/glad.h"
 
+// The S3TC formats are provided by EXT_texture_compression_s3tc, which our glad loader does not
+// include, but is supported by every desktop GPU we target
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT 0x8C4D
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
 // https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glTexImage2D.xhtml
 // These are some of our more common available internal formats
 ENUM(InternalFormat, GLint,
@@ -18,7 +29,31 @@ ENUM(InternalFormat, GLint,
 	RGB10        = GL_RGB10,
 	RGB16        = GL_RGB16,
 	RGBA8        = GL_RGBA8,
-	RGBA16       = GL_RGBA16
+	RGBA16       = GL_RGBA16,
+	SRGB8        = GL_SRGB8,
+	SRGB8_ALPHA8 = GL_SRGB8_ALPHA8,
+
+	// Floating point formats, mostly used for HDR render targets
+	R16F         = GL_R16F,
+	RG16F        = GL_RG16F,
+	R11G11B10F   = GL_R11F_G11F_B10F,
+	RGBA16F      = GL_RGBA16F,
+	RGBA32F      = GL_RGBA32F,
+
+	// Sized depth formats, these can be used as framebuffer attachments
+	Depth16         = GL_DEPTH_COMPONENT16,
+	Depth24         = GL_DEPTH_COMPONENT24,
+	Depth32F        = GL_DEPTH_COMPONENT32F,
+	Depth24Stencil8 = GL_DEPTH24_STENCIL8,
+
+	// Block compressed formats, these can only be filled with pre-compressed data (see TextureProcessor)
+	BC1          = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,
+	BC1_SRGB     = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT,
+	BC3          = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+	BC3_SRGB     = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT,
+	BC5          = GL_COMPRESSED_RG_RGTC2,
+	BC7          = GL_COMPRESSED_RGBA_BPTC_UNORM,
+	BC7_SRGB     = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM
 
 	// Note: There are sized internal formats but there is a LOT of them
 );
@@ -126,4 +161,111 @@ constexpr GLint GetTexelComponentCount(PixelFormat format)
  */
 constexpr size_t GetTexelSize(PixelFormat format, PixelType type) {
 	return GetTexelComponentSize(type) * GetTexelComponentCount(format);
+}
+
+/*
+ * Gets whether the given internal format is a 4x4 block compressed format
+ */
+constexpr bool IsBlockCompressed(InternalFormat format)
+{
+	switch (format) {
+		case InternalFormat::BC1:
+		case InternalFormat::BC1_SRGB:
+		case InternalFormat::BC3:
+		case InternalFormat::BC3_SRGB:
+		case InternalFormat::BC5:
+		case InternalFormat::BC7:
+		case InternalFormat::BC7_SRGB:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/*
+ * Gets the number of bytes used to store a single 4x4 block of a compressed format
+ * @param format The block compressed format
+ * @returns The size of a single block in bytes, or 0 if the format is not block compressed
+ */
+constexpr size_t GetBlockSize(InternalFormat format)
+{
+	switch (format) {
+		case InternalFormat::BC1:
+		case InternalFormat::BC1_SRGB:
+			return 8;
+		case InternalFormat::BC3:
+		case InternalFormat::BC3_SRGB:
+		case InternalFormat::BC5:
+		case InternalFormat::BC7:
+		case InternalFormat::BC7_SRGB:
+			return 16;
+		default:
+			return 0;
+	}
+}
+
+/*
+ * Gets whether the given internal format stores depth (and possibly stencil) rather than color
+ */
+constexpr bool IsDepthFormat(InternalFormat format)
+{
+	switch (format) {
+		case InternalFormat::Depth:
+		case InternalFormat::DepthStencil:
+		case InternalFormat::Depth16:
+		case InternalFormat::Depth24:
+		case InternalFormat::Depth32F:
+		case InternalFormat::Depth24Stencil8:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/*
+ * Gets whether the given internal format has a stencil component
+ */
+constexpr bool HasStencil(InternalFormat format)
+{
+	return format == InternalFormat::DepthStencil || format == InternalFormat::Depth24Stencil8;
+}
+
+/*
+ * Gets the number of bytes the GPU uses to store a single texel of an uncompressed internal format
+ * (drivers may pad some formats, so treat this as an estimate)
+ * @param format The uncompressed internal format
+ * @returns The size of a single texel in bytes, or 0 for compressed or unsized formats
+ */
+constexpr size_t GetInternalFormatSize(InternalFormat format)
+{
+	switch (format) {
+		case InternalFormat::R8:
+			return 1;
+		case InternalFormat::R16:
+		case InternalFormat::RG8:
+		case InternalFormat::R16F:
+		case InternalFormat::Depth16:
+			return 2;
+		case InternalFormat::RGB8:
+		case InternalFormat::SRGB8:
+			return 3;
+		case InternalFormat::RGB10:
+		case InternalFormat::RGBA8:
+		case InternalFormat::SRGB8_ALPHA8:
+		case InternalFormat::RG16F:
+		case InternalFormat::R11G11B10F:
+		case InternalFormat::Depth24:
+		case InternalFormat::Depth32F:
+		case InternalFormat::Depth24Stencil8:
+			return 4;
+		case InternalFormat::RGB16:
+			return 6;
+		case InternalFormat::RGBA16:
+		case InternalFormat::RGBA16F:
+			return 8;
+		case InternalFormat::RGBA32F:
+			return 16;
+		default:
+			return 0;
+	}
 }
\ No newline at end of file
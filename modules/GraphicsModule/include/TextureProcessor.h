@@ -0,0 +1,107 @@
+#pragma once
+#include <string>
+
+#include "Texture2DData.h"
+#include "Texture2DMipChain.h"
+
+/// <summary>
+/// The filter used to downsample one mip level into the next
+/// </summary>
+enum class MipFilter
+{
+	/// <summary>
+	/// Averages each 2x2 quad of pixels, fast but slightly blurry
+	/// </summary>
+	Box,
+	/// <summary>
+	/// A Kaiser windowed sinc filter, keeps smaller mip levels sharper at a higher processing cost
+	/// </summary>
+	Kaiser
+};
+
+/// <summary>
+/// Describes how a texture should be processed into a mip chain
+/// </summary>
+struct TextureProcessSettings
+{
+	/// <summary>
+	/// The format to store the texture in, one of RGBA8, BC1, BC3, BC5 or BC7. The sRGB variant of
+	/// the format will be selected automatically if IsSrgb is set
+	/// </summary>
+	InternalFormat Format;
+	/// <summary>
+	/// True if the texture stores colour data in sRGB space (ex: diffuse maps), false for linear data
+	/// such as normal, specular or roughness maps. sRGB textures are converted to linear before filtering
+	/// </summary>
+	bool           IsSrgb;
+	/// <summary>
+	/// The filter to use when generating mip levels
+	/// </summary>
+	MipFilter      Filter;
+	/// <summary>
+	/// The maximum number of levels to generate, or 0 to generate the full chain down to 1x1
+	/// </summary>
+	uint32_t       MaxLevels;
+	/// <summary>
+	/// The number of worker threads to use for filtering and compression, or 0 to use all hardware threads
+	/// </summary>
+	uint32_t       ThreadCount;
+
+	TextureProcessSettings() :
+		Format(InternalFormat::BC7),
+		IsSrgb(true),
+		Filter(MipFilter::Box),
+		MaxLevels(0),
+		ThreadCount(0)
+	{ }
+};
+
+/// <summary>
+/// Handles offline (or first-run) processing of textures, building gamma-correct mip chains on the CPU
+/// and encoding them into block compressed formats that can be uploaded directly to the GPU
+/// </summary>
+class TextureProcessor
+{
+public:
+	/// <summary>
+	/// Builds a full chain of uncompressed RGBA8 mip levels from the given image data
+	/// </summary>
+	/// <param name="data">The source image, must use unsigned byte components</param>
+	/// <param name="settings">The settings to use for filtering, Format is only used to tell if the data is sRGB, see ResolveFormat</param>
+	/// <returns>An RGBA8 (or SRGB8_ALPHA8) mip chain</returns>
+	static Texture2DMipChain::sptr BuildMipChain(const Texture2DData::sptr& data, const TextureProcessSettings& settings = TextureProcessSettings());
+
+	/// <summary>
+	/// Encodes an uncompressed RGBA8 mip chain into a block compressed format
+	/// </summary>
+	/// <param name="chain">The uncompressed chain, as returned by BuildMipChain</param>
+	/// <param name="format">The block compressed format to encode into (BC1, BC3, BC5 or BC7, or their sRGB variants)</param>
+	/// <param name="threadCount">The number of worker threads to use, or 0 to use all hardware threads</param>
+	/// <returns>A new mip chain storing the compressed blocks</returns>
+	static Texture2DMipChain::sptr Compress(const Texture2DMipChain::sptr& chain, InternalFormat format, uint32_t threadCount = 0);
+
+	/// <summary>
+	/// Builds the mip chain for an image and compresses it according to the given settings
+	/// </summary>
+	static Texture2DMipChain::sptr Process(const Texture2DData::sptr& data, const TextureProcessSettings& settings = TextureProcessSettings());
+
+	/// <summary>
+	/// Loads a processed texture from the cache directory, processing the source image and writing it to the
+	/// cache first if no up-to-date cache entry exists. Cache entries are invalidated when the source file
+	/// or processing settings change
+	/// </summary>
+	/// <param name="file">The path to the source image</param>
+	/// <param name="settings">The settings to process the image with</param>
+	/// <param name="cacheDirectory">The directory to store processed textures in</param>
+	/// <returns>The processed mip chain, or nullptr if the source image could not be loaded</returns>
+	static Texture2DMipChain::sptr LoadOrProcess(const std::string& file, const TextureProcessSettings& settings = TextureProcessSettings(), const std::string& cacheDirectory = "cache/textures");
+
+	/// <summary>
+	/// Gets the internal format that the given settings will produce, resolving sRGB variants
+	/// </summary>
+	static InternalFormat ResolveFormat(const TextureProcessSettings& settings);
+
+protected:
+	TextureProcessor() = default;
+	~TextureProcessor() = default;
+};
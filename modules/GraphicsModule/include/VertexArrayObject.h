@@ -3,9 +3,11 @@
 #include <cstdint>
 #include <vector>
 #include <memory>
+#include <GLM/glm.hpp>
 
 #include "VertexBuffer.h"
 #include "IndexBuffer.h"
+#include "Bounds.h"
 
 /// <summary>
 /// We'll use this just to make it more clear what the intended usage of an attribute is in our code!
@@ -128,7 +130,105 @@ public:
 	/// </summary>
 	GLuint GetHandle() const { return _handle; }
 
-	void Render() const;
+	/// <summary>
+	/// Sets the object-space bounding volumes for the mesh stored in this VAO
+	/// </summary>
+	/// <param name="bounds">The axis aligned box that contains all vertices</param>
+	/// <param name="sphere">The sphere that contains all vertices</param>
+	void SetBounds(const AxisAlignedBox& bounds, const BoundingSphere& sphere) { _bounds = bounds; _boundingSphere = sphere; }
+	/// <summary>
+	/// Gets the object-space axis aligned box containing the mesh, will be invalid if no bounds have been set
+	/// </summary>
+	const AxisAlignedBox& GetBounds() const { return _bounds; }
+	/// <summary>
+	/// Gets the object-space sphere containing the mesh
+	/// </summary>
+	const BoundingSphere& GetBoundingSphere() const { return _boundingSphere; }
+	/// <summary>
+	/// Returns true if bounds have been calculated for this VAO
+	/// </summary>
+	bool HasBounds() const { return _bounds.IsValid(); }
+
+	/// <summary>
+	/// Sets the transform used to decode quantized positions back into object space, for meshes that store their
+	/// positions as normalized integers within their bounding box
+	/// </summary>
+	/// <param name="offset">The minimum corner of the box the positions were quantized in</param>
+	/// <param name="scale">The size of the box the positions were quantized in</param>
+	void SetPositionDequantization(const glm::vec3& offset, const glm::vec3& scale);
+	/// <summary>
+	/// Gets the matrix that converts the mesh's stored positions into object space (identity for unquantized meshes),
+	/// this should be applied before the model matrix
+	/// </summary>
+	const glm::mat4& GetDequantizationMatrix() const { return _dequantization; }
+	/// <summary>
+	/// Returns true if the mesh stores it's positions quantized within it's bounds
+	/// </summary>
+	bool HasQuantizedPositions() const { return _hasQuantizedPositions; }
+	/// <summary>
+	/// Returns true if the mesh stores it's normals as 2 component octahedral encoded values, shaders will need to
+	/// decode these before use
+	/// </summary>
+	bool HasOctahedralNormals() const { return _hasOctahedralNormals; }
+
+	/// <summary>
+	/// Represents a single level of detail, as a range within the index buffer
+	/// </summary>
+	struct LodLevel
+	{
+		/// <summary>
+		/// The index of the first element in the index buffer for this level
+		/// </summary>
+		GLsizei IndexOffset;
+		/// <summary>
+		/// The number of indices in this level
+		/// </summary>
+		GLsizei IndexCount;
+		/// <summary>
+		/// The geometric error of this level compared to the full mesh, in object space units
+		/// </summary>
+		float   Error;
+	};
+
+	/// <summary>
+	/// Sets the levels of detail stored in this VAO's index buffer, level 0 should be the full detail mesh
+	/// </summary>
+	void SetLods(const std::vector<LodLevel>& lods) { _lods = lods; }
+	/// <summary>
+	/// Gets the number of levels of detail in this VAO, a mesh without generated LODs has a single level
+	/// </summary>
+	int GetLodCount() const { return _lods.empty() ? 1 : static_cast<int>(_lods.size()); }
+	/// <summary>
+	/// Gets the number of triangles that will be drawn for the given level of detail
+	/// </summary>
+	GLsizei GetTriangleCount(int lod = 0) const;
+	/// <summary>
+	/// Gets the total size of the vertex and index buffers bound to this VAO, in bytes
+	/// </summary>
+	size_t GetMemoryUsage() const;
+	/// <summary>
+	/// Selects the coarsest level of detail whose error, when projected to the screen, is below the given threshold
+	/// </summary>
+	/// <param name="pixelsPerUnit">The number of pixels that an object space unit covers on screen, see GetPixelsPerUnit</param>
+	/// <param name="maxPixelError">The largest error we will accept, in pixels</param>
+	/// <returns>The index of the level to render</returns>
+	int SelectLod(float pixelsPerUnit, float maxPixelError) const;
+
+	/// <summary>
+	/// Calculates how many pixels an object space unit covers at a given distance from a perspective camera
+	/// </summary>
+	/// <param name="projection">The camera's projection matrix</param>
+	/// <param name="viewportHeight">The height of the viewport, in pixels</param>
+	/// <param name="distance">The distance from the camera to the object</param>
+	/// <param name="objectScale">The largest scale of the object's world transform</param>
+	static float GetPixelsPerUnit(const glm::mat4& projection, float viewportHeight, float distance, float objectScale = 1.0f) {
+		return projection[1][1] * 0.5f * viewportHeight * objectScale / glm::max(distance, 0.0001f);
+	}
+
+	/// <summary>
+	/// Renders the mesh at the given level of detail
+	/// </summary>
+	void Render(int lod = 0) const;
 	
 protected:
 	// Helper structure to store a buffer and the attributes
@@ -144,6 +244,18 @@ protected:
 	std::vector<VertexBufferBinding> _vertexBuffers;
 
 	GLsizei _vertexCount;
+
+	// The object-space bounds of the mesh, used for culling
+	AxisAlignedBox _bounds;
+	BoundingSphere _boundingSphere;
+
+	// Index ranges for each level of detail, empty if the mesh has no LODs
+	std::vector<LodLevel> _lods;
+
+	// Information about compressed vertex formats
+	glm::mat4 _dequantization;
+	bool      _hasQuantizedPositions;
+	bool      _hasOctahedralNormals;
 	
 	// The underlying OpenGL handle that this class is wrapping around
 	GLuint _handle;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <GLM/glm.hpp>
+#include <GLM/gtc/packing.hpp>
 #include <VertexArrayObject.h>
 
 struct VertexPosCol {
@@ -57,4 +58,137 @@ struct VertexPosNormTexCol {
 		Position({ x, y, z }), Normal({ nX, nY, nZ }), UV({ u, v }), Color({r, g, b, a}) {}
 
 	static const std::vector<BufferAttribute> V_DECL;
+};
+
+/// <summary>
+/// Selects which vertex layout a loader should emit
+/// </summary>
+enum class VertexCompression
+{
+	/// <summary>
+	/// Full precision floats for every attribute (VertexPosNormTexCol, 48 bytes)
+	/// </summary>
+	None,
+	/// <summary>
+	/// Full precision positions, with packed normals, UVs and colours (VertexPosNormTexColPacked, 24 bytes)
+	/// </summary>
+	Packed,
+	/// <summary>
+	/// Positions quantized to 16 bits relative to the mesh bounds, with packed normals, UVs and colours (VertexQuantizedPosNormTexCol, 20 bytes)
+	/// </summary>
+	Quantized
+};
+
+/// <summary>
+/// Helpers for encoding vertex attributes into compact formats
+/// </summary>
+class VertexPacking
+{
+public:
+	/// <summary>
+	/// Encodes a unit vector using an octahedral mapping, into two signed normalized 16 bit values
+	/// </summary>
+	static glm::i16vec2 OctEncode(const glm::vec3& normal) {
+		glm::vec3 n = normal / (glm::abs(normal.x) + glm::abs(normal.y) + glm::abs(normal.z) + 1e-20f);
+		glm::vec2 result = glm::vec2(n.x, n.y);
+		// Fold the lower hemisphere over the diagonals
+		if (n.z < 0.0f) {
+			result = (1.0f - glm::abs(glm::vec2(n.y, n.x))) * glm::vec2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+		}
+		return glm::i16vec2(glm::round(glm::clamp(result, -1.0f, 1.0f) * 32767.0f));
+	}
+	/// <summary>
+	/// Decodes a normal that was encoded with OctEncode, matches the decoding done in our shaders
+	/// </summary>
+	static glm::vec3 OctDecode(const glm::i16vec2& encoded) {
+		const glm::vec2 f = glm::max(glm::vec2(encoded) / 32767.0f, -1.0f);
+		glm::vec3 n = glm::vec3(f.x, f.y, 1.0f - glm::abs(f.x) - glm::abs(f.y));
+		const float t = glm::max(-n.z, 0.0f);
+		n.x += n.x >= 0.0f ? -t : t;
+		n.y += n.y >= 0.0f ? -t : t;
+		return glm::normalize(n);
+	}
+	/// <summary>
+	/// Packs a pair of floats as half precision floats
+	/// </summary>
+	static glm::u16vec2 ToHalf2(const glm::vec2& value) {
+		return glm::u16vec2(glm::packHalf1x16(value.x), glm::packHalf1x16(value.y));
+	}
+	/// <summary>
+	/// Packs a 0-1 colour into 8 bits per channel
+	/// </summary>
+	static glm::u8vec4 ToUnorm8x4(const glm::vec4& color) {
+		return glm::u8vec4(glm::round(glm::clamp(color, 0.0f, 1.0f) * 255.0f));
+	}
+	/// <summary>
+	/// Quantizes a position to 16 bits per axis, relative to the given box
+	/// </summary>
+	static glm::u16vec4 QuantizePosition(const glm::vec3& position, const glm::vec3& boundsMin, const glm::vec3& boundsSize) {
+		const glm::vec3 scale = glm::vec3(
+			boundsSize.x > 0.0f ? 1.0f / boundsSize.x : 0.0f,
+			boundsSize.y > 0.0f ? 1.0f / boundsSize.y : 0.0f,
+			boundsSize.z > 0.0f ? 1.0f / boundsSize.z : 0.0f);
+		const glm::vec3 normalized = glm::clamp((position - boundsMin) * scale, 0.0f, 1.0f);
+		return glm::u16vec4(glm::u16vec3(glm::round(normalized * 65535.0f)), 0);
+	}
+
+protected:
+	VertexPacking() = default;
+	~VertexPacking() = default;
+};
+
+/// <summary>
+/// A compact version of VertexPosNormTexCol, with an octahedral encoded normal, half precision UVs and an
+/// 8 bit per channel colour. Half the size of the full precision vertex (24 bytes)
+/// </summary>
+struct VertexPosNormTexColPacked {
+	glm::vec3    Position;
+	glm::i16vec2 Normal;
+	glm::u16vec2 UV;
+	glm::u8vec4  Color;
+
+	VertexPosNormTexColPacked() : Position(glm::vec3(0.0f)), Normal(glm::i16vec2(0)), UV(glm::u16vec2(0)), Color(glm::u8vec4(0, 0, 0, 255)) {}
+
+	/// <summary>
+	/// Packs a full precision vertex, the bounds are ignored since positions are stored at full precision
+	/// </summary>
+	static VertexPosNormTexColPacked Pack(const VertexPosNormTexCol& vertex, const glm::vec3& boundsMin, const glm::vec3& boundsSize) {
+		VertexPosNormTexColPacked result;
+		result.Position = vertex.Position;
+		result.Normal = VertexPacking::OctEncode(vertex.Normal);
+		result.UV = VertexPacking::ToHalf2(vertex.UV);
+		result.Color = VertexPacking::ToUnorm8x4(vertex.Color);
+		return result;
+	}
+
+	static const bool QUANTIZED_POSITION = false;
+	static const std::vector<BufferAttribute> V_DECL;
+};
+
+/// <summary>
+/// The most compact of our vertex formats (20 bytes). Positions are stored as 16 bit normalized integers within the
+/// mesh's bounding box, the VAO stores the transform needed to get them back into object space
+/// </summary>
+struct VertexQuantizedPosNormTexCol {
+	glm::u16vec4 Position; // w is padding
+	glm::i16vec2 Normal;
+	glm::u16vec2 UV;
+	glm::u8vec4  Color;
+
+	VertexQuantizedPosNormTexCol() : Position(glm::u16vec4(0)), Normal(glm::i16vec2(0)), UV(glm::u16vec2(0)), Color(glm::u8vec4(0, 0, 0, 255)) {}
+
+	/// <summary>
+	/// Packs a full precision vertex, quantizing it's position within the given bounds
+	/// </summary>
+	static VertexQuantizedPosNormTexCol Pack(const VertexPosNormTexCol& vertex, const glm::vec3& boundsMin, const glm::vec3& boundsSize) {
+		VertexQuantizedPosNormTexCol result;
+		result.Position = VertexPacking::QuantizePosition(vertex.Position, boundsMin, boundsSize);
+		result.Normal = VertexPacking::OctEncode(vertex.Normal);
+		result.UV = VertexPacking::ToHalf2(vertex.UV);
+		result.Color = VertexPacking::ToUnorm8x4(vertex.Color);
+		return result;
+	}
+
+	static const bool QUANTIZED_POSITION = true;
+	static const std::vector<BufferAttribute> V_DECL;
 };
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+/// <summary>
+/// The contents of a file opened through the VirtualFileSystem. The bytes either belong to the file, or are a view
+/// into memory owned by something else (ex: a memory mapped FileArchive) that the file keeps alive
+/// </summary>
+class VirtualFile final
+{
+public:
+	typedef std::shared_ptr<VirtualFile> sptr;
+
+	/// <summary>
+	/// Creates a file that owns it's data
+	/// </summary>
+	static inline sptr Create(std::vector<uint8_t>&& data) {
+		return std::make_shared<VirtualFile>(std::move(data));
+	}
+	/// <summary>
+	/// Creates a file that points into memory owned by something else, without copying it
+	/// </summary>
+	/// <param name="data">The first byte of the file</param>
+	/// <param name="size">The size of the file, in bytes</param>
+	/// <param name="owner">The owner of the memory, which is kept alive for as long as the file is</param>
+	static inline sptr CreateView(const uint8_t* data, size_t size, const std::shared_ptr<const void>& owner) {
+		return std::make_shared<VirtualFile>(data, size, owner);
+	}
+
+	VirtualFile(std::vector<uint8_t>&& data) :
+		_storage(std::move(data)), _data(_storage.data()), _size(_storage.size()), _owner(nullptr) { }
+	VirtualFile(const uint8_t* data, size_t size, const std::shared_ptr<const void>& owner) :
+		_storage(), _data(data), _size(size), _owner(owner) { }
+
+	// We'll disallow moving and copying, since views point into our storage
+	VirtualFile(const VirtualFile& other) = delete;
+	VirtualFile(VirtualFile&& other) = delete;
+	VirtualFile& operator=(const VirtualFile& other) = delete;
+	VirtualFile& operator=(VirtualFile&& other) = delete;
+
+	const uint8_t* GetData() const { return _data; }
+	size_t GetSize() const { return _size; }
+	/// <summary>
+	/// Copies the contents of the file into a string, for text formats
+	/// </summary>
+	std::string GetText() const { return std::string(reinterpret_cast<const char*>(_data), _size); }
+	/// <summary>
+	/// Gets whether the data is a view into memory owned by something else, rather than a copy
+	/// </summary>
+	bool IsView() const { return _owner != nullptr; }
+
+protected:
+	std::vector<uint8_t>        _storage;
+	const uint8_t*              _data;
+	size_t                      _size;
+	std::shared_ptr<const void> _owner;
+};
\ No newline at end of file
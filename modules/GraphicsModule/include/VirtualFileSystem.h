@@ -0,0 +1,71 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+
+#include "VirtualFile.h"
+#include "FileArchive.h"
+
+/// <summary>
+/// The single place our loaders read files through. Files are looked up in the mounted archives first (the most
+/// recently mounted archive wins), and then on disk, so the same paths work whether or not assets have been packed
+/// </summary>
+/// <remarks>
+/// All of the functions are safe to call from any thread, so loaders running on worker threads can use it as well
+/// </remarks>
+class VirtualFileSystem
+{
+public:
+	/// <summary>
+	/// Opens and mounts an archive, returning false if it could not be opened
+	/// </summary>
+	static bool Mount(const std::string& archivePath);
+	/// <summary>
+	/// Mounts an archive that is already open, archives mounted later are searched first
+	/// </summary>
+	static void Mount(const FileArchive::sptr& archive);
+	static void Unmount(const FileArchive::sptr& archive);
+	static void UnmountAll();
+	static std::vector<FileArchive::sptr> GetMounted();
+
+	/// <summary>
+	/// If false, files are only ever read from the mounted archives. Useful to make sure a packed build isn't
+	/// quietly relying on loose files
+	/// </summary>
+	static void SetLooseFilesEnabled(bool enabled);
+	static bool GetLooseFilesEnabled();
+
+	/// <summary>
+	/// Gets whether a file exists in a mounted archive or on disk
+	/// </summary>
+	static bool Exists(const std::string& path);
+	/// <summary>
+	/// Gets whether a file would be read out of a mounted archive rather than from disk
+	/// </summary>
+	static bool IsArchived(const std::string& path);
+	/// <summary>
+	/// Opens a file, returning nullptr if it could not be found
+	/// </summary>
+	static VirtualFile::sptr Open(const std::string& path);
+	/// <summary>
+	/// Reads a whole file into a string, returning false if it could not be found
+	/// </summary>
+	static bool ReadText(const std::string& path, std::string& text);
+
+	/// <summary>
+	/// Gets the number of files that were found in an archive and on disk since we started
+	/// </summary>
+	static uint32_t GetArchiveReads() { return _archiveReads; }
+	static uint32_t GetLooseReads() { return _looseReads; }
+
+protected:
+	VirtualFileSystem() = default;
+	~VirtualFileSystem() = default;
+
+	static std::mutex                     _mutex;
+	static std::vector<FileArchive::sptr> _archives;
+	static bool                           _looseFilesEnabled;
+	static std::atomic<uint32_t>          _archiveReads;
+	static std::atomic<uint32_t>          _looseReads;
+};
\ No newline at end of file
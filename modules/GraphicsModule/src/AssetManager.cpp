@@ -0,0 +1,246 @@
+#include "AssetManager.h"
+
+#include <algorithm>
+
+#include "ObjLoader.h"
+#include "Texture2DData.h"
+#include "TextureCubeMapData.h"
+
+AssetManager::AssetManager(uint32_t threadCount) :
+	MemoryBudget(512ull * 1024 * 1024),
+	_mainThread(std::this_thread::get_id())
+{
+	if (threadCount == 0) {
+		threadCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+		threadCount = std::max(1u, threadCount);
+	}
+	_threads.reserve(threadCount);
+	for (uint32_t ix = 0; ix < threadCount; ix++) {
+		_threads.emplace_back(&AssetManager::_WorkerLoop, this);
+	}
+}
+
+AssetManager::~AssetManager() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+	_wake.notify_all();
+	for (std::thread& thread : _threads) {
+		thread.join();
+	}
+}
+
+AssetManager::Future<Texture2D> AssetManager::LoadTextureAsync(const std::string& path) {
+	return _Load<Texture2D>(AssetType::Texture2D, path,
+		[path]() -> std::shared_ptr<void> {
+			// Note that stb's flip flag is shared between threads, but every load sets it to the same thing
+			Texture2DData::sptr data = Texture2DData::LoadFromFile(path);
+			if (data == nullptr) {
+				throw std::runtime_error("Failed to load image \"" + path + "\"");
+			}
+			return data;
+		},
+		[](const std::shared_ptr<void>& loaded, size_t& bytes) -> std::shared_ptr<void> {
+			Texture2DData::sptr data = std::static_pointer_cast<Texture2DData>(loaded);
+			Texture2D::sptr result = Texture2D::Create();
+			result->LoadData(data);
+			bytes = data->GetDataSize();
+			// The data now lives on the GPU, we don't need to keep the CPU copy around
+			data->ReleaseData();
+			return result;
+		});
+}
+
+AssetManager::Future<TextureCubeMap> AssetManager::LoadCubeMapAsync(const std::string& path) {
+	return _Load<TextureCubeMap>(AssetType::TextureCubeMap, path,
+		[path]() -> std::shared_ptr<void> {
+			TextureCubeMapData::sptr data = TextureCubeMapData::LoadFromImages(path);
+			if (data == nullptr) {
+				throw std::runtime_error("Failed to load cube map \"" + path + "\"");
+			}
+			return data;
+		},
+		[](const std::shared_ptr<void>& loaded, size_t& bytes) -> std::shared_ptr<void> {
+			TextureCubeMapData::sptr data = std::static_pointer_cast<TextureCubeMapData>(loaded);
+			TextureCubeMap::sptr result = TextureCubeMap::Create();
+			result->LoadData(data);
+			bytes = data->GetDataSize();
+			data->ReleaseData();
+			return result;
+		});
+}
+
+AssetManager::Future<VertexArrayObject> AssetManager::LoadMeshAsync(const std::string& path, const glm::vec4& color, const MeshLodSettings& lodSettings, VertexCompression compression) {
+	// Anything that changes what ends up on the GPU has to be part of the key
+	std::string key = path + "|" + std::to_string(color.r) + "," + std::to_string(color.g) + "," + std::to_string(color.b) + "," + std::to_string(color.a) +
+		"|" + std::to_string((int)compression) + "|" + std::to_string(lodSettings.MinTriangleCount) + "," + std::to_string(lodSettings.MaxTriangleRatio);
+	for (float target : lodSettings.ErrorTargets) {
+		key += "," + std::to_string(target);
+	}
+
+	return _Load<VertexArrayObject>(AssetType::Mesh, key,
+		[path, color, lodSettings]() -> std::shared_ptr<void> {
+			std::shared_ptr<MeshBuilder<VertexPosNormTexCol>> mesh = std::make_shared<MeshBuilder<VertexPosNormTexCol>>(ObjLoader::LoadMeshFromFile(path, color));
+			// Simplification is by far the slowest part of loading a mesh, so we get it done while we're off the main thread
+			mesh->PrecomputeLods(lodSettings);
+			return mesh;
+		},
+		[lodSettings, compression](const std::shared_ptr<void>& loaded, size_t& bytes) -> std::shared_ptr<void> {
+			std::shared_ptr<MeshBuilder<VertexPosNormTexCol>> mesh = std::static_pointer_cast<MeshBuilder<VertexPosNormTexCol>>(loaded);
+			VertexArrayObject::sptr result = ObjLoader::Bake(*mesh, lodSettings, compression);
+			bytes = result->GetMemoryUsage();
+			return result;
+		});
+}
+
+Shader::sptr AssetManager::LoadShader(const std::string& vertexPath, const std::string& fragmentPath) {
+	Future<Shader> future = _Load<Shader>(AssetType::Shader, vertexPath + "|" + fragmentPath, nullptr,
+		[vertexPath, fragmentPath](const std::shared_ptr<void>&, size_t& bytes) -> std::shared_ptr<void> {
+			Shader::sptr result = Shader::Create();
+			result->LoadShaderPartFromFile(vertexPath.c_str(), GL_VERTEX_SHADER);
+			result->LoadShaderPartFromFile(fragmentPath.c_str(), GL_FRAGMENT_SHADER);
+			if (!result->Link()) {
+				throw std::runtime_error("Failed to link shader \"" + vertexPath + "\" + \"" + fragmentPath + "\"");
+			}
+			// We can't see how much memory the driver is using for the program, so the size of it's binary is the best guess we have
+			GLint binaryLength = 0;
+			glGetProgramiv(result->GetHandle(), GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+			bytes = static_cast<size_t>(binaryLength);
+			return result;
+		});
+	return future.get();
+}
+
+void AssetManager::Update() {
+	LOG_ASSERT(std::this_thread::get_id() == _mainThread, "Assets can only be updated from the thread that created the asset manager!");
+	_FinishLoads(false);
+	if (_totalBytes > MemoryBudget) {
+		EvictUnused(MemoryBudget);
+	}
+}
+
+uint32_t AssetManager::EvictUnused(size_t targetBytes) {
+	// Gather everything that's loaded and only referenced by us, oldest request first
+	std::vector<std::unordered_map<std::string, Entry>::iterator> candidates;
+	for (auto it = _entries.begin(); it != _entries.end(); it++) {
+		if (it->second.IsLoaded && it->second.Asset.use_count() <= 1) {
+			candidates.push_back(it);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+		return a->second.LastRequested < b->second.LastRequested;
+	});
+
+	uint32_t result = 0;
+	for (auto it : candidates) {
+		if (targetBytes > 0 && _totalBytes <= targetBytes) {
+			break;
+		}
+		TypeStats& stats = _stats[(int)it->second.Type];
+		stats.Count--;
+		stats.Bytes -= it->second.Bytes;
+		stats.Evictions++;
+		_totalBytes -= it->second.Bytes;
+		_entries.erase(it);
+		result++;
+	}
+	return result;
+}
+
+const char* AssetManager::GetTypeName(AssetType type) {
+	switch (type) {
+		case AssetType::Texture2D:      return "Textures";
+		case AssetType::TextureCubeMap: return "Cube Maps";
+		case AssetType::Mesh:           return "Meshes";
+		case AssetType::Shader:         return "Shaders";
+		default:                        return "Unknown";
+	}
+}
+
+bool AssetManager::_IsManaged(const void* asset) const {
+	if (asset == nullptr) {
+		return false;
+	}
+	for (const auto& [key, entry] : _entries) {
+		if (entry.IsLoaded && entry.Asset.lock().get() == asset) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void AssetManager::_WorkerLoop() {
+	while (true) {
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wake.wait(lock, [this]() { return _quit || !_queue.empty(); });
+			if (_quit) {
+				return;
+			}
+			job = std::move(_queue.front());
+			_queue.pop_front();
+		}
+
+		try {
+			job.Data = job.Read();
+		} catch (...) {
+			job.Error = std::current_exception();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_finished.push_back(std::move(job));
+		}
+		_done.notify_all();
+	}
+}
+
+void AssetManager::_FinishLoads(bool block) {
+	std::deque<Job> finished;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		if (block) {
+			_done.wait(lock, [this]() { return !_finished.empty(); });
+		}
+		finished.swap(_finished);
+	}
+
+	for (Job& job : finished) {
+		_pendingCount--;
+		auto it = _entries.find(job.Key);
+		LOG_ASSERT(it != _entries.end(), "Finished loading an asset that we have no entry for!");
+
+		std::shared_ptr<void> asset;
+		size_t bytes = 0;
+		std::exception_ptr error = job.Error;
+		if (!error) {
+			try {
+				asset = job.Finish(job.Data, bytes);
+			} catch (...) {
+				error = std::current_exception();
+			}
+		}
+		_Complete(it->second, asset, bytes, error, job.Key);
+	}
+}
+
+void AssetManager::_Complete(Entry& entry, const std::shared_ptr<void>& asset, size_t bytes, std::exception_ptr error, const std::string& key) {
+	entry.Resolve(asset, error);
+	entry.Resolve = nullptr;
+	if (error) {
+		LOG_WARN("Failed to load asset \"{}\"", key);
+		// Drop the entry so that the next request tries again, anyone holding the future will still see the error
+		_entries.erase(key);
+		return;
+	}
+
+	entry.Asset = asset;
+	entry.Bytes = bytes;
+	entry.IsLoaded = true;
+	TypeStats& stats = _stats[(int)entry.Type];
+	stats.Count++;
+	stats.Bytes += bytes;
+	_totalBytes += bytes;
+}
\ No newline at end of file
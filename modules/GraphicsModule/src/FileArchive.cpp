@@ -0,0 +1,325 @@
+#include "FileArchive.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <zlib.h>
+#include <gzip/compress.hpp>
+
+#include "Logging.h"
+
+#ifdef WINDOWS
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// Bump this whenever the file layout changes, so old archives are refused instead of misread
+static const uint32_t ARCHIVE_VERSION = 1;
+static const char     ARCHIVE_MAGIC[4] = { 'O', 'P', 'A', 'K' };
+
+std::string FileArchive::NormalizePath(const std::string& path) {
+	std::string result = std::filesystem::path(path).lexically_normal().generic_string();
+	if (result.size() >= 2 && result[0] == '.' && result[1] == '/') {
+		result.erase(0, 2);
+	}
+	return result;
+}
+
+uint64_t FileArchive::_Hash(const std::string& path) {
+	// FNV-1a, same as the rest of our lookups
+	uint64_t hash = 14695981039346656037ull;
+	for (char c : path) {
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+FileArchive::FileArchive() = default;
+
+FileArchive::~FileArchive() {
+	_Unmap();
+}
+
+FileArchive::sptr FileArchive::Open(const std::string& path) {
+	FileArchive::sptr result = std::make_shared<FileArchive>();
+	if (!result->_Map(path)) {
+		LOG_WARN("Could not open archive \"{}\"", path);
+		return nullptr;
+	}
+	result->_path = path;
+
+	// Check everything the index points at up front, so that lookups can trust it
+	Header header;
+	if (result->_size < sizeof(Header)) {
+		LOG_WARN("\"{}\" is too small to be an archive", path);
+		return nullptr;
+	}
+	memcpy(&header, result->_data, sizeof(Header));
+	if (memcmp(header.Magic, ARCHIVE_MAGIC, 4) != 0 || header.Version != ARCHIVE_VERSION) {
+		LOG_WARN("\"{}\" is not an archive, or was built by a different version", path);
+		return nullptr;
+	}
+	const uint64_t indexSize = (uint64_t)header.EntryCount * sizeof(Entry);
+	if (header.IndexOffset % alignof(Entry) != 0 || header.IndexOffset + indexSize > result->_size) {
+		LOG_WARN("Archive \"{}\" has a corrupt index", path);
+		return nullptr;
+	}
+	result->_entries = reinterpret_cast<const Entry*>(result->_data + header.IndexOffset);
+	result->_entryCount = header.EntryCount;
+	result->_paths = reinterpret_cast<const char*>(result->_data + header.IndexOffset + indexSize);
+	const uint64_t pathsSize = result->_size - header.IndexOffset - indexSize;
+	for (size_t ix = 0; ix < result->_entryCount; ix++) {
+		const Entry& entry = result->_entries[ix];
+		if (entry.Offset + entry.StoredSize > header.IndexOffset || (uint64_t)entry.PathOffset + entry.PathLength > pathsSize ||
+			entry.Compression > (uint32_t)ArchiveCompression::Gzip) {
+			LOG_WARN("Archive \"{}\" has a corrupt entry at index {}", path, ix);
+			return nullptr;
+		}
+	}
+	return result;
+}
+
+int64_t FileArchive::_Find(const std::string& path) const {
+	const std::string normalized = NormalizePath(path);
+	const uint64_t hash = _Hash(normalized);
+	const Entry* end = _entries + _entryCount;
+	const Entry* it = std::lower_bound(_entries, end, hash, [](const Entry& entry, uint64_t value) { return entry.PathHash < value; });
+	// Different paths can share a hash, so we check every entry with it
+	for (; it != end && it->PathHash == hash; it++) {
+		if (it->PathLength == normalized.size() && memcmp(_paths + it->PathOffset, normalized.data(), normalized.size()) == 0) {
+			return it - _entries;
+		}
+	}
+	return -1;
+}
+
+VirtualFile::sptr FileArchive::OpenFile(const std::string& path) const {
+	const int64_t index = _Find(path);
+	if (index < 0) {
+		return nullptr;
+	}
+	const Entry& entry = _entries[index];
+	const uint8_t* data = _data + entry.Offset;
+
+	if (entry.Compression == (uint32_t)ArchiveCompression::None) {
+		// The file keeps us mapped for as long as anyone is using it
+		return VirtualFile::CreateView(data, static_cast<size_t>(entry.Size), shared_from_this());
+	}
+
+	// We know how big the entry is, so it's inflated straight into a buffer of the right size in one go
+	std::vector<uint8_t> result(static_cast<size_t>(entry.Size));
+	z_stream stream = {};
+	stream.next_in = const_cast<Bytef*>(data);
+	stream.avail_in = static_cast<uInt>(entry.StoredSize);
+	stream.next_out = result.data();
+	stream.avail_out = static_cast<uInt>(result.size());
+	// 15 + 32 lets zlib detect the gzip header itself
+	if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+		LOG_ERROR("Failed to start decompressing \"{}\" from archive \"{}\"", path, _path);
+		return nullptr;
+	}
+	const int status = inflate(&stream, Z_FINISH);
+	inflateEnd(&stream);
+	if (status != Z_STREAM_END || stream.total_out != entry.Size) {
+		LOG_ERROR("Failed to decompress \"{}\" from archive \"{}\"", path, _path);
+		return nullptr;
+	}
+	return VirtualFile::Create(std::move(result));
+}
+
+std::vector<FileArchive::EntryInfo> FileArchive::GetEntries() const {
+	std::vector<EntryInfo> result;
+	result.reserve(_entryCount);
+	for (size_t ix = 0; ix < _entryCount; ix++) {
+		const Entry& entry = _entries[ix];
+		result.push_back({ std::string(_paths + entry.PathOffset, entry.PathLength), (ArchiveCompression)entry.Compression,
+			entry.Offset, entry.StoredSize, entry.Size });
+	}
+	return result;
+}
+
+bool FileArchive::Build(const std::string& outputPath, const std::string& rootDirectory, const ArchiveBuildSettings& settings) {
+	LOG_ASSERT(settings.Alignment > 0 && (settings.Alignment & (settings.Alignment - 1)) == 0, "Alignment must be a power of two, got {}", settings.Alignment);
+	namespace fs = std::filesystem;
+
+	std::error_code error;
+	if (!fs::is_directory(rootDirectory, error)) {
+		LOG_ERROR("\"{}\" is not a directory", rootDirectory);
+		return false;
+	}
+
+	// Sorting the files keeps archives built from the same folder identical, and keeps files from the same folder together
+	std::vector<std::string> files;
+	const fs::path outputFull = fs::weakly_canonical(outputPath, error);
+	for (const auto& item : fs::recursive_directory_iterator(rootDirectory, error)) {
+		if (item.is_regular_file() && fs::weakly_canonical(item.path(), error) != outputFull) {
+			files.push_back(NormalizePath(fs::relative(item.path(), rootDirectory).generic_string()));
+		}
+	}
+	std::sort(files.begin(), files.end());
+
+	std::ofstream output(outputPath, std::ios::binary);
+	if (!output.is_open()) {
+		LOG_ERROR("Could not open \"{}\" for writing", outputPath);
+		return false;
+	}
+
+	// The header is written again at the end, once we know where the index is
+	Header header;
+	memcpy(header.Magic, ARCHIVE_MAGIC, 4);
+	header.Version = ARCHIVE_VERSION;
+	header.EntryCount = static_cast<uint32_t>(files.size());
+	header.Alignment = settings.Alignment;
+	header.IndexOffset = 0;
+	output.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+	uint64_t offset = sizeof(Header);
+
+	const char zeros[256] = {};
+	auto pad = [&](uint64_t alignment) {
+		while (offset % alignment != 0) {
+			const uint64_t count = std::min<uint64_t>(alignment - offset % alignment, sizeof(zeros));
+			output.write(zeros, count);
+			offset += count;
+		}
+	};
+
+	std::vector<Entry> entries;
+	entries.reserve(files.size());
+	std::string paths;
+	uint64_t totalSize = 0;
+	uint64_t totalStored = 0;
+	std::vector<char> data;
+	for (const std::string& file : files) {
+		std::ifstream input(fs::path(rootDirectory) / file, std::ios::binary | std::ios::ate);
+		if (!input.is_open()) {
+			LOG_ERROR("Could not read \"{}\"", file);
+			return false;
+		}
+		data.resize(static_cast<size_t>(input.tellg()));
+		input.seekg(0);
+		input.read(data.data(), data.size());
+
+		Entry entry = {};
+		entry.PathHash = _Hash(file);
+		entry.Size = data.size();
+		entry.PathOffset = static_cast<uint32_t>(paths.size());
+		entry.PathLength = static_cast<uint32_t>(file.size());
+		entry.Compression = (uint32_t)ArchiveCompression::None;
+		paths += file;
+
+		std::string compressed;
+		if (settings.Compress && !data.empty()) {
+			compressed = gzip::compress(data.data(), data.size(), Z_BEST_COMPRESSION);
+			if (compressed.size() <= data.size() * settings.MinCompressionRatio) {
+				entry.Compression = (uint32_t)ArchiveCompression::Gzip;
+			}
+		}
+
+		pad(settings.Alignment);
+		entry.Offset = offset;
+		if (entry.Compression == (uint32_t)ArchiveCompression::Gzip) {
+			entry.StoredSize = compressed.size();
+			output.write(compressed.data(), compressed.size());
+		} else {
+			entry.StoredSize = data.size();
+			output.write(data.data(), data.size());
+		}
+		offset += entry.StoredSize;
+		totalSize += entry.Size;
+		totalStored += entry.StoredSize;
+		entries.push_back(entry);
+	}
+
+	pad(alignof(Entry));
+	header.IndexOffset = offset;
+	std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.PathHash < b.PathHash; });
+	output.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+	output.write(paths.data(), paths.size());
+	output.seekp(0);
+	output.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+	output.close();
+	if (!output) {
+		LOG_ERROR("Failed to write archive \"{}\"", outputPath);
+		return false;
+	}
+
+	LOG_INFO("Packed {} files ({} KB) into \"{}\" ({} KB stored)", files.size(), totalSize / 1024, outputPath, totalStored / 1024);
+	return true;
+}
+
+bool FileArchive::_Map(const std::string& path) {
+#ifdef WINDOWS
+	// Lookups jump all over the file, so we tell Windows not to bother reading ahead
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	_fileHandle = file;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+		_Unmap();
+		return false;
+	}
+	_size = static_cast<size_t>(size.QuadPart);
+	_mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (_mappingHandle == nullptr) {
+		_Unmap();
+		return false;
+	}
+	_data = static_cast<const uint8_t*>(MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+	_fileDescriptor = open(path.c_str(), O_RDONLY);
+	if (_fileDescriptor < 0) {
+		return false;
+	}
+	struct stat info;
+	if (fstat(_fileDescriptor, &info) != 0 || info.st_size == 0) {
+		_Unmap();
+		return false;
+	}
+	_size = static_cast<size_t>(info.st_size);
+	void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fileDescriptor, 0);
+	if (data != MAP_FAILED) {
+		madvise(data, _size, MADV_RANDOM);
+		_data = static_cast<const uint8_t*>(data);
+	}
+#endif
+	if (_data == nullptr) {
+		_Unmap();
+		return false;
+	}
+	return true;
+}
+
+void FileArchive::_Unmap() {
+#ifdef WINDOWS
+	if (_data != nullptr) {
+		UnmapViewOfFile(_data);
+	}
+	if (_mappingHandle != nullptr) {
+		CloseHandle(_mappingHandle);
+	}
+	if (_fileHandle != nullptr) {
+		CloseHandle(_fileHandle);
+	}
+#else
+	if (_data != nullptr) {
+		munmap(const_cast<uint8_t*>(_data), _size);
+	}
+	if (_fileDescriptor >= 0) {
+		close(_fileDescriptor);
+	}
+#endif
+	_data = nullptr;
+	_size = 0;
+	_mappingHandle = nullptr;
+	_fileHandle = nullptr;
+	_fileDescriptor = -1;
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "FrustumCuller.h"
+
+#include <xmmintrin.h>
+
+void FrustumCuller::Clear() {
+	_count = 0;
+	_visibleCount = 0;
+	_centerX.clear(); _centerY.clear(); _centerZ.clear();
+	_extentX.clear(); _extentY.clear(); _extentZ.clear();
+	_visible.clear();
+}
+
+void FrustumCuller::Reserve(size_t count) {
+	count = (count + 3) & ~(size_t)3;
+	_centerX.reserve(count); _centerY.reserve(count); _centerZ.reserve(count);
+	_extentX.reserve(count); _extentY.reserve(count); _extentZ.reserve(count);
+	_visible.reserve(count);
+}
+
+uint32_t FrustumCuller::Add(const AxisAlignedBox& bounds) {
+	glm::vec3 center = bounds.GetCenter();
+	glm::vec3 extents = bounds.GetExtents();
+	// Invalid boxes get an infinite extent so that they are never culled
+	if (!bounds.IsValid()) {
+		center = glm::vec3(0.0f);
+		extents = glm::vec3(FLT_MAX);
+	}
+	_centerX.push_back(center.x); _centerY.push_back(center.y); _centerZ.push_back(center.z);
+	_extentX.push_back(extents.x); _extentY.push_back(extents.y); _extentZ.push_back(extents.z);
+	_visible.push_back(1);
+	return _count++;
+}
+
+void FrustumCuller::ExtractPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6]) {
+	// Gribb/Hartmann plane extraction, GLM matrices are column major so we build the rows first
+	const glm::vec4 row0 = glm::vec4(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+	const glm::vec4 row1 = glm::vec4(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+	const glm::vec4 row2 = glm::vec4(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+	const glm::vec4 row3 = glm::vec4(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+	planes[0] = row3 + row0; // Left
+	planes[1] = row3 - row0; // Right
+	planes[2] = row3 + row1; // Bottom
+	planes[3] = row3 - row1; // Top
+	planes[4] = row3 + row2; // Near
+	planes[5] = row3 - row2; // Far
+	for (int ix = 0; ix < 6; ix++) {
+		planes[ix] /= glm::length(glm::vec3(planes[ix]));
+	}
+}
+
+bool FrustumCuller::TestBox(const glm::vec4 planes[6], const AxisAlignedBox& bounds) {
+	if (!bounds.IsValid()) {
+		return true;
+	}
+	const glm::vec3 center = bounds.GetCenter();
+	const glm::vec3 extents = bounds.GetExtents();
+	for (int ix = 0; ix < 6; ix++) {
+		const glm::vec3 normal = glm::vec3(planes[ix]);
+		const float dist = glm::dot(normal, center) + planes[ix].w;
+		const float radius = glm::dot(glm::abs(normal), extents);
+		if (dist < -radius) {
+			return false;
+		}
+	}
+	return true;
+}
+
+uint32_t FrustumCuller::Cull(const glm::mat4& viewProjection) {
+	glm::vec4 planes[6];
+	ExtractPlanes(viewProjection, planes);
+	return Cull(planes, 6);
+}
+
+uint32_t FrustumCuller::Cull(const glm::vec4* planes, int planeCount) {
+	planeCount = planeCount < 6 ? planeCount : 6;
+
+	// Pad the arrays out to a multiple of 4 with empty boxes at the origin, so the loop below has no remainder
+	const size_t padded = (_count + 3) & ~(size_t)3;
+	_centerX.resize(padded, 0.0f); _centerY.resize(padded, 0.0f); _centerZ.resize(padded, 0.0f);
+	_extentX.resize(padded, 0.0f); _extentY.resize(padded, 0.0f); _extentZ.resize(padded, 0.0f);
+	_visible.resize(padded, 0);
+
+	// Splat each plane, and it's absolute normal, into SSE registers once up front
+	__m128 planeX[6], planeY[6], planeZ[6], planeW[6], absX[6], absY[6], absZ[6];
+	for (int ix = 0; ix < planeCount; ix++) {
+		planeX[ix] = _mm_set1_ps(planes[ix].x);
+		planeY[ix] = _mm_set1_ps(planes[ix].y);
+		planeZ[ix] = _mm_set1_ps(planes[ix].z);
+		planeW[ix] = _mm_set1_ps(planes[ix].w);
+		absX[ix] = _mm_set1_ps(glm::abs(planes[ix].x));
+		absY[ix] = _mm_set1_ps(glm::abs(planes[ix].y));
+		absZ[ix] = _mm_set1_ps(glm::abs(planes[ix].z));
+	}
+
+	uint32_t visibleCount = 0;
+	for (size_t ix = 0; ix < padded; ix += 4) {
+		const __m128 cx = _mm_loadu_ps(&_centerX[ix]);
+		const __m128 cy = _mm_loadu_ps(&_centerY[ix]);
+		const __m128 cz = _mm_loadu_ps(&_centerZ[ix]);
+		const __m128 ex = _mm_loadu_ps(&_extentX[ix]);
+		const __m128 ey = _mm_loadu_ps(&_extentY[ix]);
+		const __m128 ez = _mm_loadu_ps(&_extentZ[ix]);
+
+		// A box is outside if it is fully behind any plane, ie: dot(n, c) + d < -dot(|n|, e)
+		__m128 outside = _mm_setzero_ps();
+		for (int p = 0; p < planeCount; p++) {
+			const __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], cx), _mm_mul_ps(planeY[p], cy)), _mm_add_ps(_mm_mul_ps(planeZ[p], cz), planeW[p]));
+			const __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absX[p], ex), _mm_mul_ps(absY[p], ey)), _mm_mul_ps(absZ[p], ez));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(dist, radius), _mm_setzero_ps()));
+		}
+
+		const int mask = _mm_movemask_ps(outside);
+		for (size_t lane = 0; lane < 4; lane++) {
+			const uint8_t visible = (mask & (1 << lane)) == 0 ? 1 : 0;
+			_visible[ix + lane] = visible;
+			if (ix + lane < _count) {
+				visibleCount += visible;
+			}
+		}
+	}
+	_visibleCount = visibleCount;
+
+	// Drop the padding so that further calls to Add append to the real entries
+	_centerX.resize(_count); _centerY.resize(_count); _centerZ.resize(_count);
+	_extentX.resize(_count); _extentY.resize(_count); _extentZ.resize(_count);
+	_visible.resize(_count);
+
+	return visibleCount;
+}
\ No newline at end of file
@@ -0,0 +1,410 @@
+#include "MeshSimplifier.h"
+
+#include <queue>
+#include <cfloat>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+#include <GLM/glm.hpp>
+
+#pragma region Helpers
+
+namespace {
+// A symmetric 4x4 matrix representing the sum of squared distances to a set of planes
+struct Quadric {
+	double A2, AB, AC, AD, B2, BC, BD, C2, CD, D2;
+
+	Quadric() : A2(0), AB(0), AC(0), AD(0), B2(0), BC(0), BD(0), C2(0), CD(0), D2(0) { }
+	Quadric(const glm::dvec3& normal, double d, double weight) {
+		A2 = normal.x * normal.x * weight; AB = normal.x * normal.y * weight; AC = normal.x * normal.z * weight; AD = normal.x * d * weight;
+		B2 = normal.y * normal.y * weight; BC = normal.y * normal.z * weight; BD = normal.y * d * weight;
+		C2 = normal.z * normal.z * weight; CD = normal.z * d * weight;
+		D2 = d * d * weight;
+	}
+
+	Quadric& operator +=(const Quadric& other) {
+		A2 += other.A2; AB += other.AB; AC += other.AC; AD += other.AD;
+		B2 += other.B2; BC += other.BC; BD += other.BD;
+		C2 += other.C2; CD += other.CD;
+		D2 += other.D2;
+		return *this;
+	}
+	Quadric operator +(const Quadric& other) const {
+		Quadric result = *this;
+		result += other;
+		return result;
+	}
+
+	// Gets the sum of squared distances from the point to all the planes in this quadric
+	double Evaluate(const glm::vec3& p) const {
+		const double x = p.x, y = p.y, z = p.z;
+		const double result =
+			A2 * x * x + 2.0 * AB * x * y + 2.0 * AC * x * z + 2.0 * AD * x +
+			B2 * y * y + 2.0 * BC * y * z + 2.0 * BD * y +
+			C2 * z * z + 2.0 * CD * z +
+			D2;
+		return result < 0.0 ? 0.0 : result;
+	}
+};
+
+// A candidate collapse of From onto To
+struct Collapse {
+	double   Cost;
+	uint32_t From;
+	uint32_t To;
+	uint32_t FromVersion;
+	uint32_t ToVersion;
+
+	bool operator >(const Collapse& other) const { return Cost > other.Cost; }
+};
+
+struct PositionKey {
+	uint32_t X, Y, Z;
+	bool operator ==(const PositionKey& other) const { return X == other.X && Y == other.Y && Z == other.Z; }
+};
+
+struct PositionKeyHash {
+	size_t operator()(const PositionKey& key) const {
+		return (size_t)key.X * 73856093u ^ (size_t)key.Y * 19349663u ^ (size_t)key.Z * 83492791u;
+	}
+};
+}
+
+// Weight applied to the planes we add along open edges, keeps the silhouette of open meshes from eroding
+static const double BOUNDARY_WEIGHT = 10.0;
+// Collapses that rotate a triangle's normal by more than ~80 degrees are rejected to avoid folding the mesh over
+static const float  FLIP_THRESHOLD = 0.2f;
+
+#pragma endregion
+
+float MeshSimplifier::Simplify(const void* vertices, size_t vertexStride, size_t positionOffset, size_t vertexCount,
+	const std::vector<uint32_t>& indices, float targetError, size_t targetIndexCount, std::vector<uint32_t>& result)
+{
+	result.clear();
+	const uint8_t* vertexBytes = reinterpret_cast<const uint8_t*>(vertices);
+	const size_t floatCount = vertexStride / sizeof(float);
+	const size_t positionFloat = positionOffset / sizeof(float);
+	auto GetPosition = [&](uint32_t vertex) -> const glm::vec3& {
+		return *reinterpret_cast<const glm::vec3*>(vertexBytes + vertex * vertexStride + positionOffset);
+	};
+
+	// Weld vertices that share a position, attribute seams (UVs, hard normals) split vertices that we still want
+	// to treat as connected
+	std::vector<uint32_t> renderToWeld(vertexCount);
+	std::vector<glm::vec3> positions;
+	std::vector<std::vector<uint32_t>> weldToRender;
+	{
+		std::unordered_map<PositionKey, uint32_t, PositionKeyHash> weldMap;
+		weldMap.reserve(vertexCount);
+		for (uint32_t ix = 0; ix < vertexCount; ix++) {
+			const glm::vec3& pos = GetPosition(ix);
+			PositionKey key;
+			memcpy(&key, &pos, sizeof(PositionKey));
+			auto it = weldMap.find(key);
+			if (it == weldMap.end()) {
+				it = weldMap.emplace(key, static_cast<uint32_t>(positions.size())).first;
+				positions.push_back(pos);
+				weldToRender.emplace_back();
+			}
+			renderToWeld[ix] = it->second;
+			weldToRender[it->second].push_back(ix);
+		}
+	}
+	const uint32_t weldCount = static_cast<uint32_t>(positions.size());
+
+	// Build our working triangle list and vertex -> triangle adjacency
+	const uint32_t triCount = static_cast<uint32_t>(indices.size() / 3);
+	std::vector<glm::uvec3> tris(triCount);
+	std::vector<bool> triAlive(triCount, true);
+	std::vector<std::vector<uint32_t>> vertTris(weldCount);
+	uint32_t aliveCount = 0;
+	for (uint32_t ix = 0; ix < triCount; ix++) {
+		tris[ix] = glm::uvec3(renderToWeld[indices[ix * 3 + 0]], renderToWeld[indices[ix * 3 + 1]], renderToWeld[indices[ix * 3 + 2]]);
+		if (tris[ix].x == tris[ix].y || tris[ix].y == tris[ix].z || tris[ix].z == tris[ix].x) {
+			triAlive[ix] = false;
+			continue;
+		}
+		aliveCount++;
+		for (int c = 0; c < 3; c++) {
+			vertTris[tris[ix][c]].push_back(ix);
+		}
+	}
+
+	// Accumulate the plane quadrics for each vertex, and find open edges
+	std::vector<Quadric> quadrics(weldCount);
+	std::unordered_map<uint64_t, uint32_t> edgeUses;
+	edgeUses.reserve(aliveCount * 3);
+	auto EdgeKey = [](uint32_t a, uint32_t b) { return a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a; };
+	for (uint32_t ix = 0; ix < triCount; ix++) {
+		if (!triAlive[ix]) continue;
+		const glm::dvec3 p0 = positions[tris[ix].x], p1 = positions[tris[ix].y], p2 = positions[tris[ix].z];
+		glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+		const double length = glm::length(normal);
+		if (length > 0.0) {
+			normal /= length;
+			const Quadric q = Quadric(normal, -glm::dot(normal, p0), 1.0);
+			for (int c = 0; c < 3; c++) {
+				quadrics[tris[ix][c]] += q;
+			}
+		}
+		for (int c = 0; c < 3; c++) {
+			edgeUses[EdgeKey(tris[ix][c], tris[ix][(c + 1) % 3])]++;
+		}
+	}
+	std::vector<bool> isBoundary(weldCount, false);
+	for (uint32_t ix = 0; ix < triCount; ix++) {
+		if (!triAlive[ix]) continue;
+		const glm::dvec3 p0 = positions[tris[ix].x], p1 = positions[tris[ix].y], p2 = positions[tris[ix].z];
+		const glm::dvec3 faceNormal = glm::cross(p1 - p0, p2 - p0);
+		for (int c = 0; c < 3; c++) {
+			const uint32_t a = tris[ix][c], b = tris[ix][(c + 1) % 3];
+			if (edgeUses[EdgeKey(a, b)] != 1) continue;
+			isBoundary[a] = isBoundary[b] = true;
+			// Add a plane perpendicular to the face along the open edge
+			const glm::dvec3 pa = positions[a], pb = positions[b];
+			glm::dvec3 normal = glm::cross(pb - pa, faceNormal);
+			const double length = glm::length(normal);
+			if (length > 0.0) {
+				normal /= length;
+				const Quadric q = Quadric(normal, -glm::dot(normal, pa), BOUNDARY_WEIGHT * glm::dot(pb - pa, pb - pa));
+				quadrics[a] += q;
+				quadrics[b] += q;
+			}
+		}
+	}
+
+	auto AttributeDistance = [&](uint32_t a, uint32_t b) {
+		const float* fa = reinterpret_cast<const float*>(vertexBytes + a * vertexStride);
+		const float* fb = reinterpret_cast<const float*>(vertexBytes + b * vertexStride);
+		float result = 0.0f;
+		for (size_t ix = 0; ix < floatCount; ix++) {
+			if (ix >= positionFloat && ix < positionFloat + 3) continue;
+			result += (fa[ix] - fb[ix]) * (fa[ix] - fb[ix]);
+		}
+		return result;
+	};
+	// Finds the render vertex at a welded position whose attributes are closest to another render vertex's
+	auto ClosestRender = [&](uint32_t render, uint32_t weld) {
+		uint32_t best = weldToRender[weld][0];
+		float bestDistance = AttributeDistance(render, best);
+		for (size_t ix = 1; ix < weldToRender[weld].size(); ix++) {
+			const float distance = AttributeDistance(render, weldToRender[weld][ix]);
+			if (distance < bestDistance) {
+				best = weldToRender[weld][ix];
+				bestDistance = distance;
+			}
+		}
+		return best;
+	};
+
+	// Render vertices at the same position with the same attributes are the same copy of the vertex, duplicates
+	// (ex: from meshes that aren't indexed) don't make a seam
+	std::vector<uint32_t> renderCopy(vertexCount);
+	for (uint32_t ix = 0; ix < vertexCount; ix++) {
+		renderCopy[ix] = ClosestRender(ix, renderToWeld[ix]);
+	}
+
+	// Vertices that are split by attributes may only collapse along the seam, otherwise we would tear it open
+	std::vector<bool> isSeam(weldCount, false);
+	for (uint32_t ix = 0; ix < weldCount; ix++) {
+		for (uint32_t render : weldToRender[ix]) {
+			isSeam[ix] = isSeam[ix] || renderCopy[render] != renderCopy[weldToRender[ix][0]];
+		}
+	}
+	// The copy of the vertex used by each triangle corner, kept up to date as vertices collapse so that we know which
+	// side of a seam each corner is on
+	std::vector<uint32_t> cornerCopy(triCount * 3);
+	for (uint32_t ix = 0; ix < triCount * 3; ix++) {
+		cornerCopy[ix] = renderCopy[indices[ix]];
+	}
+
+	std::vector<uint32_t> versions(weldCount, 0);
+	std::vector<uint32_t> remap(weldCount);
+	for (uint32_t ix = 0; ix < weldCount; ix++) {
+		remap[ix] = ix;
+	}
+
+	// A seam vertex may only slide along it's own seam, so the edge has to be a seam edge too. The triangles on the edge
+	// need to split both ends in the same places, and between them use every copy of the vertex that is moving
+	std::vector<uint32_t> edgeFrom, edgeTo, allFrom;
+	auto CountCopies = [](std::vector<uint32_t>& copies) {
+		std::sort(copies.begin(), copies.end());
+		return (size_t)(std::unique(copies.begin(), copies.end()) - copies.begin());
+	};
+	auto IsSeamEdge = [&](uint32_t from, uint32_t to) {
+		edgeFrom.clear();
+		edgeTo.clear();
+		allFrom.clear();
+		for (uint32_t tri : vertTris[from]) {
+			if (!triAlive[tri]) continue;
+			const glm::uvec3& t = tris[tri];
+			const uint32_t cornerFrom = tri * 3 + (t.x == from ? 0 : (t.y == from ? 1 : 2));
+			allFrom.push_back(cornerCopy[cornerFrom]);
+			if (t.x != to && t.y != to && t.z != to) continue;
+			const uint32_t cornerTo = tri * 3 + (t.x == to ? 0 : (t.y == to ? 1 : 2));
+			edgeFrom.push_back(cornerCopy[cornerFrom]);
+			edgeTo.push_back(cornerCopy[cornerTo]);
+		}
+		for (size_t i = 0; i < edgeFrom.size(); i++) {
+			for (size_t j = i + 1; j < edgeFrom.size(); j++) {
+				if ((edgeFrom[i] == edgeFrom[j]) != (edgeTo[i] == edgeTo[j])) return false;
+			}
+		}
+		const size_t edgeCopies = CountCopies(edgeFrom);
+		return edgeCopies > 1 && edgeCopies == CountCopies(allFrom);
+	};
+
+	auto CanCollapse = [&](uint32_t from, uint32_t to) {
+		return (!isBoundary[from] || isBoundary[to]) && (!isSeam[from] || (isSeam[to] && IsSeamEdge(from, to)));
+	};
+
+	std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> queue;
+	auto PushEdge = [&](uint32_t a, uint32_t b) {
+		const Quadric q = quadrics[a] + quadrics[b];
+		const bool ab = CanCollapse(a, b), ba = CanCollapse(b, a);
+		if (!ab && !ba) return;
+		const double costAB = ab ? q.Evaluate(positions[b]) : DBL_MAX;
+		const double costBA = ba ? q.Evaluate(positions[a]) : DBL_MAX;
+		if (costAB <= costBA) {
+			queue.push({ costAB, a, b, versions[a], versions[b] });
+		} else {
+			queue.push({ costBA, b, a, versions[b], versions[a] });
+		}
+	};
+	for (uint32_t ix = 0; ix < triCount; ix++) {
+		if (!triAlive[ix]) continue;
+		for (int c = 0; c < 3; c++) {
+			const uint32_t a = tris[ix][c], b = tris[ix][(c + 1) % 3];
+			// Each interior edge appears in two triangles, only push it once
+			if (a < b || edgeUses[EdgeKey(a, b)] == 1) {
+				PushEdge(a, b);
+			}
+		}
+	}
+
+	edgeUses.clear();
+
+	const double maxCost = (double)targetError * targetError;
+	const uint32_t targetTris = static_cast<uint32_t>(targetIndexCount / 3);
+	double worstCost = 0.0;
+	std::vector<uint32_t> neighboursFrom, neighboursTo;
+
+	auto GatherNeighbours = [&](uint32_t vertex, std::vector<uint32_t>& out) {
+		out.clear();
+		for (uint32_t tri : vertTris[vertex]) {
+			if (!triAlive[tri]) continue;
+			for (int c = 0; c < 3; c++) {
+				if (tris[tri][c] != vertex) out.push_back(tris[tri][c]);
+			}
+		}
+		std::sort(out.begin(), out.end());
+		out.erase(std::unique(out.begin(), out.end()), out.end());
+	};
+
+	while (aliveCount > targetTris && !queue.empty()) {
+		const Collapse collapse = queue.top();
+		queue.pop();
+		if (collapse.Cost > maxCost) {
+			break;
+		}
+		const uint32_t from = collapse.From, to = collapse.To;
+		// Skip stale entries, the vertices have changed since this was pushed
+		if (remap[from] != from || remap[to] != to || versions[from] != collapse.FromVersion || versions[to] != collapse.ToVersion) {
+			continue;
+		}
+
+		// Link condition, the two vertices may only share the neighbours that are part of the triangles on the edge
+		GatherNeighbours(from, neighboursFrom);
+		GatherNeighbours(to, neighboursTo);
+		uint32_t sharedTris = 0;
+		for (uint32_t tri : vertTris[from]) {
+			if (triAlive[tri] && (tris[tri].x == to || tris[tri].y == to || tris[tri].z == to)) sharedTris++;
+		}
+		if (sharedTris == 0) continue;
+		uint32_t sharedNeighbours = 0;
+		for (size_t i = 0, j = 0; i < neighboursFrom.size() && j < neighboursTo.size();) {
+			if (neighboursFrom[i] < neighboursTo[j]) i++;
+			else if (neighboursFrom[i] > neighboursTo[j]) j++;
+			else { sharedNeighbours++; i++; j++; }
+		}
+		if (sharedNeighbours > sharedTris) continue;
+
+		// Make sure none of the remaining triangles around the vertex fold over
+		bool flips = false;
+		for (uint32_t tri : vertTris[from]) {
+			if (!triAlive[tri]) continue;
+			const glm::uvec3 t = tris[tri];
+			if (t.x == to || t.y == to || t.z == to) continue;
+			const glm::vec3 p0 = positions[t.x], p1 = positions[t.y], p2 = positions[t.z];
+			const glm::vec3 n0 = t.x == from ? positions[to] : p0;
+			const glm::vec3 n1 = t.y == from ? positions[to] : p1;
+			const glm::vec3 n2 = t.z == from ? positions[to] : p2;
+			const glm::vec3 before = glm::cross(p1 - p0, p2 - p0);
+			const glm::vec3 after = glm::cross(n1 - n0, n2 - n0);
+			const float afterLength = glm::length(after);
+			if (afterLength <= 0.0f || glm::dot(before, after) < FLIP_THRESHOLD * glm::length(before) * afterLength) {
+				flips = true;
+				break;
+			}
+		}
+		if (flips) continue;
+
+		// Perform the collapse
+		remap[from] = to;
+		quadrics[to] += quadrics[from];
+		versions[to]++;
+		worstCost = glm::max(worstCost, collapse.Cost);
+		for (uint32_t tri : vertTris[from]) {
+			if (!triAlive[tri]) continue;
+			glm::uvec3& t = tris[tri];
+			if (t.x == to || t.y == to || t.z == to) {
+				triAlive[tri] = false;
+				aliveCount--;
+			} else {
+				for (int c = 0; c < 3; c++) {
+					if (t[c] == from) {
+						t[c] = to;
+						cornerCopy[tri * 3 + c] = renderCopy[ClosestRender(cornerCopy[tri * 3 + c], to)];
+					}
+				}
+				vertTris[to].push_back(tri);
+			}
+		}
+		vertTris[from].clear();
+		vertTris[to].erase(std::remove_if(vertTris[to].begin(), vertTris[to].end(), [&](uint32_t tri) { return !triAlive[tri]; }), vertTris[to].end());
+
+		GatherNeighbours(to, neighboursTo);
+		for (uint32_t neighbour : neighboursTo) {
+			PushEdge(neighbour, to);
+		}
+	}
+
+	// Map each corner back to a real vertex. When a corner's vertex was collapsed, we pick the vertex at the
+	// destination position whose attributes are closest to the original, so seams keep their attributes
+	auto FindRoot = [&](uint32_t weld) {
+		while (remap[weld] != weld) weld = remap[weld];
+		return weld;
+	};
+	std::vector<uint32_t> renderRemap(vertexCount, UINT32_MAX);
+	auto MapCorner = [&](uint32_t render) {
+		if (renderRemap[render] == UINT32_MAX) {
+			const uint32_t root = FindRoot(renderToWeld[render]);
+			if (root == renderToWeld[render]) {
+				renderRemap[render] = render;
+			} else {
+				renderRemap[render] = ClosestRender(render, root);
+			}
+		}
+		return renderRemap[render];
+	};
+
+	result.reserve(aliveCount * 3);
+	for (uint32_t ix = 0; ix < triCount; ix++) {
+		if (!triAlive[ix]) continue;
+		for (int c = 0; c < 3; c++) {
+			result.push_back(MapCorner(indices[ix * 3 + c]));
+		}
+	}
+
+	return static_cast<float>(glm::sqrt(worstCost));
+}
@@ -7,17 +7,24 @@
 #include <unordered_map>
 
 #include "StringUtils.h"
+#include "VirtualFileSystem.h"
 
-VertexArrayObject::sptr ObjLoader::LoadFromFile(const std::string& filename, const glm::vec4& inColor)
+VertexArrayObject::sptr ObjLoader::LoadFromFile(const std::string& filename, const glm::vec4& inColor, const MeshLodSettings& lodSettings, VertexCompression compression)
+{
+	MeshBuilder<VertexPosNormTexCol> mesh = LoadMeshFromFile(filename, inColor);
+	return Bake(mesh, lodSettings, compression);
+}
+
+MeshBuilder<VertexPosNormTexCol> ObjLoader::LoadMeshFromFile(const std::string& filename, const glm::vec4& inColor)
 {	
-	// Open our file in binary mode
-	std::ifstream file;
-	file.open(filename, std::ios::binary);
+	// Read the whole file through the virtual file system, so it can come from an archive
+	std::string contents;
 
 	// If our file fails to open, we will throw an error
-	if (!file) {
+	if (!VirtualFileSystem::ReadText(filename, contents)) {
 		throw std::runtime_error("Failed to open file");
 	}
+	std::istringstream file(std::move(contents));
 
 	// Stores attributes
 	std::vector<glm::vec3> positions;
@@ -125,5 +132,17 @@ VertexArrayObject::sptr ObjLoader::LoadFromFile(const std::string& filename, con
 	// You'll need to keep track of these and create vertex entries for each vertex in the face
 	// If you want to get fancy, you can track which vertices you've already added
 
-	return mesh.Bake();
+	return mesh;
+}
+
+VertexArrayObject::sptr ObjLoader::Bake(MeshBuilder<VertexPosNormTexCol>& mesh, const MeshLodSettings& lodSettings, VertexCompression compression)
+{
+	switch (compression) {
+		case VertexCompression::Packed:
+			return mesh.BakePacked<VertexPosNormTexColPacked>(lodSettings);
+		case VertexCompression::Quantized:
+			return mesh.BakePacked<VertexQuantizedPosNormTexCol>(lodSettings);
+		default:
+			return mesh.Bake(lodSettings);
+	}
 }
@@ -1,17 +1,172 @@
 #include "Shader.h"
 #include "Logging.h"
+#include "VirtualFileSystem.h"
 #include <fstream>
 #include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <unordered_set>
+
+std::string          Shader::_cacheDirectory = "";
+bool                 Shader::_hotReloadEnabled = false;
+std::vector<std::string> Shader::_hotReloadSourceDirectories;
+double               Shader::_totalLoadTime = 0.0;
+uint32_t             Shader::_cacheHits = 0;
+uint32_t             Shader::_cacheMisses = 0;
+std::vector<Shader*> Shader::_allShaders;
+
+// Bump this whenever the cache file layout changes, so old binaries are ignored
+static const uint32_t CACHE_VERSION = 1;
+
+/// <summary>
+/// The header at the start of each cached program binary
+/// </summary>
+struct ShaderCacheHeader {
+	char     Magic[4];
+	uint32_t Version;
+	uint64_t Hash;
+	uint32_t Format;
+	uint32_t Length;
+};
+
+typedef std::chrono::high_resolution_clock ShaderClock;
+
+static double MillisecondsSince(ShaderClock::time_point start) {
+	return std::chrono::duration<double, std::milli>(ShaderClock::now() - start).count();
+}
+
+static uint64_t HashBytes(uint64_t hash, const void* data, size_t length) {
+	// FNV-1a, it's fast and plenty good enough to tell sources apart
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	for (size_t ix = 0; ix < length; ix++) {
+		hash ^= bytes[ix];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+/// <summary>
+/// Copies source into output, replacing #include "file" lines with the contents of the file
+/// Includes are resolved relative to directory first, then relative to the working directory, and
+/// every file is only included once
+/// </summary>
+static void ResolveIncludes(const std::string& source, const std::filesystem::path& directory, int sourceIndex,
+	std::vector<std::string>& files, std::unordered_set<std::string>& included, std::string& output)
+{
+	std::istringstream stream(source);
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(stream, line)) {
+		lineNumber++;
+		const size_t start = line.find_first_not_of(" \t");
+		if (start == std::string::npos || line.compare(start, 8, "#include") != 0) {
+			output += line;
+			output += '\n';
+			continue;
+		}
+
+		const size_t open = line.find_first_of("\"<", start + 8);
+		const size_t close = open == std::string::npos ? std::string::npos : line.find_first_of("\">", open + 1);
+		if (close == std::string::npos) {
+			LOG_ERROR("Malformed #include in {} on line {}: {}", files[sourceIndex], lineNumber, line);
+			output += '\n';
+			continue;
+		}
+		const std::string name = line.substr(open + 1, close - open - 1);
+		std::filesystem::path path = directory / name;
+		if (!VirtualFileSystem::Exists(path.string())) {
+			path = name;
+		}
+		std::string contents;
+		if (!VirtualFileSystem::ReadText(path.string(), contents)) {
+			LOG_ERROR("Could not find \"{}\" included from {} on line {}", name, files[sourceIndex], lineNumber);
+			output += '\n';
+			continue;
+		}
+
+		// Only include each file once, this also stops files that include each other from recursing forever
+		const std::string key = FileArchive::NormalizePath(path.string());
+		if (included.insert(key).second) {
+			const int includeIndex = static_cast<int>(files.size());
+			files.push_back(path.generic_string());
+			// #line lets the compiler report errors with the line in the included file, and the file's index in files
+			output += "#line 1 " + std::to_string(includeIndex) + "\n";
+			ResolveIncludes(contents, path.parent_path(), includeIndex, files, included, output);
+			output += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(sourceIndex) + "\n";
+		} else {
+			output += '\n';
+		}
+	}
+}
+
+/// <summary>
+/// Copies the values of all the uniforms in one program into another, for the uniforms that exist in both
+/// </summary>
+static void CopyUniforms(GLuint from, GLuint to)
+{
+	GLint count = 0;
+	glGetProgramiv(from, GL_ACTIVE_UNIFORMS, &count);
+	char name[256];
+	for (GLint ix = 0; ix < count; ix++) {
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(from, ix, sizeof(name), &length, &size, &type, name);
+		// Arrays are reported as name[0], we copy them one element at a time
+		std::string base(name, length);
+		if (base.size() > 3 && base.compare(base.size() - 3, 3, "[0]") == 0) {
+			base.resize(base.size() - 3);
+		}
+
+		for (GLint element = 0; element < size; element++) {
+			const std::string elementName = size > 1 ? base + "[" + std::to_string(element) + "]" : base;
+			const GLint src = glGetUniformLocation(from, elementName.c_str());
+			const GLint dst = glGetUniformLocation(to, elementName.c_str());
+			// Uniforms in blocks have no location, those live in buffers and don't need copying
+			if (src == -1 || dst == -1) {
+				continue;
+			}
+
+			GLfloat f[16];
+			GLint i[4];
+			GLuint u[4];
+			switch (type) {
+				case GL_FLOAT:             glGetUniformfv(from, src, f); glProgramUniform1fv(to, dst, 1, f); break;
+				case GL_FLOAT_VEC2:        glGetUniformfv(from, src, f); glProgramUniform2fv(to, dst, 1, f); break;
+				case GL_FLOAT_VEC3:        glGetUniformfv(from, src, f); glProgramUniform3fv(to, dst, 1, f); break;
+				case GL_FLOAT_VEC4:        glGetUniformfv(from, src, f); glProgramUniform4fv(to, dst, 1, f); break;
+				case GL_FLOAT_MAT2:        glGetUniformfv(from, src, f); glProgramUniformMatrix2fv(to, dst, 1, false, f); break;
+				case GL_FLOAT_MAT3:        glGetUniformfv(from, src, f); glProgramUniformMatrix3fv(to, dst, 1, false, f); break;
+				case GL_FLOAT_MAT4:        glGetUniformfv(from, src, f); glProgramUniformMatrix4fv(to, dst, 1, false, f); break;
+				case GL_INT_VEC2:
+				case GL_BOOL_VEC2:         glGetUniformiv(from, src, i); glProgramUniform2iv(to, dst, 1, i); break;
+				case GL_INT_VEC3:
+				case GL_BOOL_VEC3:         glGetUniformiv(from, src, i); glProgramUniform3iv(to, dst, 1, i); break;
+				case GL_INT_VEC4:
+				case GL_BOOL_VEC4:         glGetUniformiv(from, src, i); glProgramUniform4iv(to, dst, 1, i); break;
+				case GL_UNSIGNED_INT:      glGetUniformuiv(from, src, u); glProgramUniform1uiv(to, dst, 1, u); break;
+				case GL_UNSIGNED_INT_VEC2: glGetUniformuiv(from, src, u); glProgramUniform2uiv(to, dst, 1, u); break;
+				case GL_UNSIGNED_INT_VEC3: glGetUniformuiv(from, src, u); glProgramUniform3uiv(to, dst, 1, u); break;
+				case GL_UNSIGNED_INT_VEC4: glGetUniformuiv(from, src, u); glProgramUniform4uiv(to, dst, 1, u); break;
+				// Ints, bools, samplers and images are all a single int
+				default:                   glGetUniformiv(from, src, i); glProgramUniform1iv(to, dst, 1, i); break;
+			}
+		}
+	}
+}
 
 Shader::Shader() :
-	_vs(0),
-	_fs(0),
-	_handle(0)
+	_handle(0),
+	_loadedFromCache(false)
 {
 	_handle = glCreateProgram();
+	_allShaders.push_back(this);
 }
 
 Shader::~Shader() {
+	_allShaders.erase(std::remove(_allShaders.begin(), _allShaders.end(), this), _allShaders.end());
 	if (_handle != 0) {
 		glDeleteProgram(_handle);
 		_handle = 0;
@@ -21,101 +176,401 @@ Shader::~Shader() {
 
 bool Shader::LoadShaderPart(const char* source, GLenum type)
 {
-	// Creates a new shader part (VS, FS, GS, etc...)
-	GLuint handle = glCreateShader(type);
+	ShaderPart part;
+	part.Type = type;
+	part.Files.push_back("");
+	std::unordered_set<std::string> included;
+	ResolveIncludes(source, std::filesystem::current_path(), 0, part.Files, included, part.Source);
 
-	// Load the GLSL source and compile it
-	glShaderSource(handle, 1, &source, nullptr);
-	glCompileShader(handle);
+	// Replace the stage if we already have it, so that parts can be re-loaded
+	for (ShaderPart& existing : _parts) {
+		if (existing.Type == type) {
+			existing = std::move(part);
+			return true;
+		}
+	}
+	_parts.push_back(std::move(part));
+	return true;
+}
 
-	// Get the compilation status for the shader part
-	GLint status = 0;
-	glGetShaderiv(handle, GL_COMPILE_STATUS, &status);
+bool Shader::LoadShaderPartFromFile(const char* path, GLenum type) {
+	const ShaderClock::time_point start = ShaderClock::now();
+	// Shaders are read through the virtual file system, so they can come from an archive. Only loose files can be hot-reloaded
+	std::string source;
+	if (!VirtualFileSystem::ReadText(path, source)) {
+		LOG_ERROR("File not found: {}", path);
+		throw std::runtime_error("File not found, see logs for more information");
+	}
 
-	if (status == GL_FALSE) {
-		// Get the size of the error log
-		GLint logSize = 0;
-		glGetShaderiv(handle, GL_INFO_LOG_LENGTH, &logSize);
+	ShaderPart part;
+	part.Type = type;
+	part.Files.push_back(std::filesystem::path(path).generic_string());
+	std::unordered_set<std::string> included;
+	included.insert(FileArchive::NormalizePath(path));
+	ResolveIncludes(source, std::filesystem::path(path).parent_path(), 0, part.Files, included, part.Source);
 
-		// Create a new character buffer for the log
-		char* log = new char[logSize];
+	bool replaced = false;
+	for (ShaderPart& existing : _parts) {
+		if (existing.Type == type) {
+			existing = std::move(part);
+			replaced = true;
+		}
+	}
+	if (!replaced) {
+		_parts.push_back(std::move(part));
+	}
+	_UpdateFileTimes();
+	_totalLoadTime += MillisecondsSince(start);
+	return true;
+}
 
-		// Get the log
-		glGetShaderInfoLog(handle, logSize, &logSize, log);
+bool Shader::Link()
+{
+	const ShaderClock::time_point start = ShaderClock::now();
+	const bool result = _LinkProgram(_handle);
+	_uniformLocs.clear();
+	_totalLoadTime += MillisecondsSince(start);
+	return result;
+}
 
-		// Dump error log
-		LOG_ERROR("Failed to compile shader part:\n{}", log);
+bool Shader::Reload()
+{
+	// Re-read every stage that came from a file, stages loaded from strings are kept as they are
+	std::vector<ShaderPart> oldParts = _parts;
+	try {
+		for (const ShaderPart& part : oldParts) {
+			if (!part.Files[0].empty()) {
+				// Read the file we were watching, so edits to the originals aren't hidden by the copy we first loaded
+				const std::string source = _ResolveWatchedPath(part.Files[0]);
+				LoadShaderPartFromFile(source.empty() ? part.Files[0].c_str() : source.c_str(), part.Type);
+			}
+		}
+	}
+	catch (const std::runtime_error&) {
+		_parts = oldParts;
+		return false;
+	}
 
-		// Clean up our log memory
-		delete[] log;
+	// Build into a new program, so that the old one stays usable if there are any errors
+	const ShaderClock::time_point start = ShaderClock::now();
+	GLuint program = glCreateProgram();
+	const bool result = _LinkProgram(program);
+	if (result) {
+		CopyUniforms(_handle, program);
+		glDeleteProgram(_handle);
+		_handle = program;
+		_uniformLocs.clear();
+		LOG_INFO("Reloaded shader {} in {:.1f}ms", _parts[0].Files[0], MillisecondsSince(start));
+	} else {
+		glDeleteProgram(program);
+		LOG_WARN("Failed to reload shader {}, keeping the old program", _parts[0].Files[0]);
+	}
+	return result;
+}
 
-		// Delete the broken shader result
-		glDeleteShader(handle);
-		handle = 0;
+bool Shader::HasSourceChanged() const
+{
+	for (const auto& [path, time] : _fileTimes) {
+		std::error_code error;
+		const std::filesystem::file_time_type current = std::filesystem::last_write_time(path, error);
+		// Editors often replace files when saving, so a file that is briefly missing is not a change yet
+		if (!error && current != time) {
+			return true;
+		}
 	}
+	return false;
+}
 
-	switch (type) {
-		case GL_VERTEX_SHADER: _vs = handle; break;
-		case GL_FRAGMENT_SHADER: _fs = handle; break;
-		default: LOG_WARN("Not implemented"); break;
+void Shader::_UpdateFileTimes()
+{
+	_fileTimes.clear();
+	for (const ShaderPart& part : _parts) {
+		for (const std::string& file : part.Files) {
+			const std::string path = file.empty() ? file : _ResolveWatchedPath(file);
+			std::error_code error;
+			const std::filesystem::file_time_type time = std::filesystem::last_write_time(path, error);
+			if (!path.empty() && !error) {
+				_fileTimes.emplace_back(path, time);
+			}
+		}
 	}
+}
 
-	return status != GL_FALSE;
+std::string Shader::_ResolveWatchedPath(const std::string& path)
+{
+	const std::filesystem::path file(path);
+	if (file.is_relative()) {
+		for (const std::string& directory : _hotReloadSourceDirectories) {
+			const std::filesystem::path source = std::filesystem::path(directory) / file;
+			std::error_code error;
+			if (std::filesystem::is_regular_file(source, error)) {
+				return source.generic_string();
+			}
+		}
+	}
+	// Editing the loose copy of an archived file wouldn't change what we load, so there's no point watching it
+	if (VirtualFileSystem::IsArchived(path)) {
+		return "";
+	}
+	return path;
 }
 
-bool Shader::LoadShaderPartFromFile(const char* path, GLenum type) {
-	std::ifstream file(path);
+void Shader::AddHotReloadSourceDirectory(const std::string& directory)
+{
+	std::error_code error;
+	if (!std::filesystem::is_directory(directory, error)) {
+		LOG_WARN("Shader source directory \"{}\" does not exist, ignoring", directory);
+		return;
+	}
+	_hotReloadSourceDirectories.push_back(directory);
+	// Shaders that are already loaded should start watching the originals as well
+	for (Shader* shader : _allShaders) {
+		shader->_UpdateFileTimes();
+	}
+}
+
+uint64_t Shader::_ComputeHash() const
+{
+	// The driver is part of the key, since binaries from one driver (or driver version) won't load on another
+	static std::string driver;
+	if (driver.empty()) {
+		driver = std::string((const char*)glGetString(GL_VENDOR)) + "|" +
+			std::string((const char*)glGetString(GL_RENDERER)) + "|" +
+			std::string((const char*)glGetString(GL_VERSION));
+	}
+	uint64_t hash = 14695981039346656037ull;
+	hash = HashBytes(hash, &CACHE_VERSION, sizeof(CACHE_VERSION));
+	hash = HashBytes(hash, driver.data(), driver.size());
+	for (const ShaderPart& part : _parts) {
+		hash = HashBytes(hash, &part.Type, sizeof(part.Type));
+		hash = HashBytes(hash, part.Source.data(), part.Source.size());
+	}
+	return hash;
+}
+
+bool Shader::_LoadFromCache(GLuint program, uint64_t hash)
+{
+	char fileName[32];
+	snprintf(fileName, sizeof(fileName), "%016llx.bin", (unsigned long long)hash);
+	const std::filesystem::path path = std::filesystem::path(_cacheDirectory) / fileName;
+	std::ifstream file(path, std::ios::binary);
 	if (!file.is_open()) {
-		LOG_ERROR("File not found: {}", path);
-		throw std::runtime_error("File not found, see logs for more information");
+		return false;
 	}
-	std::stringstream stream;
-	stream << file.rdbuf();
-	bool result = LoadShaderPart(stream.str().c_str(), type);
-	file.close();
-	return result;
+
+	// Anything that doesn't look exactly like what we wrote (ex: a file cut short by a crash) is ignored and rebuilt
+	std::error_code error;
+	const uintmax_t fileSize = std::filesystem::file_size(path, error);
+	ShaderCacheHeader header;
+	if (error || !file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+		memcmp(header.Magic, "SHDR", 4) != 0 || header.Version != CACHE_VERSION || header.Hash != hash ||
+		fileSize != sizeof(header) + header.Length) {
+		return false;
+	}
+	std::vector<char> binary(header.Length);
+	if (!file.read(binary.data(), header.Length)) {
+		return false;
+	}
+
+	// The driver can still reject a binary (ex: after a driver update that kept the version string), in which case we compile
+	glProgramBinary(program, header.Format, binary.data(), header.Length);
+	GLint status = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if (status == GL_FALSE) {
+		LOG_WARN("Cached shader binary {} was rejected by the driver, compiling from source", fileName);
+		return false;
+	}
+	return true;
 }
 
-bool Shader::Link()
+void Shader::_StoreInCache(GLuint program, uint64_t hash)
 {
-	LOG_ASSERT(_vs != 0 && _fs != 0, "Must attach both a vertex and fragment shader!");
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) {
+		return;
+	}
+	std::vector<char> binary(length);
+	ShaderCacheHeader header;
+	memcpy(header.Magic, "SHDR", 4);
+	header.Version = CACHE_VERSION;
+	header.Hash = hash;
+	glGetProgramBinary(program, length, &length, &header.Format, binary.data());
+	header.Length = static_cast<uint32_t>(length);
 
-	// Attach our two shaders
-	glAttachShader(_handle, _vs);
-	glAttachShader(_handle, _fs);
+	char fileName[32];
+	snprintf(fileName, sizeof(fileName), "%016llx.bin", (unsigned long long)hash);
+	std::ofstream file(std::filesystem::path(_cacheDirectory) / fileName, std::ios::binary);
+	if (!file.is_open()) {
+		LOG_WARN("Could not write shader binary {} to {}", fileName, _cacheDirectory);
+		return;
+	}
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(binary.data(), length);
+}
 
-	// Perform linking
-	glLinkProgram(_handle);
+bool Shader::_LinkProgram(GLuint program)
+{
+	LOG_ASSERT(!_parts.empty(), "Must load at least one shader part before linking!");
 
-	// Remove shader parts to save space (we can do this since we only needed the shader parts to compile an actual shader program)
-	glDetachShader(_handle, _vs);
-	glDeleteShader(_vs);
-	glDetachShader(_handle, _fs);
-	glDeleteShader(_fs);
+	const uint64_t hash = _cacheDirectory.empty() ? 0 : _ComputeHash();
+	if (!_cacheDirectory.empty() && _LoadFromCache(program, hash)) {
+		_loadedFromCache = true;
+		_cacheHits++;
+		return true;
+	}
+	_loadedFromCache = false;
+	_cacheMisses++;
 
-	GLint status = 0;
-	glGetProgramiv(_handle, GL_LINK_STATUS, &status);
-
-	if (status == GL_FALSE)
-	{
-		// Get the length of the log
-		GLint length = 0;
-		glGetProgramiv(_handle, GL_INFO_LOG_LENGTH, &length);
-
-		if (length > 0) {
-			// Read the log from openGL
-			char* log = new char[length];
-			glGetProgramInfoLog(_handle, length, &length, log);
-			LOG_ERROR("Shader failed to link:\n{}", log);
+	// Compile all our parts
+	std::vector<GLuint> handles;
+	bool compiled = true;
+	for (const ShaderPart& part : _parts) {
+		// Creates a new shader part (VS, FS, GS, etc...)
+		GLuint handle = glCreateShader(part.Type);
+
+		// Load the GLSL source and compile it
+		const char* source = part.Source.c_str();
+		glShaderSource(handle, 1, &source, nullptr);
+		glCompileShader(handle);
+
+		// Get the compilation status for the shader part
+		GLint status = 0;
+		glGetShaderiv(handle, GL_COMPILE_STATUS, &status);
+
+		if (status == GL_FALSE) {
+			// Get the size of the error log
+			GLint logSize = 0;
+			glGetShaderiv(handle, GL_INFO_LOG_LENGTH, &logSize);
+
+			// Create a new character buffer for the log
+			char* log = new char[logSize];
+
+			// Get the log
+			glGetShaderInfoLog(handle, logSize, &logSize, log);
+
+			// Dump error log, along with the files so the source string numbers in the log can be looked up
+			std::string files;
+			for (size_t ix = 0; ix < part.Files.size(); ix++) {
+				files += "\n\t" + std::to_string(ix) + ": " + (part.Files[ix].empty() ? "<string>" : part.Files[ix]);
+			}
+			LOG_ERROR("Failed to compile shader part:\n{}Files:{}", log, files);
+
+			// Clean up our log memory
 			delete[] log;
+
+			compiled = false;
 		}
-		else {
-			LOG_ERROR("Shader failed to link for an unknown reason!");
+		handles.push_back(handle);
+	}
+
+	GLint status = GL_FALSE;
+	if (compiled) {
+		// Attach our shaders
+		for (GLuint handle : handles) {
+			glAttachShader(program, handle);
+		}
+
+		// We need to ask for the binary to be kept around before linking if we want to cache it
+		if (!_cacheDirectory.empty()) {
+			glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
+
+		// Perform linking
+		glLinkProgram(program);
+
+		// Remove shader parts to save space (we can do this since we only needed the shader parts to compile an actual shader program)
+		for (GLuint handle : handles) {
+			glDetachShader(program, handle);
+		}
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+
+		if (status == GL_FALSE)
+		{
+			// Get the length of the log
+			GLint length = 0;
+			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+
+			if (length > 0) {
+				// Read the log from openGL
+				char* log = new char[length];
+				glGetProgramInfoLog(program, length, &length, log);
+				LOG_ERROR("Shader failed to link:\n{}", log);
+				delete[] log;
+			}
+			else {
+				LOG_ERROR("Shader failed to link for an unknown reason!");
+			}
+		}
+		else if (!_cacheDirectory.empty()) {
+			_StoreInCache(program, hash);
 		}
 	}
+
+	for (GLuint handle : handles) {
+		glDeleteShader(handle);
+	}
 	return status != GL_FALSE;
 }
 
+void Shader::EnableBinaryCache(const std::string& directory)
+{
+	// Some drivers don't support any binary formats, in which case there's nothing we can cache
+	GLint formats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	if (formats == 0) {
+		LOG_WARN("The driver does not support program binaries, shaders will always be compiled");
+		return;
+	}
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+	if (error) {
+		LOG_WARN("Could not create the shader cache directory {}: {}", directory, error.message());
+		return;
+	}
+	_cacheDirectory = directory;
+}
+
+void Shader::DisableBinaryCache()
+{
+	_cacheDirectory = "";
+}
+
+void Shader::ClearBinaryCache()
+{
+	if (_cacheDirectory.empty()) {
+		return;
+	}
+	std::error_code error;
+	for (const auto& entry : std::filesystem::directory_iterator(_cacheDirectory, error)) {
+		if (entry.path().extension() == ".bin") {
+			std::filesystem::remove(entry.path(), error);
+		}
+	}
+}
+
+int Shader::PollHotReload()
+{
+	if (!_hotReloadEnabled) {
+		return 0;
+	}
+	// Checking the files is a handful of system calls per shader, so we don't need to do it every frame
+	static ShaderClock::time_point lastPoll = ShaderClock::now();
+	if (MillisecondsSince(lastPoll) < 250.0) {
+		return 0;
+	}
+	lastPoll = ShaderClock::now();
+
+	int reloaded = 0;
+	for (Shader* shader : _allShaders) {
+		if (shader->HasSourceChanged()) {
+			shader->Reload();
+			reloaded++;
+		}
+	}
+	return reloaded;
+}
+
 void Shader::Bind() {
 	glUseProgram(_handle);
 }
@@ -1,7 +1,7 @@
 #include "Texture2D.h"
 
 Texture2D::Texture2D(const Texture2DDescription& description) :
-	ITexture(), _description(description)
+	ITexture(), _description(description), _levelCount(1)
 {
 
 	_RecreateTexture();
@@ -21,7 +21,18 @@ void Texture2D::_RecreateTexture() {
 
 	if (_description.Width * _description.Height > 0 && _description.Format != InternalFormat::Unknown)
 	{
-		glTextureStorage2D(_handle, 1, *_description.Format, _description.Width, _description.Height);
+		// Allocate storage for the entire mip chain up front, otherwise there is nowhere for generated mips to go
+		_levelCount = _description.MipLevels;
+		if (_levelCount == 0) {
+			_levelCount = 1;
+			if (_description.GenerateMipMaps) {
+				for (uint32_t size = glm::max(_description.Width, _description.Height); size > 1; size /= 2) {
+					_levelCount++;
+				}
+			}
+		}
+		glTextureStorage2D(_handle, _levelCount, *_description.Format, _description.Width, _description.Height);
+		glTextureParameteri(_handle, GL_TEXTURE_MAX_LEVEL, _levelCount - 1);
 
 		glTextureParameteri(_handle, GL_TEXTURE_WRAP_S, (GLenum)_description.HorizontalWrap);
 		glTextureParameteri(_handle, GL_TEXTURE_WRAP_T, (GLenum)_description.VerticalWrap);
@@ -32,6 +43,7 @@ void Texture2D::_RecreateTexture() {
 }
 
 void Texture2D::LoadData(const Texture2DData::sptr& data) {
+	LOG_ASSERT(data->HasData(), "Texture data has already been released!");
 	if (_description.Width != data->GetWidth() ||
 		_description.Height != data->GetHeight()) 
 	{
@@ -58,16 +70,63 @@ void Texture2D::LoadData(const Texture2DData::sptr& data) {
 	// Upload our data to our image
 	glTextureSubImage2D(_handle, 0, 0, 0, _description.Width, _description.Height, *data->GetFormat(), *data->GetPixelType(), data->GetDataPtr());
 
-	if (_description.GenerateMipMaps) {
+	if (_description.GenerateMipMaps && _levelCount > 1) {
 		glGenerateTextureMipmap(_handle);
 	}
 }
 
+void Texture2D::LoadData(const Texture2DMipChain::sptr& data) {
+	LOG_ASSERT(data != nullptr && data->GetLevelCount() > 0, "Cannot load an empty mip chain!");
+
+	// The chain already contains all our levels, so the texture must match it exactly
+	if (_description.Width != data->GetWidth() ||
+		_description.Height != data->GetHeight() ||
+		_description.Format != data->GetFormat() ||
+		_levelCount != data->GetLevelCount())
+	{
+		_description.Width = data->GetWidth();
+		_description.Height = data->GetHeight();
+		_description.Format = data->GetFormat();
+		_description.MipLevels = data->GetLevelCount();
+		_description.GenerateMipMaps = false;
+
+		_RecreateTexture();
+	}
+
+	// We can get better error logs by attaching an object label!
+	if (!data->DebugName.empty()) {
+		glObjectLabel(GL_TEXTURE, _handle, data->DebugName.length(), data->DebugName.c_str());
+	}
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	for (uint32_t ix = 0; ix < data->GetLevelCount(); ix++) {
+		const Texture2DMipChain::MipLevel& level = data->GetLevel(ix);
+		if (data->IsCompressed()) {
+			glCompressedTextureSubImage2D(_handle, ix, 0, 0, level.Width, level.Height, *data->GetFormat(), (GLsizei)level.Data.size(), level.Data.data());
+		} else {
+			glTextureSubImage2D(_handle, ix, 0, 0, level.Width, level.Height, *data->GetPixelFormat(), GL_UNSIGNED_BYTE, level.Data.data());
+		}
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
 Texture2D::sptr Texture2D::LoadFromFile(const std::string& path) {
 	Texture2DData::sptr data = Texture2DData::LoadFromFile(path);
 	LOG_ASSERT(data != nullptr, "Failed to load image from file!");
 	Texture2D::sptr result = Texture2D::Create();
 	result->LoadData(data);
+	// The data now lives on the GPU, we don't need to keep the CPU copy around
+	data->ReleaseData();
+	return result;
+}
+
+Texture2D::sptr Texture2D::LoadFromFileCached(const std::string& path, const TextureProcessSettings& settings) {
+	Texture2DMipChain::sptr data = TextureProcessor::LoadOrProcess(path, settings);
+	LOG_ASSERT(data != nullptr, "Failed to load image from file!");
+	Texture2DDescription desc = Texture2DDescription();
+	desc.MinificationFilter = MinFilter::LinearMipLinear;
+	Texture2D::sptr result = Texture2D::Create(desc);
+	result->LoadData(data);
 	return result;
 }
 
@@ -3,8 +3,10 @@
 #include <filesystem>
 #include <stb_image.h>
 
+#include "VirtualFileSystem.h"
+
 Texture2DData::Texture2DData(uint32_t width, uint32_t height, PixelFormat format, PixelType type, void* sourceData, InternalFormat recommendedFormat) :
-	_width(width), _height(height), _format(format), _type(type), _data(nullptr), _recommendedFormat(recommendedFormat)
+	_width(width), _height(height), _format(format), _type(type), _data(nullptr), _recommendedFormat(recommendedFormat), _deleter(free)
 {
 	LOG_ASSERT(width > 0 & height > 0, "Width and height must both be greater than zero! Got {}x{}", width, height);
 	_dataSize = width * (size_t)height * GetTexelSize(_format, _type);
@@ -15,8 +17,23 @@ Texture2DData::Texture2DData(uint32_t width, uint32_t height, PixelFormat format
 	}
 }
 
+Texture2DData::Texture2DData(uint32_t width, uint32_t height, PixelFormat format, PixelType type, void* data, DataDeleter deleter, InternalFormat recommendedFormat) :
+	_width(width), _height(height), _format(format), _type(type), _data(data), _recommendedFormat(recommendedFormat), _deleter(deleter)
+{
+	LOG_ASSERT(width > 0 & height > 0, "Width and height must both be greater than zero! Got {}x{}", width, height);
+	LOG_ASSERT(data != nullptr, "Cannot adopt a null buffer!");
+	_dataSize = width * (size_t)height * GetTexelSize(_format, _type);
+}
+
 Texture2DData::~Texture2DData() {
-	free(_data);
+	ReleaseData();
+}
+
+void Texture2DData::ReleaseData() {
+	if (_data != nullptr && _deleter) {
+		_deleter(_data);
+	}
+	_data = nullptr;
 }
 
 Texture2DData::sptr Texture2DData::LoadFromFile(const std::string& file, bool forceRgba)
@@ -25,9 +42,16 @@ Texture2DData::sptr Texture2DData::LoadFromFile(const std::string& file, bool fo
 	int width, height, numChannels;
 	const int targetChannels = forceRgba ? 4 : 0;
 
-	// Use STBI to load the image
+	// Read the file through the virtual file system, so it can come from an archive
+	VirtualFile::sptr source = VirtualFileSystem::Open(file);
+	if (source == nullptr) {
+		LOG_WARN("Could not find image \"{}\"", file);
+		return nullptr;
+	}
+
+	// Use STBI to decode the image
 	stbi_set_flip_vertically_on_load(true);
-	uint8_t* data = stbi_load(file.c_str(), &width, &height, &numChannels, targetChannels);
+	uint8_t* data = stbi_load_from_memory(source->GetData(), static_cast<int>(source->GetSize()), &width, &height, &numChannels, targetChannels);
 
 	// If we could not load any data, warn and return null
 	if (data == nullptr) {
@@ -71,13 +95,10 @@ Texture2DData::sptr Texture2DData::LoadFromFile(const std::string& file, bool fo
 		LOG_WARN("The alignment of a horizontal line is not a multiple of 4, this will require a call to glPixelStorei(GL_PACK_ALIGNMENT)");
 	}
 
-	// Create the result and store our image data in it
+	// Create the result and hand STBI's buffer over to it, rather than keeping two copies around
 	// Note that stbi will always give us an array of unsigned bytes (uint8_t)
-	Texture2DData::sptr result = std::make_shared<Texture2DData>(width, height, image_format, PixelType::UByte, data, internal_format);
+	Texture2DData::sptr result = std::make_shared<Texture2DData>(width, height, image_format, PixelType::UByte, data, stbi_image_free, internal_format);
 	result->DebugName = std::filesystem::path(file).filename().string();
-	
-	// We now have a copy in our ptr, we can free STBI's copy of it
-	stbi_image_free(data);
 
 	return result;
 }
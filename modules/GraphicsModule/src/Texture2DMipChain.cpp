@@ -0,0 +1,120 @@
+#include "Texture2DMipChain.h"
+
+#include <fstream>
+
+// Header for our texture container format, followed by LevelCount (LevelHeader, data) pairs
+struct TextureFileHeader {
+	char     Magic[4];
+	uint32_t Version;
+	GLint    Format;
+	GLint    PixelFormat;
+	uint32_t LevelCount;
+	uint32_t Reserved;
+	uint64_t SourceStamp;
+};
+
+struct TextureFileLevelHeader {
+	uint32_t Width;
+	uint32_t Height;
+	uint64_t DataSize;
+};
+
+static const char     TEXTURE_FILE_MAGIC[4] = { 'O', 'T', 'E', 'X' };
+static const uint32_t TEXTURE_FILE_VERSION = 1;
+
+Texture2DMipChain::Texture2DMipChain(InternalFormat format, PixelFormat pixelFormat) :
+	_format(format), _pixelFormat(pixelFormat), _levels(std::vector<MipLevel>())
+{ }
+
+Texture2DMipChain::MipLevel& Texture2DMipChain::AddLevel(uint32_t width, uint32_t height, size_t dataSize) {
+	MipLevel& level = _levels.emplace_back();
+	level.Width = width;
+	level.Height = height;
+	level.Data.resize(dataSize);
+	return level;
+}
+
+size_t Texture2DMipChain::GetTotalDataSize() const {
+	size_t result = 0;
+	for (const MipLevel& level : _levels) {
+		result += level.Data.size();
+	}
+	return result;
+}
+
+size_t Texture2DMipChain::GetImageSize(uint32_t width, uint32_t height, InternalFormat format, PixelFormat pixelFormat) {
+	if (IsBlockCompressed(format)) {
+		// Block compressed images are always stored as whole 4x4 blocks, even for the 2x2 and 1x1 levels
+		const size_t blocksX = (width + 3) / 4;
+		const size_t blocksY = (height + 3) / 4;
+		return blocksX * blocksY * GetBlockSize(format);
+	} else {
+		return (size_t)width * height * GetTexelSize(pixelFormat, PixelType::UByte);
+	}
+}
+
+bool Texture2DMipChain::SaveToFile(const std::string& path, uint64_t sourceStamp) const {
+	std::ofstream file(path, std::ios::binary);
+	if (!file) {
+		LOG_WARN("Failed to open \"{}\" for writing", path);
+		return false;
+	}
+
+	TextureFileHeader header;
+	memcpy(header.Magic, TEXTURE_FILE_MAGIC, sizeof(TEXTURE_FILE_MAGIC));
+	header.Version = TEXTURE_FILE_VERSION;
+	header.Format = *_format;
+	header.PixelFormat = *_pixelFormat;
+	header.LevelCount = GetLevelCount();
+	header.Reserved = 0;
+	header.SourceStamp = sourceStamp;
+	file.write(reinterpret_cast<const char*>(&header), sizeof(TextureFileHeader));
+
+	for (const MipLevel& level : _levels) {
+		TextureFileLevelHeader levelHeader;
+		levelHeader.Width = level.Width;
+		levelHeader.Height = level.Height;
+		levelHeader.DataSize = level.Data.size();
+		file.write(reinterpret_cast<const char*>(&levelHeader), sizeof(TextureFileLevelHeader));
+		file.write(reinterpret_cast<const char*>(level.Data.data()), level.Data.size());
+	}
+
+	return file.good();
+}
+
+Texture2DMipChain::sptr Texture2DMipChain::LoadFromFile(const std::string& path, uint64_t* sourceStamp) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		return nullptr;
+	}
+
+	TextureFileHeader header;
+	file.read(reinterpret_cast<char*>(&header), sizeof(TextureFileHeader));
+	if (!file || memcmp(header.Magic, TEXTURE_FILE_MAGIC, sizeof(TEXTURE_FILE_MAGIC)) != 0 || header.Version != TEXTURE_FILE_VERSION) {
+		LOG_WARN("\"{}\" is not a valid texture cache file", path);
+		return nullptr;
+	}
+
+	Texture2DMipChain::sptr result = std::make_shared<Texture2DMipChain>((InternalFormat)header.Format, (PixelFormat)header.PixelFormat);
+	result->_levels.reserve(header.LevelCount);
+	for (uint32_t ix = 0; ix < header.LevelCount; ix++) {
+		TextureFileLevelHeader levelHeader;
+		file.read(reinterpret_cast<char*>(&levelHeader), sizeof(TextureFileLevelHeader));
+		if (!file || levelHeader.DataSize != GetImageSize(levelHeader.Width, levelHeader.Height, result->_format, result->_pixelFormat)) {
+			LOG_WARN("Texture cache file \"{}\" is truncated or corrupt", path);
+			return nullptr;
+		}
+		MipLevel& level = result->AddLevel(levelHeader.Width, levelHeader.Height, levelHeader.DataSize);
+		file.read(reinterpret_cast<char*>(level.Data.data()), levelHeader.DataSize);
+	}
+
+	if (!file) {
+		LOG_WARN("Texture cache file \"{}\" is truncated or corrupt", path);
+		return nullptr;
+	}
+
+	if (sourceStamp != nullptr) {
+		*sourceStamp = header.SourceStamp;
+	}
+	return result;
+}
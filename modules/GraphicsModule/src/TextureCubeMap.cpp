@@ -48,8 +48,13 @@ void TextureCubeMap::LoadData(const TextureCubeMapData::sptr& data) {
 	int componentSize = (GLint)GetTexelComponentSize(data->GetPixelType());
 	glPixelStorei(GL_PACK_ALIGNMENT, componentSize);
 
-	// Upload our data to our image
-	glTextureSubImage3D(_handle, 0, 0, 0, 0, _description.Size, _description.Size, 6, *data->GetFormat(), *data->GetPixelType(), data->GetDataPtr());
+	// Upload our data to our image, one face at a time since the faces are not necessarily contiguous
+	for (int ix = 0; ix < 6; ix++) {
+		const void* faceData = data->GetFaceDataPtr((CubeMapFace)ix);
+		if (faceData != nullptr) {
+			glTextureSubImage3D(_handle, 0, 0, 0, ix, _description.Size, _description.Size, 1, *data->GetFormat(), *data->GetPixelType(), faceData);
+		}
+	}
 
 	if (_description.GenerateMipMaps) {
 		glGenerateTextureMipmap(_handle);
@@ -61,6 +66,8 @@ TextureCubeMap::sptr TextureCubeMap::LoadFromImages(const std::string& path)
 	TextureCubeMapData::sptr data = TextureCubeMapData::LoadFromImages(path);
 	TextureCubeMap::sptr result = TextureCubeMap::Create();
 	result->LoadData(data);
+	// The data now lives on the GPU, we don't need to keep the CPU copy around
+	data->ReleaseData();
 	return result;
 }
 
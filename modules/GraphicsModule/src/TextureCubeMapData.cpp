@@ -1,39 +1,45 @@
 #include "TextureCubeMapData.h"
 #include <filesystem>
+#include "VirtualFileSystem.h"
 
 TextureCubeMapData::TextureCubeMapData(uint32_t size, PixelFormat format, PixelType type, void* sourceData, InternalFormat recommendedFormat) :
-	_size(size), _format(format), _type(type), _data(nullptr), _recommendedFormat(recommendedFormat) {
+	_size(size), _format(format), _type(type), _recommendedFormat(recommendedFormat) {
 	LOG_ASSERT(size > 0, "Size must be greater than zero! Got {}", size)
 	_faceDataSize = (size_t)_size * _size * GetTexelSize(_format, _type);
 	_dataSize = _faceDataSize * 6;
-	_data = malloc(_dataSize);
-	LOG_ASSERT(_data != nullptr, "Failed to allocate texture data!")
+
+	// We allocate all 6 faces in a single block, and each face keeps the block alive until it is released
+	std::shared_ptr<char> block(static_cast<char*>(malloc(_dataSize)), free);
+	LOG_ASSERT(block != nullptr, "Failed to allocate texture data!")
 	if (sourceData != nullptr) {
-		memcpy(_data, sourceData, _dataSize);
+		memcpy(block.get(), sourceData, _dataSize);
+	}
+	for (int ix = 0; ix < 6; ix++) {
+		_faces[ix] = std::make_shared<Texture2DData>(_size, _size, _format, _type, block.get() + (_faceDataSize * ix), [block](void*) {}, _recommendedFormat);
 	}
 }
 
-TextureCubeMapData::~TextureCubeMapData() {
-	free(_data);
+TextureCubeMapData::TextureCubeMapData(const std::vector<Texture2DData::sptr>& faces) {
+	LOG_ASSERT(faces.size() == 6, "Must pass in exactly 6 images!");
+	LOG_ASSERT(faces[0] != nullptr, "The first face of a cube map may not be null!");
+
+	// We'll grab our settings from the first image and assume that they're the same everywhere
+	_size              = faces[0]->GetWidth();
+	_format            = faces[0]->GetFormat();
+	_type              = faces[0]->GetPixelType();
+	_recommendedFormat = faces[0]->GetRecommendedFormat();
+	_faceDataSize = (size_t)_size * _size * GetTexelSize(_format, _type);
+	_dataSize = _faceDataSize * 6;
+
+	for (int ix = 0; ix < 6; ix++) {
+		LoadFaceData(faces[ix], (CubeMapFace)ix);
+	}
 }
 
 TextureCubeMapData::sptr TextureCubeMapData::CreateFromImages(const std::vector<Texture2DData::sptr>& images)
 {
-	LOG_ASSERT(images.size() == 6, "Must pass in exactly 6 images!");
-
-	// We'll grab our settings from the first image and assume that they're the same everywhere
-	uint32_t    size   = images[0]->GetWidth();
-	PixelFormat format = images[0]->GetFormat();
-	PixelType   type   = images[0]->GetPixelType();
-	InternalFormat internal_format = images[0]->GetRecommendedFormat();
-	
-	TextureCubeMapData::sptr result = std::make_shared<TextureCubeMapData>(size, format, type, nullptr, internal_format);
-	
-	for(int ix = 0; ix < 6; ix++) {
-		result->LoadFaceData(images[ix], (CubeMapFace)ix);
-	}
-	
-	return result;
+	// The faces will reference the images directly, so we don't need a second copy of every face
+	return std::make_shared<TextureCubeMapData>(images);
 }
 
 TextureCubeMapData::sptr TextureCubeMapData::LoadFromImages(const std::string& rootImagePath) {
@@ -59,7 +65,7 @@ TextureCubeMapData::sptr TextureCubeMapData::LoadFromImages(const std::string& r
 		fs::path imagePath = rootFile;
 		imagePath += PATHS[ix];
 		imagePath += extension;
-		if (fs::exists(imagePath)) {
+		if (VirtualFileSystem::Exists(imagePath.string())) {
 			data[ix] = Texture2DData::LoadFromFile(imagePath.string());
 		}
 		else {
@@ -76,9 +82,14 @@ void TextureCubeMapData::LoadFaceData(const Texture2DData::sptr& data, CubeMapFa
 		LOG_ASSERT(data->GetFormat() == _format, "Data format does not match! {} vs {}", data->GetFormat(), _format);
 		LOG_ASSERT(data->GetPixelType() == _type, "Data pixel type does not match! {} vs {}", data->GetPixelType(), _type);
 
-		size_t offset = (size_t)face * _faceDataSize;
-		memcpy(static_cast<char*>(_data) + offset, data->GetDataPtr(), _faceDataSize);
+		_faces[(size_t)face] = data;
 	} else {
 		LOG_WARN("Data for face {} was null, ignoring", face);
 	}
 }
+
+void TextureCubeMapData::ReleaseData() {
+	for (int ix = 0; ix < 6; ix++) {
+		_faces[ix] = nullptr;
+	}
+}
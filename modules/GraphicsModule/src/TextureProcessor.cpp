@@ -0,0 +1,744 @@
+#include "TextureProcessor.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <filesystem>
+#include <functional>
+#include <thread>
+#include <xmmintrin.h>
+
+#include "Logging.h"
+
+// All of our filtering is done on 4 component floating point pixels, which map exactly onto an SSE register
+typedef __m128 Pixel;
+typedef std::vector<Pixel> PixelImage;
+
+#pragma region Helpers
+
+/// <summary>
+/// Splits the range [0, count) into roughly equal chunks and runs them on worker threads
+/// </summary>
+static void ParallelFor(size_t count, uint32_t threadCount, const std::function<void(size_t, size_t)>& func) {
+	if (threadCount == 0) {
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+	threadCount = static_cast<uint32_t>(std::min<size_t>(threadCount, count));
+
+	// Not worth spinning up threads for tiny workloads (ex: the bottom few mip levels)
+	if (threadCount <= 1 || count < 16) {
+		func(0, count);
+		return;
+	}
+
+	std::vector<std::thread> workers;
+	workers.reserve(threadCount);
+	const size_t chunk = (count + threadCount - 1) / threadCount;
+	for (size_t start = 0; start < count; start += chunk) {
+		workers.emplace_back(func, start, std::min(start + chunk, count));
+	}
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+}
+
+namespace {
+/// <summary>
+/// Lookup table for converting sRGB encoded bytes into linear values
+/// </summary>
+struct SrgbTables {
+	float   ToLinear[256];
+	uint8_t FromLinear[4096];
+
+	SrgbTables() {
+		for (int ix = 0; ix < 256; ix++) {
+			const float c = ix / 255.0f;
+			ToLinear[ix] = c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+		}
+		for (int ix = 0; ix < 4096; ix++) {
+			const float l = ix / 4095.0f;
+			const float c = l <= 0.0031308f ? l * 12.92f : 1.055f * powf(l, 1.0f / 2.4f) - 0.055f;
+			FromLinear[ix] = static_cast<uint8_t>(std::clamp(c * 255.0f + 0.5f, 0.0f, 255.0f));
+		}
+	}
+};
+}
+
+static const SrgbTables& GetSrgbTables() {
+	static SrgbTables tables;
+	return tables;
+}
+
+/// <summary>
+/// Gets the number of levels in a full mip chain for an image of the given size
+/// </summary>
+static uint32_t CalculateMipCount(uint32_t width, uint32_t height) {
+	uint32_t result = 1;
+	while (width > 1 || height > 1) {
+		width = std::max(1u, width / 2);
+		height = std::max(1u, height / 2);
+		result++;
+	}
+	return result;
+}
+
+/// <summary>
+/// Zeroth order modified Bessel function of the first kind, used by the Kaiser window
+/// </summary>
+static float BesselI0(float x) {
+	float result = 1.0f;
+	float term = 1.0f;
+	const float halfX = x * 0.5f;
+	for (int k = 1; k < 16; k++) {
+		term *= (halfX / k) * (halfX / k);
+		result += term;
+	}
+	return result;
+}
+
+// The Kaiser kernel covers 6 source pixels for every destination pixel when downsampling by 2
+static const int KAISER_TAPS = 6;
+
+/// <summary>
+/// Calculates the normalized weights for a 2x Kaiser windowed sinc downsampling kernel
+/// </summary>
+static void CalculateKaiserWeights(float weights[KAISER_TAPS]) {
+	const float alpha = 4.0f;
+	const float radius = KAISER_TAPS / 2.0f;
+	float total = 0.0f;
+	for (int ix = 0; ix < KAISER_TAPS; ix++) {
+		// Distance from the destination pixel center, in source pixels
+		const float d = (ix - KAISER_TAPS / 2 + 0.5f);
+		// Sinc with a cutoff of half the source frequency
+		const float x = d * 0.5f * 3.14159265359f;
+		const float sinc = x == 0.0f ? 1.0f : sinf(x) / x;
+		const float r = d / radius;
+		const float window = BesselI0(alpha * sqrtf(std::max(0.0f, 1.0f - r * r))) / BesselI0(alpha);
+		weights[ix] = sinc * window;
+		total += weights[ix];
+	}
+	for (int ix = 0; ix < KAISER_TAPS; ix++) {
+		weights[ix] /= total;
+	}
+}
+
+#pragma endregion
+
+#pragma region Mip Generation
+
+/// <summary>
+/// Gets whether a format stores colors in sRGB space, and so needs converting to linear before we filter it
+/// </summary>
+static bool IsSrgbFormat(InternalFormat format) {
+	switch (format) {
+		case InternalFormat::SRGB8:
+		case InternalFormat::SRGB8_ALPHA8:
+		case InternalFormat::BC1_SRGB:
+		case InternalFormat::BC3_SRGB:
+		case InternalFormat::BC7_SRGB:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/// <summary>
+/// Converts source texture data into linear floating point RGBA pixels
+/// </summary>
+static PixelImage ToLinearImage(const Texture2DData::sptr& data, bool isSrgb) {
+	LOG_ASSERT(data->GetPixelType() == PixelType::UByte, "Texture processing only supports unsigned byte textures, got {}", data->GetPixelType());
+
+	const float* toLinear = GetSrgbTables().ToLinear;
+	const int channels = GetTexelComponentCount(data->GetFormat());
+	const size_t count = (size_t)data->GetWidth() * data->GetHeight();
+	const uint8_t* src = static_cast<const uint8_t*>(data->GetDataPtr());
+
+	PixelImage result(count);
+	for (size_t ix = 0; ix < count; ix++) {
+		const uint8_t* texel = src + ix * channels;
+		float values[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+		for (int c = 0; c < channels; c++) {
+			// Alpha is never gamma encoded
+			values[c] = (isSrgb && c < 3) ? toLinear[texel[c]] : texel[c] / 255.0f;
+		}
+		// Match the behaviour of OpenGL when sampling single channel textures
+		if (channels == 1) {
+			values[1] = values[2] = values[0];
+		}
+		result[ix] = _mm_loadu_ps(values);
+	}
+	return result;
+}
+
+/// <summary>
+/// Downsamples an image by 2 along each axis by averaging 2x2 pixel quads
+/// </summary>
+static void DownsampleBox(const PixelImage& src, uint32_t srcWidth, uint32_t srcHeight, PixelImage& dst, uint32_t dstWidth, uint32_t dstHeight, uint32_t threadCount) {
+	const Pixel quarter = _mm_set1_ps(0.25f);
+	ParallelFor(dstHeight, threadCount, [&](size_t start, size_t end) {
+		for (size_t y = start; y < end; y++) {
+			const size_t y0 = std::min<size_t>(y * 2, srcHeight - 1);
+			const size_t y1 = std::min<size_t>(y * 2 + 1, srcHeight - 1);
+			const Pixel* row0 = &src[y0 * srcWidth];
+			const Pixel* row1 = &src[y1 * srcWidth];
+			Pixel* out = &dst[y * dstWidth];
+			for (size_t x = 0; x < dstWidth; x++) {
+				const size_t x0 = std::min<size_t>(x * 2, srcWidth - 1);
+				const size_t x1 = std::min<size_t>(x * 2 + 1, srcWidth - 1);
+				const Pixel sum = _mm_add_ps(_mm_add_ps(row0[x0], row0[x1]), _mm_add_ps(row1[x0], row1[x1]));
+				out[x] = _mm_mul_ps(sum, quarter);
+			}
+		}
+	});
+}
+
+/// <summary>
+/// Downsamples an image by 2 along each axis using a separable Kaiser windowed sinc filter
+/// </summary>
+static void DownsampleKaiser(const PixelImage& src, uint32_t srcWidth, uint32_t srcHeight, PixelImage& dst, uint32_t dstWidth, uint32_t dstHeight, uint32_t threadCount) {
+	float weights[KAISER_TAPS];
+	CalculateKaiserWeights(weights);
+	Pixel taps[KAISER_TAPS];
+	for (int ix = 0; ix < KAISER_TAPS; ix++) {
+		taps[ix] = _mm_set1_ps(weights[ix]);
+	}
+
+	// Horizontal pass, srcWidth x srcHeight -> dstWidth x srcHeight
+	PixelImage temp((size_t)dstWidth * srcHeight);
+	ParallelFor(srcHeight, threadCount, [&](size_t start, size_t end) {
+		for (size_t y = start; y < end; y++) {
+			const Pixel* row = &src[y * srcWidth];
+			Pixel* out = &temp[y * dstWidth];
+			for (int x = 0; x < (int)dstWidth; x++) {
+				// If this axis is not being reduced, we just copy the pixel
+				if (srcWidth == dstWidth) {
+					out[x] = row[x];
+					continue;
+				}
+				Pixel sum = _mm_setzero_ps();
+				for (int t = 0; t < KAISER_TAPS; t++) {
+					const int sx = std::clamp(x * 2 + t - KAISER_TAPS / 2 + 1, 0, (int)srcWidth - 1);
+					sum = _mm_add_ps(sum, _mm_mul_ps(row[sx], taps[t]));
+				}
+				out[x] = sum;
+			}
+		}
+	});
+
+	// Vertical pass, dstWidth x srcHeight -> dstWidth x dstHeight
+	ParallelFor(dstHeight, threadCount, [&](size_t start, size_t end) {
+		for (int y = (int)start; y < (int)end; y++) {
+			Pixel* out = &dst[y * (size_t)dstWidth];
+			if (srcHeight == dstHeight) {
+				memcpy(out, &temp[y * (size_t)dstWidth], sizeof(Pixel) * dstWidth);
+				continue;
+			}
+			for (size_t x = 0; x < dstWidth; x++) {
+				out[x] = _mm_setzero_ps();
+			}
+			for (int t = 0; t < KAISER_TAPS; t++) {
+				const int sy = std::clamp(y * 2 + t - KAISER_TAPS / 2 + 1, 0, (int)srcHeight - 1);
+				const Pixel* row = &temp[sy * (size_t)dstWidth];
+				for (size_t x = 0; x < dstWidth; x++) {
+					out[x] = _mm_add_ps(out[x], _mm_mul_ps(row[x], taps[t]));
+				}
+			}
+		}
+	});
+}
+
+/// <summary>
+/// Quantizes a linear floating point image into an RGBA8 mip level
+/// </summary>
+static void QuantizeLevel(const PixelImage& src, Texture2DMipChain::MipLevel& level, bool isSrgb) {
+	const uint8_t* fromLinear = GetSrgbTables().FromLinear;
+	const Pixel zero = _mm_setzero_ps();
+	const Pixel one = _mm_set1_ps(1.0f);
+	const size_t count = (size_t)level.Width * level.Height;
+	alignas(16) float values[4];
+	for (size_t ix = 0; ix < count; ix++) {
+		// The Kaiser filter can ring outside of the 0-1 range, so we clamp before quantizing
+		_mm_store_ps(values, _mm_min_ps(_mm_max_ps(src[ix], zero), one));
+		uint8_t* out = &level.Data[ix * 4];
+		for (int c = 0; c < 4; c++) {
+			out[c] = (isSrgb && c < 3) ?
+				fromLinear[static_cast<int>(values[c] * 4095.0f + 0.5f)] :
+				static_cast<uint8_t>(values[c] * 255.0f + 0.5f);
+		}
+	}
+}
+
+#pragma endregion
+
+#pragma region Block Compression
+
+/// <summary>
+/// Reads a 4x4 block of RGBA8 pixels from an image, clamping at the edges for images that are not a multiple of 4
+/// </summary>
+static void ExtractBlock(const Texture2DMipChain::MipLevel& level, uint32_t blockX, uint32_t blockY, uint8_t block[16][4]) {
+	for (uint32_t y = 0; y < 4; y++) {
+		const uint32_t sy = std::min(blockY * 4 + y, level.Height - 1);
+		for (uint32_t x = 0; x < 4; x++) {
+			const uint32_t sx = std::min(blockX * 4 + x, level.Width - 1);
+			memcpy(block[y * 4 + x], &level.Data[((size_t)sy * level.Width + sx) * 4], 4);
+		}
+	}
+}
+
+/// <summary>
+/// Finds the two endpoints of the line that best fits the first <i>channels</i> components of the block,
+/// using the principal axis of the block's covariance matrix
+/// </summary>
+static void FitEndpoints(const uint8_t block[16][4], int channels, float minOut[4], float maxOut[4]) {
+	float mean[4] = { 0, 0, 0, 0 };
+	for (int ix = 0; ix < 16; ix++) {
+		for (int c = 0; c < channels; c++) {
+			mean[c] += block[ix][c];
+		}
+	}
+	for (int c = 0; c < channels; c++) {
+		mean[c] /= 16.0f;
+	}
+
+	float cov[4][4] = {};
+	for (int ix = 0; ix < 16; ix++) {
+		float d[4];
+		for (int c = 0; c < channels; c++) {
+			d[c] = block[ix][c] - mean[c];
+		}
+		for (int a = 0; a < channels; a++) {
+			for (int b = 0; b < channels; b++) {
+				cov[a][b] += d[a] * d[b];
+			}
+		}
+	}
+
+	// A few steps of power iteration is plenty to find the principal axis of a 4x4 block
+	float axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	for (int iter = 0; iter < 8; iter++) {
+		float next[4] = { 0, 0, 0, 0 };
+		float length = 0.0f;
+		for (int a = 0; a < channels; a++) {
+			for (int b = 0; b < channels; b++) {
+				next[a] += cov[a][b] * axis[b];
+			}
+			length = std::max(length, fabsf(next[a]));
+		}
+		if (length < 1e-6f) {
+			break;
+		}
+		for (int a = 0; a < channels; a++) {
+			axis[a] = next[a] / length;
+		}
+	}
+
+	float minT = FLT_MAX, maxT = -FLT_MAX;
+	for (int ix = 0; ix < 16; ix++) {
+		float t = 0.0f;
+		for (int c = 0; c < channels; c++) {
+			t += (block[ix][c] - mean[c]) * axis[c];
+		}
+		minT = std::min(minT, t);
+		maxT = std::max(maxT, t);
+	}
+
+	float axisLengthSq = 0.0f;
+	for (int c = 0; c < channels; c++) {
+		axisLengthSq += axis[c] * axis[c];
+	}
+	axisLengthSq = std::max(axisLengthSq, 1e-6f);
+
+	// Inset the endpoints slightly, this reduces the error for the interpolated values
+	const float inset = (maxT - minT) / 32.0f;
+	minT += inset;
+	maxT -= inset;
+	for (int c = 0; c < channels; c++) {
+		minOut[c] = std::clamp(mean[c] + axis[c] * minT / axisLengthSq, 0.0f, 255.0f);
+		maxOut[c] = std::clamp(mean[c] + axis[c] * maxT / axisLengthSq, 0.0f, 255.0f);
+	}
+}
+
+static inline uint16_t PackRgb565(const float color[3]) {
+	const uint16_t r = static_cast<uint16_t>(color[0] * 31.0f / 255.0f + 0.5f);
+	const uint16_t g = static_cast<uint16_t>(color[1] * 63.0f / 255.0f + 0.5f);
+	const uint16_t b = static_cast<uint16_t>(color[2] * 31.0f / 255.0f + 0.5f);
+	return (r << 11) | (g << 5) | b;
+}
+
+static inline void UnpackRgb565(uint16_t packed, int out[3]) {
+	const int r = (packed >> 11) & 31;
+	const int g = (packed >> 5) & 63;
+	const int b = packed & 31;
+	out[0] = (r << 3) | (r >> 2);
+	out[1] = (g << 2) | (g >> 4);
+	out[2] = (b << 3) | (b >> 2);
+}
+
+/// <summary>
+/// Encodes the colour portion of a BC1/BC3 block (8 bytes)
+/// </summary>
+/// <param name="allowAlpha">True to use BC1's punch-through alpha mode for blocks with transparent pixels</param>
+static void EncodeColorBlock(const uint8_t block[16][4], bool allowAlpha, uint8_t* out) {
+	bool hasTransparent = false;
+	if (allowAlpha) {
+		for (int ix = 0; ix < 16; ix++) {
+			hasTransparent |= block[ix][3] < 128;
+		}
+	}
+
+	float minColor[4], maxColor[4];
+	FitEndpoints(block, 3, minColor, maxColor);
+	uint16_t c0 = PackRgb565(maxColor);
+	uint16_t c1 = PackRgb565(minColor);
+
+	// 4 colour mode requires c0 > c1, 3 colour + transparent mode requires c0 <= c1
+	if ((c0 < c1 && !hasTransparent) || (c0 > c1 && hasTransparent)) {
+		std::swap(c0, c1);
+	}
+
+	int palette[4][3];
+	UnpackRgb565(c0, palette[0]);
+	UnpackRgb565(c1, palette[1]);
+	const bool fourColor = c0 > c1;
+	for (int c = 0; c < 3; c++) {
+		if (fourColor) {
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		} else {
+			palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+			palette[3][c] = 0;
+		}
+	}
+
+	uint32_t indices = 0;
+	for (int ix = 0; ix < 16; ix++) {
+		uint32_t best = 0;
+		if (hasTransparent && block[ix][3] < 128) {
+			best = 3;
+		} else {
+			int bestError = INT_MAX;
+			const int paletteSize = fourColor ? 4 : 3;
+			for (int p = 0; p < paletteSize; p++) {
+				const int dr = palette[p][0] - block[ix][0];
+				const int dg = palette[p][1] - block[ix][1];
+				const int db = palette[p][2] - block[ix][2];
+				const int error = dr * dr + dg * dg + db * db;
+				if (error < bestError) {
+					bestError = error;
+					best = p;
+				}
+			}
+		}
+		indices |= best << (ix * 2);
+	}
+
+	out[0] = c0 & 0xFF;
+	out[1] = c0 >> 8;
+	out[2] = c1 & 0xFF;
+	out[3] = c1 >> 8;
+	memcpy(out + 4, &indices, 4);
+}
+
+/// <summary>
+/// Encodes a single channel of a block into a BC4 block (8 bytes), used for BC3 alpha and BC5
+/// </summary>
+static void EncodeSingleChannelBlock(const uint8_t block[16][4], int channel, uint8_t* out) {
+	int minValue = 255, maxValue = 0;
+	for (int ix = 0; ix < 16; ix++) {
+		minValue = std::min<int>(minValue, block[ix][channel]);
+		maxValue = std::max<int>(maxValue, block[ix][channel]);
+	}
+
+	// We always use the 8 value mode, where a0 > a1
+	out[0] = static_cast<uint8_t>(maxValue);
+	out[1] = static_cast<uint8_t>(minValue);
+
+	int palette[8];
+	palette[0] = maxValue;
+	palette[1] = minValue;
+	for (int ix = 2; ix < 8; ix++) {
+		palette[ix] = ((8 - ix) * maxValue + (ix - 1) * minValue) / 7;
+	}
+
+	uint64_t indices = 0;
+	if (maxValue != minValue) {
+		for (int ix = 0; ix < 16; ix++) {
+			uint64_t best = 0;
+			int bestError = INT_MAX;
+			for (int p = 0; p < 8; p++) {
+				const int error = abs(palette[p] - block[ix][channel]);
+				if (error < bestError) {
+					bestError = error;
+					best = p;
+				}
+			}
+			indices |= best << (ix * 3);
+		}
+	}
+	for (int ix = 0; ix < 6; ix++) {
+		out[2 + ix] = static_cast<uint8_t>((indices >> (ix * 8)) & 0xFF);
+	}
+}
+
+namespace {
+/// <summary>
+/// Helper for writing the bitstream of a 128 bit BC7 block
+/// </summary>
+struct BlockBitWriter {
+	uint8_t* Data;
+	uint32_t Position = 0;
+
+	void Write(uint32_t value, uint32_t bitCount) {
+		for (uint32_t ix = 0; ix < bitCount; ix++, Position++) {
+			if ((value >> ix) & 1) {
+				Data[Position / 8] |= 1 << (Position % 8);
+			}
+		}
+	}
+};
+}
+
+/// <summary>
+/// Encodes a block into BC7 mode 6 (single subset, RGBA endpoints with 7 bits + a p-bit per endpoint, 4 bit indices).
+/// This is the highest precision mode for smooth blocks, and gives good quality for most content
+/// </summary>
+static void EncodeBC7Block(const uint8_t block[16][4], uint8_t* out) {
+	static const int WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	float endpoints[2][4];
+	FitEndpoints(block, 4, endpoints[0], endpoints[1]);
+
+	// Quantize each endpoint to 7 bits, picking the shared p-bit that minimizes the error
+	int quantized[2][4];
+	int pBits[2];
+	int expanded[2][4];
+	for (int e = 0; e < 2; e++) {
+		int bestError = INT_MAX;
+		for (int p = 0; p < 2; p++) {
+			int error = 0;
+			int q[4];
+			for (int c = 0; c < 4; c++) {
+				q[c] = std::clamp(static_cast<int>((endpoints[e][c] - p) / 2.0f + 0.5f), 0, 127);
+				const int d = ((q[c] << 1) | p) - static_cast<int>(endpoints[e][c] + 0.5f);
+				error += d * d;
+			}
+			if (error < bestError) {
+				bestError = error;
+				pBits[e] = p;
+				memcpy(quantized[e], q, sizeof(q));
+			}
+		}
+		for (int c = 0; c < 4; c++) {
+			expanded[e][c] = (quantized[e][c] << 1) | pBits[e];
+		}
+	}
+
+	int palette[16][4];
+	for (int ix = 0; ix < 16; ix++) {
+		for (int c = 0; c < 4; c++) {
+			palette[ix][c] = ((64 - WEIGHTS[ix]) * expanded[0][c] + WEIGHTS[ix] * expanded[1][c] + 32) >> 6;
+		}
+	}
+
+	int indices[16];
+	for (int ix = 0; ix < 16; ix++) {
+		int bestError = INT_MAX;
+		for (int p = 0; p < 16; p++) {
+			int error = 0;
+			for (int c = 0; c < 4; c++) {
+				const int d = palette[p][c] - block[ix][c];
+				error += d * d;
+			}
+			if (error < bestError) {
+				bestError = error;
+				indices[ix] = p;
+			}
+		}
+	}
+
+	// The MSB of the first index is implicitly zero, so we swap the endpoints if it would be set
+	if (indices[0] & 8) {
+		std::swap(quantized[0], quantized[1]);
+		std::swap(pBits[0], pBits[1]);
+		for (int ix = 0; ix < 16; ix++) {
+			indices[ix] = 15 - indices[ix];
+		}
+	}
+
+	memset(out, 0, 16);
+	BlockBitWriter writer{ out };
+	writer.Write(1 << 6, 7); // Mode 6
+	for (int c = 0; c < 4; c++) {
+		writer.Write(quantized[0][c], 7);
+		writer.Write(quantized[1][c], 7);
+	}
+	writer.Write(pBits[0], 1);
+	writer.Write(pBits[1], 1);
+	writer.Write(indices[0], 3);
+	for (int ix = 1; ix < 16; ix++) {
+		writer.Write(indices[ix], 4);
+	}
+}
+
+/// <summary>
+/// Encodes a single 4x4 block of pixels into the given format
+/// </summary>
+static void EncodeBlock(const uint8_t block[16][4], InternalFormat format, uint8_t* out) {
+	switch (format) {
+		case InternalFormat::BC1:
+		case InternalFormat::BC1_SRGB:
+			EncodeColorBlock(block, true, out);
+			break;
+		case InternalFormat::BC3:
+		case InternalFormat::BC3_SRGB:
+			EncodeSingleChannelBlock(block, 3, out);
+			EncodeColorBlock(block, false, out + 8);
+			break;
+		case InternalFormat::BC5:
+			EncodeSingleChannelBlock(block, 0, out);
+			EncodeSingleChannelBlock(block, 1, out + 8);
+			break;
+		case InternalFormat::BC7:
+		case InternalFormat::BC7_SRGB:
+			EncodeBC7Block(block, out);
+			break;
+		default:
+			LOG_ASSERT(false, "Format {} is not a supported block compression format", format);
+			break;
+	}
+}
+
+#pragma endregion
+
+InternalFormat TextureProcessor::ResolveFormat(const TextureProcessSettings& settings) {
+	if (!settings.IsSrgb) {
+		return settings.Format;
+	}
+	switch (settings.Format) {
+		case InternalFormat::RGBA8: return InternalFormat::SRGB8_ALPHA8;
+		case InternalFormat::BC1:   return InternalFormat::BC1_SRGB;
+		case InternalFormat::BC3:   return InternalFormat::BC3_SRGB;
+		case InternalFormat::BC7:   return InternalFormat::BC7_SRGB;
+		// BC5 is used for 2 channel data (ex: normal maps) which is never sRGB
+		default: return settings.Format;
+	}
+}
+
+Texture2DMipChain::sptr TextureProcessor::BuildMipChain(const Texture2DData::sptr& data, const TextureProcessSettings& settings) {
+	LOG_ASSERT(data != nullptr, "Cannot build a mip chain from null data!");
+
+	uint32_t width = data->GetWidth();
+	uint32_t height = data->GetHeight();
+	uint32_t levelCount = CalculateMipCount(width, height);
+	if (settings.MaxLevels > 0) {
+		levelCount = std::min(levelCount, settings.MaxLevels);
+	}
+
+	// IsSrgb is only a request, formats that are never sRGB (ex: BC5) keep their data linear
+	const bool isSrgb = IsSrgbFormat(ResolveFormat(settings));
+	Texture2DMipChain::sptr result = std::make_shared<Texture2DMipChain>(isSrgb ? InternalFormat::SRGB8_ALPHA8 : InternalFormat::RGBA8);
+	result->DebugName = data->DebugName;
+
+	// We do all filtering in linear space, otherwise sRGB textures get darker with each level
+	PixelImage current = ToLinearImage(data, isSrgb);
+	PixelImage next;
+	for (uint32_t level = 0; level < levelCount; level++) {
+		Texture2DMipChain::MipLevel& mip = result->AddLevel(width, height, (size_t)width * height * 4);
+		QuantizeLevel(current, mip, isSrgb);
+
+		if (level + 1 < levelCount) {
+			const uint32_t nextWidth = std::max(1u, width / 2);
+			const uint32_t nextHeight = std::max(1u, height / 2);
+			next.resize((size_t)nextWidth * nextHeight);
+			if (settings.Filter == MipFilter::Kaiser) {
+				DownsampleKaiser(current, width, height, next, nextWidth, nextHeight, settings.ThreadCount);
+			} else {
+				DownsampleBox(current, width, height, next, nextWidth, nextHeight, settings.ThreadCount);
+			}
+			std::swap(current, next);
+			width = nextWidth;
+			height = nextHeight;
+		}
+	}
+
+	return result;
+}
+
+Texture2DMipChain::sptr TextureProcessor::Compress(const Texture2DMipChain::sptr& chain, InternalFormat format, uint32_t threadCount) {
+	LOG_ASSERT(chain != nullptr && !chain->IsCompressed() && chain->GetPixelFormat() == PixelFormat::RGBA, "Can only compress RGBA8 mip chains!");
+	LOG_ASSERT(IsBlockCompressed(format), "Format {} is not a block compressed format", format);
+
+	const size_t blockSize = GetBlockSize(format);
+	Texture2DMipChain::sptr result = std::make_shared<Texture2DMipChain>(format);
+	result->DebugName = chain->DebugName;
+
+	for (uint32_t level = 0; level < chain->GetLevelCount(); level++) {
+		const Texture2DMipChain::MipLevel& src = chain->GetLevel(level);
+		Texture2DMipChain::MipLevel& dst = result->AddLevel(src.Width, src.Height, Texture2DMipChain::GetImageSize(src.Width, src.Height, format, PixelFormat::RGBA));
+
+		const uint32_t blocksX = (src.Width + 3) / 4;
+		const uint32_t blocksY = (src.Height + 3) / 4;
+
+		// Each row of blocks is independent, so we can split the rows between our workers
+		ParallelFor(blocksY, threadCount, [&](size_t start, size_t end) {
+			uint8_t block[16][4];
+			for (uint32_t by = (uint32_t)start; by < (uint32_t)end; by++) {
+				for (uint32_t bx = 0; bx < blocksX; bx++) {
+					ExtractBlock(src, bx, by, block);
+					EncodeBlock(block, format, &dst.Data[((size_t)by * blocksX + bx) * blockSize]);
+				}
+			}
+		});
+	}
+
+	return result;
+}
+
+Texture2DMipChain::sptr TextureProcessor::Process(const Texture2DData::sptr& data, const TextureProcessSettings& settings) {
+	Texture2DMipChain::sptr chain = BuildMipChain(data, settings);
+	const InternalFormat format = ResolveFormat(settings);
+	if (IsBlockCompressed(format)) {
+		chain = Compress(chain, format, settings.ThreadCount);
+	}
+	return chain;
+}
+
+Texture2DMipChain::sptr TextureProcessor::LoadOrProcess(const std::string& file, const TextureProcessSettings& settings, const std::string& cacheDirectory) {
+	namespace fs = std::filesystem;
+	std::error_code error;
+
+	// The stamp identifies both the state of the source file and the settings used to process it
+	const fs::path sourcePath = fs::path(file);
+	const auto writeTime = fs::last_write_time(sourcePath, error);
+	const uintmax_t fileSize = fs::file_size(sourcePath, error);
+	uint64_t stamp = static_cast<uint64_t>(writeTime.time_since_epoch().count());
+	stamp = stamp * 31 + fileSize;
+	stamp = stamp * 31 + static_cast<uint64_t>(*ResolveFormat(settings));
+	stamp = stamp * 31 + static_cast<uint64_t>(settings.Filter);
+	stamp = stamp * 31 + settings.MaxLevels;
+
+	// Name the cache entry after the source so it's easy to find, with a hash of the full path to avoid collisions
+	const size_t pathHash = std::hash<std::string>()(fs::absolute(sourcePath, error).string());
+	const fs::path cachePath = fs::path(cacheDirectory) / (sourcePath.stem().string() + "_" + std::to_string(pathHash) + ".otex");
+
+	uint64_t cachedStamp = 0;
+	Texture2DMipChain::sptr result = Texture2DMipChain::LoadFromFile(cachePath.string(), &cachedStamp);
+	if (result != nullptr && cachedStamp == stamp) {
+		result->DebugName = sourcePath.filename().string();
+		return result;
+	}
+
+	LOG_INFO("Processing texture \"{}\" into the cache", file);
+	Texture2DData::sptr data = Texture2DData::LoadFromFile(file, true);
+	if (data == nullptr) {
+		return nullptr;
+	}
+	result = Process(data, settings);
+
+	fs::create_directories(cachePath.parent_path(), error);
+	if (!result->SaveToFile(cachePath.string(), stamp)) {
+		LOG_WARN("Failed to write texture cache entry \"{}\"", cachePath.string());
+	}
+	return result;
+}
@@ -6,7 +6,10 @@
 VertexArrayObject::VertexArrayObject() :
 	_indexBuffer(nullptr),
 	_handle(0),
-	_vertexCount(0)
+	_vertexCount(0),
+	_dequantization(glm::mat4(1.0f)),
+	_hasQuantizedPositions(false),
+	_hasOctahedralNormals(false)
 {
 	glCreateVertexArrays(1, &_handle);
 }
@@ -46,6 +49,9 @@ void VertexArrayObject::AddVertexBuffer(const VertexBuffer::sptr& buffer, const
 	Bind();
 	buffer->Bind();
 	for (const BufferAttribute& attrib : attributes) {
+		if (attrib.Usage == AttribUsage::Normal) {
+			_hasOctahedralNormals = attrib.Size == 2;
+		}
 		glEnableVertexArrayAttrib(_handle, attrib.Slot);
 		glVertexAttribPointer(attrib.Slot, attrib.Size, attrib.Type, attrib.Normalized, attrib.Stride, (void*)attrib.Offset);
 	}
@@ -53,6 +59,15 @@ void VertexArrayObject::AddVertexBuffer(const VertexBuffer::sptr& buffer, const
 
 }
 
+void VertexArrayObject::SetPositionDequantization(const glm::vec3& offset, const glm::vec3& scale) {
+	_dequantization = glm::mat4(
+		glm::vec4(scale.x, 0.0f, 0.0f, 0.0f),
+		glm::vec4(0.0f, scale.y, 0.0f, 0.0f),
+		glm::vec4(0.0f, 0.0f, scale.z, 0.0f),
+		glm::vec4(offset, 1.0f));
+	_hasQuantizedPositions = true;
+}
+
 void VertexArrayObject::Bind() const {
 	glBindVertexArray(_handle);
 }
@@ -61,12 +76,45 @@ void VertexArrayObject::UnBind() {
 	glBindVertexArray(0);
 }
 
-void VertexArrayObject::Render() const {
+GLsizei VertexArrayObject::GetTriangleCount(int lod) const {
+	if (!_lods.empty()) {
+		return _lods[glm::clamp(lod, 0, (int)_lods.size() - 1)].IndexCount / 3;
+	}
+	return (_indexBuffer != nullptr ? (GLsizei)_indexBuffer->GetElementCount() : _vertexCount) / 3;
+}
+
+size_t VertexArrayObject::GetMemoryUsage() const {
+	size_t result = _indexBuffer != nullptr ? _indexBuffer->GetTotalSize() : 0;
+	for (const VertexBufferBinding& binding : _vertexBuffers) {
+		result += binding.Buffer->GetTotalSize();
+	}
+	return result;
+}
+
+int VertexArrayObject::SelectLod(float pixelsPerUnit, float maxPixelError) const {
+	int result = 0;
+	// Levels are ordered by increasing error, so take the last one that is still acceptable
+	for (int ix = 1; ix < (int)_lods.size(); ix++) {
+		if (_lods[ix].Error * pixelsPerUnit > maxPixelError) {
+			break;
+		}
+		result = ix;
+	}
+	return result;
+}
+
+void VertexArrayObject::Render(int lod) const {
 	Bind();
 	if (_indexBuffer != nullptr) {
-		glDrawElements(GL_TRIANGLES, _indexBuffer->GetElementCount(), _indexBuffer->GetElementType(), nullptr);
+		if (!_lods.empty()) {
+			const LodLevel& level = _lods[glm::clamp(lod, 0, (int)_lods.size() - 1)];
+			const size_t indexSize = _indexBuffer->GetElementType() == GL_UNSIGNED_INT ? 4 : (_indexBuffer->GetElementType() == GL_UNSIGNED_SHORT ? 2 : 1);
+			glDrawElements(GL_TRIANGLES, level.IndexCount, _indexBuffer->GetElementType(), (void*)(level.IndexOffset * indexSize));
+		} else {
+			glDrawElements(GL_TRIANGLES, _indexBuffer->GetElementCount(), _indexBuffer->GetElementType(), nullptr);
+		}
 	} else {
-		glDrawArrays(GL_TRIANGLES, 0, _vertexCount / 3);
+		glDrawArrays(GL_TRIANGLES, 0, _vertexCount);
 	}
 	UnBind();
 }
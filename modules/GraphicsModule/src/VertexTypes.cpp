@@ -5,6 +5,8 @@ VertexPosCol* VPC = nullptr;
 VertexPosNormCol* VPNC = nullptr;
 VertexPosNormTex* VPNT = nullptr;
 VertexPosNormTexCol* VPNTC = nullptr;
+VertexPosNormTexColPacked* VPNTCP = nullptr;
+VertexQuantizedPosNormTexCol* VQPNTC = nullptr;
 
 const std::vector<BufferAttribute> VertexPosCol::V_DECL = {
 	BufferAttribute(0, 3, GL_FLOAT, false, sizeof(VertexPosCol), (size_t)&VPC->Position, AttribUsage::Position),
@@ -26,4 +28,18 @@ const std::vector<BufferAttribute> VertexPosNormTexCol::V_DECL = {
 	BufferAttribute(2, 3, GL_FLOAT, false, sizeof(VertexPosNormTexCol), (size_t)&VPNTC->Normal, AttribUsage::Normal),
 	BufferAttribute(3, 2, GL_FLOAT, false, sizeof(VertexPosNormTexCol), (size_t)&VPNTC->UV, AttribUsage::Texture),
 };
+// Packed formats use 2 component normals (octahedral encoded) in the normal slot, our vertex shaders decode
+// them when u_OctahedralNormals is set
+const std::vector<BufferAttribute> VertexPosNormTexColPacked::V_DECL = {
+	BufferAttribute(0, 3, GL_FLOAT, false, sizeof(VertexPosNormTexColPacked), (size_t)&VPNTCP->Position, AttribUsage::Position),
+	BufferAttribute(1, 4, GL_UNSIGNED_BYTE, true, sizeof(VertexPosNormTexColPacked), (size_t)&VPNTCP->Color, AttribUsage::Color),
+	BufferAttribute(2, 2, GL_SHORT, true, sizeof(VertexPosNormTexColPacked), (size_t)&VPNTCP->Normal, AttribUsage::Normal),
+	BufferAttribute(3, 2, GL_HALF_FLOAT, false, sizeof(VertexPosNormTexColPacked), (size_t)&VPNTCP->UV, AttribUsage::Texture),
+};
+const std::vector<BufferAttribute> VertexQuantizedPosNormTexCol::V_DECL = {
+	BufferAttribute(0, 3, GL_UNSIGNED_SHORT, true, sizeof(VertexQuantizedPosNormTexCol), (size_t)&VQPNTC->Position, AttribUsage::Position),
+	BufferAttribute(1, 4, GL_UNSIGNED_BYTE, true, sizeof(VertexQuantizedPosNormTexCol), (size_t)&VQPNTC->Color, AttribUsage::Color),
+	BufferAttribute(2, 2, GL_SHORT, true, sizeof(VertexQuantizedPosNormTexCol), (size_t)&VQPNTC->Normal, AttribUsage::Normal),
+	BufferAttribute(3, 2, GL_HALF_FLOAT, false, sizeof(VertexQuantizedPosNormTexCol), (size_t)&VQPNTC->UV, AttribUsage::Texture),
+};
 #pragma warning(pop)
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "VirtualFileSystem.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+#include "Logging.h"
+
+std::mutex                     VirtualFileSystem::_mutex;
+std::vector<FileArchive::sptr> VirtualFileSystem::_archives;
+bool                           VirtualFileSystem::_looseFilesEnabled = true;
+std::atomic<uint32_t>          VirtualFileSystem::_archiveReads(0);
+std::atomic<uint32_t>          VirtualFileSystem::_looseReads(0);
+
+bool VirtualFileSystem::Mount(const std::string& archivePath) {
+	FileArchive::sptr archive = FileArchive::Open(archivePath);
+	if (archive == nullptr) {
+		return false;
+	}
+	Mount(archive);
+	LOG_INFO("Mounted archive \"{}\" with {} files", archivePath, archive->GetEntryCount());
+	return true;
+}
+
+void VirtualFileSystem::Mount(const FileArchive::sptr& archive) {
+	LOG_ASSERT(archive != nullptr, "Cannot mount a null archive!");
+	std::lock_guard<std::mutex> lock(_mutex);
+	_archives.push_back(archive);
+}
+
+void VirtualFileSystem::Unmount(const FileArchive::sptr& archive) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_archives.erase(std::remove(_archives.begin(), _archives.end(), archive), _archives.end());
+}
+
+void VirtualFileSystem::UnmountAll() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_archives.clear();
+}
+
+std::vector<FileArchive::sptr> VirtualFileSystem::GetMounted() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _archives;
+}
+
+void VirtualFileSystem::SetLooseFilesEnabled(bool enabled) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_looseFilesEnabled = enabled;
+}
+
+bool VirtualFileSystem::GetLooseFilesEnabled() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _looseFilesEnabled;
+}
+
+bool VirtualFileSystem::Exists(const std::string& path) {
+	std::vector<FileArchive::sptr> archives;
+	bool looseFiles;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		archives = _archives;
+		looseFiles = _looseFilesEnabled;
+	}
+	for (auto it = archives.rbegin(); it != archives.rend(); it++) {
+		if ((*it)->Contains(path)) {
+			return true;
+		}
+	}
+	std::error_code error;
+	return looseFiles && std::filesystem::is_regular_file(path, error);
+}
+
+bool VirtualFileSystem::IsArchived(const std::string& path) {
+	std::vector<FileArchive::sptr> archives;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		archives = _archives;
+	}
+	for (const FileArchive::sptr& archive : archives) {
+		if (archive->Contains(path)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+VirtualFile::sptr VirtualFileSystem::Open(const std::string& path) {
+	// We take a copy of the list so the lock isn't held while we decompress or read from disk
+	std::vector<FileArchive::sptr> archives;
+	bool looseFiles;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		archives = _archives;
+		looseFiles = _looseFilesEnabled;
+	}
+	for (auto it = archives.rbegin(); it != archives.rend(); it++) {
+		VirtualFile::sptr result = (*it)->OpenFile(path);
+		if (result != nullptr) {
+			_archiveReads++;
+			return result;
+		}
+	}
+	if (!looseFiles) {
+		return nullptr;
+	}
+
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file.is_open()) {
+		return nullptr;
+	}
+	std::vector<uint8_t> data(static_cast<size_t>(file.tellg()));
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(data.data()), data.size());
+	_looseReads++;
+	return VirtualFile::Create(std::move(data));
+}
+
+bool VirtualFileSystem::ReadText(const std::string& path, std::string& text) {
+	VirtualFile::sptr file = Open(path);
+	if (file == nullptr) {
+		return false;
+	}
+	text = file->GetText();
+	return true;
+}
\ No newline at end of file
@@ -25,12 +25,21 @@ namespace nou
 		//because of how ENTT manages memory.
 		//By putting the transform here and managing our own Entity objects carefully,
 		//we make sure that our pointers will be stable - which is important
-		//in a hierarchy with transforms storing pointers to parent/child objects.
+		//in a hierarchy with transforms linking to parent/child objects.
 		Transform transform;
 
 		static Entity Create();
+		//Entities made with Allocate (or new) come from a shared pool, so
+		//they stay put in memory but sit next to each other rather than
+		//being scattered around the heap.
 		static std::unique_ptr<Entity> Allocate();
 
+		//Number of entities currently allocated from the pool.
+		static size_t GetPooledCount();
+
+		static void* operator new(size_t size);
+		static void operator delete(void* ptr, size_t size);
+
 		Entity(entt::entity id);
 		Entity(Entity&&) = delete;
 
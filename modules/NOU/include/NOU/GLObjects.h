@@ -113,6 +113,78 @@ namespace nou
 		bool m_dynamic;
 	};
 
+	//Class for managing OpenGL index buffers (also called element buffers, or EBOs).
+	//An index buffer lets many triangles share the same vertices - instead of
+	//spelling out every triangle corner in our vertex buffers, we store each
+	//unique vertex once and list which vertices make up each triangle.
+	//Indices can be stored as 8, 16, or 32-bit integers. Smaller is better
+	//(less memory, less bandwidth), as long as the largest index still fits!
+	//As with VertexBuffer, this class is intended to be used via pointers.
+	class IndexBuffer
+	{
+		public:
+
+		template<typename T>
+		IndexBuffer(const std::vector<T>& data)
+		{
+			m_len = 0;
+			m_type = GL_UNSIGNED_INT;
+
+			glGenBuffers(1, &m_id);
+			UpdateData(data);
+		}
+
+		~IndexBuffer()
+		{
+			glDeleteBuffers(1, &m_id);
+		}
+
+		IndexBuffer(const IndexBuffer&) = delete;
+
+		GLsizei Length() const { return m_len; }
+
+		//One of GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, or GL_UNSIGNED_INT.
+		GLenum ElementType() const { return m_type; }
+
+		GLsizei ElementSize() const
+		{
+			return (m_type == GL_UNSIGNED_BYTE) ? 1 : (m_type == GL_UNSIGNED_SHORT) ? 2 : 4;
+		}
+
+		GLuint GetID() const { return m_id; }
+
+		//Only GLubyte, GLushort, and GLuint are valid index types in OpenGL.
+		template<typename T>
+		void UpdateData(const std::vector<T>& data)
+		{
+			static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4,
+						  "Indices must be 8, 16, or 32-bit unsigned integers.");
+
+			m_len = (GLsizei)data.size();
+			m_type = (sizeof(T) == 1) ? GL_UNSIGNED_BYTE :
+					 (sizeof(T) == 2) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+			//Note that index buffers are bound to GL_ELEMENT_ARRAY_BUFFER.
+			//This binding is part of VAO state, so we unbind any VAO first to avoid
+			//accidentally attaching this buffer to whatever was drawn last.
+			glBindVertexArray(0);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_id);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)m_len * sizeof(T),
+						 (m_len > 0) ? &(data[0]) : nullptr, GL_STATIC_DRAW);
+		}
+
+		protected:
+
+		//The OpenGL ID of our index buffer.
+		GLuint m_id;
+
+		//The number of indices in our buffer (3 per triangle).
+		GLsizei m_len;
+
+		//The data type of a single index.
+		GLenum m_type;
+	};
+
 	//Class for managing OpenGL Vertex Array Objects (VAOs).
 	//Just as with VertexBuffer, as written, this class is intended to be used via pointers.
 	class VertexArray
@@ -136,6 +208,7 @@ namespace nou
 			m_drawMode = DrawMode::TRIANGLES;
 			glGenVertexArrays(1, &m_id);
 			m_len = 0;
+			m_ibo = nullptr;
 		}
 
 		~VertexArray()
@@ -240,6 +313,17 @@ namespace nou
 														 (long long)buf.ElementSize()));
 		}
 
+		//Associates an index buffer with our vertex array object.
+		//Once set, Draw will draw using the indices instead of reading our vertex
+		//buffers in order. Pass in nullptr to go back to non-indexed drawing.
+		void BindIndices(const IndexBuffer* buf)
+		{
+			m_ibo = buf;
+
+			glBindVertexArray(m_id);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, (buf != nullptr) ? buf->GetID() : 0);
+		}
+
 		void SetDrawMode(DrawMode drawMode)
 		{
 			m_drawMode = drawMode;
@@ -247,10 +331,27 @@ namespace nou
 
 		void Draw()
 		{
+			glBindVertexArray(m_id);
+
+			if (m_ibo != nullptr)
+			{
+				glDrawElements((int)m_drawMode, m_ibo->Length(), m_ibo->ElementType(), nullptr);
+				return;
+			}
+
 			m_len = m_vbos.begin()->second->Length();
+			glDrawArrays((int)m_drawMode, 0, m_len);
+		}
+
+		//Draws only part of our data, starting from the given vertex.
+		//(Useful when many objects share one buffer, e.g., for batching.)
+		void DrawRange(GLint first, GLsizei count)
+		{
+			if (count == 0)
+				return;
 
 			glBindVertexArray(m_id);
-			glDrawArrays((int)m_drawMode, 0, m_len);
+			glDrawArrays((int)m_drawMode, first, count);
 		}
 
 		void DrawElements(const std::vector<GLuint>& indices, size_t count)
@@ -275,6 +376,9 @@ namespace nou
 
 		//A record of the VBOs associated with this VAO.
 		std::map<GLint, const VertexBuffer*> m_vbos;
+
+		//The index buffer associated with this VAO, if any.
+		const IndexBuffer* m_ibo;
 	};
 }
 
@@ -10,8 +10,15 @@ Helpful reference: https://www.khronos.org/files/gltf20-reference-guide.pdf
 #pragma once
 
 #include "Mesh.h"
+#include "Entity.h"
+#include "Material.h"
+
+#include "GLM/gtc/quaternion.hpp"
 
 #include <string>
+#include <vector>
+#include <memory>
+#include <functional>
 
 //Forward declaration of objects defined by the tinyGLTF library.
 namespace tinygltf
@@ -30,8 +37,122 @@ namespace nou::GLTF
 		int elementSize;
 	};
 
+	//A single interleaved vertex, as produced by LoadScene.
+	//The layout (position, normal, UV, color) matches VertexPosNormTexCol,
+	//so the data can be handed straight to a MeshBuilder (see AppendToBuilder).
+	struct Vertex
+	{
+		glm::vec3 pos;
+		glm::vec3 normal;
+		glm::vec2 uv;
+		glm::vec4 color;
+	};
+
+	//Part of a mesh that came from a single glTF primitive.
+	struct SubMesh
+	{
+		//Where this primitive's triangles start in MeshData::indices,
+		//and how many indices it uses.
+		size_t firstIndex;
+		size_t indexCount;
+		//Index of the glTF material used by the primitive (-1 if none).
+		int material;
+	};
+
+	//Indexed geometry for one glTF mesh.
+	//All of the mesh's primitives are merged into one vertex and index list,
+	//so the whole mesh can be drawn in a single call.
+	struct MeshData
+	{
+		std::string name;
+		std::vector<Vertex> verts;
+		std::vector<GLuint> indices;
+		std::vector<SubMesh> subMeshes;
+
+		//Size in bytes of the widest index type used by the file (1, 2, or 4).
+		int sourceIndexSize = 0;
+
+		bool hasNormals = true;
+		bool hasUVs = true;
+		bool hasColors = true;
+	};
+
+	//One node of the glTF scene hierarchy.
+	struct NodeData
+	{
+		std::string name;
+		//Index into SceneData::meshes, or -1 for nodes without geometry.
+		int mesh = -1;
+		//Index into SceneData::nodes, or -1 for root nodes.
+		int parent = -1;
+
+		glm::vec3 pos = glm::vec3(0.0f);
+		glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+		glm::vec3 scale = glm::vec3(1.0f);
+	};
+
+	//Everything LoadScene pulls out of a file.
+	//Nodes are sorted so that parents always come before their children.
+	struct SceneData
+	{
+		std::vector<MeshData> meshes;
+		std::vector<NodeData> nodes;
+	};
+
+	//Functions the loader uses to get at files, so models can come from somewhere
+	//other than the disk (e.g. an archive mounted in the VirtualFileSystem).
+	//Every file is read through these, including any .bin buffers and images the model references.
+	//Anything left empty falls back to reading from disk.
+	struct FileCallbacks
+	{
+		std::function<bool(const std::string& path)> exists;
+		std::function<bool(const std::string& path, std::vector<unsigned char>& data)> read;
+	};
+
+	//Replaces the functions used to read files, for every load that starts after this.
+	//Pass an empty FileCallbacks to go back to reading from disk.
+	void SetFileCallbacks(const FileCallbacks& callbacks);
+
 	//Loads a 3D model into the mesh object given.
+	//This flattens the first mesh in the file into a list of triangles (no indices).
 	void LoadMesh(const std::string& filename, Mesh& mesh, bool flipUVY = true);
+
+	//Loads every mesh and node in the file, keeping the index buffers.
+	//Accessors are decoded on up to numThreads threads (0 = one per hardware thread).
+	bool LoadScene(const std::string& filename, SceneData& scene,
+				   bool flipUVY = true, unsigned int numThreads = 0);
+
+	//Loads every mesh in the file into a single indexed mesh object.
+	//Node transforms are not applied - use LoadScene if you need the hierarchy.
+	void LoadIndexedMesh(const std::string& filename, Mesh& mesh, bool flipUVY = true);
+
+	//Uploads the indexed geometry to the mesh object given.
+	void BuildMesh(const MeshData& data, Mesh& mesh);
+
+	//Creates one entity per node in the scene, with transforms parented to match
+	//the glTF hierarchy. Nodes with geometry are given a CMeshRenderer using mat.
+	//The meshes and entities are appended to the given lists, which own them -
+	//keep them alive for as long as you are using the scene!
+	void InstantiateScene(const SceneData& scene, Material& mat,
+						  std::vector<std::unique_ptr<Mesh>>& meshes,
+						  std::vector<std::unique_ptr<Entity>>& entities);
+
+	//Appends a mesh to a MeshBuilder (or anything with the same AddVertex/AddIndex
+	//interface), e.g. MeshBuilder<VertexPosNormTexCol>.
+	template<typename Builder>
+	void AppendToBuilder(const MeshData& data, Builder& builder)
+	{
+		uint32_t baseVertex = static_cast<uint32_t>(builder.GetVertexCount());
+
+		builder.ReserveVertexSpace(data.verts.size());
+		builder.ReserveIndexSpace(data.indices.size());
+
+		for (const Vertex& v : data.verts)
+			builder.AddVertex(v.pos, v.normal, v.uv, v.color);
+
+		for (GLuint index : data.indices)
+			builder.AddIndex(baseVertex + index);
+	}
 	
 	void DumpErrorsAndWarnings(const std::string& filename,
 							   const std::string& err,
@@ -41,6 +162,10 @@ namespace nou::GLTF
 	bool ParseGLTF(const std::string& filename, tinygltf::Model& gltf,
 				   std::string& err, std::string& warn);
 
+	//Takes a glTF model and extracts every mesh and node, keeping the index buffers.
+	bool ExtractScene(const tinygltf::Model& gltf, SceneData& scene, bool flipUVY,
+					  unsigned int numThreads, std::string& err, std::string& warn);
+
 	//Takes a glTF model and extracts vertex positions, normals, and texture coordinates.
 	bool ExtractGeometry(const tinygltf::Model& gltf, Mesh& mesh, bool flipUVY,
 					     std::string& err, std::string& warn);
@@ -54,4 +179,7 @@ namespace nou::GLTF
 	//Utility functions for more easily accessing data stored in glTF buffers.
 	int FindAccessor(const tinygltf::Primitive& geom, const std::string& name);
 	DataGetter BuildGetter(const tinygltf::Model& gltf, int accIndex);
+
+	//Reads a single index from an 8, 16, or 32-bit index accessor.
+	GLuint ReadIndex(const DataGetter& getter, size_t i);
 }
\ No newline at end of file
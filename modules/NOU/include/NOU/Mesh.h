@@ -41,18 +41,29 @@ namespace nou
 		void SetNormals(const std::vector<glm::vec3>& normals);
 		void SetUVs(const std::vector<glm::vec2>& uvs);
 
+		//Sets the triangle indices for this mesh. Meshes with indices store each
+		//unique vertex only once, rather than once per triangle corner.
+		//The indices are uploaded using the smallest type that fits the largest index
+		//(8, 16, or 32-bit). Pass in an empty vector to go back to non-indexed drawing.
+		void SetIndices(const std::vector<GLuint>& indices);
+
 		//Fetches a vertex buffer associated with the desired attribute.
 		//Used by mesh rendering components to grab the requisite data
 		//associated with this model in OpenGL.
 		const VertexBuffer* GetVBO(Attrib attrib) const;
 
+		//Fetches the index buffer for this mesh, or nullptr if the mesh is not indexed.
+		const IndexBuffer* GetIBO() const;
+
 		protected:
 
 		std::vector<glm::vec3> m_verts;
 		std::vector<glm::vec3> m_normals;
 		std::vector<glm::vec2> m_uvs;
+		std::vector<GLuint> m_indices;
 
 		std::map<Attrib, std::unique_ptr<VertexBuffer>> m_vbo;
+		std::unique_ptr<IndexBuffer> m_ibo;
 
 		//Sets up a VertexBuffer for the desired attribute.
 		template<typename T>
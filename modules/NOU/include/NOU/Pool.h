@@ -0,0 +1,114 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+Pool.h
+Simple chunked pool allocator for objects that need stable addresses.
+*/
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstddef>
+
+namespace nou
+{
+	//Hands out storage for objects of a single type from large chunks.
+	//Objects allocated one after another end up next to each other in memory
+	//rather than scattered around the heap, which makes walking over them
+	//(e.g., during FK) much kinder to the cache.
+	//Chunks are never moved or freed while the pool is alive, so the address
+	//of an object will not change for as long as it lives.
+	//Note that the pool only manages memory - constructing and destroying
+	//the objects is up to the caller (e.g., via placement new).
+	//Allocate and Free can be called from any thread.
+	template<typename T, size_t ChunkSize = 256>
+	class Pool
+	{
+		public:
+
+		Pool() = default;
+		~Pool() = default;
+
+		//The pool owns its chunks, so no copying or moving.
+		Pool(const Pool&) = delete;
+		Pool(Pool&&) = delete;
+		Pool& operator=(const Pool&) = delete;
+		Pool& operator=(Pool&&) = delete;
+
+		//Returns storage for one object of type T.
+		void* Allocate()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if (m_free == nullptr)
+				AddChunk();
+
+			Slot* slot = m_free;
+			m_free = slot->next;
+			++m_used;
+
+			return slot->storage;
+		}
+
+		//Returns storage obtained from Allocate to the pool.
+		//The object in it must already have been destroyed.
+		void Free(void* ptr)
+		{
+			if (ptr == nullptr)
+				return;
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			//Storage is the first (and only) member of the slot, so the
+			//pointer we handed out is also the address of the slot.
+			Slot* slot = static_cast<Slot*>(ptr);
+			slot->next = m_free;
+			m_free = slot;
+			--m_used;
+		}
+
+		//Number of objects currently allocated from the pool.
+		size_t GetUsed() const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_used;
+		}
+
+		//Number of objects the pool can hold before it needs another chunk.
+		size_t GetCapacity() const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_chunks.size() * ChunkSize;
+		}
+
+		protected:
+
+		union Slot
+		{
+			Slot* next;
+			alignas(T) unsigned char storage[sizeof(T)];
+		};
+
+		std::vector<std::unique_ptr<Slot[]>> m_chunks;
+		Slot* m_free = nullptr;
+		size_t m_used = 0;
+		mutable std::mutex m_mutex;
+
+		void AddChunk()
+		{
+			m_chunks.emplace_back(new Slot[ChunkSize]);
+			Slot* chunk = m_chunks.back().get();
+
+			//Push the new slots onto the free list back to front, so that
+			//they are handed out in order of increasing address.
+			for (size_t i = ChunkSize; i > 0; --i)
+			{
+				chunk[i - 1].next = m_free;
+				m_free = &chunk[i - 1];
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -14,21 +14,30 @@ Simple class for managing object transforms with basic hierarchy support.
 #include "GLM/gtx/quaternion.hpp"
 
 #include <vector>
+#include <cstdint>
 
 //Simple implementation of a transform component.
 
 namespace nou
 {
+	//Where the data for each transform actually lives (see Transform.cpp).
+	struct TransformNode;
+
 	class Transform
 	{
 		public:
 
-		glm::vec3 m_pos;
-		glm::vec3 m_scale;
-		glm::quat m_rotation;
+		//These refer to our node in the shared transform storage, so they
+		//can be read and written just like normal members.
+		glm::vec3& m_pos;
+		glm::vec3& m_scale;
+		glm::quat& m_rotation;
 
 		Transform();
-		Transform(const Transform& other) = default;
+		//Copies the local transform and joins the same parent as other.
+		//Children are NOT copied - a child can only have one parent.
+		Transform(const Transform& other);
+		Transform& operator=(const Transform& other);
 		virtual ~Transform();
 
 		//This will update the transform on the object
@@ -58,12 +67,22 @@ namespace nou
 		//Pass in nullptr if you wish for the object to not have a parent.
 		void SetParent(Transform* parent);
 
-		protected:
+		//Returns the parent object, or nullptr if there isn't one.
+		Transform* GetParent() const;
 
-		Transform* m_parent;
-		std::vector<Transform*> m_children;
+		protected:
 
-		glm::mat4 m_global;
+		//Our local transform, global transform, and links to our parent,
+		//children and siblings all live in a node in one big shared pool,
+		//rather than in the transform itself. Nodes link to each other by
+		//index, so DoFK only ever walks through the pool (which is stored
+		//in large contiguous chunks) rather than hopping around the heap.
+		//Nodes never move, so it's safe to keep a pointer to ours.
+		int32_t m_index;
+		TransformNode* m_node;
+
+		//Used by our public constructors once a node has been set aside.
+		explicit Transform(int32_t index);
 
 		//These functions are protected since they will be handled
 		//by SetParent - we don't want to have to manually update this ourselves
@@ -48,6 +48,10 @@ namespace nou
 
 		if ((vbo = mesh.GetVBO(Mesh::Attrib::UV)) != nullptr)
 			m_vao->BindAttrib(*vbo, (GLint)Mesh::Attrib::UV);
+
+		//Indexed meshes are drawn through their index buffer.
+		//(GetIBO returns nullptr for non-indexed meshes, which unbinds any old one.)
+		m_vao->BindIndices(mesh.GetIBO());
 	}
 
 	void CMeshRenderer::SetMaterial(Material& mat)
@@ -7,11 +7,20 @@ Minimal and lightly OOP wrapper for the ENTT framework.
 */
 
 #include "NOU/Entity.h"
+#include "NOU/Pool.h"
 
 namespace nou
 {
 	entt::registry Entity::ecs;
 
+	static Pool<Entity>& GetPool()
+	{
+		//Deliberately never deleted, so entities destroyed during static
+		//destruction (in any order) can still be returned to the pool.
+		static Pool<Entity>* pool = new Pool<Entity>();
+		return *pool;
+	}
+
 	Entity Entity::Create()
 	{
 		entt::entity id = ecs.create();
@@ -34,4 +43,27 @@ namespace nou
 		if(m_id != entt::null)
 			ecs.destroy(m_id);
 	}
+
+	size_t Entity::GetPooledCount()
+	{
+		return GetPool().GetUsed();
+	}
+
+	void* Entity::operator new(size_t size)
+	{
+		//Classes derived from Entity may be bigger than our slots,
+		//so those just go on the heap as usual.
+		if (size != sizeof(Entity))
+			return ::operator new(size);
+
+		return GetPool().Allocate();
+	}
+
+	void Entity::operator delete(void* ptr, size_t size)
+	{
+		if (size != sizeof(Entity))
+			::operator delete(ptr);
+		else
+			GetPool().Free(ptr);
+	}
 }
\ No newline at end of file
@@ -8,13 +8,30 @@ Helpful reference: https://www.khronos.org/files/gltf20-reference-guide.pdf
 */
 
 #include "NOU/GLTFLoader.h"
+#include "NOU/CMeshRenderer.h"
+
+#include "GLM/gtx/matrix_decompose.hpp"
 
 #include <sstream>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <mutex>
 
 #include "tiny_gltf.h"
 
 namespace nou::GLTF
 {
+	//Set by SetFileCallbacks, guarded since loads can happen on any thread.
+	static FileCallbacks fileCallbacks;
+	static std::mutex fileCallbacksMutex;
+
+	void SetFileCallbacks(const FileCallbacks& callbacks)
+	{
+		std::lock_guard<std::mutex> lock(fileCallbacksMutex);
+		fileCallbacks = callbacks;
+	}
+
 	void LoadMesh(const std::string& filename, Mesh& mesh, bool flipUVY)
 	{
 		auto gltf = std::make_unique<tinygltf::Model>();
@@ -78,6 +95,47 @@ namespace nou::GLTF
 
 		bool binary = ext == "glb";
 
+		//Route tinyGLTF's file access through our callbacks, if we have any.
+		FileCallbacks callbacks;
+		{
+			std::lock_guard<std::mutex> lock(fileCallbacksMutex);
+			callbacks = fileCallbacks;
+		}
+
+		if (callbacks.exists || callbacks.read)
+		{
+			tinygltf::FsCallbacks fs;
+			fs.ExpandFilePath = &tinygltf::ExpandFilePath;
+			fs.WriteWholeFile = &tinygltf::WriteWholeFile;
+			fs.user_data = &callbacks;
+
+			fs.FileExists = [](const std::string& path, void* userData)
+			{
+				const FileCallbacks* cb = static_cast<const FileCallbacks*>(userData);
+				return cb->exists ? cb->exists(path) : tinygltf::FileExists(path, nullptr);
+			};
+
+			fs.ReadWholeFile = [](std::vector<unsigned char>* out, std::string* err,
+								  const std::string& path, void* userData)
+			{
+				const FileCallbacks* cb = static_cast<const FileCallbacks*>(userData);
+
+				if (!cb->read)
+					return tinygltf::ReadWholeFile(out, err, path, nullptr);
+
+				if (!cb->read(path, *out))
+				{
+					if (err)
+						(*err) += "File not found: " + path + "\n";
+					return false;
+				}
+
+				return true;
+			};
+
+			loader->SetFsCallbacks(fs);
+		}
+
 		bool result = (binary) ? 
 					  loader->LoadBinaryFromFile(&gltf, &tinygltfErr, &tinygltfWarn, filename.c_str())
 					: loader->LoadASCIIFromFile(&gltf, &tinygltfErr, &tinygltfWarn, filename.c_str());
@@ -168,7 +226,9 @@ namespace nou::GLTF
 		//data as a set of triangles.
 		DataGetter faceIndexer = BuildGetter(gltf, geom.indices);
 
-		if (faceIndexer.elementSize != sizeof(GLshort))
+		if (faceIndexer.elementSize != sizeof(GLubyte) &&
+			faceIndexer.elementSize != sizeof(GLushort) &&
+			faceIndexer.elementSize != sizeof(GLuint))
 		{
 			err = "Primitive indices are in a currently unsupported format. " \
 				"Consider changing your GLTF export settings, or else this loader " \
@@ -251,10 +311,7 @@ namespace nou::GLTF
 		for (size_t i = startIndex, f = 0; i < startIndex + faceIndexer.len && f < faceIndexer.len; ++i, ++f)
 		{
 			//What vertex do we need to look at?
-			GLshort vertIndex;
-			memcpy(&vertIndex, &faceIndexer.data[f * faceIndexer.stride], sizeof(GLshort));
-
-			size_t vert = vertIndex;
+			size_t vert = ReadIndex(faceIndexer, f);
 
 			//Grab our vertex position.
 			memcpy(&verts[i], &vGetter.data[vert * vGetter.stride], sizeof(glm::vec3));
@@ -278,6 +335,601 @@ namespace nou::GLTF
 		return true;
 	}
 
+	void LoadIndexedMesh(const std::string& filename, Mesh& mesh, bool flipUVY)
+	{
+		SceneData scene;
+
+		if (!LoadScene(filename, scene, flipUVY))
+			return;
+
+		//Merge every mesh in the file, offsetting indices as we go.
+		MeshData merged;
+
+		for (const MeshData& data : scene.meshes)
+		{
+			GLuint baseVertex = (GLuint)merged.verts.size();
+
+			merged.verts.insert(merged.verts.end(), data.verts.begin(), data.verts.end());
+
+			for (GLuint index : data.indices)
+				merged.indices.push_back(baseVertex + index);
+
+			merged.hasNormals = merged.hasNormals && data.hasNormals;
+			merged.hasUVs = merged.hasUVs && data.hasUVs;
+		}
+
+		BuildMesh(merged, mesh);
+	}
+
+	bool LoadScene(const std::string& filename, SceneData& scene, 
+				   bool flipUVY, unsigned int numThreads)
+	{
+		auto gltf = std::make_unique<tinygltf::Model>();
+
+		std::string err, warn;
+
+		bool result = ParseGLTF(filename, *gltf, err, warn);
+
+		if (result)
+			result = ExtractScene(*gltf, scene, flipUVY, numThreads, err, warn);
+
+		DumpErrorsAndWarnings(filename, err, warn);
+
+		if (result)
+		{
+			size_t vertCount = 0, indexCount = 0;
+
+			for (const MeshData& data : scene.meshes)
+			{
+				vertCount += data.verts.size();
+				indexCount += data.indices.size();
+			}
+
+			printf("Loaded scene from %s (%zu meshes, %zu nodes, %zu vertices, %zu triangles).\n",
+				filename.c_str(), scene.meshes.size(), scene.nodes.size(), vertCount, indexCount / 3);
+		}
+
+		return result;
+	}
+
+	void BuildMesh(const MeshData& data, Mesh& mesh)
+	{
+		//NOU meshes keep each attribute in its own buffer, so we split our
+		//interleaved vertices back out here.
+		std::vector<glm::vec3> verts(data.verts.size());
+		std::vector<glm::vec3> normals;
+		std::vector<glm::vec2> uvs;
+
+		if (data.hasNormals)
+			normals.resize(data.verts.size());
+
+		if (data.hasUVs)
+			uvs.resize(data.verts.size());
+
+		for (size_t i = 0; i < data.verts.size(); ++i)
+		{
+			verts[i] = data.verts[i].pos;
+
+			if (data.hasNormals)
+				normals[i] = data.verts[i].normal;
+
+			if (data.hasUVs)
+				uvs[i] = data.verts[i].uv;
+		}
+
+		mesh.SetVerts(verts);
+
+		if (data.hasNormals)
+			mesh.SetNormals(normals);
+
+		if (data.hasUVs)
+			mesh.SetUVs(uvs);
+
+		mesh.SetIndices(data.indices);
+	}
+
+	void InstantiateScene(const SceneData& scene, Material& mat,
+						  std::vector<std::unique_ptr<Mesh>>& meshes,
+						  std::vector<std::unique_ptr<Entity>>& entities)
+	{
+		//Upload each mesh once - nodes that share a mesh share the buffers.
+		std::vector<Mesh*> meshLookup(scene.meshes.size(), nullptr);
+
+		for (size_t i = 0; i < scene.meshes.size(); ++i)
+		{
+			if (scene.meshes[i].indices.size() == 0)
+				continue;
+
+			meshes.push_back(std::make_unique<Mesh>());
+			BuildMesh(scene.meshes[i], *meshes.back());
+			meshLookup[i] = meshes.back().get();
+		}
+
+		//Parents always come before children in scene.nodes, so a parent's
+		//entity already exists by the time we get to its children.
+		size_t firstEntity = entities.size();
+
+		for (const NodeData& node : scene.nodes)
+		{
+			entities.push_back(Entity::Allocate());
+			Entity& entity = *entities.back();
+
+			entity.transform.m_pos = node.pos;
+			entity.transform.m_rotation = node.rotation;
+			entity.transform.m_scale = node.scale;
+
+			if (node.parent != -1)
+				entity.transform.SetParent(&entities[firstEntity + node.parent]->transform);
+
+			if (node.mesh != -1 && meshLookup[node.mesh] != nullptr)
+				entity.Add<CMeshRenderer>(entity, *meshLookup[node.mesh], mat);
+		}
+	}
+
+	//A vertex attribute stream, along with what we need to know to convert it to floats.
+	struct AttribStream
+	{
+		DataGetter getter;
+		int componentType;
+		int components;
+		bool normalized;
+
+		bool Valid() const { return getter.data != nullptr; }
+	};
+
+	//Work needed to decode one glTF primitive into its spot in a MeshData.
+	struct PrimitiveJob
+	{
+		MeshData* target;
+		size_t vertexOffset;
+		size_t vertexCount;
+		size_t indexOffset;
+		size_t indexCount;
+
+		AttribStream position, normal, uv, color;
+		DataGetter indices;
+		bool indexed;
+	};
+
+	//One chunk of work for our decoding threads (a range of vertices or indices).
+	struct DecodeTask
+	{
+		const PrimitiveJob* job;
+		bool decodeIndices;
+		size_t begin;
+		size_t end;
+	};
+
+	//Checks that an accessor has plain (non-sparse) data lying inside its buffer.
+	static bool AccessorInBounds(const tinygltf::Model& gltf, int accIndex)
+	{
+		if (accIndex < 0 || accIndex >= (int)gltf.accessors.size())
+			return false;
+
+		const tinygltf::Accessor& acc = gltf.accessors[accIndex];
+
+		if (acc.bufferView < 0 || acc.bufferView >= (int)gltf.bufferViews.size() || 
+			acc.sparse.isSparse)
+			return false;
+
+		const tinygltf::BufferView& bv = gltf.bufferViews[acc.bufferView];
+
+		if (bv.buffer < 0 || bv.buffer >= (int)gltf.buffers.size())
+			return false;
+
+		DataGetter getter = BuildGetter(gltf, accIndex);
+
+		size_t end = bv.byteOffset + acc.byteOffset;
+
+		if (getter.len > 0)
+			end += (getter.len - 1) * (size_t)getter.stride + (size_t)getter.elementSize;
+
+		return getter.stride > 0 && end <= gltf.buffers[bv.buffer].data.size();
+	}
+
+	//Checks that an accessor's data is usable as a vertex attribute, and wraps it up.
+	//Returns an invalid stream (with a warning or error) if the data can't be used.
+	static AttribStream BuildStream(const tinygltf::Model& gltf, int accIndex,
+									bool allowNormalized, std::string& problem)
+	{
+		AttribStream stream = { { nullptr, 0, 0, 0 }, 0, 0, false };
+
+		if (!AccessorInBounds(gltf, accIndex))
+		{
+			problem = "sparse, empty, or out of bounds accessors are not supported";
+			return stream;
+		}
+
+		const tinygltf::Accessor& acc = gltf.accessors[accIndex];
+
+		bool isFloat = acc.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT;
+		bool isUnorm = acc.normalized &&
+			(acc.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE ||
+			 acc.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT);
+
+		if (!isFloat && !(allowNormalized && isUnorm))
+		{
+			problem = "unsupported component type";
+			return stream;
+		}
+
+		stream.getter = BuildGetter(gltf, accIndex);
+		stream.componentType = acc.componentType;
+		stream.components = tinygltf::GetNumComponentsInType(acc.type);
+		stream.normalized = isUnorm;
+
+		return stream;
+	}
+
+	//Reads up to 4 components of a single element, converting to float.
+	static void ReadStream(const AttribStream& stream, size_t i, float* out)
+	{
+		const unsigned char* src = &stream.getter.data[i * stream.getter.stride];
+
+		switch (stream.componentType)
+		{
+			case TINYGLTF_COMPONENT_TYPE_FLOAT:
+				memcpy(out, src, sizeof(float) * stream.components);
+				break;
+
+			case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+				for (int c = 0; c < stream.components; ++c)
+					out[c] = src[c] / 255.0f;
+				break;
+
+			case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+				for (int c = 0; c < stream.components; ++c)
+				{
+					GLushort value;
+					memcpy(&value, &src[c * sizeof(GLushort)], sizeof(GLushort));
+					out[c] = value / 65535.0f;
+				}
+				break;
+		}
+	}
+
+	static void DecodeVertices(const PrimitiveJob& job, size_t begin, size_t end, bool flipUVY)
+	{
+		Vertex* verts = &job.target->verts[job.vertexOffset];
+
+		for (size_t i = begin; i < end; ++i)
+		{
+			Vertex& v = verts[i];
+
+			ReadStream(job.position, i, &v.pos.x);
+
+			if (job.normal.Valid())
+				ReadStream(job.normal, i, &v.normal.x);
+			else
+				v.normal = glm::vec3(0.0f);
+
+			if (job.uv.Valid())
+			{
+				ReadStream(job.uv, i, &v.uv.x);
+
+				if (flipUVY)
+					v.uv.y = 1.0f - v.uv.y;
+			}
+			else
+				v.uv = glm::vec2(0.0f);
+
+			//Colors may be RGB or RGBA - alpha defaults to 1.
+			v.color = glm::vec4(1.0f);
+
+			if (job.color.Valid())
+				ReadStream(job.color, i, &v.color.x);
+		}
+	}
+
+	//Returns false if any index refers to a vertex that doesn't exist.
+	static bool DecodeIndices(const PrimitiveJob& job, size_t begin, size_t end)
+	{
+		GLuint* indices = &job.target->indices[job.indexOffset];
+		GLuint base = (GLuint)job.vertexOffset;
+		bool valid = true;
+
+		for (size_t i = begin; i < end; ++i)
+		{
+			GLuint index = job.indexed ? ReadIndex(job.indices, i) : (GLuint)i;
+
+			if (index >= job.vertexCount)
+			{
+				valid = false;
+				index = 0;
+			}
+
+			indices[i] = base + index;
+		}
+
+		return valid;
+	}
+
+	//Sorts nodes so that parents come before children, recording each node's parent.
+	static void VisitNode(const tinygltf::Model& gltf, int nodeIndex, int parent,
+						  std::vector<int>& order, std::vector<int>& parents,
+						  std::vector<bool>& visited)
+	{
+		if (nodeIndex < 0 || nodeIndex >= (int)gltf.nodes.size() || visited[nodeIndex])
+			return;
+
+		visited[nodeIndex] = true;
+		order.push_back(nodeIndex);
+		parents.push_back(parent);
+
+		int self = (int)order.size() - 1;
+
+		for (int child : gltf.nodes[nodeIndex].children)
+			VisitNode(gltf, child, self, order, parents, visited);
+	}
+
+	bool ExtractScene(const tinygltf::Model& gltf, SceneData& scene, bool flipUVY,
+					  unsigned int numThreads, std::string& err, std::string& warn)
+	{
+		if (gltf.meshes.size() == 0)
+		{
+			err = "No meshes in file.";
+			return false;
+		}
+
+		scene.meshes.clear();
+		scene.nodes.clear();
+		scene.meshes.resize(gltf.meshes.size());
+
+		//First pass: validate each primitive and work out where its data will go.
+		//Doing this up front means our threads can write straight into the final
+		//arrays, with no merging afterwards.
+		std::vector<PrimitiveJob> jobs;
+
+		for (size_t m = 0; m < gltf.meshes.size(); ++m)
+		{
+			const tinygltf::Mesh& meshData = gltf.meshes[m];
+			MeshData& target = scene.meshes[m];
+			target.name = meshData.name;
+
+			size_t vertCount = 0, indexCount = 0;
+
+			for (size_t p = 0; p < meshData.primitives.size(); ++p)
+			{
+				const tinygltf::Primitive& geom = meshData.primitives[p];
+				std::string where = " in mesh " + std::to_string(m) +
+									", primitive " + std::to_string(p);
+				std::string problem;
+
+				if (geom.mode != TINYGLTF_MODE_TRIANGLES && geom.mode != -1)
+				{
+					warn += "\nSkipping non-triangle geometry" + where;
+					continue;
+				}
+
+				PrimitiveJob job = {};
+				job.target = &target;
+
+				job.position = BuildStream(gltf, FindAccessor(geom, "POSITION"), false, problem);
+
+				if (!job.position.Valid() || job.position.components != 3)
+				{
+					warn += "\nSkipping geometry without usable vertex positions" + where;
+					continue;
+				}
+
+				job.vertexCount = job.position.getter.len;
+
+				//Optional attributes must have one element per vertex to be usable.
+				auto optional = [&](const char* name, bool allowNormalized, int minComponents,
+								    int maxComponents, AttribStream& out)
+				{
+					int id = FindAccessor(geom, name);
+
+					if (id == -1)
+						return;
+
+					out = BuildStream(gltf, id, allowNormalized, problem);
+
+					if (out.Valid() && (out.getter.len != job.vertexCount ||
+						out.components < minComponents || out.components > maxComponents))
+					{
+						problem = "unexpected element count or type";
+						out.getter.data = nullptr;
+					}
+
+					if (!out.Valid())
+						warn += "\nIgnoring " + std::string(name) + where + ": " + problem;
+				};
+
+				optional("NORMAL", false, 3, 3, job.normal);
+				optional("TEXCOORD_0", true, 2, 2, job.uv);
+				optional("COLOR_0", true, 3, 4, job.color);
+
+				job.indexed = geom.indices != -1;
+
+				if (job.indexed)
+				{
+					if (!AccessorInBounds(gltf, geom.indices))
+					{
+						warn += "\nSkipping geometry with unreadable indices" + where;
+						continue;
+					}
+
+					DataGetter indexer = BuildGetter(gltf, geom.indices);
+
+					if (indexer.elementSize != sizeof(GLubyte) &&
+						indexer.elementSize != sizeof(GLushort) &&
+						indexer.elementSize != sizeof(GLuint))
+					{
+						warn += "\nSkipping geometry with unsupported indices" + where;
+						continue;
+					}
+
+					job.indices = indexer;
+					job.indexCount = indexer.len;
+					target.sourceIndexSize = std::max(target.sourceIndexSize, indexer.elementSize);
+				}
+				else
+					job.indexCount = job.vertexCount;
+
+				target.hasNormals = target.hasNormals && job.normal.Valid();
+				target.hasUVs = target.hasUVs && job.uv.Valid();
+				target.hasColors = target.hasColors && job.color.Valid();
+
+				job.vertexOffset = vertCount;
+				job.indexOffset = indexCount;
+
+				target.subMeshes.push_back({ indexCount, job.indexCount, geom.material });
+
+				vertCount += job.vertexCount;
+				indexCount += job.indexCount;
+
+				jobs.push_back(job);
+			}
+
+			target.verts.resize(vertCount);
+			target.indices.resize(indexCount);
+
+			if (vertCount == 0)
+				target.hasNormals = target.hasUVs = target.hasColors = false;
+		}
+
+		if (jobs.size() == 0)
+		{
+			err = "No usable geometry found in file.";
+			return false;
+		}
+
+		//Split large primitives up, so that a file with one huge mesh still gets
+		//spread across all of our threads.
+		const size_t vertsPerTask = 16384;
+		const size_t indicesPerTask = 65536;
+
+		std::vector<DecodeTask> tasks;
+
+		for (const PrimitiveJob& job : jobs)
+		{
+			for (size_t i = 0; i < job.vertexCount; i += vertsPerTask)
+				tasks.push_back({ &job, false, i, std::min(i + vertsPerTask, job.vertexCount) });
+
+			for (size_t i = 0; i < job.indexCount; i += indicesPerTask)
+				tasks.push_back({ &job, true, i, std::min(i + indicesPerTask, job.indexCount) });
+		}
+
+		std::atomic<size_t> nextTask(0);
+		std::atomic<bool> indicesValid(true);
+
+		auto worker = [&]()
+		{
+			size_t t;
+
+			while ((t = nextTask.fetch_add(1)) < tasks.size())
+			{
+				const DecodeTask& task = tasks[t];
+
+				if (!task.decodeIndices)
+					DecodeVertices(*task.job, task.begin, task.end, flipUVY);
+				else if (!DecodeIndices(*task.job, task.begin, task.end))
+					indicesValid = false;
+			}
+		};
+
+		if (numThreads == 0)
+			numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+		numThreads = (unsigned int)std::min((size_t)numThreads, tasks.size());
+
+		//The calling thread does its share of the work too.
+		std::vector<std::thread> threads;
+
+		for (unsigned int i = 1; i < numThreads; ++i)
+			threads.emplace_back(worker);
+
+		worker();
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		if (!indicesValid)
+			warn += "\nSome indices referred to vertices that do not exist, and were replaced.";
+
+		//Now for the node hierarchy.
+		//We start from the roots of the default scene (or every node that isn't
+		//anyone's child, if the file doesn't list any scenes).
+		std::vector<int> roots;
+
+		if (gltf.scenes.size() > 0)
+		{
+			int sceneIndex = (gltf.defaultScene >= 0 && gltf.defaultScene < (int)gltf.scenes.size()) ?
+							 gltf.defaultScene : 0;
+			roots = gltf.scenes[sceneIndex].nodes;
+		}
+		else
+		{
+			std::vector<bool> isChild(gltf.nodes.size(), false);
+
+			for (const tinygltf::Node& node : gltf.nodes)
+				for (int child : node.children)
+					if (child >= 0 && child < (int)isChild.size())
+						isChild[child] = true;
+
+			for (size_t i = 0; i < gltf.nodes.size(); ++i)
+				if (!isChild[i])
+					roots.push_back((int)i);
+		}
+
+		std::vector<int> order, parents;
+		std::vector<bool> visited(gltf.nodes.size(), false);
+
+		for (int root : roots)
+			VisitNode(gltf, root, -1, order, parents, visited);
+
+		scene.nodes.resize(order.size());
+
+		for (size_t i = 0; i < order.size(); ++i)
+		{
+			const tinygltf::Node& src = gltf.nodes[order[i]];
+			NodeData& node = scene.nodes[i];
+
+			node.name = src.name;
+			node.parent = parents[i];
+			node.mesh = (src.mesh >= 0 && src.mesh < (int)scene.meshes.size()) ? src.mesh : -1;
+
+			if (src.matrix.size() == 16)
+			{
+				glm::mat4 matrix;
+
+				for (int j = 0; j < 16; ++j)
+					matrix[j / 4][j % 4] = (float)src.matrix[j];
+
+				glm::vec3 skew;
+				glm::vec4 perspective;
+				glm::decompose(matrix, node.scale, node.rotation, node.pos, skew, perspective);
+				continue;
+			}
+
+			if (src.translation.size() == 3)
+				node.pos = glm::vec3(src.translation[0], src.translation[1], src.translation[2]);
+
+			//glTF stores quaternions as (x, y, z, w), GLM's constructor takes w first.
+			if (src.rotation.size() == 4)
+				node.rotation = glm::quat((float)src.rotation[3], (float)src.rotation[0],
+										  (float)src.rotation[1], (float)src.rotation[2]);
+
+			if (src.scale.size() == 3)
+				node.scale = glm::vec3(src.scale[0], src.scale[1], src.scale[2]);
+		}
+
+		//A file with geometry but no nodes still deserves to show up.
+		if (scene.nodes.size() == 0)
+		{
+			for (size_t m = 0; m < scene.meshes.size(); ++m)
+			{
+				NodeData node;
+				node.name = scene.meshes[m].name;
+				node.mesh = (int)m;
+				scene.nodes.push_back(node);
+			}
+		}
+
+		return true;
+	}
+
 	int FindAccessor(const tinygltf::Primitive& geom, const std::string& name)
 	{
 		auto it = geom.attributes.find(name);
@@ -302,4 +954,29 @@ namespace nou::GLTF
 
 		return { data, len, stride, size };
 	}
+
+	GLuint ReadIndex(const DataGetter& getter, size_t i)
+	{
+		const unsigned char* src = &getter.data[i * getter.stride];
+
+		switch (getter.elementSize)
+		{
+			case sizeof(GLubyte):
+				return *src;
+
+			case sizeof(GLushort):
+			{
+				GLushort index;
+				memcpy(&index, src, sizeof(GLushort));
+				return index;
+			}
+
+			default:
+			{
+				GLuint index;
+				memcpy(&index, src, sizeof(GLuint));
+				return index;
+			}
+		}
+	}
 }
\ No newline at end of file
@@ -28,6 +28,48 @@ namespace nou
 		SetVBO(Attrib::UV, 2, m_uvs);
 	}
 
+	//Copies our indices into the narrowest integer type that can hold them.
+	template<typename T>
+	static std::vector<T> NarrowIndices(const std::vector<GLuint>& indices)
+	{
+		std::vector<T> result(indices.size());
+
+		for (size_t i = 0; i < indices.size(); ++i)
+			result[i] = static_cast<T>(indices[i]);
+
+		return result;
+	}
+
+	void Mesh::SetIndices(const std::vector<GLuint>& indices)
+	{
+		m_indices = indices;
+
+		if (m_indices.size() == 0)
+		{
+			m_ibo.reset();
+			return;
+		}
+
+		GLuint maxIndex = 0;
+
+		for (GLuint index : m_indices)
+			maxIndex = (index > maxIndex) ? index : maxIndex;
+
+		//Unlike VBOs, we always recreate the index buffer, since its element type
+		//may change with the new data.
+		if (maxIndex <= 0xFF)
+			m_ibo = std::make_unique<IndexBuffer>(NarrowIndices<GLubyte>(m_indices));
+		else if (maxIndex <= 0xFFFF)
+			m_ibo = std::make_unique<IndexBuffer>(NarrowIndices<GLushort>(m_indices));
+		else
+			m_ibo = std::make_unique<IndexBuffer>(m_indices);
+	}
+
+	const IndexBuffer* Mesh::GetIBO() const
+	{
+		return m_ibo.get();
+	}
+
 	const VertexBuffer* Mesh::GetVBO(Mesh::Attrib attrib) const
 	{
 		auto it = m_vbo.find(attrib);
@@ -10,47 +10,267 @@ Simple class for managing object transforms with basic hierarchy support.
 
 #include "GLM/gtx/transform.hpp"
 
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
 namespace nou
 {
-	Transform::Transform()
+	//Everything FK needs to know about a transform.
+	//Indices are -1 if there is no such node.
+	struct TransformNode
 	{
-		m_parent = nullptr;
+		glm::mat4 global;
+		glm::quat rotation;
+		glm::vec3 pos;
+		glm::vec3 scale;
+
+		//The transform that owns this node, only used to hand back
+		//parent objects (FK never needs it).
+		Transform* owner;
+
+		int32_t parent;
+		int32_t firstChild;
+		int32_t lastChild;
+		int32_t prevSibling;
+		int32_t nextSibling;
+	};
+
+	//Shared storage for the nodes of every transform.
+	//Nodes are stored in fixed-size chunks, so a node never moves once it has
+	//been created, and looking one up by index is just a bit of arithmetic.
+	class TransformStore
+	{
+		public:
+
+		static constexpr int32_t ChunkSize = 1024;
+		static constexpr int32_t MaxChunks = 4096;
+
+		TransformNode& operator[](int32_t index)
+		{
+			return m_chunks[index / ChunkSize][index % ChunkSize];
+		}
+
+		//Creating and destroying transforms can happen from any thread.
+		//Changing the hierarchy or doing FK on the same transforms from
+		//several threads at once is still up to you to avoid.
+		int32_t Allocate()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if (!m_freeIndices.empty())
+			{
+				int32_t index = m_freeIndices.back();
+				m_freeIndices.pop_back();
+				return index;
+			}
+
+			if (m_count == m_chunkCount * ChunkSize)
+			{
+				if (m_chunkCount == MaxChunks)
+					throw std::runtime_error("Too many transforms!");
+
+				m_chunks[m_chunkCount++].reset(new TransformNode[ChunkSize]);
+			}
+
+			return m_count++;
+		}
+
+		void Free(int32_t index)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_freeIndices.push_back(index);
+		}
+
+		private:
 
-		m_pos = glm::vec3(0.0f);
-		m_scale = glm::vec3(1.0f);
-		m_rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+		//This is a fixed array (rather than a vector) so that looking up
+		//a chunk never races with another thread adding one.
+		std::unique_ptr<TransformNode[]> m_chunks[MaxChunks];
+		int32_t m_chunkCount = 0;
+		int32_t m_count = 0;
+		std::vector<int32_t> m_freeIndices;
+		std::mutex m_mutex;
+	};
 
-		m_global = glm::mat4(1.0f);
+	static TransformStore& GetStore()
+	{
+		//Deliberately never deleted, so transforms destroyed during static
+		//destruction (in any order) can still give back their nodes.
+		static TransformStore* store = new TransformStore();
+		return *store;
 	}
 
-	Transform::~Transform()
+	static int32_t AllocateNode()
 	{
-		SetParent(nullptr);
+		TransformStore& store = GetStore();
+		int32_t index = store.Allocate();
+
+		TransformNode& node = store[index];
+		node.global = glm::mat4(1.0f);
+		node.rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+		node.pos = glm::vec3(0.0f);
+		node.scale = glm::vec3(1.0f);
+		node.owner = nullptr;
+		node.parent = -1;
+		node.firstChild = -1;
+		node.lastChild = -1;
+		node.prevSibling = -1;
+		node.nextSibling = -1;
+
+		return index;
 	}
 
-	void Transform::DoFK()
+	//Adds a node to the end of a parent node's list of children.
+	static void LinkChild(TransformStore& store, int32_t parentIndex, int32_t childIndex)
+	{
+		TransformNode& parent = store[parentIndex];
+		TransformNode& child = store[childIndex];
+
+		child.parent = parentIndex;
+		child.prevSibling = parent.lastChild;
+		child.nextSibling = -1;
+
+		if (parent.lastChild >= 0)
+			store[parent.lastChild].nextSibling = childIndex;
+		else
+			parent.firstChild = childIndex;
+
+		parent.lastChild = childIndex;
+	}
+
+	//Removes a node from its parent's list of children.
+	static void UnlinkChild(TransformStore& store, int32_t childIndex)
+	{
+		TransformNode& child = store[childIndex];
+		TransformNode& parent = store[child.parent];
+
+		//Unlink the child from its siblings...
+		if (child.prevSibling >= 0)
+			store[child.prevSibling].nextSibling = child.nextSibling;
+		else
+			parent.firstChild = child.nextSibling;
+
+		if (child.nextSibling >= 0)
+			store[child.nextSibling].prevSibling = child.prevSibling;
+		else
+			parent.lastChild = child.prevSibling;
+
+		//...and from its parent.
+		child.parent = -1;
+		child.prevSibling = -1;
+		child.nextSibling = -1;
+	}
+
+	//Computes the global transform of a node from its local transform
+	//and its parent's current global transform.
+	static void UpdateGlobal(TransformStore& store, TransformNode& node)
 	{
 		//First, grab our local transform...
-		glm::mat4 local = glm::translate(m_pos) *
-						  glm::toMat4(glm::normalize(m_rotation)) *
-						  glm::scale(m_scale);
+		glm::mat4 local = glm::translate(node.pos) *
+						  glm::toMat4(glm::normalize(node.rotation)) *
+						  glm::scale(node.scale);
 
 		//If we have a parent, we need to multiply by our parent's
 		//global transform.
-		if (m_parent != nullptr)
-			m_global = m_parent->m_global * local;
+		if (node.parent >= 0)
+			node.global = store[node.parent].global * local;
 
 		//If we have no parent object, our global transform is our
 		//local transform!
 		else
-			m_global = local;
+			node.global = local;
+	}
 
-		//FK is recursive - we now repeat this process on our child nodes.
-		//Eventually, we'll be at the bottom of the hierarchy and this will
-		//return.
-		for (auto* child : m_children)
+	Transform::Transform(int32_t index)
+		: m_pos(GetStore()[index].pos),
+		  m_scale(GetStore()[index].scale),
+		  m_rotation(GetStore()[index].rotation),
+		  m_index(index),
+		  m_node(&GetStore()[index])
+	{
+		m_node->owner = this;
+	}
+
+	Transform::Transform()
+		: Transform(AllocateNode())
+	{
+	}
+
+	Transform::Transform(const Transform& other)
+		: Transform(AllocateNode())
+	{
+		m_pos = other.m_pos;
+		m_scale = other.m_scale;
+		m_rotation = other.m_rotation;
+
+		m_node->global = other.m_node->global;
+
+		SetParent(other.GetParent());
+	}
+
+	Transform& Transform::operator=(const Transform& other)
+	{
+		if (this == &other)
+			return *this;
+
+		m_pos = other.m_pos;
+		m_scale = other.m_scale;
+		m_rotation = other.m_rotation;
+
+		m_node->global = other.m_node->global;
+
+		SetParent(other.GetParent());
+
+		return *this;
+	}
+
+	Transform::~Transform()
+	{
+		SetParent(nullptr);
+
+		//Any children we still have become root objects, rather than
+		//being left linked to a node that is about to be reused.
+		TransformStore& store = GetStore();
+
+		while (m_node->firstChild >= 0)
+			UnlinkChild(store, m_node->firstChild);
+
+		store.Free(m_index);
+	}
+
+	void Transform::DoFK()
+	{
+		TransformStore& store = GetStore();
+
+		UpdateGlobal(store, *m_node);
+
+		//Rather than recursing, we walk the rest of the hierarchy depth-first
+		//by following the links between nodes: down to the first child if
+		//there is one, otherwise across to the next sibling, climbing back up
+		//until we find a sibling or get back to where we started.
+		//Parents are always visited before their children, so each node's
+		//parent global transform is up to date by the time we reach it.
+		int32_t index = m_index;
+
+		while (true)
 		{
-			child->DoFK();
+			if (store[index].firstChild >= 0)
+			{
+				index = store[index].firstChild;
+			}
+			else
+			{
+				while (index != m_index && store[index].nextSibling < 0)
+					index = store[index].parent;
+
+				if (index == m_index)
+					break;
+
+				index = store[index].nextSibling;
+			}
+
+			UpdateGlobal(store, store[index]);
 		}
 	}
 
@@ -63,17 +283,17 @@ namespace nou
 						  glm::toMat4(m_rotation) *
 						  glm::scale(m_scale);
 
-		if (m_parent != nullptr)
-			m_global = m_parent->RecomputeGlobal() * local;
+		if (m_node->parent >= 0)
+			m_node->global = GetStore()[m_node->parent].owner->RecomputeGlobal() * local;
 		else
-			m_global = local;
+			m_node->global = local;
 
-		return m_global;
+		return m_node->global;
 	}
 
 	const glm::mat4& Transform::GetGlobal() const
 	{
-		return m_global;
+		return m_node->global;
 	}
 
 	glm::mat3 Transform::GetNormal() const
@@ -86,7 +306,7 @@ namespace nou
 		//transform matrix (the rotation/scale bit) - since we'll re-normalize
 		//the normals in our shader anyways.
 		if(m_scale.x == m_scale.y && m_scale.x == m_scale.z)
-			return glm::mat3(m_global);
+			return glm::mat3(m_node->global);
 
 		//If we do have a non-uniform scale, then we need to undo that scale, 
 		//hence the inverse. However, we want to preserve our rotation.
@@ -96,37 +316,36 @@ namespace nou
 		//You could also do some trickery here with the reciprocal of your
 		//scale vector and your rotation quaternion, but this is a bit more
 		//"bulletproof" and straightforward if you're doing oddball transformations.
-		return glm::inverse(glm::transpose(glm::mat3(m_global)));
+		return glm::inverse(glm::transpose(glm::mat3(m_node->global)));
 	}
 
 	void Transform::SetParent(Transform* parent)
 	{
 		//If we had a parent before, remove this as a child from that object.
-		if(m_parent != nullptr)
-			m_parent->RemoveChild(this);
-
-		m_parent = parent;
+		if(m_node->parent >= 0)
+			GetStore()[m_node->parent].owner->RemoveChild(this);
 
 		//If we have a parent now, add this as a child to that object.
-		if(m_parent != nullptr)
-			m_parent->AddChild(this);			
+		if(parent != nullptr)
+			parent->AddChild(this);
+	}
+
+	Transform* Transform::GetParent() const
+	{
+		if (m_node->parent < 0)
+			return nullptr;
+
+		return GetStore()[m_node->parent].owner;
 	}
 
 	void Transform::AddChild(Transform* child)
 	{
-		m_children.push_back(child);
+		//New children go on the end of our list of children.
+		LinkChild(GetStore(), m_index, child->m_index);
 	}
 
 	void Transform::RemoveChild(Transform* child)
 	{
-		for (auto it = m_children.begin(); it != m_children.end(); ++it)
-		{
-			if (*it == child)
-			{
-				m_children.erase(it);
-				break;
-			}
-
-		}
+		UnlinkChild(GetStore(), child->m_index);
 	}
 }
\ No newline at end of file
@@ -13,6 +13,9 @@
 //////////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include <string>
+#include <vector>
+#include <unordered_map>
 #include "GLM/glm.hpp"
 #include "glad/glad.h"
 #include "stb_truetype.h"
@@ -47,7 +50,13 @@ namespace  TTK
 	
 	class TrueTypeTextureFont {
 	public:
-		TrueTypeTextureFont(const char* fileName, uint32_t size);
+		/*
+		 * Loads a font and packs its glyphs into an atlas
+		 * @param fileName The path to the TrueType font to load
+		 * @param size The pixel height to rasterize glyphs at
+		 * @param signedDistanceField True to store glyphs as signed distance fields, which stay sharp when text is scaled
+		 */
+		TrueTypeTextureFont(const char* fileName, uint32_t size, bool signedDistanceField = false);
 		~TrueTypeTextureFont();
 		
 		GlyphInfo GetGlyph(int codePoint, float offsetX, float offsetY) const;
@@ -58,6 +67,8 @@ namespace  TTK
 
 		virtual GLint GetTexture() const { return myTexture; }
 
+		bool IsSignedDistanceField() const { return myIsSdf; }
+
 	protected:
 		friend class FontRenderer;
 		GLuint   myTexture;
@@ -69,6 +80,8 @@ namespace  TTK
 		const uint32_t FONT_OVERSAMPLE_Y = 2;
 		const uint32_t FIRST_CHAR = ' ';
 		const uint32_t CHAR_COUNT = '~' - ' ';
+		// The distance (in atlas pixels) that the distance field extends past the edge of each glyph
+		const int      SDF_PADDING = 4;
 
 		stbtt_packedchar* myCharInfo;
 		uint32_t          myFontSize;
@@ -78,6 +91,9 @@ namespace  TTK
 		int               myAscent,
 						  myDescent,
 						  myLineGap;
+		bool              myIsSdf;
+
+		void __PackSdfGlyphs(uint8_t* atlasData);
 	};
 	
 	class FontRenderer {
@@ -101,17 +117,73 @@ namespace  TTK
 			glm::vec2 UV;
 		};
 
+		// A glyph corner in a laid out string, relative to the string's origin at a scale of 1
+		struct RunVert {
+			glm::vec2 Position;
+			glm::vec2 UV;
+		};
+
+		// The cached layout of a single string in a single font
+		struct GlyphRun {
+			std::vector<RunVert> Verts;
+			uint64_t             LastUsedFrame;
+		};
+
+		struct RunKey {
+			const TrueTypeTextureFont* Font;
+			std::string                Text;
+			bool operator==(const RunKey& other) const { return Font == other.Font && Text == other.Text; }
+		};
+
+		struct RunKeyHash {
+			size_t operator()(const RunKey& key) const {
+				return std::hash<std::string>()(key.Text) ^ (std::hash<const void*>()(key.Font) << 1);
+			}
+		};
+
+		// A range of vertices in the frame buffer that all use the same font
+		struct Batch {
+			const TrueTypeTextureFont* Font;
+			size_t FirstVert;
+			size_t VertCount;
+		};
+
 	public:
 		~FontRenderer();
 
+		/*
+		 * Queues a string to be drawn, text is drawn on top of the scene when the frame is flushed
+		 * @param font The font to draw the text with
+		 * @param text The text to draw
+		 * @param pos The position of the text, in screen coordinates
+		 * @param color The color of the text
+		 * @param scale The scale to draw the text at, relative to the font's size
+		 */
 		void Render(const TrueTypeTextureFont& font, const char* text, const glm::vec2& pos, const glm::vec4& color, float scale = 1.0f);
+
+		/*
+		 * Draws all text that has been queued this frame, using one draw call per font
+		 */
+		void Flush();
 		
 	private:
 		FontRenderer();
+
+		const GlyphRun& __GetRun(const TrueTypeTextureFont& font, const char* text);
+		void __BuildRun(const TrueTypeTextureFont& font, const char* text, GlyphRun& run) const;
+		void __EnsureIndexCapacity(size_t quads);
 				
 		GLuint   m_ShaderHandle;
 		GLuint   m_VAO, m_VBO, m_EBO;
-		Vert     m_MeshData[256 * 4];
-		GLuint   m_IndexData[256 * 6];
+		size_t   m_VertexCapacity;
+		size_t   m_QuadCapacity;
+		uint64_t m_FrameIndex;
+
+		std::vector<Vert>  m_MeshData;
+		std::vector<Batch> m_Batches;
+		std::unordered_map<RunKey, GlyphRun, RunKeyHash> m_RunCache;
+
+		// Cached runs that have not been drawn for this many frames will be dropped
+		static const uint64_t MaxRunAge = 120;
 	};
 }
\ No newline at end of file
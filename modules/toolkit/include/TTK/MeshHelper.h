@@ -4,8 +4,8 @@
 // You may not use this header in your GDW games.
 //
 // This header contains a helper class for drawing the primitive types that
-// were originally supported by GLUT. This file was purposefully built to
-// be non-optimal
+// were originally supported by GLUT. Shapes are queued up as instances and
+// drawn with a single instanced draw call per shape when flushed
 //
 // Based off of TTK by Michael Gharbharan 2017
 // Shawn Matthews 2019
@@ -13,6 +13,7 @@
 //////////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include <vector>
 #include "TTKContext.h"
 
 namespace TTK {
@@ -21,21 +22,37 @@ namespace TTK {
 		public:
 			~MeshHelper();
 			MeshHelper();
-			void RenderTeapot(const glm::mat4& transform, const glm::vec4& color) const;
-			void RenderSphere(const glm::mat4& transform, const glm::vec4& color) const;
-			void RenderCube(const glm::mat4& transform, const glm::vec4& color) const;
+			void RenderTeapot(const glm::mat4& transform, const glm::vec4& color);
+			void RenderSphere(const glm::mat4& transform, const glm::vec4& color);
+			void RenderCube(const glm::mat4& transform, const glm::vec4& color);
+
+			// Draws all queued shapes, one instanced draw call per shape type
+			void Flush();
 			
 		private:
+			struct instance {
+				glm::mat4 Transform;
+				glm::vec4 Color;
+			};
 			struct mesh {
 				GLuint VAO;
 				GLuint VBO;
+				GLuint InstanceVBO;
+				GLsizei VertexCount;
+				size_t  InstanceCapacity;
+				std::vector<instance> Instances;
 			};
 			mesh __MakeMesh(const float* data, size_t size) const;
+			void __Queue(mesh& mesh, const glm::mat4& transform, const glm::vec4& color);
+			void __Flush(mesh& mesh);
 			
 			mesh m_Teapot;
 			mesh m_Sphere;
 			mesh m_Cube;
 			GLuint m_Shader;
+
+			// Queued instances will be flushed early once a shape reaches this many instances
+			static const size_t MaxInstances = 16384;
 		};
 	}
 }
\ No newline at end of file
@@ -0,0 +1,91 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// This header is a part of the Tutorial Tool Kit (TTK) library. 
+// You may not use this header in your GDW games.
+//
+// This header contains a batched sprite renderer. Sprites are queued up
+// during the frame, then sorted by layer and texture and drawn with one
+// draw call per (layer, texture) pair
+//
+// Shawn Matthews 2019
+//
+//////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <vector>
+#include <GLM/glm.hpp>
+#include "glad/glad.h"
+#include "FontRenderer.h"
+
+namespace TTK
+{
+	class SpriteBatch {
+	public:
+		static SpriteBatch& Instance() {
+			if (m_Instance == nullptr)
+				m_Instance = new SpriteBatch();
+			return *m_Instance;
+		}
+		static void DestroyContext() {
+			delete m_Instance;
+			m_Instance = nullptr;
+		}
+
+	private:
+		static SpriteBatch* m_Instance;
+
+		struct Vert {
+			glm::vec4 Position;
+			glm::vec2 UV;
+			Col8      Color;
+		};
+
+		struct Sprite {
+			int       Layer;
+			GLuint    Texture;
+			uint32_t  Order;
+			glm::vec4 Corners[4];
+			glm::vec4 UVRect;
+			Col8      Color;
+		};
+
+	public:
+		~SpriteBatch();
+
+		/*
+		 * Queues a unit quad (-1 to 1 on x and y) to be drawn with the given texture
+		 * @param texture The OpenGL handle of the texture to draw the sprite with
+		 * @param matrix The matrix that transforms the quad directly into clip space
+		 * @param uvMin The UV coordinate at the quad's top left corner (-1, 1)
+		 * @param uvMax The UV coordinate at the quad's bottom right corner (1, -1)
+		 * @param color The color to tint the sprite with
+		 * @param layer The layer to draw the sprite on, lower layers are drawn first
+		 */
+		void Submit(GLuint texture, const glm::mat4& matrix, const glm::vec2& uvMin, const glm::vec2& uvMax, const glm::vec4& color = glm::vec4(1.0f), int layer = 0);
+
+		/*
+		 * Draws all sprites that have been queued, sorted by layer and then texture. Sprites in the same layer
+		 * that share a texture keep the order they were submitted in
+		 */
+		void Flush();
+
+		/*
+		 * Gets the number of draw calls that were issued by the last flush
+		 */
+		size_t GetLastDrawCount() const { return m_LastDrawCount; }
+
+	private:
+		SpriteBatch();
+
+		void __EnsureIndexCapacity(size_t quads);
+
+		GLuint m_ShaderHandle;
+		GLuint m_VAO, m_VBO, m_EBO;
+		size_t m_VertexCapacity;
+		size_t m_QuadCapacity;
+		size_t m_LastDrawCount;
+
+		std::vector<Sprite> m_Sprites;
+		std::vector<Vert>   m_MeshData;
+	};
+}
\ No newline at end of file
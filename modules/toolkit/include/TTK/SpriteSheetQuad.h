@@ -75,11 +75,13 @@ namespace TTK {
 		void SetLooping(bool loop);
 
 		/*
-		 * Renders this sprite with the given transformation matrix. Note that this matrix
-		 * should transform the sprite directly into clip space
+		 * Queues this sprite to be rendered with the given transformation matrix. Note that this matrix
+		 * should transform the sprite directly into clip space. Sprites are drawn in batches by the
+		 * SpriteBatch when the frame is flushed
 		 * @param matrix The MVP matrix to render this sprite with
+		 * @param layer The layer to draw the sprite on, lower layers are drawn first
 		 */
-		void Draw(const glm::mat4& matrix);
+		void Draw(const glm::mat4& matrix, int layer = 0);
 
 		/*
 		 * Sets a given frame to last for a given duration in seconds
@@ -112,18 +114,11 @@ namespace TTK {
 		int GetNumberOfFrames() const;
 
 	private:
-		struct QuadVert {
-			glm::vec3 Position;
-			glm::vec2 Texture;
-		};
-
 		int   m_CurrentFrame;
 		float m_FrameTime;
 		bool  m_DoesLoop;
 		Texture2D m_Texture;
 		glm::vec4 m_Color;
-		QuadVert  m_Vertices[4];
-		uint32_t m_VAO, m_VBO, m_EBO, m_Shader;
 
 		std::vector<SpriteCoordinates> m_SpriteCoordinates;
 
@@ -13,6 +13,7 @@
 //////////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include <vector>
 #include <GLM/glm.hpp>
 #include "FontRenderer.h"
 
@@ -66,6 +67,7 @@ namespace TTK
 
 		void RenderText(const char* text, const glm::vec2& position, const glm::vec4& color, float scale = 1.0f);
 		
+		// Shapes are queued and drawn as instances when the context is flushed
 		void DrawTeapot(const glm::mat4& mat, const glm::vec4& color = glm::vec4(1.0f)) const;
 		void DrawSphere(const glm::mat4& mat, const glm::vec4& color = glm::vec4(1.0f)) const;
 		void DrawCube(const glm::mat4& mat, const glm::vec4& color = glm::vec4(1.0f)) const;
@@ -77,6 +79,16 @@ namespace TTK
 		
 		void Flush();
 
+		// OpenGL state is tracked here so that TTK only has to query it (which stalls the pipeline) once per frame,
+		// at the start of Flush. If state is changed outside of TTK mid-frame, call ResetStateCache to re-read it
+		void SetBlendEnabled(bool enabled);
+		bool IsBlendEnabled() const { return m_BlendEnabled; }
+		void SetDepthWriteEnabled(bool enabled);
+		bool IsDepthWriteEnabled() const { return m_DepthWriteEnabled; }
+		void SetDepthTestEnabled(bool enabled);
+		bool IsDepthTestEnabled() const { return m_DepthTestEnabled; }
+		void ResetStateCache();
+
 	private:
 		Context();
 		glm::mat4				  m_Projection;
@@ -89,27 +101,34 @@ namespace TTK
 		GLuint m_PointShaderHandle;
 		struct GLBuff {
 			GLuint VBO, VAO;
-			size_t Count;
+			size_t Capacity;
 			size_t ElemSize;
 			GLenum Mode;
-			void*  Data;
 			GLuint Shader;
 		};
 		GLBuff m_Tris, m_Lines, m_Points;
 
+		bool m_BlendEnabled;
+		bool m_DepthWriteEnabled;
+		bool m_DepthTestEnabled;
+
 		int m_WindowWidth, m_WindowHeight;
 		int m_viewportX, m_viewportY;
 
-		GLBuff __InitBuff(GLenum mode, GLuint shader, void* dataSource, size_t elemSize, size_t maxElems);
-		void __Flush(GLBuff& buff);
+		GLBuff __InitBuff(GLenum mode, GLuint shader, size_t elemSize, size_t initialElems);
+		template <typename T>
+		void __Flush(GLBuff& buff, std::vector<T>& verts);
 		GLuint __CompileShader(const char* vsSource, const char* fsSource);
 
-		static const size_t MaxPointVerts = 512;
-		static const size_t MaxLineVerts = 512 * 2;
-		static const size_t MaxTriVerts = 512 * 3;
+		// The streams grow as needed, these are just the sizes we start at
+		static const size_t InitialPointVerts = 512;
+		static const size_t InitialLineVerts = 512 * 2;
+		static const size_t InitialTriVerts = 512 * 3;
+		// Streams are flushed early once they reach this many vertices, to keep memory bounded
+		static const size_t MaxBatchVerts = 65536 * 3;
 
-		PointVert  m_PointVerts[MaxPointVerts];
-		SimpleVert m_LineVerts[MaxLineVerts];
-		SimpleVert m_TriVerts[MaxTriVerts];
+		std::vector<PointVert>  m_PointVerts;
+		std::vector<SimpleVert> m_LineVerts;
+		std::vector<SimpleVert> m_TriVerts;
 	};
 }
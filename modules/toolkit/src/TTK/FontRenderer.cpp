@@ -53,9 +53,10 @@ char* readFile(const char* filename) {
 
 TTK::FontRenderer* TTK::FontRenderer::m_Instance = nullptr;
 
-TTK::TrueTypeTextureFont::TrueTypeTextureFont(const char* fileName, uint32_t size)
+TTK::TrueTypeTextureFont::TrueTypeTextureFont(const char* fileName, uint32_t size, bool signedDistanceField)
 {
 	myFontSize = size;
+	myIsSdf = signedDistanceField;
 
 	unsigned char* fontData = (unsigned char*)readFile(fileName);
 	uint8_t* atlasData = new uint8_t[static_cast<size_t>(ATLAS_WIDTH) * ATLAS_HEIGHT];
@@ -75,25 +76,25 @@ TTK::TrueTypeTextureFont::TrueTypeTextureFont(const char* fileName, uint32_t siz
 	myPixelHeightScale = stbtt_ScaleForPixelHeight(&myFontInfo, static_cast<float>(size));
 	myEmToPixel = stbtt_ScaleForMappingEmToPixels(&myFontInfo, 1.0f);
 
-	stbtt_pack_context context;
-	if (!stbtt_PackBegin(&context, atlasData, ATLAS_WIDTH, ATLAS_HEIGHT, 0, 1, nullptr)) {
-		LOG_ERROR("Failed to pack font texture");
-		delete[] atlasData;
-		delete[] fontData;
-		return;
-	}
-
-	stbtt_PackSetOversampling(&context, FONT_OVERSAMPLE_X, FONT_OVERSAMPLE_Y);
-	if (!stbtt_PackFontRange(&context, fontData, 0, static_cast<float>(size), FIRST_CHAR, CHAR_COUNT, myCharInfo)) {
-		LOG_ERROR("Failed to pack font range");
-		delete[] atlasData;
-		delete[] fontData;
-		return;
-	}
-	stbtt_PackEnd(&context);
+	if (myIsSdf) {
+		__PackSdfGlyphs(atlasData);
+	} else {
+		stbtt_pack_context context;
+		if (!stbtt_PackBegin(&context, atlasData, ATLAS_WIDTH, ATLAS_HEIGHT, 0, 1, nullptr)) {
+			LOG_ERROR("Failed to pack font texture");
+			delete[] atlasData;
+			delete[] fontData;
+			return;
+		}
 
-	for (uint32_t ix = FIRST_CHAR; ix < FIRST_CHAR + CHAR_COUNT; ix++) {
-		// TODO: Grab glyph data
+		stbtt_PackSetOversampling(&context, FONT_OVERSAMPLE_X, FONT_OVERSAMPLE_Y);
+		if (!stbtt_PackFontRange(&context, fontData, 0, static_cast<float>(size), FIRST_CHAR, CHAR_COUNT, myCharInfo)) {
+			LOG_ERROR("Failed to pack font range");
+			delete[] atlasData;
+			delete[] fontData;
+			return;
+		}
+		stbtt_PackEnd(&context);
 	}
 
 	// Create and upload the texture to store our font in
@@ -101,7 +102,7 @@ TTK::TrueTypeTextureFont::TrueTypeTextureFont(const char* fileName, uint32_t siz
 	glCreateTextures(GL_TEXTURE_2D, 1, &myTexture);
 	glTextureParameteri(myTexture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTextureParameteri(myTexture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTextureParameteri(myTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
+	glTextureParameteri(myTexture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTextureParameteri(myTexture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	LOG_ASSERT(glGetError() == GL_NONE, "Some error has occured!");
 	glTextureStorage2D(myTexture, 1, GL_R8, ATLAS_WIDTH, ATLAS_HEIGHT);
@@ -115,6 +116,61 @@ TTK::TrueTypeTextureFont::TrueTypeTextureFont(const char* fileName, uint32_t siz
 	delete[] fontData;
 }
 
+void TTK::TrueTypeTextureFont::__PackSdfGlyphs(uint8_t* atlasData) {
+	memset(atlasData, 0, static_cast<size_t>(ATLAS_WIDTH) * ATLAS_HEIGHT);
+
+	// Distance is stored so that 128 lies on the glyph's edge, and the full range covers the padding on either side
+	const unsigned char onEdge = 128;
+	const float distScale = static_cast<float>(onEdge) / SDF_PADDING;
+
+	// Simple shelf packing, glyphs are placed left to right and we move down a row when we run out of space
+	int x = 1, y = 1, rowHeight = 0;
+	for (uint32_t ix = 0; ix < CHAR_COUNT; ix++) {
+		stbtt_packedchar& info = myCharInfo[ix];
+		memset(&info, 0, sizeof(stbtt_packedchar));
+
+		int advance, leftBearing;
+		stbtt_GetCodepointHMetrics(&myFontInfo, FIRST_CHAR + ix, &advance, &leftBearing);
+		info.xadvance = advance * myPixelHeightScale;
+
+		int width, height, xOff, yOff;
+		unsigned char* sdf = stbtt_GetCodepointSDF(&myFontInfo, myPixelHeightScale, FIRST_CHAR + ix, SDF_PADDING, onEdge, distScale, &width, &height, &xOff, &yOff);
+		// Whitespace has no glyph, but still has an advance
+		if (sdf == nullptr) {
+			continue;
+		}
+
+		if (x + width + 1 > static_cast<int>(ATLAS_WIDTH)) {
+			x = 1;
+			y += rowHeight + 1;
+			rowHeight = 0;
+		}
+		if (y + height + 1 > static_cast<int>(ATLAS_HEIGHT)) {
+			LOG_ERROR("Font atlas is too small to fit all SDF glyphs");
+			stbtt_FreeSDF(sdf, nullptr);
+			return;
+		}
+
+		for (int row = 0; row < height; row++) {
+			memcpy(atlasData + static_cast<size_t>(y + row) * ATLAS_WIDTH + x, sdf + static_cast<size_t>(row) * width, width);
+		}
+		stbtt_FreeSDF(sdf, nullptr);
+
+		// Fill in the packed char the same way stbtt_PackFontRange would, so that GetGlyph works for both atlas types
+		info.x0 = static_cast<unsigned short>(x);
+		info.y0 = static_cast<unsigned short>(y);
+		info.x1 = static_cast<unsigned short>(x + width);
+		info.y1 = static_cast<unsigned short>(y + height);
+		info.xoff = static_cast<float>(xOff);
+		info.yoff = static_cast<float>(yOff);
+		info.xoff2 = static_cast<float>(xOff + width);
+		info.yoff2 = static_cast<float>(yOff + height);
+
+		x += width + 1;
+		rowHeight = glm::max(rowHeight, height);
+	}
+}
+
 TTK::TrueTypeTextureFont::~TrueTypeTextureFont()
 {
 	delete[] myCharInfo;
@@ -197,22 +253,22 @@ glm::vec2 TTK::TrueTypeTextureFont::MeausureString(const char* text, const float
 
 TTK::FontRenderer::~FontRenderer()
 {
-	glDeleteShader(m_ShaderHandle);
+	glDeleteProgram(m_ShaderHandle);
+	glDeleteBuffers(1, &m_VBO);
+	glDeleteBuffers(1, &m_EBO);
 	glDeleteVertexArrays(1, &m_VAO);
 }
 
 void TTK::FontRenderer::Render(const TrueTypeTextureFont& font, const char* text, const glm::vec2& pos, const glm::vec4& color, float scale)
 {
-	size_t length = strlen(text);
-	
-	float multiplier = scale;
-
-	// The number of quads ACTUALLY drawn Shit-For-Brains
-	int quads = 0;
-
-	glm::vec2 originPos = glm::vec2(pos.x, pos.y);
+	if (text == nullptr || text[0] == '\0') {
+		return;
+	}
 
-	static GlyphInfo glyph;
+	const GlyphRun& run = __GetRun(font, text);
+	if (run.Verts.empty()) {
+		return;
+	}
 
 	Col8 gpuCol;
 	gpuCol.R = static_cast<char>(color.r * 255);
@@ -220,109 +276,164 @@ void TTK::FontRenderer::Render(const TrueTypeTextureFont& font, const char* text
 	gpuCol.B = static_cast<char>(color.b * 255);
 	gpuCol.A = static_cast<char>(color.a * 255);
 
-	float xOff{ 0 }, yOff{ 0 };
+	// Extend the last batch if it uses the same font, otherwise start a new one
+	if (m_Batches.empty() || m_Batches.back().Font != &font) {
+		m_Batches.push_back({ &font, m_MeshData.size(), 0 });
+	}
+	m_Batches.back().VertCount += run.Verts.size();
 
-	for (int i = 0; i < length; i++) {
-		glyph = font.GetGlyph(text[i], xOff, yOff);
-		xOff = glyph.OffsetX;
-		yOff = glyph.OffsetY;
+	// The layout is cached, all we need to do is place it on the screen
+	for (const RunVert& vert : run.Verts) {
+		m_MeshData.push_back({ pos + vert.Position * scale, gpuCol, vert.UV });
+	}
+}
 
-		if (text[i] == '\n')
-		{
-			yOff += font.GetLineHeight() * multiplier;
-			xOff = 0;
-		}
-		else if (text[i] == '\r') {
-			xOff = 0;
-		}
-		else if (text[i] == '\t') {
-			float xOffTemp{ 0 }, yOffTemp{ 0 };
-			glyph = font.GetGlyph(' ', xOffTemp, yOffTemp);
-			xOff += glyph.OffsetX * 4;
+void TTK::FontRenderer::Flush()
+{
+	m_FrameIndex++;
+
+	// Every so often, drop any cached strings that we have not drawn in a while
+	if (m_FrameIndex % MaxRunAge == 0) {
+		for (auto it = m_RunCache.begin(); it != m_RunCache.end();) {
+			if (m_FrameIndex - it->second.LastUsedFrame > MaxRunAge) {
+				it = m_RunCache.erase(it);
+			} else {
+				++it;
+			}
 		}
-		else {
-			m_MeshData[quads * 4 + 0].Position = originPos + glyph.Positions[0] * multiplier;
-			m_MeshData[quads * 4 + 0].UV = glyph.UVs[0];
-			m_MeshData[quads * 4 + 0].Color = gpuCol;
+	}
+
+	if (m_MeshData.empty()) {
+		return;
+	}
 
-			m_MeshData[quads * 4 + 1].Position = originPos + glyph.Positions[1] * multiplier;
-			m_MeshData[quads * 4 + 1].UV = glyph.UVs[1];
-			m_MeshData[quads * 4 + 1].Color = gpuCol;
+	__EnsureIndexCapacity(m_MeshData.size() / 4);
 
-			m_MeshData[quads * 4 + 2].Position = originPos + glyph.Positions[2] * multiplier;
-			m_MeshData[quads * 4 + 2].UV = glyph.UVs[2];
-			m_MeshData[quads * 4 + 2].Color = gpuCol;
+	// Grow the vertex buffer if needed, otherwise orphan it so we don't wait on last frame's draw
+	if (m_MeshData.size() > m_VertexCapacity) {
+		m_VertexCapacity = m_MeshData.capacity();
+	}
+	glNamedBufferData(m_VBO, m_VertexCapacity * sizeof(Vert), nullptr, GL_STREAM_DRAW);
+	glNamedBufferSubData(m_VBO, 0, m_MeshData.size() * sizeof(Vert), m_MeshData.data());
+
+	// We use the state that the context has tracked, rather than querying OpenGL and forcing a sync
+	TTK::Context& context = TTK::Context::Instance();
+	const bool blendState = context.IsBlendEnabled();
+	const bool depthMaskEnabled = context.IsDepthWriteEnabled();
+	context.SetDepthWriteEnabled(false);
+	context.SetBlendEnabled(true);
+	glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ZERO);
 
-			m_MeshData[quads * 4 + 3].Position = originPos + glyph.Positions[3] * multiplier;
-			m_MeshData[quads * 4 + 3].UV = glyph.UVs[3];
-			m_MeshData[quads * 4 + 3].Color = gpuCol;
+	glm::mat4 proj = context.GetOrthoProjection();
+	glUseProgram(m_ShaderHandle);
+	glProgramUniformMatrix4fv(m_ShaderHandle, 0, 1, false, &proj[0][0]);
+	glBindVertexArray(m_VAO);
+	for (const Batch& batch : m_Batches) {
+		glProgramUniformHandleui64ARB(m_ShaderHandle, 1, batch.Font->m_TexHandle);
+		glProgramUniform1i(m_ShaderHandle, 2, batch.Font->IsSignedDistanceField() ? 1 : 0);
+		// Each quad has 4 verts and 6 indices, and our indices are laid out in quad order
+		const size_t firstIndex = (batch.FirstVert / 4) * 6;
+		glDrawElements(GL_TRIANGLES, static_cast<GLsizei>((batch.VertCount / 4) * 6), GL_UNSIGNED_INT, reinterpret_cast<void*>(firstIndex * sizeof(GLuint)));
+	}
+	glBindVertexArray(0);
 
+	context.SetBlendEnabled(blendState);
+	context.SetDepthWriteEnabled(depthMaskEnabled);
 
-			m_IndexData[quads * 6 + 0] = quads * 4 + 0;
-			m_IndexData[quads * 6 + 1] = quads * 4 + 1;
-			m_IndexData[quads * 6 + 2] = quads * 4 + 2;
+	m_MeshData.clear();
+	m_Batches.clear();
+}
 
-			m_IndexData[quads * 6 + 3] = quads * 4 + 0;
-			m_IndexData[quads * 6 + 4] = quads * 4 + 2;
-			m_IndexData[quads * 6 + 5] = quads * 4 + 3;
+const TTK::FontRenderer::GlyphRun& TTK::FontRenderer::__GetRun(const TrueTypeTextureFont& font, const char* text) {
+	auto result = m_RunCache.try_emplace(RunKey{ &font, text });
+	GlyphRun& run = result.first->second;
+	// Newly inserted, we need to lay it out
+	if (result.second) {
+		__BuildRun(font, text, run);
+	}
+	run.LastUsedFrame = m_FrameIndex;
+	return run;
+}
 
-			quads++;
+void TTK::FontRenderer::__BuildRun(const TrueTypeTextureFont& font, const char* text, GlyphRun& run) const {
+	GlyphInfo glyph;
+	float xOff{ 0 }, yOff{ 0 };
+
+	const size_t length = strlen(text);
+	run.Verts.reserve(length * 4);
+	for (size_t i = 0; i < length; i++) {
+		const uint32_t c = static_cast<unsigned char>(text[i]);
+		if (c == '\n') {
+			yOff += font.GetLineHeight();
+			xOff = 0;
+		}
+		else if (c == '\r') {
+			xOff = 0;
+		}
+		else if (c == '\t') {
+			float xOffTemp{ 0 }, yOffTemp{ 0 };
+			glyph = font.GetGlyph(' ', xOffTemp, yOffTemp);
+			xOff += glyph.OffsetX * 4;
+		}
+		else if (c >= font.FIRST_CHAR && c < font.FIRST_CHAR + font.CHAR_COUNT) {
+			glyph = font.GetGlyph(c, xOff, yOff);
+			xOff = glyph.OffsetX;
+			yOff = glyph.OffsetY;
+
+			for (int corner = 0; corner < 4; corner++) {
+				run.Verts.push_back({ glyph.Positions[corner], glyph.UVs[corner] });
+			}
 		}
 	}
+}
 
-	length = quads;
+void TTK::FontRenderer::__EnsureIndexCapacity(size_t quads) {
+	if (quads <= m_QuadCapacity) {
+		return;
+	}
 
-	// Update and render our meshes
-	bool blendState = glIsEnabled(GL_BLEND);
-	GLboolean depthMaskEnabled = false;
-	glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMaskEnabled);
-	glDepthMask(GL_FALSE);
-	glEnable(GL_BLEND);
-	glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ZERO);
-	glGetError();
-	glm::mat4 proj = TTK::Context::Instance().GetOrthoProjection();
-	glUseProgram(m_ShaderHandle);
-	glProgramUniformMatrix4fv(m_ShaderHandle, 0, 1, false, &proj[0][0]);
-	glProgramUniformHandleui64ARB(m_ShaderHandle, 1, font.m_TexHandle);	
-	glBindVertexArray(m_VAO);
-	glNamedBufferSubData(m_VBO, 0, length * 4 * sizeof(Vert), m_MeshData);
-	glNamedBufferSubData(m_EBO, 0, length * 6 * sizeof(GLuint), m_IndexData);
-	glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(length * 6), GL_UNSIGNED_INT, nullptr);
-	glBindVertexArray(0);
-	LOG_ASSERT(glGetError() == GL_NONE, "Failed to draw our text mesh!");
-	if (!blendState) glDisable(GL_BLEND);
-	glDepthMask(depthMaskEnabled);
+	// The index pattern never changes, so we only rebuild it when we need to store more quads
+	m_QuadCapacity = glm::max(quads, m_QuadCapacity * 2);
+	std::vector<GLuint> indices(m_QuadCapacity * 6);
+	for (size_t quad = 0; quad < m_QuadCapacity; quad++) {
+		const GLuint base = static_cast<GLuint>(quad * 4);
+		indices[quad * 6 + 0] = base + 0;
+		indices[quad * 6 + 1] = base + 1;
+		indices[quad * 6 + 2] = base + 2;
+		indices[quad * 6 + 3] = base + 0;
+		indices[quad * 6 + 4] = base + 2;
+		indices[quad * 6 + 5] = base + 3;
+	}
+	glNamedBufferData(m_EBO, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
 }
 
 TTK::FontRenderer::FontRenderer() {
 	LOG_INFO("Initializing font renderer");
 
-	memset(m_MeshData, 0, sizeof(m_MeshData));
-	memset(m_IndexData, 0, sizeof(m_IndexData));
+	m_VertexCapacity = 256 * 4;
+	m_QuadCapacity = 0;
+	m_FrameIndex = 0;
+	m_MeshData.reserve(m_VertexCapacity);
 
 	glCreateVertexArrays(1, &m_VAO);
 	glBindVertexArray(m_VAO);
 	GLuint buffers[2];
 	glCreateBuffers(2, buffers);
 	glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
-	glNamedBufferData(buffers[0], 256 * 4 * sizeof(Vert), m_MeshData, GL_DYNAMIC_DRAW);
+	glNamedBufferData(buffers[0], m_VertexCapacity * sizeof(Vert), nullptr, GL_STREAM_DRAW);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
-	glNamedBufferData(buffers[1], 256 * 6 * sizeof(GLuint), m_IndexData, GL_DYNAMIC_DRAW);
 	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(1);
 	glEnableVertexAttribArray(2);
-	#pragma warning(push)
-	#pragma warning(disable: 6011)
-	Vert* v = nullptr;
-	glVertexAttribPointer(0, 3, GL_FLOAT, false, sizeof(Vert), &v->Position);
-	glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, false, sizeof(Vert), &v->Color);
-	glVertexAttribPointer(2, 2, GL_FLOAT, false, sizeof(Vert), &v->UV);
-	#pragma warning(pop)
+	glVertexAttribPointer(0, 2, GL_FLOAT, false, sizeof(Vert), (void*)offsetof(Vert, Position));
+	glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, true, sizeof(Vert), (void*)offsetof(Vert, Color));
+	glVertexAttribPointer(2, 2, GL_FLOAT, false, sizeof(Vert), (void*)offsetof(Vert, UV));
 	
 	glBindVertexArray(0);
 
 	m_VBO = buffers[0];
 	m_EBO = buffers[1];
+	__EnsureIndexCapacity(256);
 
 	const char* vsSource = R"LIT(#version 430
             layout (location = 0) in vec2 vertexPosition;
@@ -340,12 +451,18 @@ TTK::FontRenderer::FontRenderer() {
 	const char* fsSource = R"LIT(#version 430
 			#extension GL_ARB_bindless_texture : enable
             layout(bindless_sampler, location = 1) uniform sampler2D xSampler;
+            layout (location = 2) uniform int xIsSdf;
             layout (location = 0) in vec4 fragColor;
             layout (location = 1) in vec2 fragUv;            	
             out vec4 frag_color;            	
             void main() {
-                frag_color = fragColor;
-				frag_color.a = texture2D(xSampler, fragUv).r;
+                float coverage = texture(xSampler, fragUv).r;
+                if (xIsSdf != 0) {
+                    // 0.5 is the glyph's edge, we use the screen-space derivative to keep a ~1 pixel wide edge at any scale
+                    float width = fwidth(coverage);
+                    coverage = smoothstep(0.5 - width, 0.5 + width, coverage);
+                }
+                frag_color = vec4(fragColor.rgb, fragColor.a * coverage);
             })LIT";
 
 	m_ShaderHandle = glCreateProgram();
@@ -13,6 +13,7 @@
 
 #include "TTK/GraphicsUtils.h"
 #include "TTK/TTKContext.h"
+#include "TTK/SpriteBatch.h"
 #include <GLM/gtc/matrix_transform.inl>
 
 #include "imgui.h"
@@ -46,10 +47,10 @@ void TTK::Graphics::SetViewport(int x, int y, int w, int h)
 }
 
 void TTK::Graphics::SetDepthEnabled(bool isEnabled) {
-	if (isEnabled)
-		glEnable(GL_DEPTH_TEST);
-	else
-		glDisable(GL_DEPTH_TEST);
+	// The app may have toggled depth testing itself since the cache was read, so we always apply this, and then let
+	// the context know so the cache matches
+	if (isEnabled) glEnable(GL_DEPTH_TEST); else glDisable(GL_DEPTH_TEST);
+	TTK::Context::Instance().SetDepthTestEnabled(isEnabled);
 }
 
 void TTK::Graphics::SetCameraMatrix(const glm::mat4& view) {
@@ -94,6 +95,7 @@ void TTK::Graphics::DrawGrid(float gridWidth, AlignMode mode) {
 void TTK::Graphics::Cleanup() {
 	TTK::Context::DestroyContext();
 	TTK::FontRenderer::DestroyContext();
+	TTK::SpriteBatch::DestroyContext();
 }
 
 void TTK::Graphics::DrawText2D(const std::string& text, float posX, float posY, float fontSize) {
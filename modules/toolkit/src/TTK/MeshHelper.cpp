@@ -21,49 +21,84 @@ TTK::Impl::MeshHelper::~MeshHelper() {
 	glDeleteBuffers(1, &m_Teapot.VBO);
 	glDeleteBuffers(1, &m_Sphere.VBO);
 	glDeleteBuffers(1, &m_Cube.VBO);
+	glDeleteBuffers(1, &m_Teapot.InstanceVBO);
+	glDeleteBuffers(1, &m_Sphere.InstanceVBO);
+	glDeleteBuffers(1, &m_Cube.InstanceVBO);
 	glDeleteVertexArrays(1, &m_Teapot.VAO);
 	glDeleteVertexArrays(1, &m_Sphere.VAO);
 	glDeleteVertexArrays(1, &m_Cube.VAO);
 	glDeleteProgram(m_Shader);
 }
 
-void TTK::Impl::MeshHelper::RenderTeapot(const glm::mat4& transform, const glm::vec4& color) const {
-	glUseProgram(m_Shader);
-	glm::mat4 t = Context::Instance().GetViewProjection() * transform;
-	glProgramUniformMatrix4fv(m_Shader, 0, 1, FALSE, &t[0][0]);
-	glProgramUniform4fv(m_Shader, 1, 1, &color[0]);
-	glBindVertexArray(m_Teapot.VAO);
-	glDrawArrays(GL_TRIANGLES, 0, sizeof(TeapotData) / (sizeof(float) * 6));
+void TTK::Impl::MeshHelper::RenderTeapot(const glm::mat4& transform, const glm::vec4& color) {
+	__Queue(m_Teapot, transform, color);
 }
 
-void TTK::Impl::MeshHelper::RenderSphere(const glm::mat4& transform, const glm::vec4& color) const {
-	glUseProgram(m_Shader);
-	glm::mat4 t = Context::Instance().GetViewProjection() * transform;
-	glProgramUniformMatrix4fv(m_Shader, 0, 1, FALSE, &t[0][0]);
-	glProgramUniform4fv(m_Shader, 1, 1, &color[0]);
-	glBindVertexArray(m_Sphere.VAO);
-	glDrawArrays(GL_TRIANGLES, 0, sizeof(SphereData) / (sizeof(float) * 6));
+void TTK::Impl::MeshHelper::RenderSphere(const glm::mat4& transform, const glm::vec4& color) {
+	__Queue(m_Sphere, transform, color);
 }
 
-void TTK::Impl::MeshHelper::RenderCube(const glm::mat4& transform, const glm::vec4& color) const
-{
+void TTK::Impl::MeshHelper::RenderCube(const glm::mat4& transform, const glm::vec4& color) {
+	__Queue(m_Cube, transform, color);
+}
+
+void TTK::Impl::MeshHelper::Flush() {
+	__Flush(m_Teapot);
+	__Flush(m_Sphere);
+	__Flush(m_Cube);
+}
+
+void TTK::Impl::MeshHelper::__Queue(mesh& mesh, const glm::mat4& transform, const glm::vec4& color) {
+	// We bake the view projection in now, so that camera changes before the flush don't affect shapes that are already queued
+	mesh.Instances.push_back({ Context::Instance().GetViewProjection() * transform, color });
+	if (mesh.Instances.size() >= MaxInstances) {
+		__Flush(mesh);
+	}
+}
+
+void TTK::Impl::MeshHelper::__Flush(mesh& mesh) {
+	if (mesh.Instances.empty()) {
+		return;
+	}
+
+	const size_t count = mesh.Instances.size();
+	// Grow the instance buffer if needed, otherwise orphan the old store so we don't stall on draws still using it
+	if (count > mesh.InstanceCapacity) {
+		mesh.InstanceCapacity = count;
+	}
+	glNamedBufferData(mesh.InstanceVBO, mesh.InstanceCapacity * sizeof(instance), nullptr, GL_STREAM_DRAW);
+	glNamedBufferSubData(mesh.InstanceVBO, 0, count * sizeof(instance), mesh.Instances.data());
+
 	glUseProgram(m_Shader);
-	glm::mat4 t = Context::Instance().GetViewProjection() * transform;
-	glProgramUniformMatrix4fv(m_Shader, 0, 1, FALSE, &t[0][0]);
-	glProgramUniform4fv(m_Shader, 1, 1, &color[0]);
-	glBindVertexArray(m_Cube.VAO);
-	glDrawArrays(GL_TRIANGLES, 0, sizeof(CubeData) / (sizeof(float) * 6));
+	glBindVertexArray(mesh.VAO);
+	glDrawArraysInstanced(GL_TRIANGLES, 0, mesh.VertexCount, static_cast<GLsizei>(count));
+
+	mesh.Instances.clear();
 }
 
 TTK::Impl::MeshHelper::mesh TTK::Impl::MeshHelper::__MakeMesh(const float* data, size_t size) const {
 	mesh result;
+	result.VertexCount = static_cast<GLsizei>(size / (sizeof(float) * 6));
+	result.InstanceCapacity = 0;
 	glCreateVertexArrays(1, &result.VAO);
 	glBindVertexArray(result.VAO);
 	glCreateBuffers(1, &result.VBO);
 	glBindBuffer(GL_ARRAY_BUFFER, result.VBO);
-	glNamedBufferData(result.VBO, size, data, GL_DYNAMIC_DRAW);
+	glNamedBufferData(result.VBO, size, data, GL_STATIC_DRAW);
 	glEnableVertexAttribArray(0);
 	glVertexAttribPointer(0, 3, GL_FLOAT, false, sizeof(float) * 6, 0);
+
+	// Per-instance attributes, the transform takes up 4 attribute slots (1-4) and the color is in slot 5
+	glCreateBuffers(1, &result.InstanceVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, result.InstanceVBO);
+	for (int ix = 0; ix < 4; ix++) {
+		glEnableVertexAttribArray(1 + ix);
+		glVertexAttribPointer(1 + ix, 4, GL_FLOAT, false, sizeof(instance), (void*)(offsetof(instance, Transform) + sizeof(glm::vec4) * ix));
+		glVertexAttribDivisor(1 + ix, 1);
+	}
+	glEnableVertexAttribArray(5);
+	glVertexAttribPointer(5, 4, GL_FLOAT, false, sizeof(instance), (void*)offsetof(instance, Color));
+	glVertexAttribDivisor(5, 1);
 	return result;
 }
 
@@ -77,16 +112,20 @@ TTK::Impl::MeshHelper::MeshHelper()
 	
 	const char* vsSource = R"LIT(#version 430
             layout (location = 0) in vec3 vertexPosition;
-            layout (location = 0) uniform mat4 xTransform;	
+            layout (location = 1) in mat4 instanceTransform;
+            layout (location = 5) in vec4 instanceColor;
+
+            layout (location = 0) out vec4 fragmentColor;
             void main() {
-                gl_Position = xTransform * vec4(vertexPosition, 1);
+                gl_Position = instanceTransform * vec4(vertexPosition, 1);
+                fragmentColor = instanceColor;
             })LIT";
 
 	const char* fsSource = R"LIT(#version 430   
-            layout (location = 1) uniform vec4 xColor;		
+            layout (location = 0) in vec4 fragColor;
             out vec4 frag_color;            	
             void main() {
-                frag_color = xColor;
+                frag_color = fragColor;
             })LIT";
 
 	m_Shader = glCreateProgram();
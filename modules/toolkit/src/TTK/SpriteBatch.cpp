@@ -0,0 +1,195 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// This file is a part of the Tutorial Tool Kit (TTK) library. 
+// You may not use this file in your GDW games.
+//
+// This file implements the TTK sprite batch
+//
+// Shawn Matthews 2019
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "TTK/SpriteBatch.h"
+#include <algorithm>
+#include "Logging.h"
+
+TTK::SpriteBatch* TTK::SpriteBatch::m_Instance = nullptr;
+
+TTK::SpriteBatch::~SpriteBatch()
+{
+	glDeleteProgram(m_ShaderHandle);
+	glDeleteBuffers(1, &m_VBO);
+	glDeleteBuffers(1, &m_EBO);
+	glDeleteVertexArrays(1, &m_VAO);
+}
+
+void TTK::SpriteBatch::Submit(GLuint texture, const glm::mat4& matrix, const glm::vec2& uvMin, const glm::vec2& uvMax, const glm::vec4& color, int layer)
+{
+	Sprite sprite;
+	sprite.Layer = layer;
+	sprite.Texture = texture;
+	sprite.Order = static_cast<uint32_t>(m_Sprites.size());
+
+	// Transform the corners of the unit quad now, so that every sprite can share a single draw
+	// Corner order is top left, top right, bottom left, bottom right
+	const glm::vec4 right = matrix[0];
+	const glm::vec4 up    = matrix[1];
+	sprite.Corners[0] = matrix[3] - right + up;
+	sprite.Corners[1] = matrix[3] + right + up;
+	sprite.Corners[2] = matrix[3] - right - up;
+	sprite.Corners[3] = matrix[3] + right - up;
+	sprite.UVRect = glm::vec4(uvMin, uvMax);
+
+	sprite.Color.R = static_cast<char>(color.r * 255);
+	sprite.Color.G = static_cast<char>(color.g * 255);
+	sprite.Color.B = static_cast<char>(color.b * 255);
+	sprite.Color.A = static_cast<char>(color.a * 255);
+
+	m_Sprites.push_back(sprite);
+}
+
+void TTK::SpriteBatch::Flush()
+{
+	m_LastDrawCount = 0;
+	if (m_Sprites.empty()) {
+		return;
+	}
+
+	// Sort by layer, then by texture so that every run of sprites sharing a texture becomes one draw
+	std::sort(m_Sprites.begin(), m_Sprites.end(), [](const Sprite& a, const Sprite& b) {
+		if (a.Layer != b.Layer) return a.Layer < b.Layer;
+		if (a.Texture != b.Texture) return a.Texture < b.Texture;
+		return a.Order < b.Order;
+	});
+
+	m_MeshData.resize(m_Sprites.size() * 4);
+	for (size_t ix = 0; ix < m_Sprites.size(); ix++) {
+		const Sprite& sprite = m_Sprites[ix];
+		Vert* verts = &m_MeshData[ix * 4];
+		verts[0] = { sprite.Corners[0], { sprite.UVRect.x, sprite.UVRect.y }, sprite.Color };
+		verts[1] = { sprite.Corners[1], { sprite.UVRect.z, sprite.UVRect.y }, sprite.Color };
+		verts[2] = { sprite.Corners[2], { sprite.UVRect.x, sprite.UVRect.w }, sprite.Color };
+		verts[3] = { sprite.Corners[3], { sprite.UVRect.z, sprite.UVRect.w }, sprite.Color };
+	}
+
+	__EnsureIndexCapacity(m_Sprites.size());
+
+	// Grow the vertex buffer if needed, otherwise orphan it so we don't wait on the previous draw
+	if (m_MeshData.size() > m_VertexCapacity) {
+		m_VertexCapacity = m_MeshData.capacity();
+	}
+	glNamedBufferData(m_VBO, m_VertexCapacity * sizeof(Vert), nullptr, GL_STREAM_DRAW);
+	glNamedBufferSubData(m_VBO, 0, m_MeshData.size() * sizeof(Vert), m_MeshData.data());
+
+	glUseProgram(m_ShaderHandle);
+	glBindVertexArray(m_VAO);
+	size_t runStart = 0;
+	for (size_t ix = 1; ix <= m_Sprites.size(); ix++) {
+		// Keep extending the run until the layer or texture changes
+		if (ix < m_Sprites.size() && m_Sprites[ix].Layer == m_Sprites[runStart].Layer && m_Sprites[ix].Texture == m_Sprites[runStart].Texture) {
+			continue;
+		}
+		glBindTextureUnit(0, m_Sprites[runStart].Texture);
+		glDrawElements(GL_TRIANGLES, static_cast<GLsizei>((ix - runStart) * 6), GL_UNSIGNED_INT, reinterpret_cast<void*>(runStart * 6 * sizeof(GLuint)));
+		m_LastDrawCount++;
+		runStart = ix;
+	}
+	glBindVertexArray(0);
+
+	m_Sprites.clear();
+}
+
+void TTK::SpriteBatch::__EnsureIndexCapacity(size_t quads)
+{
+	if (quads <= m_QuadCapacity) {
+		return;
+	}
+
+	// The index pattern never changes, so we only rebuild it when we need to store more quads
+	m_QuadCapacity = glm::max(quads, m_QuadCapacity * 2);
+	std::vector<GLuint> indices(m_QuadCapacity * 6);
+	for (size_t quad = 0; quad < m_QuadCapacity; quad++) {
+		const GLuint base = static_cast<GLuint>(quad * 4);
+		indices[quad * 6 + 0] = base + 0;
+		indices[quad * 6 + 1] = base + 1;
+		indices[quad * 6 + 2] = base + 2;
+		indices[quad * 6 + 3] = base + 2;
+		indices[quad * 6 + 4] = base + 1;
+		indices[quad * 6 + 5] = base + 3;
+	}
+	glNamedBufferData(m_EBO, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+}
+
+TTK::SpriteBatch::SpriteBatch()
+{
+	LOG_INFO("Initializing sprite batch");
+
+	m_VertexCapacity = 256 * 4;
+	m_QuadCapacity = 0;
+	m_LastDrawCount = 0;
+
+	glCreateVertexArrays(1, &m_VAO);
+	glBindVertexArray(m_VAO);
+	GLuint buffers[2];
+	glCreateBuffers(2, buffers);
+	m_VBO = buffers[0];
+	m_EBO = buffers[1];
+	glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+	glNamedBufferData(m_VBO, m_VertexCapacity * sizeof(Vert), nullptr, GL_STREAM_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(0, 4, GL_FLOAT, false, sizeof(Vert), (void*)offsetof(Vert, Position));
+	glVertexAttribPointer(1, 2, GL_FLOAT, false, sizeof(Vert), (void*)offsetof(Vert, UV));
+	glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, true, sizeof(Vert), (void*)offsetof(Vert, Color));
+	glBindVertexArray(0);
+
+	__EnsureIndexCapacity(256);
+
+	const char* vsSource = R"LIT(#version 440
+            layout (location = 0) in vec4 vertexPosition;
+            layout (location = 1) in vec2 vertexTexture;
+            layout (location = 2) in vec4 vertexColor;
+            layout (location = 0) out vec2 fragmentTexture;
+            layout (location = 1) out vec4 fragmentColor;
+            void main() {
+                gl_Position = vertexPosition;
+                fragmentTexture = vertexTexture;
+                fragmentColor = vertexColor;
+            })LIT";
+
+	const char* fsSource = R"LIT(#version 440
+            layout(binding = 0) uniform sampler2D xSampler;
+            layout (location = 0) in vec2 fragUv;
+            layout (location = 1) in vec4 fragColor;
+            out vec4 frag_color;            	
+            void main() {
+				frag_color = texture(xSampler, fragUv) * fragColor;
+            })LIT";
+
+	m_ShaderHandle = glCreateProgram();
+
+	GLuint programs[2];
+	programs[0] = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(programs[0], 1, &vsSource, NULL);
+	glCompileShader(programs[0]);
+	programs[1] = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(programs[1], 1, &fsSource, NULL);
+	glCompileShader(programs[1]);
+
+	// Attach our two shaders
+	glAttachShader(m_ShaderHandle, programs[0]);
+	glAttachShader(m_ShaderHandle, programs[1]);
+
+	// Perform linking
+	glLinkProgram(m_ShaderHandle);
+
+	// Remove shader parts to save space
+	glDetachShader(m_ShaderHandle, programs[0]);
+	glDeleteShader(programs[0]);
+	glDetachShader(m_ShaderHandle, programs[1]);
+	glDeleteShader(programs[1]);
+
+	LOG_INFO("Done initializing sprite batch");
+}
\ No newline at end of file
@@ -15,6 +15,7 @@
 #include <string>
 #include "Logging.h"
 #include "TTK/MeshHelper.h"
+#include "TTK/SpriteBatch.h"
 
 TTK::Context* TTK::Context::m_Instance = nullptr;
 
@@ -28,6 +29,7 @@ TTK::Context::~Context() {
 	glDeleteVertexArrays(1, &m_Lines.VAO);
 	glDeleteVertexArrays(1, &m_Points.VAO);
 	glDeleteProgram(m_ShaderHandle);
+	glDeleteProgram(m_PointShaderHandle);
 }
 
 glm::mat4 TTK::Context::GetOrthoProjection() const {
@@ -69,26 +71,19 @@ void TTK::Context::DrawCube(const glm::mat4& mat, const glm::vec4& color) const
 }
 
 void TTK::Context::AddLine(const glm::vec3& a, const glm::vec3& b, const glm::vec4& color) {
-	m_LineVerts[m_Lines.Count + 0].Position = a;
-	m_LineVerts[m_Lines.Count + 0].Color = color;
-	m_LineVerts[m_Lines.Count + 1].Position = b;
-	m_LineVerts[m_Lines.Count + 1].Color = color;
-	m_Lines.Count += 2;
-	if (m_Lines.Count == MaxLineVerts) {
-		__Flush(m_Lines);
+	m_LineVerts.push_back({ a, color });
+	m_LineVerts.push_back({ b, color });
+	if (m_LineVerts.size() >= MaxBatchVerts) {
+		__Flush(m_Lines, m_LineVerts);
 	}
 }
 
 void TTK::Context::AddTri(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec4& color) {
-	m_TriVerts[m_Tris.Count + 0].Position = a;
-	m_TriVerts[m_Tris.Count + 0].Color = color;
-	m_TriVerts[m_Tris.Count + 1].Position = b;
-	m_TriVerts[m_Tris.Count + 1].Color = color;
-	m_TriVerts[m_Tris.Count + 2].Position = c;
-	m_TriVerts[m_Tris.Count + 2].Color = color;
-	m_Tris.Count += 3;
-	if (m_Tris.Count == MaxTriVerts) {
-		__Flush(m_Tris);
+	m_TriVerts.push_back({ a, color });
+	m_TriVerts.push_back({ b, color });
+	m_TriVerts.push_back({ c, color });
+	if (m_TriVerts.size() >= MaxBatchVerts) {
+		__Flush(m_Tris, m_TriVerts);
 	}
 }
 
@@ -101,24 +96,59 @@ void TTK::Context::AddQuad(const glm::vec3& min, const glm::vec3& max, const glm
 
 void TTK::Context::AddPoint(const glm::vec3& pos, float size, const glm::vec4& color)
 {
-	m_PointVerts[m_Points.Count].Position = pos;
-	m_PointVerts[m_Points.Count].Color = color;
-	m_PointVerts[m_Points.Count].Size = size;
-	m_Points.Count += 1;
-	if (m_Points.Count == MaxPointVerts) {
-		__Flush(m_Points);
+	m_PointVerts.push_back({ pos, color, size });
+	if (m_PointVerts.size() >= MaxBatchVerts) {
+		__Flush(m_Points, m_PointVerts);
 	}
 }
 
 void TTK::Context::Flush() {
-	__Flush(m_Tris);
-	__Flush(m_Lines);
-	__Flush(m_Points);
+	// The app may have changed state itself since last frame, so we re-read it once here rather than every time
+	// something is drawn
+	ResetStateCache();
+	TTK::SpriteBatch::Instance().Flush();
+	m_MeshHelper->Flush();
+	__Flush(m_Tris, m_TriVerts);
+	__Flush(m_Lines, m_LineVerts);
+	__Flush(m_Points, m_PointVerts);
+	// Text goes last so that it ends up on top of everything else
+	TTK::FontRenderer::Instance().Flush();
+}
+
+void TTK::Context::SetBlendEnabled(bool enabled) {
+	if (enabled != m_BlendEnabled) {
+		if (enabled) glEnable(GL_BLEND); else glDisable(GL_BLEND);
+		m_BlendEnabled = enabled;
+	}
+}
+
+void TTK::Context::SetDepthWriteEnabled(bool enabled) {
+	if (enabled != m_DepthWriteEnabled) {
+		glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+		m_DepthWriteEnabled = enabled;
+	}
+}
+
+void TTK::Context::SetDepthTestEnabled(bool enabled) {
+	if (enabled != m_DepthTestEnabled) {
+		if (enabled) glEnable(GL_DEPTH_TEST); else glDisable(GL_DEPTH_TEST);
+		m_DepthTestEnabled = enabled;
+	}
+}
+
+void TTK::Context::ResetStateCache() {
+	GLboolean depthMask = GL_TRUE;
+	glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
+	m_DepthWriteEnabled = depthMask == GL_TRUE;
+	m_BlendEnabled = glIsEnabled(GL_BLEND);
+	m_DepthTestEnabled = glIsEnabled(GL_DEPTH_TEST);
 }
 
 TTK::Context::Context() {
 	m_Projection = glm::ortho(0.0f, 800.0f, 0.0f, 600.0f);
 	m_ViewMatrix = glm::mat4(1.0f);
+	// Read the initial state once, after this we track it ourselves
+	ResetStateCache();
 	m_DefaultFont = new TrueTypeTextureFont("C:\\\\Windows\\Fonts\\consola.ttf", 32);
 	
 	const char* vsSource = R"LIT(#version 430
@@ -159,19 +189,23 @@ TTK::Context::Context() {
 	m_PointShaderHandle = __CompileShader(vsSourcePoint, fsSource);
 
 
-	m_Tris = __InitBuff(GL_TRIANGLES, m_ShaderHandle, m_TriVerts, sizeof(SimpleVert), MaxTriVerts);
+	m_TriVerts.reserve(InitialTriVerts);
+	m_LineVerts.reserve(InitialLineVerts);
+	m_PointVerts.reserve(InitialPointVerts);
+
+	m_Tris = __InitBuff(GL_TRIANGLES, m_ShaderHandle, sizeof(SimpleVert), InitialTriVerts);
 	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(1);
 	glVertexAttribPointer(0, 3, GL_FLOAT, false, sizeof(SimpleVert), (void*)offsetof(SimpleVert, Position));
 	glVertexAttribPointer(1, 4, GL_FLOAT, false, sizeof(SimpleVert), (void*)offsetof(SimpleVert, Color));
 
-	m_Lines = __InitBuff(GL_LINES, m_ShaderHandle, m_LineVerts, sizeof(SimpleVert), MaxLineVerts);
+	m_Lines = __InitBuff(GL_LINES, m_ShaderHandle, sizeof(SimpleVert), InitialLineVerts);
 	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(1);
 	glVertexAttribPointer(0, 3, GL_FLOAT, false, sizeof(SimpleVert), (void*)offsetof(SimpleVert, Position));
 	glVertexAttribPointer(1, 4, GL_FLOAT, false, sizeof(SimpleVert), (void*)offsetof(SimpleVert, Color));
 
-	m_Points = __InitBuff(GL_POINTS, m_PointShaderHandle, m_PointVerts, sizeof(PointVert), MaxLineVerts);
+	m_Points = __InitBuff(GL_POINTS, m_PointShaderHandle, sizeof(PointVert), InitialPointVerts);
 	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(1);
 	glEnableVertexAttribArray(2);
@@ -188,12 +222,11 @@ TTK::Context::Context() {
 	glEnable(GL_PROGRAM_POINT_SIZE);
 }
 
-TTK::Context::GLBuff TTK::Context::__InitBuff(GLenum mode, GLuint shader, void* dataSource, size_t elemSize, size_t maxElems)
+TTK::Context::GLBuff TTK::Context::__InitBuff(GLenum mode, GLuint shader, size_t elemSize, size_t initialElems)
 {
 	GLBuff result;
 	result.Mode = mode;
-	result.Count = 0;
-	result.Data = dataSource;
+	result.Capacity = initialElems;
 	result.ElemSize = elemSize;
 	result.Shader = shader;
 
@@ -201,19 +234,27 @@ TTK::Context::GLBuff TTK::Context::__InitBuff(GLenum mode, GLuint shader, void*
 	glBindVertexArray(result.VAO);
 	glCreateBuffers(1, &result.VBO);
 	glBindBuffer(GL_ARRAY_BUFFER, result.VBO);
-	glNamedBufferData(result.VBO, elemSize * maxElems, nullptr, GL_STREAM_DRAW);
+	glNamedBufferData(result.VBO, elemSize * initialElems, nullptr, GL_STREAM_DRAW);
 
 	return result;
 }
 
-void TTK::Context::__Flush(GLBuff& buff) {
-	if (buff.Count > 0) {
+template <typename T>
+void TTK::Context::__Flush(GLBuff& buff, std::vector<T>& verts) {
+	if (!verts.empty()) {
+		// Grow the buffer if the stream no longer fits, otherwise orphan the old store so that we
+		// don't have to wait on any draws that are still reading from it
+		if (verts.size() > buff.Capacity) {
+			buff.Capacity = verts.capacity();
+		}
+		glNamedBufferData(buff.VBO, buff.Capacity * buff.ElemSize, nullptr, GL_STREAM_DRAW);
+		glNamedBufferSubData(buff.VBO, 0, verts.size() * buff.ElemSize, verts.data());
+
 		glUseProgram(buff.Shader);
 		glUniformMatrix4fv(0, 1, false, &m_ViewProjection[0][0]);
-		glNamedBufferSubData(buff.VBO, 0, buff.Count * buff.ElemSize, buff.Data);
 		glBindVertexArray(buff.VAO);
-		glDrawArrays(buff.Mode, 0, static_cast<GLsizei>(buff.Count));
-		buff.Count = 0;
+		glDrawArrays(buff.Mode, 0, static_cast<GLsizei>(verts.size()));
+		verts.clear();
 	}
 }
 
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+#include <Logging.h>
+#include <Timing.h>
+#include <FileArchive.h>
+
+// Packs a resource folder into a single archive that the VirtualFileSystem can mount, so a build can ship one file
+// instead of hundreds of loose ones. Run with no arguments for usage
+
+typedef Timing::Clock Clock;
+
+void PrintUsage() {
+	std::cout << "Usage:" << std::endl;
+	std::cout << "  AssetPacker <folder> <archive> [--no-compress] [--ratio <0-1>] [--align <bytes>]" << std::endl;
+	std::cout << "      Packs every file under folder into archive, with paths relative to folder" << std::endl;
+	std::cout << "      --no-compress  Stores every file as is" << std::endl;
+	std::cout << "      --ratio        Only keeps a file compressed if it shrinks to this fraction of it's size (default 0.9)" << std::endl;
+	std::cout << "      --align        The alignment of each file in the archive, a power of two (default 64)" << std::endl;
+	std::cout << "  AssetPacker --list <archive>" << std::endl;
+	std::cout << "      Lists the files in an archive" << std::endl;
+}
+
+int ListArchive(const std::string& path) {
+	FileArchive::sptr archive = FileArchive::Open(path);
+	if (archive == nullptr) {
+		return 1;
+	}
+
+	uint64_t totalSize = 0;
+	uint64_t totalStored = 0;
+	std::cout << std::setw(12) << "Size" << std::setw(12) << "Stored" << "  Compression  Path" << std::endl;
+	for (const FileArchive::EntryInfo& entry : archive->GetEntries()) {
+		std::cout << std::setw(12) << entry.Size << std::setw(12) << entry.StoredSize << "  "
+			<< std::left << std::setw(11) << (entry.Compression == ArchiveCompression::Gzip ? "gzip" : "none") << std::right
+			<< "  " << entry.Path << std::endl;
+		totalSize += entry.Size;
+		totalStored += entry.StoredSize;
+	}
+	std::cout << archive->GetEntryCount() << " files, " << totalSize / 1024 << " KB stored in " << totalStored / 1024 << " KB" << std::endl;
+	return 0;
+}
+
+int main(int argc, char** argv) {
+	Logger::Init();
+
+	if (argc == 3 && std::string(argv[1]) == "--list") {
+		const int result = ListArchive(argv[2]);
+		Logger::Uninitialize();
+		return result;
+	}
+	if (argc < 3) {
+		PrintUsage();
+		Logger::Uninitialize();
+		return 1;
+	}
+
+	ArchiveBuildSettings settings;
+	for (int ix = 3; ix < argc; ix++) {
+		const std::string arg = argv[ix];
+		if (arg == "--no-compress") {
+			settings.Compress = false;
+		} else if (arg == "--ratio" && ix + 1 < argc) {
+			settings.MinCompressionRatio = std::stof(argv[++ix]);
+		} else if (arg == "--align" && ix + 1 < argc) {
+			settings.Alignment = static_cast<uint32_t>(std::stoul(argv[++ix]));
+		} else {
+			std::cout << "Unknown argument \"" << arg << "\"" << std::endl;
+			PrintUsage();
+			Logger::Uninitialize();
+			return 1;
+		}
+	}
+	if (settings.Alignment == 0 || (settings.Alignment & (settings.Alignment - 1)) != 0) {
+		std::cout << "Alignment must be a power of two" << std::endl;
+		Logger::Uninitialize();
+		return 1;
+	}
+
+	const Clock::time_point start = Clock::now();
+	const bool result = FileArchive::Build(argv[2], argv[1], settings);
+	if (result) {
+		std::cout << "Built \"" << argv[2] << "\" in " << std::fixed << std::setprecision(1) << Timing::ElapsedMs(start) << "ms" << std::endl;
+	}
+
+	Logger::Uninitialize();
+	return result ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#include <Logging.h>
+#include <Timing.h>
+#include <Scene.h>
+#include <Transform.h>
+#include <GameObjectTag.h>
+#include <IBehaviour.h>
+#include <BehaviourSystem.h>
+#include <FollowPathBehaviour.h>
+#include <PhysicsSystem.h>
+#include <MeshBuilder.h>
+#include <MeshFactory.h>
+#include <VertexTypes.h>
+
+// Measures the cost of working with large GameScenes, away from any rendering so that the numbers are not muddied
+// by the GPU. Only components that do not need a GL context are used, the costs scale the same way for the others
+
+typedef Timing::Clock Clock;
+
+const uint32_t SceneEntityCount = 100000;
+const uint32_t SpawnCount = 10000;
+const uint32_t BehaviourCount = 10000;
+const int      BehaviourUpdates = 20;
+const uint32_t PhysicsBodyCount = 4000;
+const int      PhysicsSteps = 300;
+
+// Gives an entity the components a typical scene object has besides rendering, a name, tags and some bounds
+inline void SetupObject(GameObject object, uint32_t ix) {
+	object.get<GameObjectTag>().Tags = 1;
+	object.get<Transform>().SetLocalPosition((float)(ix % 316), (float)(ix / 316), 0.0f);
+	object.emplace<SpatialProxy>(AxisAlignedBox(glm::vec3(-0.5f), glm::vec3(0.5f)));
+}
+
+// Times loading a big scene from a file against building the same scene in code
+void BenchmarkSaveLoad(uint32_t entityCount) {
+	Clock::time_point start = Clock::now();
+	GameScene::sptr built = GameScene::Create("benchmark");
+	for (uint32_t ix = 0; ix < entityCount; ix++) {
+		SetupObject(built->CreateEntity("benchmark" + std::to_string(ix)), ix);
+	}
+	const double buildMs = Timing::ElapsedMs(start);
+
+	start = Clock::now();
+	built->SaveBinary("scene_benchmark.bin", false);
+	const double saveMs = Timing::ElapsedMs(start);
+	start = Clock::now();
+	built->SaveBinary("scene_benchmark_compressed.bin", true);
+	const double saveCompressedMs = Timing::ElapsedMs(start);
+	built = nullptr;
+
+	start = Clock::now();
+	GameScene::sptr loaded = GameScene::Create("loaded");
+	loaded->LoadBinary("scene_benchmark.bin");
+	const double loadMs = Timing::ElapsedMs(start);
+	LOG_ASSERT(loaded->Registry().alive() == entityCount, "Loaded scene has the wrong number of entities!");
+	loaded = nullptr;
+
+	start = Clock::now();
+	loaded = GameScene::Create("loaded");
+	loaded->LoadBinary("scene_benchmark_compressed.bin");
+	const double loadCompressedMs = Timing::ElapsedMs(start);
+	loaded = nullptr;
+
+	std::cout << "Scene with " << entityCount << " entities" << std::endl;
+	std::cout << "  Built in code: " << buildMs << "ms" << std::endl;
+	std::cout << "  Save:          " << saveMs << "ms, " << std::filesystem::file_size("scene_benchmark.bin") / 1024 << " KB" << std::endl;
+	std::cout << "  Save (gzip):   " << saveCompressedMs << "ms, " << std::filesystem::file_size("scene_benchmark_compressed.bin") / 1024 << " KB" << std::endl;
+	std::cout << "  Load:          " << loadMs << "ms" << std::endl;
+	std::cout << "  Load (gzip):   " << loadCompressedMs << "ms" << std::endl;
+
+	std::filesystem::remove("scene_benchmark.bin");
+	std::filesystem::remove("scene_benchmark_compressed.bin");
+}
+
+// Times spawning copies of a prefab one at a time against spawning them all at once
+void BenchmarkSpawning(uint32_t count) {
+	GameScene::sptr source = GameScene::Create("source");
+	GameObject original = source->CreateEntity("prefab");
+	SetupObject(original, 0);
+	const entt::entity prefab = source->CreatePrefab(original.entity());
+
+	std::vector<glm::vec3> positions(count);
+	for (uint32_t ix = 0; ix < count; ix++) {
+		positions[ix] = glm::vec3((float)(ix % 316), (float)(ix / 316), 0.0f);
+	}
+
+	GameScene::sptr target = GameScene::Create("spawn");
+	Clock::time_point start = Clock::now();
+	for (uint32_t ix = 0; ix < count; ix++) {
+		GameObject object = target->CreateEntity(prefab);
+		object.get<Transform>().SetLocalPosition(positions[ix]);
+	}
+	const double singleMs = Timing::ElapsedMs(start);
+
+	target = GameScene::Create("spawn");
+	start = Clock::now();
+	target->CreateEntities(prefab, positions);
+	const double bulkMs = Timing::ElapsedMs(start);
+	target = nullptr;
+
+	std::cout << "Spawning " << count << " copies of a prefab" << std::endl;
+	std::cout << "  One at a time: " << singleMs << "ms (" << count / singleMs << "/ms)" << std::endl;
+	std::cout << "  Bulk:          " << bulkMs << "ms (" << count / bulkMs << "/ms)" << std::endl;
+}
+
+// Times updating behaviours through BehaviourBinding against updating them with the BehaviourSystem
+void BenchmarkBehaviours(uint32_t count) {
+	const std::vector<glm::vec3> path = { glm::vec3(0.0f), glm::vec3(10.0f, 0.0f, 0.0f), glm::vec3(10.0f, 10.0f, 0.0f), glm::vec3(0.0f, 10.0f, 0.0f) };
+	Timing::Instance().DeltaTime = 1.0f / 60.0f;
+
+	GameScene::sptr target = GameScene::Create("behaviours");
+	for (uint32_t ix = 0; ix < count; ix++) {
+		BehaviourBinding::Bind<FollowPathBehaviour>(target->CreateEntity())->Points = path;
+	}
+	Clock::time_point start = Clock::now();
+	for (int update = 0; update < BehaviourUpdates; update++) {
+		target->Registry().view<BehaviourBinding>().each([&](entt::entity entity, BehaviourBinding& binding) {
+			for (const auto& behaviour : binding.Behaviours) {
+				if (behaviour->Enabled) {
+					behaviour->Update(entt::handle(target->Registry(), entity));
+				}
+			}
+		});
+	}
+	const double bindingMs = Timing::ElapsedMs(start) / BehaviourUpdates;
+
+	target = GameScene::Create("behaviours");
+	for (uint32_t ix = 0; ix < count; ix++) {
+		BehaviourSystem::Bind<FollowPathBehaviour>(target->CreateEntity()).Points = path;
+	}
+	start = Clock::now();
+	for (int update = 0; update < BehaviourUpdates; update++) {
+		BehaviourSystem::Update(target->Registry());
+	}
+	const double systemMs = Timing::ElapsedMs(start) / BehaviourUpdates;
+	target = nullptr;
+
+	std::cout << "Updating " << count << " path following behaviours" << std::endl;
+	std::cout << "  BehaviourBinding: " << bindingMs << "ms per update" << std::endl;
+	std::cout << "  BehaviourSystem:  " << systemMs << "ms per update" << std::endl;
+}
+
+// Times stepping a pile of boxes falling onto a triangle mesh floor
+void BenchmarkPhysics(uint32_t count) {
+	const float stepSize = 1.0f / 60.0f;
+
+	// Boxes are stacked 10 high in a square grid
+	const uint32_t side = (uint32_t)glm::ceil(glm::sqrt(count / 10.0f));
+	std::vector<glm::vec3> positions(count);
+	for (uint32_t ix = 0; ix < count; ix++) {
+		const uint32_t column = ix / 10;
+		positions[ix] = glm::vec3((column % side) * 0.6f, (column / side) * 0.6f, 0.3f + (ix % 10) * 0.55f);
+	}
+
+	double createMs = 0.0, stepMs = 0.0, syncMs = 0.0;
+	uint32_t activeFirst = 0, activeLast = 0;
+	GameScene::sptr target = GameScene::Create("physics");
+	{
+		// The system needs to go before it's scene does
+		PhysicsSystem physics(*target);
+
+		MeshBuilder<VertexPosNormTexCol> floorMesh;
+		MeshFactory::AddPlane(floorMesh, glm::vec3(side * 0.3f, side * 0.3f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec2(side * 0.6f + 10.0f));
+		GameObject floor = target->CreateEntity("Floor");
+		floor.emplace<ColliderComponent>(ColliderComponent::TriangleMesh(floorMesh));
+		floor.emplace<RigidBodyComponent>().Mass = 0.0f;
+
+		GameObject box = target->CreateEntity("Box");
+		box.emplace<ColliderComponent>(ColliderComponent::Box(glm::vec3(0.25f)));
+		box.emplace<RigidBodyComponent>();
+		const entt::entity boxPrefab = target->CreatePrefab(box);
+		target->Registry().destroy(box);
+
+		// Bodies are created on the first step, so it counts as part of creating them
+		Clock::time_point start = Clock::now();
+		target->CreateEntities(boxPrefab, positions);
+		physics.Step(stepSize);
+		createMs = Timing::ElapsedMs(start);
+		GameScene::Prefabs().destroy(boxPrefab);
+
+		for (int step = 0; step < PhysicsSteps; step++) {
+			physics.Step(stepSize);
+			stepMs += physics.GetStepTime() / PhysicsSteps;
+			syncMs += physics.GetSyncTime() / PhysicsSteps;
+			if (step == 0) {
+				activeFirst = physics.GetActiveBodyCount();
+			}
+		}
+		activeLast = physics.GetActiveBodyCount();
+	}
+	target = nullptr;
+
+	std::cout << "Simulating " << count << " falling boxes for " << PhysicsSteps << " steps" << std::endl;
+	std::cout << "  Spawn and create bodies: " << createMs << "ms" << std::endl;
+	std::cout << "  Step: " << stepMs << "ms, sync: " << syncMs << "ms" << std::endl;
+	std::cout << "  Active bodies: " << activeFirst << " at the start, " << activeLast << " at the end" << std::endl;
+}
+
+int main() {
+	Logger::Init();
+	std::cout << std::fixed << std::setprecision(3);
+
+	BenchmarkSaveLoad(SceneEntityCount);
+	BenchmarkSpawning(SpawnCount);
+	BenchmarkBehaviours(BehaviourCount);
+	BenchmarkPhysics(PhysicsBodyCount);
+
+	Logger::Uninitialize();
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include <random>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include <GLM/glm.hpp>
+#include <GLM/gtc/matrix_transform.hpp>
+
+#include <Timing.h>
+#include <SpatialIndex.h>
+
+// Measures the cost of keeping a SpatialIndex up to date as more and more of the scene moves each frame, comparing
+// incremental updates (MoveProxy) against discarding and rebuilding the tree, as well as the cost of culling and picking
+
+typedef Timing::Clock Clock;
+
+const int   ObjectCount = 100000;
+const float WorldSize = 1000.0f;
+const float ObjectSize = 1.0f;
+const int   FrameCount = 30;
+const int   RayCount = 1000;
+
+inline AxisAlignedBox MakeBox(const glm::vec3& position) {
+	return AxisAlignedBox(position - glm::vec3(ObjectSize * 0.5f), position + glm::vec3(ObjectSize * 0.5f));
+}
+
+int main() {
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> positionDist(-WorldSize * 0.5f, WorldSize * 0.5f);
+	std::uniform_real_distribution<float> velocityDist(-2.0f, 2.0f);
+
+	std::vector<glm::vec3> positions(ObjectCount);
+	std::vector<glm::vec3> velocities(ObjectCount);
+	std::vector<int32_t>   proxies(ObjectCount);
+
+	SpatialIndex index;
+	Clock::time_point start = Clock::now();
+	for (int ix = 0; ix < ObjectCount; ix++) {
+		positions[ix] = glm::vec3(positionDist(random), positionDist(random), positionDist(random));
+		velocities[ix] = glm::vec3(velocityDist(random), velocityDist(random), velocityDist(random));
+		proxies[ix] = index.CreateProxy(MakeBox(positions[ix]), (entt::entity)ix);
+	}
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "Inserted " << ObjectCount << " objects in " << Timing::ElapsedMs(start) << "ms (height " << index.GetHeight() << ")" << std::endl;
+
+	start = Clock::now();
+	index.Rebuild();
+	std::cout << "Full rebuild took " << Timing::ElapsedMs(start) << "ms (height " << index.GetHeight() << ")" << std::endl << std::endl;
+
+	std::cout << "Moving %   Incremental (ms/frame)   Reinserted   Rebuild (ms/frame)" << std::endl;
+	const float movingPercents[] = { 0.1f, 1.0f, 5.0f, 10.0f, 25.0f, 50.0f, 100.0f };
+	for (float percent : movingPercents) {
+		const int movingCount = (int)(ObjectCount * percent / 100.0f);
+
+		// Incremental: only the moving objects are updated, most will stay inside their fattened bounds
+		double incremental = 0.0;
+		int reinserted = 0;
+		for (int frame = 0; frame < FrameCount; frame++) {
+			start = Clock::now();
+			for (int ix = 0; ix < movingCount; ix++) {
+				positions[ix] += velocities[ix] * (1.0f / 60.0f);
+				reinserted += index.MoveProxy(proxies[ix], MakeBox(positions[ix])) ? 1 : 0;
+			}
+			incremental += Timing::ElapsedMs(start);
+		}
+
+		// Rebuild: update the moving objects and rebuild the tree from scratch each frame
+		double rebuild = 0.0;
+		for (int frame = 0; frame < FrameCount; frame++) {
+			start = Clock::now();
+			for (int ix = 0; ix < movingCount; ix++) {
+				positions[ix] += velocities[ix] * (1.0f / 60.0f);
+				index.MoveProxy(proxies[ix], MakeBox(positions[ix]));
+			}
+			index.Rebuild();
+			rebuild += Timing::ElapsedMs(start);
+		}
+
+		std::cout << std::setw(8) << percent << "   " << std::setw(22) << incremental / FrameCount << "   "
+			<< std::setw(10) << reinserted / FrameCount << "   " << std::setw(18) << rebuild / FrameCount << std::endl;
+	}
+	std::cout << std::endl;
+
+	// Culling with a typical perspective camera in the middle of the scene
+	glm::mat4 viewProjection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 300.0f) *
+		glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	std::vector<entt::entity> visible;
+	visible.reserve(ObjectCount);
+	start = Clock::now();
+	for (int frame = 0; frame < FrameCount; frame++) {
+		visible.clear();
+		index.QueryFrustum(viewProjection, visible);
+	}
+	std::cout << "Frustum query: " << Timing::ElapsedMs(start) / FrameCount << "ms, " << visible.size() << " visible" << std::endl;
+
+	// Picking, using a batch of random rays through the scene
+	std::vector<SpatialRay> rays(RayCount);
+	std::vector<SpatialRayHit> hits(RayCount);
+	for (SpatialRay& ray : rays) {
+		ray = SpatialRay(glm::vec3(positionDist(random), positionDist(random), positionDist(random)),
+			glm::normalize(glm::vec3(velocityDist(random), velocityDist(random), velocityDist(random))), WorldSize);
+	}
+	start = Clock::now();
+	index.RaycastBatch(rays.data(), rays.size(), hits.data());
+	int hitCount = 0;
+	for (const SpatialRayHit& hit : hits) {
+		hitCount += hit.IsHit() ? 1 : 0;
+	}
+	std::cout << "Raycast batch: " << Timing::ElapsedMs(start) << "ms for " << RayCount << " rays, " << hitCount << " hits" << std::endl;
+
+	// Proximity, using a batch of sphere queries
+	std::vector<BoundingSphere> spheres(RayCount);
+	for (BoundingSphere& sphere : spheres) {
+		sphere = BoundingSphere(glm::vec3(positionDist(random), positionDist(random), positionDist(random)), 10.0f);
+	}
+	std::vector<std::vector<entt::entity>> sphereResults;
+	start = Clock::now();
+	index.QuerySpheres(spheres.data(), spheres.size(), sphereResults);
+	std::cout << "Sphere batch: " << Timing::ElapsedMs(start) << "ms for " << RayCount << " queries" << std::endl;
+
+	return 0;
+}
\ No newline at end of file
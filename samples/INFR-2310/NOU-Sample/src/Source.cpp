@@ -64,8 +64,10 @@ int main()
 	//Load in a couple of GLTF models.
 	Mesh boxMesh;
 	GLTF::LoadMesh("models/boxtextured/BoxTextured.gltf", boxMesh);
+	//The duck shares most of its vertices between triangles, so we keep its
+	//index buffer rather than flattening it (~2.4k vertices instead of ~12.6k).
 	Mesh duckMesh;
-	GLTF::LoadMesh("models/duck/Duck.gltf", duckMesh);
+	GLTF::LoadIndexedMesh("models/duck/Duck.gltf", duckMesh);
 
 	//Load in our textures.
 	Texture2D triangleTex = Texture2D("textures/color-grid.png");
@@ -9,6 +9,7 @@ Week 3 Tutorial Starter - Created for INFR 2310 at Ontario Tech.
 #include "NOU/CCamera.h"
 #include "Sprites/CSpriteRenderer.h"
 #include "Sprites/CSpriteAnimator.h"
+#include "Sprites/SpriteBatch.h"
 #include "CKnightFSM.h"
 
 #include "imgui.h"
@@ -64,7 +65,8 @@ int main()
 	//Create the knight entity.
 	Entity knightEntity = Entity::Create();
 	knightEntity.transform.m_scale = glm::vec3(2.0f, 2.0f, 2.0f);
-	knightEntity.Add<CSpriteRenderer>(knightEntity, *knightSheet, knightMat);
+	//The knight goes on a higher layer so it is always drawn on top of the explosion.
+	knightEntity.Add<CSpriteRenderer>(knightEntity, *knightSheet, knightMat).SetLayer(1);
 	knightEntity.Add<CSpriteAnimator>(knightEntity, *knightSheet);
 	knightEntity.Add<CKnightFSM>(knightEntity);
 
@@ -113,9 +115,10 @@ int main()
 		okBoomer.transform.RecomputeGlobal();
 		knightEntity.transform.RecomputeGlobal();
 
-		//Draws the sprites.
+		//Submits the sprites, then draws them all in as few calls as possible.
 		okBoomer.Get<CSpriteRenderer>().Draw();
-		knightEntity.Get<CSpriteRenderer>().Draw();	
+		knightEntity.Get<CSpriteRenderer>().Draw();
+		SpriteBatch::Flush();
 
 		//For Imgui stuff...
 		App::StartImgui();
@@ -133,6 +136,7 @@ int main()
 		App::SwapBuffers();
 	}
 
+	SpriteBatch::Cleanup();
 	App::Cleanup();
 
 	return 0; 
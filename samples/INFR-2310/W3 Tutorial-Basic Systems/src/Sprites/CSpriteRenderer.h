@@ -4,6 +4,8 @@ NOU Framework - Created for INFR 2310 at Ontario Tech.
 
 CSpriteRenderer.h
 Simple sprite renderer component.
+Sprites are not drawn right away - they are submitted to the SpriteBatch,
+which draws everything at once when flushed.
 
 As a convention in NOU, we put "C" before a class name to signify
 that we intend the class for use as a component with the ENTT framework.
@@ -11,7 +13,6 @@ that we intend the class for use as a component with the ENTT framework.
 
 #pragma once
 
-#include "NOU/GLObjects.h"
 #include "NOU/Material.h"
 #include "NOU/Entity.h"
 #include "Spritesheet.h"
@@ -28,26 +29,26 @@ namespace nou
 		CSpriteRenderer(Entity& owner, Spritesheet& sheet, Material& mat);
 		virtual ~CSpriteRenderer() = default;
 
-		//"Move" constructor and assignment operators required for 
-		//using this class as a component (need to specify these manually
-		//since we're working with smart pointers as class members).
 		CSpriteRenderer(CSpriteRenderer&&) = default;
 		CSpriteRenderer& operator=(CSpriteRenderer&&) = default;
 
+		//Submits this sprite to the SpriteBatch.
 		void Draw();
 
 		void SetSize(const glm::vec2& size);
 		void SetFrame(const Spritesheet::Frame& frame);
 
+		//Sprites on higher layers are drawn on top of sprites on lower layers.
+		void SetLayer(int layer);
+
 		protected:
 
 		Entity* m_owner;
 		Material* m_mat;
 		Spritesheet* m_sheet;
 
-		std::unique_ptr<VertexBuffer> m_vboVert;
-		std::unique_ptr<VertexBuffer> m_vboUV;
-
-		std::unique_ptr<VertexArray> m_vao;
+		glm::vec2 m_size;
+		Spritesheet::Frame m_frame;
+		int m_layer;
 	};
 }
@@ -0,0 +1,138 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+SpriteBatch.cpp
+Collects sprites over a frame and draws them in as few draw calls as possible.
+*/
+
+#include "SpriteBatch.h"
+#include "NOU/CCamera.h"
+#include "NOU/Mesh.h"
+
+#include <algorithm>
+
+namespace nou
+{
+	std::vector<SpriteBatch::Sprite> SpriteBatch::s_sprites;
+	std::vector<glm::vec3> SpriteBatch::s_verts;
+	std::vector<glm::vec2> SpriteBatch::s_uvs;
+
+	std::unique_ptr<VertexBuffer> SpriteBatch::s_vboVert = nullptr;
+	std::unique_ptr<VertexBuffer> SpriteBatch::s_vboUV = nullptr;
+	std::unique_ptr<VertexArray> SpriteBatch::s_vao = nullptr;
+
+	size_t SpriteBatch::s_lastDrawCount = 0;
+
+	void SpriteBatch::Submit(Material& mat, const glm::mat4& model, const glm::vec2& size,
+							 const Spritesheet::Frame& frame, int layer)
+	{
+		Sprite sprite;
+		sprite.mat = &mat;
+		sprite.layer = layer;
+		sprite.frame = frame;
+
+		//We move the corners into world space now, so that sprites with
+		//different transforms can still share one draw call.
+		sprite.corners[Spritesheet::BOTTOM_LEFT] = glm::vec3(model * glm::vec4(-0.5f * size.x, -0.5f * size.y, 0.0f, 1.0f));
+		sprite.corners[Spritesheet::BOTTOM_RIGHT] = glm::vec3(model * glm::vec4(0.5f * size.x, -0.5f * size.y, 0.0f, 1.0f));
+		sprite.corners[Spritesheet::TOP_RIGHT] = glm::vec3(model * glm::vec4(0.5f * size.x, 0.5f * size.y, 0.0f, 1.0f));
+		sprite.corners[Spritesheet::TOP_LEFT] = glm::vec3(model * glm::vec4(-0.5f * size.x, 0.5f * size.y, 0.0f, 1.0f));
+
+		s_sprites.push_back(sprite);
+	}
+
+	void SpriteBatch::Flush()
+	{
+		s_lastDrawCount = 0;
+
+		if (s_sprites.empty())
+			return;
+
+		//Sort by layer first, then by material. Stable sorting means sprites
+		//with the same layer and material are still drawn in submission order.
+		std::stable_sort(s_sprites.begin(), s_sprites.end(),
+			[](const Sprite& a, const Sprite& b)
+			{
+				if (a.layer != b.layer)
+					return a.layer < b.layer;
+
+				return a.mat < b.mat;
+			});
+
+		//Same triangle layout as the old per-sprite renderer:
+		//(bottom left, bottom right, top right), (bottom left, top right, top left).
+		static const Spritesheet::VertIndex order[6] =
+		{
+			Spritesheet::BOTTOM_LEFT, Spritesheet::BOTTOM_RIGHT, Spritesheet::TOP_RIGHT,
+			Spritesheet::BOTTOM_LEFT, Spritesheet::TOP_RIGHT, Spritesheet::TOP_LEFT
+		};
+
+		s_verts.resize(s_sprites.size() * 6);
+		s_uvs.resize(s_sprites.size() * 6);
+
+		for (size_t i = 0; i < s_sprites.size(); ++i)
+		{
+			for (size_t v = 0; v < 6; ++v)
+			{
+				s_verts[i * 6 + v] = s_sprites[i].corners[order[v]];
+				s_uvs[i * 6 + v] = s_sprites[i].frame.uv[order[v]];
+			}
+		}
+
+		//Our buffers are re-specified every frame (which also lets the driver
+		//hand us fresh memory instead of waiting on last frame's draw).
+		if (s_vao == nullptr)
+		{
+			s_vboVert = std::make_unique<VertexBuffer>(3, s_verts, true);
+			s_vboUV = std::make_unique<VertexBuffer>(2, s_uvs, true);
+			s_vao = std::make_unique<VertexArray>();
+			s_vao->BindAttrib(*s_vboVert, (GLint)Mesh::Attrib::POSITION);
+			s_vao->BindAttrib(*s_vboUV, (GLint)Mesh::Attrib::UV);
+		}
+		else
+		{
+			s_vboVert->UpdateData(s_verts);
+			s_vboUV->UpdateData(s_uvs);
+		}
+
+		const glm::mat4& viewProj = CCamera::current->Get<CCamera>().GetVP();
+
+		size_t runStart = 0;
+
+		for (size_t i = 1; i <= s_sprites.size(); ++i)
+		{
+			//Keep going until the layer or material changes.
+			if (i < s_sprites.size() &&
+				s_sprites[i].layer == s_sprites[runStart].layer &&
+				s_sprites[i].mat == s_sprites[runStart].mat)
+				continue;
+
+			s_sprites[runStart].mat->Use();
+
+			//The vertices are already in world space, so our model matrix is just the identity.
+			ShaderProgram::Current()->SetUniform("viewproj", viewProj);
+			ShaderProgram::Current()->SetUniform("model", glm::mat4(1.0f));
+			ShaderProgram::Current()->SetUniform("normal", glm::mat3(1.0f));
+
+			s_vao->DrawRange(static_cast<GLint>(runStart * 6), static_cast<GLsizei>((i - runStart) * 6));
+			++s_lastDrawCount;
+
+			runStart = i;
+		}
+
+		s_sprites.clear();
+	}
+
+	void SpriteBatch::Cleanup()
+	{
+		s_vao = nullptr;
+		s_vboVert = nullptr;
+		s_vboUV = nullptr;
+	}
+
+	size_t SpriteBatch::GetLastDrawCount()
+	{
+		return s_lastDrawCount;
+	}
+}
@@ -0,0 +1,67 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+SpriteBatch.h
+Collects sprites over a frame and draws them in as few draw calls as possible.
+
+Rather than each sprite having its own vertex buffer and draw call,
+sprite renderers submit their quads here. When we flush, sprites are
+sorted by layer and then by material, and every run of sprites that
+share a layer and material is drawn with a single call.
+*/
+
+#pragma once
+
+#include "NOU/GLObjects.h"
+#include "NOU/Material.h"
+#include "Spritesheet.h"
+#include "GLM/glm.hpp"
+
+#include <vector>
+#include <memory>
+
+namespace nou
+{
+	class SpriteBatch
+	{
+		public:
+
+		//Queues a sprite of the given size, centered on the origin of the model matrix.
+		//Lower layers are drawn first (i.e., higher layers end up on top).
+		static void Submit(Material& mat, const glm::mat4& model, const glm::vec2& size,
+						   const Spritesheet::Frame& frame, int layer = 0);
+
+		//Draws everything that has been submitted this frame using the current camera.
+		static void Flush();
+
+		//Frees the GPU resources used by the batch.
+		static void Cleanup();
+
+		//The number of draw calls made by the last flush (handy for debugging).
+		static size_t GetLastDrawCount();
+
+		protected:
+
+		struct Sprite
+		{
+			Material* mat;
+			int layer;
+			glm::vec3 corners[4];
+			Spritesheet::Frame frame;
+		};
+
+		static std::vector<Sprite> s_sprites;
+		static std::vector<glm::vec3> s_verts;
+		static std::vector<glm::vec2> s_uvs;
+
+		static std::unique_ptr<VertexBuffer> s_vboVert;
+		static std::unique_ptr<VertexBuffer> s_vboUV;
+		static std::unique_ptr<VertexArray> s_vao;
+
+		static size_t s_lastDrawCount;
+
+		//This class is only used through its static functions.
+		SpriteBatch() = default;
+	};
+}
@@ -108,7 +108,7 @@ int main() {
 				}
 			}
 
-			auto name = controllables[selectedVao].get<GameObjectTag>().Name;
+			const std::string& name = controllables[selectedVao].get<GameObjectTag>().GetName();
 			ImGui::Text(name.c_str());
 			auto behaviour = BehaviourBinding::Get<SimpleMoveBehaviour>(controllables[selectedVao]);
 			ImGui::Checkbox("Relative Rotation", &behaviour->Relative);
@@ -1,4 +1,4 @@
-#version 410
+#version 430
 
 layout(location = 0) in vec3 inPos;
 layout(location = 1) in vec3 inColor;
@@ -26,9 +26,54 @@ uniform float u_LightAttenuationQuadratic;
 uniform float u_TextureMix;
 
 uniform vec3  u_CamPos;
+uniform mat4  u_View;
+
+// The sun (a directional light), this is the only light that casts shadows. It is off while the color is black
+uniform vec3  u_SunDir; // Points towards the sun
+uniform vec3  u_SunCol;
+
+// Cascaded shadow maps for the sun, shadows are off while u_CascadeCount is 0
+// The shadow map has a fixed binding, so that it never shares a texture slot with a sampler2D
+#define MAX_CASCADES 4
+layout(binding = 8) uniform sampler2DArrayShadow s_ShadowMap;
+uniform int   u_CascadeCount;
+uniform mat4  u_CascadeMatrices[MAX_CASCADES];
+uniform vec4  u_CascadeSplits;     // The view space depth where each cascade ends
+uniform vec4  u_CascadeTexelSizes; // The size of a shadow map texel in world units, for each cascade
+uniform float u_ShadowNormalBias;  // How far to push lookups along the normal, in texels
 
 out vec4 frag_color;
 
+// Returns how much of the sun reaches the given point, from 0 (fully shadowed) to 1 (fully lit)
+float SunShadow(vec3 worldPos, vec3 N) {
+	// Pick the first cascade that covers the fragment
+	float viewDepth = -(u_View * vec4(worldPos, 1.0)).z;
+	int cascade = 0;
+	while (cascade < u_CascadeCount && viewDepth > u_CascadeSplits[cascade]) {
+		cascade++;
+	}
+	if (cascade >= u_CascadeCount) {
+		return 1.0;
+	}
+
+	// Pushing the lookup out along the normal avoids acne, scaling by the texel size keeps it the same in every cascade
+	vec3 offsetPos = worldPos + N * u_ShadowNormalBias * u_CascadeTexelSizes[cascade];
+	vec4 lightPos = u_CascadeMatrices[cascade] * vec4(offsetPos, 1.0);
+	vec3 coords = lightPos.xyz / lightPos.w * 0.5 + 0.5;
+
+	// 3x3 PCF, each tap is already bilinear filtered by the hardware comparison
+	vec2 texelSize = 1.0 / vec2(textureSize(s_ShadowMap, 0).xy);
+	float result = 0.0;
+	for (int x = -1; x <= 1; x++) {
+		for (int y = -1; y <= 1; y++) {
+			result += texture(s_ShadowMap, vec4(coords.xy + vec2(x, y) * texelSize, cascade, coords.z));
+		}
+	}
+	return result / 9.0;
+}
+
+#include "lighting/clustered_lights.glsl"
+
 // https://learnopengl.com/Advanced-Lighting/Advanced-Lighting
 void main() {
 	// Lecture 5
@@ -57,6 +102,18 @@ void main() {
 	float spec = pow(max(dot(N, h), 0.0), u_Shininess); // Shininess coefficient (can be a uniform)
 	vec3 specular = u_SpecularLightStrength * texSpec * spec * u_LightCol; // Can also use a specular color
 
+	// Sun, no attenuation since it's infinitely far away
+	vec3 sun = vec3(0.0);
+	if (dot(u_SunCol, u_SunCol) > 0.0) {
+		vec3 sunDir = normalize(u_SunDir);
+		float sunDif = max(dot(N, sunDir), 0.0);
+		float sunSpec = pow(max(dot(N, normalize(sunDir + viewDir)), 0.0), u_Shininess);
+		float shadow = u_CascadeCount > 0 ? SunShadow(inPos, N) : 1.0;
+		sun = (sunDif + u_SpecularLightStrength * texSpec * sunSpec) * u_SunCol * shadow;
+	}
+
+	vec3 points = u_ClusterGrid.x > 0 ? ClusteredLights(inPos, N, viewDir, u_SpecularLightStrength * texSpec) : vec3(0.0);
+
 	// Get the albedo from the diffuse / albedo map
 	vec4 textureColor1 = texture(s_Diffuse, inUV);
 	vec4 textureColor2 = texture(s_Diffuse2, inUV);
@@ -64,7 +121,9 @@ void main() {
 
 	vec3 result = (
 		(u_AmbientCol * u_AmbientStrength) + // global ambient light
-		(ambient + diffuse + specular) * attenuation // light factors from our single light
+		(ambient + diffuse + specular) * attenuation + // light factors from our single light
+		sun + // light from the sun
+		points // light from the clustered point lights
 		) * inColor * textureColor.rgb; // Object color
 
 	frag_color = vec4(result, textureColor.a);
@@ -0,0 +1,50 @@
+// Clustered point lights, see ClusteredLighting. The view is split into a grid of clusters, and each cluster
+// has a list of the lights that touch it. Clustered lights are off while u_ClusterGrid.x is 0
+// Expects u_View and u_Shininess to be declared before this file is included
+struct PointLight {
+	vec3  Position;
+	float Radius;
+	vec3  Color;
+	float Intensity;
+};
+layout(std430, binding = 0) readonly buffer b_Lights {
+	PointLight Lights[];
+};
+layout(std430, binding = 1) readonly buffer b_Clusters {
+	uvec2 Clusters[]; // The offset of the cluster's list in LightIndices, and the number of lights in it
+};
+layout(std430, binding = 2) readonly buffer b_LightIndices {
+	uint LightIndices[];
+};
+uniform ivec3 u_ClusterGrid;          // The number of tiles across and down the screen, and the number of depth slices
+uniform vec2  u_ClusterTileScale;     // Converts from pixels to tiles
+uniform vec2  u_ClusterDepthScaleBias; // Converts from view depth to a slice, slice = log(depth) * scale + bias
+
+// Adds up the diffuse and specular light from all the point lights in the fragment's cluster
+vec3 ClusteredLights(vec3 worldPos, vec3 N, vec3 viewDir, float specStrength) {
+	float viewDepth = -(u_View * vec4(worldPos, 1.0)).z;
+	int slice = int(log(max(viewDepth, 0.0001)) * u_ClusterDepthScaleBias.x + u_ClusterDepthScaleBias.y);
+	if (slice >= u_ClusterGrid.z) {
+		return vec3(0.0);
+	}
+	ivec2 tile = min(ivec2(gl_FragCoord.xy * u_ClusterTileScale), u_ClusterGrid.xy - 1);
+	uvec2 cluster = Clusters[(max(slice, 0) * u_ClusterGrid.y + tile.y) * u_ClusterGrid.x + tile.x];
+
+	vec3 result = vec3(0.0);
+	for (uint ix = 0; ix < cluster.y; ix++) {
+		PointLight light = Lights[LightIndices[cluster.x + ix]];
+		vec3 toLight = light.Position - worldPos;
+		float distSq = dot(toLight, toLight);
+		if (distSq >= light.Radius * light.Radius) {
+			continue;
+		}
+		vec3 lightDir = toLight * inversesqrt(max(distSq, 0.0001));
+		// Inverse square falloff, windowed so that it reaches 0 at the light's radius
+		float window = clamp(1.0 - pow(distSq / (light.Radius * light.Radius), 2.0), 0.0, 1.0);
+		float attenuation = window * window / (distSq + 1.0);
+		float dif = max(dot(N, lightDir), 0.0);
+		float spec = pow(max(dot(N, normalize(lightDir + viewDir)), 0.0), u_Shininess);
+		result += (dif + specStrength * spec) * light.Color * light.Intensity * attenuation;
+	}
+	return result;
+}
\ No newline at end of file
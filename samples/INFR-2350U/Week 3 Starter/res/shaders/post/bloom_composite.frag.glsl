@@ -0,0 +1,15 @@
+#version 410
+
+layout(location = 0) in vec2 inUV;
+
+uniform sampler2D s_Source;
+uniform sampler2D s_Bloom;
+uniform float u_Intensity;
+
+out vec4 frag_color;
+
+void main() {
+    vec4 source = texture(s_Source, inUV);
+    vec3 bloom = texture(s_Bloom, inUV).rgb;
+    frag_color = vec4(source.rgb + bloom * u_Intensity, source.a);
+}
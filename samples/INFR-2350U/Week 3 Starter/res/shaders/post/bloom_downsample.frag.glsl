@@ -0,0 +1,34 @@
+#version 410
+
+layout(location = 0) in vec2 inUV;
+
+uniform sampler2D s_Source;
+
+out vec4 frag_color;
+
+void main() {
+    vec2 texel = 1.0 / vec2(textureSize(s_Source, 0));
+
+    // 13 tap downsample, a weighted blend of 5 overlapping 2x2 boxes. This avoids the blocky
+    // artifacts we would get from just averaging 2x2 blocks at each level
+    vec3 a = texture(s_Source, inUV + texel * vec2(-2.0,  2.0)).rgb;
+    vec3 b = texture(s_Source, inUV + texel * vec2( 0.0,  2.0)).rgb;
+    vec3 c = texture(s_Source, inUV + texel * vec2( 2.0,  2.0)).rgb;
+    vec3 d = texture(s_Source, inUV + texel * vec2(-2.0,  0.0)).rgb;
+    vec3 e = texture(s_Source, inUV).rgb;
+    vec3 f = texture(s_Source, inUV + texel * vec2( 2.0,  0.0)).rgb;
+    vec3 g = texture(s_Source, inUV + texel * vec2(-2.0, -2.0)).rgb;
+    vec3 h = texture(s_Source, inUV + texel * vec2( 0.0, -2.0)).rgb;
+    vec3 i = texture(s_Source, inUV + texel * vec2( 2.0, -2.0)).rgb;
+    vec3 j = texture(s_Source, inUV + texel * vec2(-1.0,  1.0)).rgb;
+    vec3 k = texture(s_Source, inUV + texel * vec2( 1.0,  1.0)).rgb;
+    vec3 l = texture(s_Source, inUV + texel * vec2(-1.0, -1.0)).rgb;
+    vec3 m = texture(s_Source, inUV + texel * vec2( 1.0, -1.0)).rgb;
+
+    vec3 result = e * 0.125;
+    result += (a + c + g + i) * 0.03125;
+    result += (b + d + f + h) * 0.0625;
+    result += (j + k + l + m) * 0.125;
+
+    frag_color = vec4(result, 1.0);
+}
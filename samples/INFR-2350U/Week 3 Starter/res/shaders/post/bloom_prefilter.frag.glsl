@@ -0,0 +1,29 @@
+#version 410
+
+layout(location = 0) in vec2 inUV;
+
+uniform sampler2D s_Source;
+uniform float u_Threshold;
+// The width of the soft transition around the threshold
+uniform float u_Knee;
+
+out vec4 frag_color;
+
+void main() {
+    vec2 texel = 1.0 / vec2(textureSize(s_Source, 0));
+
+    // Average a 4x4 block with 4 bilinear taps, so that single bright pixels don't flicker as the camera moves
+    vec3 color = texture(s_Source, inUV + texel * vec2(-1.0, -1.0)).rgb;
+    color += texture(s_Source, inUV + texel * vec2( 1.0, -1.0)).rgb;
+    color += texture(s_Source, inUV + texel * vec2(-1.0,  1.0)).rgb;
+    color += texture(s_Source, inUV + texel * vec2( 1.0,  1.0)).rgb;
+    color *= 0.25;
+
+    // Quadratic soft threshold, so pixels fade in to the bloom instead of popping
+    float brightness = max(color.r, max(color.g, color.b));
+    float soft = clamp(brightness - u_Threshold + u_Knee, 0.0, 2.0 * u_Knee);
+    soft = (soft * soft) / (4.0 * u_Knee);
+    float contribution = max(soft, brightness - u_Threshold) / max(brightness, 0.00001);
+
+    frag_color = vec4(color * contribution, 1.0);
+}
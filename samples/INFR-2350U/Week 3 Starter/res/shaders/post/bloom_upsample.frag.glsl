@@ -0,0 +1,26 @@
+#version 410
+
+layout(location = 0) in vec2 inUV;
+
+uniform sampler2D s_Source;
+// The size of the filter in texels of the source
+uniform float u_Radius;
+
+out vec4 frag_color;
+
+void main() {
+    vec2 texel = u_Radius / vec2(textureSize(s_Source, 0));
+
+    // 3x3 tent filter, this gets added (with blending) to the level above
+    vec3 result = texture(s_Source, inUV).rgb * 4.0;
+    result += texture(s_Source, inUV + texel * vec2( 0.0,  1.0)).rgb * 2.0;
+    result += texture(s_Source, inUV + texel * vec2( 0.0, -1.0)).rgb * 2.0;
+    result += texture(s_Source, inUV + texel * vec2( 1.0,  0.0)).rgb * 2.0;
+    result += texture(s_Source, inUV + texel * vec2(-1.0,  0.0)).rgb * 2.0;
+    result += texture(s_Source, inUV + texel * vec2(-1.0,  1.0)).rgb;
+    result += texture(s_Source, inUV + texel * vec2( 1.0,  1.0)).rgb;
+    result += texture(s_Source, inUV + texel * vec2(-1.0, -1.0)).rgb;
+    result += texture(s_Source, inUV + texel * vec2( 1.0, -1.0)).rgb;
+
+    frag_color = vec4(result / 16.0, 1.0);
+}
@@ -0,0 +1,11 @@
+#version 410
+
+layout(location = 0) out vec2 outUV;
+
+void main() {
+    // Generates a single triangle that covers the whole screen from the vertex index,
+    // so we don't need a vertex buffer (vertices are at (0,0), (2,0) and (0,2) in UV space)
+    vec2 uv = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    outUV = uv;
+    gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,155 @@
+#version 410
+
+layout(location = 0) in vec2 inUV;
+
+uniform sampler2D s_Source;
+// The minimum contrast needed to count as an edge, relative to the brightest neighbour
+uniform float u_EdgeThreshold;
+// The minimum contrast needed to count as an edge, keeps us from processing dark areas
+uniform float u_EdgeThresholdMin;
+// How much sub-pixel aliasing to remove
+uniform float u_Subpixel;
+
+out vec4 frag_color;
+
+// How far to step along the edge for each search iteration (based on FXAA 3.11's quality presets)
+#define ITERATIONS 12
+const float QUALITY[ITERATIONS] = float[](1.0, 1.0, 1.0, 1.0, 1.0, 1.5, 2.0, 2.0, 2.0, 2.0, 4.0, 8.0);
+
+// Perceived brightness, we work with brightness rather than color for edge detection
+float Luma(vec3 color) {
+    return sqrt(dot(color, vec3(0.299, 0.587, 0.114)));
+}
+
+void main() {
+    vec2 texel = 1.0 / vec2(textureSize(s_Source, 0));
+
+    vec3 colorCenter = texture(s_Source, inUV).rgb;
+    float lumaCenter = Luma(colorCenter);
+    float lumaDown   = Luma(textureOffset(s_Source, inUV, ivec2( 0, -1)).rgb);
+    float lumaUp     = Luma(textureOffset(s_Source, inUV, ivec2( 0,  1)).rgb);
+    float lumaLeft   = Luma(textureOffset(s_Source, inUV, ivec2(-1,  0)).rgb);
+    float lumaRight  = Luma(textureOffset(s_Source, inUV, ivec2( 1,  0)).rgb);
+
+    // Skip pixels that aren't on an edge
+    float lumaMin = min(lumaCenter, min(min(lumaDown, lumaUp), min(lumaLeft, lumaRight)));
+    float lumaMax = max(lumaCenter, max(max(lumaDown, lumaUp), max(lumaLeft, lumaRight)));
+    float lumaRange = lumaMax - lumaMin;
+    if (lumaRange < max(u_EdgeThresholdMin, lumaMax * u_EdgeThreshold)) {
+        frag_color = vec4(colorCenter, 1.0);
+        return;
+    }
+
+    float lumaDownLeft  = Luma(textureOffset(s_Source, inUV, ivec2(-1, -1)).rgb);
+    float lumaUpRight   = Luma(textureOffset(s_Source, inUV, ivec2( 1,  1)).rgb);
+    float lumaUpLeft    = Luma(textureOffset(s_Source, inUV, ivec2(-1,  1)).rgb);
+    float lumaDownRight = Luma(textureOffset(s_Source, inUV, ivec2( 1, -1)).rgb);
+
+    float lumaDownUp       = lumaDown + lumaUp;
+    float lumaLeftRight    = lumaLeft + lumaRight;
+    float lumaLeftCorners  = lumaDownLeft + lumaUpLeft;
+    float lumaDownCorners  = lumaDownLeft + lumaDownRight;
+    float lumaRightCorners = lumaDownRight + lumaUpRight;
+    float lumaUpCorners    = lumaUpRight + lumaUpLeft;
+
+    // Work out if the edge is horizontal or vertical
+    float edgeHorizontal = abs(-2.0 * lumaLeft + lumaLeftCorners) + abs(-2.0 * lumaCenter + lumaDownUp) * 2.0 + abs(-2.0 * lumaRight + lumaRightCorners);
+    float edgeVertical   = abs(-2.0 * lumaUp + lumaUpCorners) + abs(-2.0 * lumaCenter + lumaLeftRight) * 2.0 + abs(-2.0 * lumaDown + lumaDownCorners);
+    bool isHorizontal = edgeHorizontal >= edgeVertical;
+
+    // Work out which side of the pixel the edge is on
+    float luma1 = isHorizontal ? lumaDown : lumaLeft;
+    float luma2 = isHorizontal ? lumaUp : lumaRight;
+    float gradient1 = luma1 - lumaCenter;
+    float gradient2 = luma2 - lumaCenter;
+    bool is1Steepest = abs(gradient1) >= abs(gradient2);
+    float gradientScaled = 0.25 * max(abs(gradient1), abs(gradient2));
+
+    float stepLength = isHorizontal ? texel.y : texel.x;
+    float lumaLocalAverage;
+    if (is1Steepest) {
+        stepLength = -stepLength;
+        lumaLocalAverage = 0.5 * (luma1 + lumaCenter);
+    } else {
+        lumaLocalAverage = 0.5 * (luma2 + lumaCenter);
+    }
+
+    // Move half a pixel onto the edge
+    vec2 currentUV = inUV;
+    if (isHorizontal) {
+        currentUV.y += stepLength * 0.5;
+    } else {
+        currentUV.x += stepLength * 0.5;
+    }
+
+    // Walk along the edge in both directions until we reach the ends
+    vec2 offset = isHorizontal ? vec2(texel.x, 0.0) : vec2(0.0, texel.y);
+    vec2 uv1 = currentUV - offset * QUALITY[0];
+    vec2 uv2 = currentUV + offset * QUALITY[0];
+
+    float lumaEnd1 = Luma(texture(s_Source, uv1).rgb) - lumaLocalAverage;
+    float lumaEnd2 = Luma(texture(s_Source, uv2).rgb) - lumaLocalAverage;
+    bool reached1 = abs(lumaEnd1) >= gradientScaled;
+    bool reached2 = abs(lumaEnd2) >= gradientScaled;
+    bool reachedBoth = reached1 && reached2;
+
+    if (!reached1) {
+        uv1 -= offset * QUALITY[1];
+    }
+    if (!reached2) {
+        uv2 += offset * QUALITY[1];
+    }
+
+    if (!reachedBoth) {
+        for (int i = 2; i < ITERATIONS; i++) {
+            if (!reached1) {
+                lumaEnd1 = Luma(texture(s_Source, uv1).rgb) - lumaLocalAverage;
+            }
+            if (!reached2) {
+                lumaEnd2 = Luma(texture(s_Source, uv2).rgb) - lumaLocalAverage;
+            }
+            reached1 = abs(lumaEnd1) >= gradientScaled;
+            reached2 = abs(lumaEnd2) >= gradientScaled;
+            reachedBoth = reached1 && reached2;
+
+            if (!reached1) {
+                uv1 -= offset * QUALITY[i];
+            }
+            if (!reached2) {
+                uv2 += offset * QUALITY[i];
+            }
+            if (reachedBoth) {
+                break;
+            }
+        }
+    }
+
+    // Work out how far this pixel is from the closest end of the edge
+    float distance1 = isHorizontal ? (inUV.x - uv1.x) : (inUV.y - uv1.y);
+    float distance2 = isHorizontal ? (uv2.x - inUV.x) : (uv2.y - inUV.y);
+    bool isDirection1 = distance1 < distance2;
+    float distanceFinal = min(distance1, distance2);
+    float edgeLength = distance1 + distance2;
+    float pixelOffset = -distanceFinal / edgeLength + 0.5;
+
+    // Only blend if the end of the edge we found varies in the same direction as this pixel
+    bool isLumaCenterSmaller = lumaCenter < lumaLocalAverage;
+    bool correctVariation = ((isDirection1 ? lumaEnd1 : lumaEnd2) < 0.0) != isLumaCenterSmaller;
+    float finalOffset = correctVariation ? pixelOffset : 0.0;
+
+    // Sub-pixel aliasing, for details smaller than a pixel that the edge search can't find
+    float lumaAverage = (1.0 / 12.0) * (2.0 * (lumaDownUp + lumaLeftRight) + lumaLeftCorners + lumaRightCorners);
+    float subPixelOffset1 = clamp(abs(lumaAverage - lumaCenter) / lumaRange, 0.0, 1.0);
+    float subPixelOffset2 = (-2.0 * subPixelOffset1 + 3.0) * subPixelOffset1 * subPixelOffset1;
+    float subPixelOffsetFinal = subPixelOffset2 * subPixelOffset2 * u_Subpixel;
+    finalOffset = max(finalOffset, subPixelOffsetFinal);
+
+    vec2 finalUV = inUV;
+    if (isHorizontal) {
+        finalUV.y += finalOffset * stepLength;
+    } else {
+        finalUV.x += finalOffset * stepLength;
+    }
+
+    frag_color = vec4(texture(s_Source, finalUV).rgb, 1.0);
+}
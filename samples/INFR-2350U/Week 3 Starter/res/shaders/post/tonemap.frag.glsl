@@ -0,0 +1,34 @@
+#version 410
+
+layout(location = 0) in vec2 inUV;
+
+uniform sampler2D s_Source;
+uniform float u_Exposure;
+uniform float u_Gamma;
+// 0 = Clamp, 1 = Reinhard, 2 = ACES
+uniform int u_Operator;
+
+out vec4 frag_color;
+
+// Krzysztof Narkowicz's fit of the ACES filmic curve
+vec3 ACESFilm(vec3 x) {
+    const float a = 2.51;
+    const float b = 0.03;
+    const float c = 2.43;
+    const float d = 0.59;
+    const float e = 0.14;
+    return clamp((x * (a * x + b)) / (x * (c * x + d) + e), 0.0, 1.0);
+}
+
+void main() {
+    vec3 color = texture(s_Source, inUV).rgb * u_Exposure;
+
+    if (u_Operator == 1) {
+        color = color / (1.0 + color);
+    } else if (u_Operator == 2) {
+        color = ACESFilm(color);
+    }
+
+    color = pow(clamp(color, 0.0, 1.0), vec3(1.0 / u_Gamma));
+    frag_color = vec4(color, 1.0);
+}
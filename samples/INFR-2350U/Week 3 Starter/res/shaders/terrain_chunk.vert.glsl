@@ -0,0 +1,34 @@
+#version 410
+
+// Vertices are laid out like Terrain::Vertex, the normal is octahedral encoded
+layout(location = 0) in vec3 inPosition;
+layout(location = 2) in vec2 inNormal;
+
+layout(location = 0) out vec3 outPos;
+layout(location = 1) out vec3 outColor;
+layout(location = 2) out vec3 outNormal;
+layout(location = 3) out vec2 outUV;
+
+uniform mat4 u_ModelViewProjection;
+uniform mat4 u_Model;
+// How many times the textures repeat per world unit
+uniform float u_TextureScale;
+
+vec3 OctDecode(vec2 f) {
+	vec3 n = vec3(f.x, f.y, 1.0 - abs(f.x) - abs(f.y));
+	float t = max(-n.z, 0.0);
+	n.xy += mix(vec2(t), vec2(-t), greaterThanEqual(n.xy, vec2(0.0)));
+	return normalize(n);
+}
+
+void main() {
+	gl_Position = u_ModelViewProjection * vec4(inPosition, 1.0);
+	outPos = (u_Model * vec4(inPosition, 1.0)).xyz;
+
+	// The terrain is only ever moved, never rotated or scaled, so the normals are already in world space
+	outNormal = OctDecode(inNormal);
+
+	// Textures are projected straight down in world space, so they line up across chunks of any level
+	outUV = outPos.xy * u_TextureScale;
+	outColor = vec3(1.0);
+}
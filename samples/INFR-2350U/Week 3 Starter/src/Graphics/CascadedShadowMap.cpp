@@ -0,0 +1,265 @@
+#include "CascadedShadowMap.h"
+
+#include <Logging.h>
+#include <GLM/gtc/matrix_transform.hpp>
+#include "imgui.h"
+
+CascadedShadowMap::CascadedShadowMap(unsigned resolution, int cascadeCount) :
+	LightDirection(glm::normalize(glm::vec3(-0.5f, -0.3f, -1.0f))),
+	MaxDistance(80.0f),
+	SplitLambda(0.75f),
+	FirstCachedCascade(2),
+	CacheMargin(0.25f),
+	SlopeBias(2.0f),
+	NormalBias(1.5f),
+	_resolution(resolution),
+	_cascadeCount(cascadeCount)
+{
+	LOG_ASSERT(cascadeCount > 0 && cascadeCount <= MaxCascades, "Cascade count must be between 1 and {}", MaxCascades);
+
+	glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &_texture);
+	glTextureStorage3D(_texture, 1, GL_DEPTH_COMPONENT32F, resolution, resolution, cascadeCount);
+	// Linear filtering with comparisons enabled gives us bilinear PCF for free
+	glTextureParameteri(_texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTextureParameteri(_texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTextureParameteri(_texture, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+	glTextureParameteri(_texture, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+	// Anything outside of the shadow map is lit
+	const glm::vec4 border = glm::vec4(1.0f);
+	glTextureParameteri(_texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+	glTextureParameteri(_texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+	glTextureParameterfv(_texture, GL_TEXTURE_BORDER_COLOR, &border[0]);
+
+	for (int ix = 0; ix < cascadeCount; ix++) {
+		glCreateFramebuffers(1, &_cascades[ix].FBO);
+		glNamedFramebufferTextureLayer(_cascades[ix].FBO, GL_DEPTH_ATTACHMENT, _texture, 0, ix);
+		glNamedFramebufferDrawBuffer(_cascades[ix].FBO, GL_NONE);
+		glNamedFramebufferReadBuffer(_cascades[ix].FBO, GL_NONE);
+		if (glCheckNamedFramebufferStatus(_cascades[ix].FBO, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+			LOG_ERROR("Shadow cascade {} framebuffer is not complete", ix);
+		}
+	}
+}
+
+CascadedShadowMap::~CascadedShadowMap()
+{
+	for (int ix = 0; ix < _cascadeCount; ix++) {
+		glDeleteFramebuffers(1, &_cascades[ix].FBO);
+	}
+	glDeleteTextures(1, &_texture);
+}
+
+void CascadedShadowMap::ClearCasters()
+{
+	_culler.Clear();
+	_isStatic.clear();
+	_staticSignature = 0;
+}
+
+uint32_t CascadedShadowMap::AddCaster(const AxisAlignedBox& bounds, bool isStatic)
+{
+	_isStatic.push_back(isStatic ? 1 : 0);
+	if (isStatic && bounds.IsValid()) {
+		// FNV-1a over the bounds snapped to 1/256th of a unit, so tiny floating point differences don't count as changes
+		const glm::ivec3 min = glm::ivec3(glm::floor(bounds.Min * 256.0f));
+		const glm::ivec3 max = glm::ivec3(glm::floor(bounds.Max * 256.0f));
+		const int values[6] = { min.x, min.y, min.z, max.x, max.y, max.z };
+		uint64_t hash = 14695981039346656037ull;
+		for (int value : values) {
+			hash = (hash ^ (uint32_t)value) * 1099511628211ull;
+		}
+		_staticSignature += hash;
+	}
+	return _culler.Add(bounds);
+}
+
+void CascadedShadowMap::InvalidateCache()
+{
+	for (int ix = 0; ix < _cascadeCount; ix++) {
+		_cascades[ix].IsCacheValid = false;
+	}
+}
+
+void CascadedShadowMap::Update(const glm::mat4& view, const glm::mat4& projection)
+{
+	const glm::vec3 lightDir = glm::normalize(LightDirection);
+	if (glm::dot(lightDir, _lastLightDirection) < 0.99999f || _staticSignature != _lastStaticSignature) {
+		InvalidateCache();
+		_lastLightDirection = lightDir;
+		_lastStaticSignature = _staticSignature;
+	}
+
+	const glm::mat4 invView = glm::inverse(view);
+	const glm::vec3 cameraPos = glm::vec3(invView[3]);
+	const glm::vec3 forward = -glm::normalize(glm::vec3(invView[2]));
+
+	// Pull the near and far planes, and the size of the view at each depth, back out of the projection matrix
+	const bool isOrtho = projection[2][3] == 0.0f;
+	float nearPlane, farPlane;
+	if (isOrtho) {
+		nearPlane = (projection[3][2] + 1.0f) / projection[2][2];
+		farPlane = (projection[3][2] - 1.0f) / projection[2][2];
+	} else {
+		nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+		farPlane = projection[3][2] / (projection[2][2] + 1.0f);
+	}
+	farPlane = glm::min(farPlane, nearPlane + MaxDistance);
+	// The squared length of the half diagonal of the view, at a depth of 1 for perspective, or for any depth for ortho
+	const float diagonalSq = 1.0f / (projection[0][0] * projection[0][0]) + 1.0f / (projection[1][1] * projection[1][1]);
+
+	float splitNear = nearPlane;
+	for (int ix = 0; ix < _cascadeCount; ix++) {
+		Cascade& cascade = _cascades[ix];
+
+		// Practical split scheme, blending between even and logarithmic splits
+		const float t = (ix + 1) / (float)_cascadeCount;
+		const float evenSplit = nearPlane + (farPlane - nearPlane) * t;
+		const float logSplit = nearPlane * glm::pow(farPlane / nearPlane, t);
+		const float splitFar = glm::mix(evenSplit, logSplit, SplitLambda);
+		cascade.SplitFar = splitFar;
+
+		// Find the smallest sphere around the slice of the view between the splits. This only depends on the
+		// split depths and field of view, so the sphere does not change size as the camera turns
+		float centerDepth, radius;
+		if (isOrtho) {
+			centerDepth = (splitNear + splitFar) * 0.5f;
+			radius = glm::sqrt((splitFar - splitNear) * (splitFar - splitNear) * 0.25f + diagonalSq);
+		} else {
+			centerDepth = glm::min((splitNear + splitFar) * (1.0f + diagonalSq) * 0.5f, splitFar);
+			radius = glm::max(
+				glm::sqrt((centerDepth - splitNear) * (centerDepth - splitNear) + diagonalSq * splitNear * splitNear),
+				glm::sqrt((splitFar - centerDepth) * (splitFar - centerDepth) + diagonalSq * splitFar * splitFar));
+		}
+		// Round the radius up so floating point error doesn't change the size of a texel from frame to frame
+		radius = glm::ceil(radius * 16.0f) / 16.0f;
+		const glm::vec3 center = cameraPos + forward * centerDepth;
+		splitNear = splitFar;
+
+		if (IsCascadeCached(ix)) {
+			// Cached cascades can be re-used as long as they still cover the whole slice
+			if (cascade.IsCacheValid && glm::distance(center, cascade.Center) + radius <= cascade.Radius) {
+				cascade.NeedsRender = false;
+				continue;
+			}
+			radius *= 1.0f + CacheMargin;
+		}
+
+		cascade.Center = center;
+		cascade.Radius = radius;
+		cascade.ViewProjection = _CreateLightMatrix(center, radius, lightDir);
+		cascade.NeedsRender = true;
+	}
+}
+
+void CascadedShadowMap::Render(const Shader::sptr& depthShader, const DrawCasterFunc& drawCaster)
+{
+	_cascadesRendered = 0;
+	_castersDrawn = 0;
+
+	bool anyToRender = false;
+	for (int ix = 0; ix < _cascadeCount; ix++) {
+		anyToRender |= _cascades[ix].NeedsRender;
+	}
+	if (!anyToRender) {
+		return;
+	}
+
+	depthShader->Bind();
+	glViewport(0, 0, _resolution, _resolution);
+	glEnable(GL_DEPTH_TEST);
+	glDepthMask(GL_TRUE);
+	glEnable(GL_CULL_FACE);
+	// Casters in front of the near plane are flattened onto it instead of being clipped
+	glEnable(GL_DEPTH_CLAMP);
+	glEnable(GL_POLYGON_OFFSET_FILL);
+	glPolygonOffset(SlopeBias, 1.0f);
+
+	for (int ix = 0; ix < _cascadeCount; ix++) {
+		Cascade& cascade = _cascades[ix];
+		if (!cascade.NeedsRender) {
+			continue;
+		}
+
+		// Cull against every plane but the near plane, anything between the light and the cascade can cast into it
+		glm::vec4 planes[6];
+		FrustumCuller::ExtractPlanes(cascade.ViewProjection, planes);
+		planes[4] = planes[5];
+		_culler.Cull(planes, 5);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, cascade.FBO);
+		glClear(GL_DEPTH_BUFFER_BIT);
+
+		const bool isCached = IsCascadeCached(ix);
+		const float pixelsPerUnit = _resolution / (2.0f * cascade.Radius);
+		for (uint32_t caster = 0; caster < _culler.GetCount(); caster++) {
+			// Dynamic casters would leave a trail behind them in cached cascades, so they only go in the near ones
+			if (_culler.IsVisible(caster) && (!isCached || _isStatic[caster])) {
+				drawCaster(caster, cascade.ViewProjection, pixelsPerUnit);
+				_castersDrawn++;
+			}
+		}
+
+		cascade.NeedsRender = false;
+		cascade.IsCacheValid = isCached;
+		_cascadesRendered++;
+	}
+
+	glDisable(GL_POLYGON_OFFSET_FILL);
+	glDisable(GL_DEPTH_CLAMP);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void CascadedShadowMap::Apply(const Shader::sptr& shader) const
+{
+	glBindTextureUnit(TextureSlot, _texture);
+
+	glm::mat4 matrices[MaxCascades];
+	glm::vec4 splits = glm::vec4(0.0f);
+	glm::vec4 texelSizes = glm::vec4(0.0f);
+	for (int ix = 0; ix < _cascadeCount; ix++) {
+		matrices[ix] = _cascades[ix].ViewProjection;
+		splits[ix] = _cascades[ix].SplitFar;
+		texelSizes[ix] = 2.0f * _cascades[ix].Radius / _resolution;
+	}
+	shader->SetUniform("u_CascadeCount", _cascadeCount);
+	shader->SetUniformMatrix(shader->GetUniformLocation("u_CascadeMatrices"), matrices, _cascadeCount);
+	shader->SetUniform("u_CascadeSplits", splits);
+	shader->SetUniform("u_CascadeTexelSizes", texelSizes);
+	shader->SetUniform("u_ShadowNormalBias", NormalBias);
+}
+
+void CascadedShadowMap::RenderImGui()
+{
+	if (ImGui::DragFloat3("Light Direction", &LightDirection.x, 0.01f, -1.0f, 1.0f)) {
+		if (glm::length(LightDirection) < 0.001f) {
+			LightDirection = glm::vec3(0.0f, 0.0f, -1.0f);
+		}
+	}
+	ImGui::DragFloat("Shadow Distance", &MaxDistance, 1.0f, 1.0f, 1000.0f);
+	ImGui::SliderFloat("Split Lambda", &SplitLambda, 0.0f, 1.0f);
+	ImGui::SliderInt("First Cached Cascade", &FirstCachedCascade, 0, _cascadeCount);
+	ImGui::SliderFloat("Cache Margin", &CacheMargin, 0.0f, 1.0f);
+	ImGui::SliderFloat("Slope Bias", &SlopeBias, 0.0f, 8.0f);
+	ImGui::SliderFloat("Normal Bias", &NormalBias, 0.0f, 4.0f);
+	for (int ix = 0; ix < _cascadeCount; ix++) {
+		ImGui::Text("Cascade %d: %.1f units%s", ix, _cascades[ix].SplitFar, IsCascadeCached(ix) ? " (cached)" : "");
+	}
+	ImGui::Text("Cascades rendered: %d, casters drawn: %u", _cascadesRendered, _castersDrawn);
+}
+
+glm::mat4 CascadedShadowMap::_CreateLightMatrix(const glm::vec3& center, float radius, const glm::vec3& lightDir) const
+{
+	const glm::vec3 up = glm::abs(lightDir.z) > 0.99f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(0.0f, 0.0f, 1.0f);
+	const glm::mat4 lightView = glm::lookAt(center - lightDir * radius, center, up);
+	glm::mat4 lightProjection = glm::ortho(-radius, radius, -radius, radius, 0.0f, 2.0f * radius);
+
+	// Find where the world origin lands in the shadow map, and shift the projection so that it lands on a texel
+	// corner. This makes the cascade move in whole texels, so the shadow edges don't crawl as the camera moves
+	const glm::vec4 origin = lightProjection * lightView * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	const glm::vec2 texelOrigin = glm::vec2(origin) * (_resolution * 0.5f);
+	const glm::vec2 offset = (glm::round(texelOrigin) - texelOrigin) / (_resolution * 0.5f);
+	lightProjection[3][0] += offset.x;
+	lightProjection[3][1] += offset.y;
+
+	return lightProjection * lightView;
+}
\ No newline at end of file
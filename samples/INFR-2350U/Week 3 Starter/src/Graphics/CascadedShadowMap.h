@@ -0,0 +1,124 @@
+#pragma once
+#include <vector>
+#include <functional>
+#include <GLM/glm.hpp>
+#include <Shader.h>
+#include <FrustumCuller.h>
+
+//Shadows for a directional light (the sun), split into cascades that each cover a slice of the camera's view
+//*Each cascade is fit to a sphere around it's slice, so it's size doesn't change as the camera turns, and it's
+// position is snapped to whole shadow map texels, so shadow edges don't shimmer as the camera moves
+//*Far cascades can be cached: they only draw static casters, and are only re-rendered when the light or the
+// static casters change, or when the camera leaves the area they were rendered for
+//*Casters are culled against each cascade before drawing, without the near plane since casters between the light
+// and the cascade still cast shadows into it (they get flattened onto the near plane with depth clamping)
+class CascadedShadowMap
+{
+public:
+	typedef std::shared_ptr<CascadedShadowMap> sptr;
+	static inline sptr Create(unsigned resolution = 2048, int cascadeCount = 4) {
+		return std::make_shared<CascadedShadowMap>(resolution, cascadeCount);
+	}
+
+	//The most cascades we support, this needs to match MAX_CASCADES in the shaders
+	static const int MaxCascades = 4;
+	//The texture slot the shadow map is bound to, this needs to match the binding of s_ShadowMap in the shaders
+	static const int TextureSlot = 8;
+
+	//Invoked for each caster that is visible in a cascade being rendered
+	//*pixelsPerUnit is how many shadow map texels a world unit covers, for picking a level of detail
+	typedef std::function<void(uint32_t caster, const glm::mat4& lightViewProjection, float pixelsPerUnit)> DrawCasterFunc;
+
+	CascadedShadowMap(unsigned resolution, int cascadeCount);
+	~CascadedShadowMap();
+
+	//We'll disallow moving and copying, since we own OpenGL objects
+	CascadedShadowMap(const CascadedShadowMap& other) = delete;
+	CascadedShadowMap(CascadedShadowMap&& other) = delete;
+	CascadedShadowMap& operator=(const CascadedShadowMap& other) = delete;
+	CascadedShadowMap& operator=(CascadedShadowMap&& other) = delete;
+
+	//The direction the light is shining in
+	glm::vec3 LightDirection;
+	//How far from the camera shadows are drawn
+	float     MaxDistance;
+	//Blends between evenly spaced (0) and logarithmic (1) cascade splits, higher values give near cascades more detail
+	float     SplitLambda;
+	//Cascades from this index on are cached, set it to the cascade count to disable caching
+	int       FirstCachedCascade;
+	//How much bigger cached cascades are than they need to be, as a fraction of their size
+	//*Bigger margins mean the camera can move further before they are re-rendered, but they have less detail
+	float     CacheMargin;
+	//Slope scaled depth offset applied while rendering the shadow map, to avoid shadow acne
+	float     SlopeBias;
+	//How far to offset lookups along the surface normal, in shadow map texels, to avoid shadow acne
+	float     NormalBias;
+
+	//Removes all the casters, call once per frame before adding the frame's casters
+	void ClearCasters();
+	//Adds a shadow caster, static casters are the only ones drawn into cached cascades
+	//*Returns the index of the caster, which is passed back to the draw function in Render
+	uint32_t AddCaster(const AxisAlignedBox& bounds, bool isStatic);
+	//Forces the cached cascades to be re-rendered next frame
+	//*Changes to the number or bounds of static casters are detected automatically
+	void InvalidateCache();
+
+	//Fits the cascades around the camera's view, call after adding the casters for the frame
+	void Update(const glm::mat4& view, const glm::mat4& projection);
+	//Renders the cascades that need it, using depthShader for all the casters
+	//*Leaves the default framebuffer bound, the viewport will need to be reset
+	void Render(const Shader::sptr& depthShader, const DrawCasterFunc& drawCaster);
+	//Binds the shadow map and sets the uniforms a shader needs to sample it
+	void Apply(const Shader::sptr& shader) const;
+
+	unsigned GetResolution() const { return _resolution; }
+	int GetCascadeCount() const { return _cascadeCount; }
+	//Gets the view space depth where a cascade ends
+	float GetCascadeSplit(int index) const { return _cascades[index].SplitFar; }
+	bool IsCascadeCached(int index) const { return index >= FirstCachedCascade; }
+	//Gets the number of cascades that were rendered in the last call to Render
+	int GetCascadesRendered() const { return _cascadesRendered; }
+	//Gets the number of casters that were drawn in the last call to Render, across all cascades
+	uint32_t GetCastersDrawn() const { return _castersDrawn; }
+
+	//Draws ImGui controls for the shadow settings
+	void RenderImGui();
+
+protected:
+	struct Cascade
+	{
+		//The matrix used to render and sample the cascade
+		glm::mat4 ViewProjection = glm::mat4(1.0f);
+		//The bounding sphere the cascade was rendered for
+		glm::vec3 Center = glm::vec3(0.0f);
+		float     Radius = 0.0f;
+		//The view space depth where the cascade ends
+		float     SplitFar = 0.0f;
+		//The framebuffer with the cascade's layer of the shadow map attached
+		GLuint    FBO = 0;
+		//Whether the cascade needs to be rendered this frame
+		bool      NeedsRender = true;
+		//Whether a cached cascade's contents can be re-used
+		bool      IsCacheValid = false;
+	};
+
+	unsigned _resolution;
+	int      _cascadeCount;
+	//A 2D array texture with a depth layer for each cascade
+	GLuint   _texture = 0;
+	Cascade  _cascades[MaxCascades];
+
+	FrustumCuller        _culler;
+	std::vector<uint8_t> _isStatic;
+
+	//A hash of the static casters' bounds, summed so that it doesn't depend on the order casters are added in
+	uint64_t  _staticSignature = 0;
+	uint64_t  _lastStaticSignature = 0;
+	glm::vec3 _lastLightDirection = glm::vec3(0.0f);
+
+	int      _cascadesRendered = 0;
+	uint32_t _castersDrawn = 0;
+
+	//Builds a light space matrix for a sphere, snapped so that the sphere moves in whole texels
+	glm::mat4 _CreateLightMatrix(const glm::vec3& center, float radius, const glm::vec3& lightDir) const;
+};
\ No newline at end of file
@@ -0,0 +1,405 @@
+#include "ClusteredLighting.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <emmintrin.h>
+#include <Logging.h>
+#include "imgui.h"
+
+//Below this many lights, waking up the workers costs more than the assignment itself
+static const size_t MinLightsForThreads = 256;
+
+ClusteredLighting::ClusteredLighting(int threadCount) :
+	MaxDistance(100.0f)
+{
+	_lightBuffer = ShaderStorageBuffer::Create();
+	_clusterBuffer = ShaderStorageBuffer::Create();
+	_indexBuffer = ShaderStorageBuffer::Create();
+	_clusters.resize(ClusterCount, { 0, 0 });
+
+	if (threadCount <= 0) {
+		threadCount = (int)std::max(1u, std::thread::hardware_concurrency());
+	}
+	// The slices are what gets split between workers in the second stage, so more workers than slices won't help
+	_threadCount = std::min(threadCount, (int)Slices);
+	_lists.resize(_threadCount);
+	_threads.reserve(_threadCount - 1);
+	for (int ix = 1; ix < _threadCount; ix++) {
+		_threads.emplace_back(&ClusteredLighting::_WorkerLoop, this, ix);
+	}
+}
+
+ClusteredLighting::~ClusteredLighting()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+	_wake.notify_all();
+	for (std::thread& thread : _threads) {
+		thread.join();
+	}
+}
+
+void ClusteredLighting::_RunParallel(const std::function<void(int)>& job, int count)
+{
+	if (count <= 1 || _threads.empty()) {
+		for (int ix = 0; ix < count; ix++) {
+			job(ix);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_job = job;
+		_jobCount = count;
+		_pending = (int)_threads.size();
+		_generation++;
+	}
+	_wake.notify_all();
+
+	// The calling thread does it's share instead of sitting idle
+	job(0);
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_done.wait(lock, [&]() { return _pending == 0; });
+}
+
+void ClusteredLighting::_WorkerLoop(int worker)
+{
+	uint64_t generation = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wake.wait(lock, [&]() { return _quit || _generation != generation; });
+			if (_quit) {
+				return;
+			}
+			generation = _generation;
+		}
+
+		// The job is only replaced once every worker has reported back, so it's safe to read without the lock
+		if (worker < _jobCount) {
+			_job(worker);
+		}
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (--_pending == 0) {
+			_done.notify_one();
+		}
+	}
+}
+
+void ClusteredLighting::Assign(const glm::mat4& view, const glm::mat4& projection)
+{
+	const auto start = std::chrono::high_resolution_clock::now();
+	_lastView = view;
+	_lastProjection = projection;
+
+	// Pull the near and far planes back out of the projection matrix
+	const bool isOrtho = projection[3][3] == 1.0f;
+	float nearPlane, farPlane;
+	if (isOrtho) {
+		nearPlane = (projection[3][2] + 1.0f) / projection[2][2];
+		farPlane = (projection[3][2] - 1.0f) / projection[2][2];
+	} else {
+		nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+		farPlane = projection[3][2] / (projection[2][2] + 1.0f);
+	}
+	// The slices are logarithmic, so the near plane can't be at or behind the camera
+	nearPlane = glm::max(nearPlane, 0.01f);
+	farPlane = glm::clamp(farPlane, nearPlane * 1.01f, nearPlane + MaxDistance);
+	_sliceScale = Slices / glm::log(farPlane / nearPlane);
+	_sliceBias = -glm::log(nearPlane) * _sliceScale;
+
+	const size_t lightCount = Lights.size();
+	_ranges.resize(lightCount);
+	const int workers = lightCount < MinLightsForThreads ? 1 : _threadCount;
+
+	// Stage 1: work out which clusters each light touches, each worker takes a block of lights
+	// Blocks are a multiple of 4 lights, so that only the last block has a partial group of 4
+	const size_t block = ((lightCount + workers - 1) / workers + 3) & ~(size_t)3;
+	_RunParallel([&](int worker) {
+		const size_t begin = std::min(block * worker, lightCount);
+		const size_t end = std::min(begin + block, lightCount);
+		_BoundLights(_lists[worker], begin, end, view, projection, nearPlane, farPlane, isOrtho);
+	}, workers);
+
+	// Split the slices between the workers, so that each one gets about the same number of light / cluster pairs
+	uint32_t sliceWork[Slices] = { 0 };
+	uint32_t totalWork = 0;
+	_visibleLightCount = 0;
+	for (int worker = 0; worker < workers; worker++) {
+		for (int slice = 0; slice < Slices; slice++) {
+			sliceWork[slice] += _lists[worker].SliceWork[slice];
+		}
+		_visibleLightCount += _lists[worker].VisibleLights;
+	}
+	for (int slice = 0; slice < Slices; slice++) {
+		totalWork += sliceWork[slice];
+	}
+	int slice = 0;
+	uint32_t work = 0;
+	for (int worker = 0; worker < workers; worker++) {
+		_lists[worker].SliceBegin = slice;
+		const uint64_t target = (uint64_t)totalWork * (worker + 1) / workers;
+		while (slice < Slices && (worker == workers - 1 || work < target)) {
+			work += sliceWork[slice];
+			slice++;
+		}
+		_lists[worker].SliceEnd = slice;
+	}
+
+	// Stage 2: each worker builds the light lists for it's own slices, so no locking is needed
+	_RunParallel([&](int worker) {
+		_BuildLists(_lists[worker]);
+	}, workers);
+
+	// Stage 3: the workers' lists get stored one after the other, so shift each worker's offsets past the ones before it
+	_indexCount = 0;
+	for (int worker = 0; worker < _threadCount; worker++) {
+		WorkerLists& lists = _lists[worker];
+		if (worker >= workers) {
+			lists.Indices.clear();
+			lists.SliceBegin = lists.SliceEnd = 0;
+		}
+		lists.Base = _indexCount;
+		const size_t clusterBegin = (size_t)lists.SliceBegin * TilesX * TilesY;
+		const size_t clusterEnd = (size_t)lists.SliceEnd * TilesX * TilesY;
+		for (size_t ix = clusterBegin; ix < clusterEnd; ix++) {
+			_clusters[ix].Offset += lists.Base;
+		}
+		_indexCount += (uint32_t)lists.Indices.size();
+	}
+
+	_assignTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void ClusteredLighting::_BoundLights(WorkerLists& lists, size_t begin, size_t end, const glm::mat4& view, const glm::mat4& projection, float nearPlane, float farPlane, bool isOrtho)
+{
+	std::fill(lists.SliceWork, lists.SliceWork + Slices, 0u);
+	lists.VisibleLights = 0;
+
+	// We only need the view space position of each light, so we splat the top 3 rows of the view matrix
+	const __m128 m00 = _mm_set1_ps(view[0][0]), m10 = _mm_set1_ps(view[1][0]), m20 = _mm_set1_ps(view[2][0]), m30 = _mm_set1_ps(view[3][0]);
+	const __m128 m01 = _mm_set1_ps(view[0][1]), m11 = _mm_set1_ps(view[1][1]), m21 = _mm_set1_ps(view[2][1]), m31 = _mm_set1_ps(view[3][1]);
+	const __m128 m02 = _mm_set1_ps(view[0][2]), m12 = _mm_set1_ps(view[1][2]), m22 = _mm_set1_ps(view[2][2]), m32 = _mm_set1_ps(view[3][2]);
+
+	// Maps view space x / depth (or just x for ortho) straight to a tile, tile = ((ndc * 0.5) + 0.5) * tiles
+	const __m128 scaleX = _mm_set1_ps(projection[0][0] * 0.5f * TilesX);
+	const __m128 scaleY = _mm_set1_ps(projection[1][1] * 0.5f * TilesY);
+	const __m128 biasX = _mm_set1_ps(((isOrtho ? projection[3][0] : -projection[2][0]) * 0.5f + 0.5f) * TilesX);
+	const __m128 biasY = _mm_set1_ps(((isOrtho ? projection[3][1] : -projection[2][1]) * 0.5f + 0.5f) * TilesY);
+	const __m128 maxTileX = _mm_set1_ps((float)(TilesX - 1));
+	const __m128 maxTileY = _mm_set1_ps((float)(TilesY - 1));
+	const __m128 nearV = _mm_set1_ps(nearPlane);
+	const __m128 farV = _mm_set1_ps(farPlane);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	for (size_t ix = begin; ix < end; ix += 4) {
+		// Gather 4 lights, a partial group at the end is padded with lights that have no radius
+		alignas(16) float px[4] = { 0 }, py[4] = { 0 }, pz[4] = { 0 }, pr[4] = { 0 };
+		const size_t count = std::min<size_t>(4, end - ix);
+		for (size_t lane = 0; lane < count; lane++) {
+			const PointLight& light = Lights[ix + lane];
+			px[lane] = light.Position.x;
+			py[lane] = light.Position.y;
+			pz[lane] = light.Position.z;
+			pr[lane] = light.Radius;
+		}
+		const __m128 x = _mm_load_ps(px), y = _mm_load_ps(py), z = _mm_load_ps(pz), r = _mm_load_ps(pr);
+
+		const __m128 vx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m10, y)), _mm_add_ps(_mm_mul_ps(m20, z), m30));
+		const __m128 vy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m01, x), _mm_mul_ps(m11, y)), _mm_add_ps(_mm_mul_ps(m21, z), m31));
+		const __m128 vz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m02, x), _mm_mul_ps(m12, y)), _mm_add_ps(_mm_mul_ps(m22, z), m32));
+
+		// The depth range of the sphere, clipped to the near and far planes
+		const __m128 depth = _mm_sub_ps(zero, vz);
+		const __m128 depthMin = _mm_max_ps(_mm_sub_ps(depth, r), nearV);
+		const __m128 depthMax = _mm_min_ps(_mm_add_ps(depth, r), farV);
+		__m128 valid = _mm_and_ps(_mm_cmple_ps(depthMin, depthMax), _mm_cmpgt_ps(r, zero));
+
+		// The sphere fits in the box [v - r, v + r], clipped to [depthMin, depthMax]. x / depth is monotonic in both x and
+		// depth, so the box's projected extents come from it's corners
+		__m128 invMin = one, invMax = one;
+		if (!isOrtho) {
+			// Lanes that are already invalid could divide by 0 here, but they are masked off below
+			invMin = _mm_div_ps(one, _mm_max_ps(depthMin, nearV));
+			invMax = _mm_div_ps(one, _mm_max_ps(depthMax, nearV));
+		}
+		const __m128 x0 = _mm_sub_ps(vx, r), x1 = _mm_add_ps(vx, r);
+		const __m128 y0 = _mm_sub_ps(vy, r), y1 = _mm_add_ps(vy, r);
+		__m128 tileX0 = _mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_mul_ps(x0, invMin), _mm_mul_ps(x0, invMax)), scaleX), biasX);
+		__m128 tileX1 = _mm_add_ps(_mm_mul_ps(_mm_max_ps(_mm_mul_ps(x1, invMin), _mm_mul_ps(x1, invMax)), scaleX), biasX);
+		__m128 tileY0 = _mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_mul_ps(y0, invMin), _mm_mul_ps(y0, invMax)), scaleY), biasY);
+		__m128 tileY1 = _mm_add_ps(_mm_mul_ps(_mm_max_ps(_mm_mul_ps(y1, invMin), _mm_mul_ps(y1, invMax)), scaleY), biasY);
+
+		// Lights that are entirely off the side of the screen don't touch anything
+		valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(tileX1, zero), _mm_cmplt_ps(tileX0, _mm_set1_ps((float)TilesX))));
+		valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(tileY1, zero), _mm_cmplt_ps(tileY0, _mm_set1_ps((float)TilesY))));
+
+		// Clamp to the grid, after which everything is positive so truncating is the same as flooring
+		alignas(16) int32_t tx0[4], tx1[4], ty0[4], ty1[4];
+		_mm_store_si128((__m128i*)tx0, _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(tileX0, zero), maxTileX)));
+		_mm_store_si128((__m128i*)tx1, _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(tileX1, zero), maxTileX)));
+		_mm_store_si128((__m128i*)ty0, _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(tileY0, zero), maxTileY)));
+		_mm_store_si128((__m128i*)ty1, _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(tileY1, zero), maxTileY)));
+		alignas(16) float dMin[4], dMax[4];
+		_mm_store_ps(dMin, depthMin);
+		_mm_store_ps(dMax, depthMax);
+		const int validMask = _mm_movemask_ps(valid);
+
+		for (size_t lane = 0; lane < count; lane++) {
+			LightRange& range = _ranges[ix + lane];
+			if ((validMask & (1 << lane)) == 0) {
+				range.ZMin = 1;
+				range.ZMax = 0;
+				continue;
+			}
+			// The slices are logarithmic, which SSE has no instruction for, so they are done one light at a time
+			const int z0 = glm::clamp((int)(glm::log(dMin[lane]) * _sliceScale + _sliceBias), 0, Slices - 1);
+			const int z1 = glm::clamp((int)(glm::log(dMax[lane]) * _sliceScale + _sliceBias), 0, Slices - 1);
+			range.XMin = (uint8_t)tx0[lane]; range.XMax = (uint8_t)tx1[lane];
+			range.YMin = (uint8_t)ty0[lane]; range.YMax = (uint8_t)ty1[lane];
+			range.ZMin = (uint8_t)z0;        range.ZMax = (uint8_t)z1;
+
+			const uint32_t area = (uint32_t)(tx1[lane] - tx0[lane] + 1) * (uint32_t)(ty1[lane] - ty0[lane] + 1);
+			for (int slice = z0; slice <= z1; slice++) {
+				lists.SliceWork[slice] += area;
+			}
+			lists.VisibleLights++;
+		}
+	}
+}
+
+void ClusteredLighting::_BuildLists(WorkerLists& lists)
+{
+	const size_t clusterBegin = (size_t)lists.SliceBegin * TilesX * TilesY;
+	const size_t clusterEnd = (size_t)lists.SliceEnd * TilesX * TilesY;
+	for (size_t ix = clusterBegin; ix < clusterEnd; ix++) {
+		_clusters[ix] = { 0, 0 };
+	}
+	if (lists.SliceBegin >= lists.SliceEnd) {
+		lists.Indices.clear();
+		return;
+	}
+
+	// Invokes func(cluster, light) for every cluster in our slices that a light touches
+	auto forEachCluster = [&](auto func) {
+		const uint32_t lightCount = (uint32_t)_ranges.size();
+		for (uint32_t light = 0; light < lightCount; light++) {
+			const LightRange& range = _ranges[light];
+			const int z0 = std::max((int)range.ZMin, lists.SliceBegin);
+			const int z1 = std::min((int)range.ZMax, lists.SliceEnd - 1);
+			for (int z = z0; z <= z1; z++) {
+				for (int y = range.YMin; y <= range.YMax; y++) {
+					Cluster* row = &_clusters[((size_t)z * TilesY + y) * TilesX];
+					for (int x = range.XMin; x <= range.XMax; x++) {
+						func(row[x], light);
+					}
+				}
+			}
+		}
+	};
+
+	// Count the lights in each cluster, then turn the counts into offsets and fill in the lists
+	// Doing it in two passes means every list is contiguous without having to allocate per cluster
+	forEachCluster([](Cluster& cluster, uint32_t light) { cluster.Count++; });
+	uint32_t offset = 0;
+	for (size_t ix = clusterBegin; ix < clusterEnd; ix++) {
+		_clusters[ix].Offset = offset;
+		offset += _clusters[ix].Count;
+		_clusters[ix].Count = 0;
+	}
+	lists.Indices.resize(offset);
+	uint32_t* indices = lists.Indices.data();
+	forEachCluster([indices](Cluster& cluster, uint32_t light) { indices[cluster.Offset + cluster.Count++] = light; });
+}
+
+void ClusteredLighting::Upload()
+{
+	// Allocate re-specifies each buffer, so we never have to wait on last frame's draws before writing
+	_lightBuffer->Allocate(sizeof(PointLight), Lights.size());
+	_lightBuffer->UpdateData(Lights.data(), 0, Lights.size() * sizeof(PointLight));
+	_clusterBuffer->Allocate(sizeof(Cluster), ClusterCount);
+	_clusterBuffer->UpdateData(_clusters.data(), 0, _clusters.size() * sizeof(Cluster));
+	_indexBuffer->Allocate(sizeof(uint32_t), _indexCount);
+	for (const WorkerLists& lists : _lists) {
+		_indexBuffer->UpdateData(lists.Indices.data(), lists.Base * sizeof(uint32_t), lists.Indices.size() * sizeof(uint32_t));
+	}
+}
+
+void ClusteredLighting::Apply(const Shader::sptr& shader, unsigned viewportWidth, unsigned viewportHeight) const
+{
+	_lightBuffer->BindBase(LightBinding);
+	_clusterBuffer->BindBase(ClusterBinding);
+	_indexBuffer->BindBase(IndexBinding);
+	shader->SetUniform("u_ClusterGrid", glm::ivec3(TilesX, TilesY, Slices));
+	shader->SetUniform("u_ClusterTileScale", glm::vec2(TilesX / (float)glm::max(viewportWidth, 1u), TilesY / (float)glm::max(viewportHeight, 1u)));
+	shader->SetUniform("u_ClusterDepthScaleBias", glm::vec2(_sliceScale, _sliceBias));
+}
+
+void ClusteredLighting::Benchmark(uint32_t maxLights, int iterations)
+{
+	const std::vector<PointLight> saved = Lights;
+	const glm::mat4 view = _lastView;
+	const glm::mat4 projection = _lastProjection;
+	const glm::mat4 invView = glm::inverse(view);
+	const bool isOrtho = projection[3][3] == 1.0f;
+	iterations = glm::max(iterations, 1);
+
+	// The same seed every time, so that runs can be compared
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> ndc(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> depth(1.0f, MaxDistance);
+	std::uniform_real_distribution<float> radius(0.5f, 3.0f);
+
+	_benchmarkResults.clear();
+	LOG_INFO("==== Clustered light assignment, {} threads =====", _threadCount);
+	for (uint32_t count = 256; count <= maxLights; count *= 2) {
+		// Scatter lights through the view, so that they all land in the grid
+		Lights.resize(count);
+		for (PointLight& light : Lights) {
+			const float d = depth(random);
+			glm::vec2 viewPos = glm::vec2(ndc(random), ndc(random));
+			if (isOrtho) {
+				viewPos = (viewPos - glm::vec2(projection[3])) / glm::vec2(projection[0][0], projection[1][1]);
+			} else {
+				viewPos = viewPos * d / glm::vec2(projection[0][0], projection[1][1]);
+			}
+			light.Position = glm::vec3(invView * glm::vec4(viewPos, -d, 1.0f));
+			light.Radius = radius(random);
+		}
+
+		// Warm up once, so the lists are already allocated
+		Assign(view, projection);
+		float total = 0.0f;
+		for (int ix = 0; ix < iterations; ix++) {
+			Assign(view, projection);
+			total += _assignTime;
+		}
+		const BenchmarkResult result = { count, total / iterations, _indexCount };
+		_benchmarkResults.push_back(result);
+		LOG_INFO("\t{:>6} lights: {:.3f}ms, {} indices", result.LightCount, result.Milliseconds, result.IndexCount);
+	}
+
+	Lights = saved;
+	Assign(view, projection);
+}
+
+void ClusteredLighting::RenderImGui()
+{
+	ImGui::Text("Lights: %zu (%u visible), %d threads", Lights.size(), _visibleLightCount, _threadCount);
+	ImGui::Text("Assignment: %.3fms, %u indices (%.1f per cluster)", _assignTime, _indexCount, _indexCount / (float)ClusterCount);
+	ImGui::Text("Grid: %dx%dx%d", TilesX, TilesY, Slices);
+	ImGui::DragFloat("Light Distance", &MaxDistance, 1.0f, 1.0f, 1000.0f);
+	if (ImGui::Button("Run Benchmark")) {
+		Benchmark();
+	}
+	for (const BenchmarkResult& result : _benchmarkResults) {
+		ImGui::Text("%6u lights: %.3fms, %u indices", result.LightCount, result.Milliseconds, result.IndexCount);
+	}
+}
\ No newline at end of file
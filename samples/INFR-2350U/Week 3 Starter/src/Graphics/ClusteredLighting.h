@@ -0,0 +1,165 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <GLM/glm.hpp>
+#include <Shader.h>
+#include <ShaderStorageBuffer.h>
+
+//A point light for clustered shading, laid out to match the PointLight struct in the shaders (std430)
+struct PointLight
+{
+	glm::vec3 Position  = glm::vec3(0.0f);
+	//The light has no effect past this distance
+	float     Radius    = 1.0f;
+	glm::vec3 Color     = glm::vec3(1.0f);
+	float     Intensity = 1.0f;
+};
+
+//Clustered forward lighting, lets us shade with thousands of point lights
+//*The view is split into a grid of clusters, tiles on screen and logarithmic slices in depth, and each frame the
+// lights are assigned to the clusters they touch on the CPU. Fragments then only loop over the lights in their cluster
+//*Assignment is split across worker threads: first the lights are bounded 4 at a time with SSE, then each worker
+// builds the lists for it's own range of depth slices, so no two workers ever write to the same cluster
+//*The lights, clusters and light indices are uploaded into shader storage buffers at fixed bindings
+class ClusteredLighting
+{
+public:
+	typedef std::shared_ptr<ClusteredLighting> sptr;
+	static inline sptr Create(int threadCount = 0) {
+		return std::make_shared<ClusteredLighting>(threadCount);
+	}
+
+	//The size of the cluster grid, these are sent to the shaders so they can be changed here without touching them
+	static const int TilesX = 16;
+	static const int TilesY = 9;
+	static const int Slices = 24;
+	static const int ClusterCount = TilesX * TilesY * Slices;
+
+	//The buffer bindings, these need to match the bindings of the buffer blocks in the shaders
+	static const int LightBinding = 0;
+	static const int ClusterBinding = 1;
+	static const int IndexBinding = 2;
+
+	//threadCount of 0 will use all of the hardware threads
+	ClusteredLighting(int threadCount = 0);
+	~ClusteredLighting();
+
+	//We'll disallow moving and copying, since we own OpenGL objects and threads
+	ClusteredLighting(const ClusteredLighting& other) = delete;
+	ClusteredLighting(ClusteredLighting&& other) = delete;
+	ClusteredLighting& operator=(const ClusteredLighting& other) = delete;
+	ClusteredLighting& operator=(ClusteredLighting&& other) = delete;
+
+	//The lights in the scene, in world space
+	std::vector<PointLight> Lights;
+	//How far from the camera lights are drawn, lights further away than this are dropped
+	float MaxDistance;
+
+	//Assigns the lights to the clusters for the given camera
+	void Assign(const glm::mat4& view, const glm::mat4& projection);
+	//Uploads the lights and the results of the last Assign to the GPU
+	void Upload();
+	//Binds the buffers and sets the uniforms a shader needs to find the clusters, for a viewport of the given size
+	void Apply(const Shader::sptr& shader, unsigned viewportWidth, unsigned viewportHeight) const;
+
+	GLuint GetLightBuffer() const { return _lightBuffer->GetHandle(); }
+	GLuint GetClusterBuffer() const { return _clusterBuffer->GetHandle(); }
+	GLuint GetIndexBuffer() const { return _indexBuffer->GetHandle(); }
+	size_t GetLightBufferSize() const { return _lightBuffer->GetTotalSize(); }
+	size_t GetClusterBufferSize() const { return _clusterBuffer->GetTotalSize(); }
+	size_t GetIndexBufferSize() const { return _indexBuffer->GetTotalSize(); }
+
+	//Gets how long the last Assign took, in milliseconds
+	float GetAssignTime() const { return _assignTime; }
+	//Gets the number of light indices written by the last Assign, across all clusters
+	uint32_t GetIndexCount() const { return _indexCount; }
+	//Gets the number of lights that touched at least one cluster in the last Assign
+	uint32_t GetVisibleLightCount() const { return _visibleLightCount; }
+	int GetThreadCount() const { return _threadCount; }
+
+	//Times Assign with increasing numbers of random lights in front of the camera from the last Assign, and logs the results
+	//*Lights is restored afterwards
+	void Benchmark(uint32_t maxLights = 16384, int iterations = 20);
+
+	//Draws ImGui controls showing the assignment stats and benchmark results
+	void RenderImGui();
+
+protected:
+	//The range of clusters a light touches, inclusive. Lights that touch nothing have ZMin > ZMax
+	struct LightRange
+	{
+		uint8_t XMin, XMax;
+		uint8_t YMin, YMax;
+		uint8_t ZMin, ZMax;
+		uint8_t Padding[2];
+	};
+
+	//Matches the uvec2 in the shaders, where the cluster's lights start in the index list, and how many there are
+	struct Cluster
+	{
+		uint32_t Offset;
+		uint32_t Count;
+	};
+
+	//The results each worker builds for it's range of slices
+	struct WorkerLists
+	{
+		std::vector<uint32_t> Indices;
+		uint32_t              Base = 0;
+		//How many clusters the worker's lights touched in each slice, used to balance the slices between workers
+		uint32_t              SliceWork[Slices];
+		uint32_t              VisibleLights = 0;
+		int                   SliceBegin = 0;
+		int                   SliceEnd = 0;
+	};
+
+	struct BenchmarkResult
+	{
+		uint32_t LightCount;
+		float    Milliseconds;
+		uint32_t IndexCount;
+	};
+
+	ShaderStorageBuffer::sptr _lightBuffer;
+	ShaderStorageBuffer::sptr _clusterBuffer;
+	ShaderStorageBuffer::sptr _indexBuffer;
+
+	std::vector<LightRange>   _ranges;
+	std::vector<Cluster>      _clusters;
+	std::vector<WorkerLists>  _lists;
+
+	//The depth slicing from the last Assign, slice = log(depth) * scale + bias
+	float     _sliceScale = 0.0f;
+	float     _sliceBias = 0.0f;
+	glm::mat4 _lastView = glm::mat4(1.0f);
+	glm::mat4 _lastProjection = glm::mat4(1.0f);
+
+	float    _assignTime = 0.0f;
+	uint32_t _indexCount = 0;
+	uint32_t _visibleLightCount = 0;
+	std::vector<BenchmarkResult> _benchmarkResults;
+
+	//A small pool of threads that live as long as we do, spinning up new threads every frame costs more than the work
+	//*The calling thread is always worker 0, so the pool holds threadCount - 1 threads
+	int                      _threadCount;
+	std::vector<std::thread> _threads;
+	std::mutex               _mutex;
+	std::condition_variable  _wake;
+	std::condition_variable  _done;
+	std::function<void(int)> _job;
+	int                      _jobCount = 0;
+	uint64_t                 _generation = 0;
+	int                      _pending = 0;
+	bool                     _quit = false;
+
+	//Runs job for workers [0, count), and waits for them all to finish
+	void _RunParallel(const std::function<void(int)>& job, int count);
+	void _WorkerLoop(int worker);
+	//Works out which clusters the lights in [begin, end) touch, begin must be a multiple of 4
+	void _BoundLights(WorkerLists& lists, size_t begin, size_t end, const glm::mat4& view, const glm::mat4& projection, float nearPlane, float farPlane, bool isOrtho);
+	//Builds the light lists for a worker's range of slices
+	void _BuildLists(WorkerLists& lists);
+};
\ No newline at end of file
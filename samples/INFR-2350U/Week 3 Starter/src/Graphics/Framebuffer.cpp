@@ -1,11 +1,39 @@
 #include "Framebuffer.h"
 
+#include <Logging.h>
+
+GLuint Framebuffer::_fullscreenVAO = 0;
+
 DepthTarget::~DepthTarget()
 {
+	Unload();
+}
+
+void DepthTarget::Unload()
+{
+	_texture = nullptr;
+	if (_renderbuffer != 0) {
+		glDeleteRenderbuffers(1, &_renderbuffer);
+		_renderbuffer = 0;
+	}
 }
 
 ColorTarget::~ColorTarget()
 {
+	Unload();
+}
+
+void ColorTarget::Unload()
+{
+	for (auto& texture : _textures) {
+		texture = nullptr;
+	}
+	for (auto& renderbuffer : _renderbuffers) {
+		if (renderbuffer != 0) {
+			glDeleteRenderbuffers(1, &renderbuffer);
+			renderbuffer = 0;
+		}
+	}
 }
 
 Framebuffer::Framebuffer()
@@ -14,7 +42,306 @@ Framebuffer::Framebuffer()
 
 Framebuffer::~Framebuffer()
 {
+	_color.Unload();
+	_depth.Unload();
+	if (_FBO != 0) {
+		glDeleteFramebuffers(1, &_FBO);
+	}
+	if (_resolveFBO != 0) {
+		glDeleteFramebuffers(1, &_resolveFBO);
+	}
+}
+
+void Framebuffer::Init(unsigned width, unsigned height, unsigned samples)
+{
+	LOG_ASSERT(width > 0 && height > 0, "Framebuffer size must be greater than 0!");
+	LOG_ASSERT(!_isInit, "Framebuffer has already been initialized!");
+
+	_width = width;
+	_height = height;
+	_samples = samples > 0 ? samples : 1;
+
+	glCreateFramebuffers(1, &_FBO);
+	// When multisampled, we render into renderbuffers on the main FBO, and resolve into textures on a second FBO
+	if (_samples > 1) {
+		glCreateFramebuffers(1, &_resolveFBO);
+	}
+
+	_isInit = true;
+}
+
+Texture2D::sptr Framebuffer::_CreateTargetTexture(InternalFormat format) const
+{
+	Texture2DDescription desc;
+	desc.Width = _width;
+	desc.Height = _height;
+	desc.Format = format;
+	desc.GenerateMipMaps = false;
+	desc.MipLevels = 1;
+	desc.MinificationFilter = MinFilter::Linear;
+	desc.MagnificationFilter = MagFilter::Linear;
+	desc.HorizontalWrap = WrapMode::ClampToEdge;
+	desc.VerticalWrap = WrapMode::ClampToEdge;
+	desc.MaxAnisotropic = 1.0f;
+	return Texture2D::Create(desc);
+}
+
+int Framebuffer::AddColorTarget(InternalFormat format)
+{
+	LOG_ASSERT(_isInit, "Framebuffer must be initialized before adding targets!");
+	LOG_ASSERT(!IsDepthFormat(format), "Use AddDepthTarget for depth formats!");
+
+	unsigned index = _color._numAttachments++;
+	_color._textures.push_back(nullptr);
+	_color._renderbuffers.push_back(0);
+	_color._formats.push_back(format);
+	_color._buffers.push_back(GL_COLOR_ATTACHMENT0 + index);
+	_color._owned.push_back(true);
+
+	_CreateColorTarget(index);
+	_UpdateDrawBuffers();
+	return index;
+}
+
+void Framebuffer::AddDepthTarget(InternalFormat format)
+{
+	LOG_ASSERT(_isInit, "Framebuffer must be initialized before adding targets!");
+	LOG_ASSERT(IsDepthFormat(format), "Depth targets require a depth format!");
+
+	_depth.Unload();
+	_depth._format = format;
+	_depth._owned = true;
+	_depthActive = true;
+
+	_CreateDepthTarget();
+}
+
+int Framebuffer::AttachColorTexture(const Texture2D::sptr& texture)
+{
+	LOG_ASSERT(_isInit, "Framebuffer must be initialized before adding targets!");
+	LOG_ASSERT(!IsMultisampled(), "Cannot attach textures directly to a multisampled framebuffer!");
+	LOG_ASSERT(texture->GetWidth() == _width && texture->GetHeight() == _height, "Texture size does not match the framebuffer!");
+
+	unsigned index = _color._numAttachments++;
+	_color._textures.push_back(texture);
+	_color._renderbuffers.push_back(0);
+	_color._formats.push_back(texture->GetFormat());
+	_color._buffers.push_back(GL_COLOR_ATTACHMENT0 + index);
+	_color._owned.push_back(false);
+
+	glNamedFramebufferTexture(_FBO, _color._buffers[index], texture->GetHandle(), 0);
+	_UpdateDrawBuffers();
+	return index;
+}
+
+void Framebuffer::AttachDepthTexture(const Texture2D::sptr& texture)
+{
+	LOG_ASSERT(_isInit, "Framebuffer must be initialized before adding targets!");
+	LOG_ASSERT(!IsMultisampled(), "Cannot attach textures directly to a multisampled framebuffer!");
+	LOG_ASSERT(IsDepthFormat(texture->GetFormat()), "Depth targets require a depth format!");
+	LOG_ASSERT(texture->GetWidth() == _width && texture->GetHeight() == _height, "Texture size does not match the framebuffer!");
+
+	_depth.Unload();
+	_depth._texture = texture;
+	_depth._format = texture->GetFormat();
+	_depth._owned = false;
+	_depthActive = true;
+
+	GLenum attachment = HasStencil(_depth._format) ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+	glNamedFramebufferTexture(_FBO, attachment, texture->GetHandle(), 0);
+}
+
+void Framebuffer::_CreateColorTarget(unsigned index)
+{
+	InternalFormat format = _color._formats[index];
+	GLenum attachment = _color._buffers[index];
+
+	_color._textures[index] = _CreateTargetTexture(format);
+
+	if (IsMultisampled()) {
+		// Render into multisampled storage, the texture only receives the resolved image
+		glCreateRenderbuffers(1, &_color._renderbuffers[index]);
+		glNamedRenderbufferStorageMultisample(_color._renderbuffers[index], _samples, *format, _width, _height);
+		glNamedFramebufferRenderbuffer(_FBO, attachment, GL_RENDERBUFFER, _color._renderbuffers[index]);
+		glNamedFramebufferTexture(_resolveFBO, attachment, _color._textures[index]->GetHandle(), 0);
+	} else {
+		glNamedFramebufferTexture(_FBO, attachment, _color._textures[index]->GetHandle(), 0);
+	}
+}
+
+void Framebuffer::_CreateDepthTarget()
+{
+	GLenum attachment = HasStencil(_depth._format) ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+
+	_depth._texture = _CreateTargetTexture(_depth._format);
+	// Depth textures should not be filtered when sampled
+	_depth._texture->SetMinFilter(MinFilter::Nearest);
+	_depth._texture->SetMagFilter(MagFilter::Nearest);
+
+	if (IsMultisampled()) {
+		glCreateRenderbuffers(1, &_depth._renderbuffer);
+		glNamedRenderbufferStorageMultisample(_depth._renderbuffer, _samples, *_depth._format, _width, _height);
+		glNamedFramebufferRenderbuffer(_FBO, attachment, GL_RENDERBUFFER, _depth._renderbuffer);
+		glNamedFramebufferTexture(_resolveFBO, attachment, _depth._texture->GetHandle(), 0);
+	} else {
+		glNamedFramebufferTexture(_FBO, attachment, _depth._texture->GetHandle(), 0);
+	}
+}
+
+void Framebuffer::_UpdateDrawBuffers()
+{
+	if (_color._numAttachments > 0) {
+		glNamedFramebufferDrawBuffers(_FBO, _color._numAttachments, _color._buffers.data());
+	} else {
+		// Depth only framebuffer (ex: for shadow maps)
+		glNamedFramebufferDrawBuffer(_FBO, GL_NONE);
+		glNamedFramebufferReadBuffer(_FBO, GL_NONE);
+	}
+}
+
+void Framebuffer::Reshape(unsigned width, unsigned height)
+{
+	LOG_ASSERT(_isInit, "Framebuffer must be initialized before reshaping!");
+	if (width == 0 || height == 0 || (width == _width && height == _height)) {
+		return;
+	}
+
+	_width = width;
+	_height = height;
+
+	for (unsigned ix = 0; ix < _color._numAttachments; ix++) {
+		if (!_color._owned[ix]) {
+			LOG_WARN("Framebuffer is being reshaped, but color target {} was attached externally and will not be resized", ix);
+			continue;
+		}
+		if (_color._renderbuffers[ix] != 0) {
+			glDeleteRenderbuffers(1, &_color._renderbuffers[ix]);
+			_color._renderbuffers[ix] = 0;
+		}
+		_CreateColorTarget(ix);
+	}
+
+	if (_depthActive) {
+		if (_depth._owned) {
+			_depth.Unload();
+			_CreateDepthTarget();
+		} else {
+			LOG_WARN("Framebuffer is being reshaped, but the depth target was attached externally and will not be resized");
+		}
+	}
+}
+
+void Framebuffer::Bind() const
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, _FBO);
+	glViewport(0, 0, _width, _height);
 }
 
+void Framebuffer::Unbind() const
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
 
+void Framebuffer::Clear(const glm::vec4& color, float depth, int stencil)
+{
+	for (unsigned ix = 0; ix < _color._numAttachments; ix++) {
+		glClearNamedFramebufferfv(_FBO, GL_COLOR, ix, &color[0]);
+	}
+	if (_depthActive) {
+		if (HasStencil(_depth._format)) {
+			glClearNamedFramebufferfi(_FBO, GL_DEPTH_STENCIL, 0, depth, stencil);
+		} else {
+			glClearNamedFramebufferfv(_FBO, GL_DEPTH, 0, &depth);
+		}
+	}
+}
+
+void Framebuffer::Resolve() const
+{
+	if (!IsMultisampled()) {
+		return;
+	}
 
+	// Blits can only copy one color buffer at a time, so we resolve each target individually
+	for (unsigned ix = 0; ix < _color._numAttachments; ix++) {
+		glNamedFramebufferReadBuffer(_FBO, _color._buffers[ix]);
+		glNamedFramebufferDrawBuffer(_resolveFBO, _color._buffers[ix]);
+		// Integer formats must use nearest, we'll stick with it for everything since the sizes match
+		glBlitNamedFramebuffer(_FBO, _resolveFBO, 0, 0, _width, _height, 0, 0, _width, _height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	}
+	if (_depthActive) {
+		GLbitfield mask = GL_DEPTH_BUFFER_BIT | (HasStencil(_depth._format) ? GL_STENCIL_BUFFER_BIT : 0);
+		glBlitNamedFramebuffer(_FBO, _resolveFBO, 0, 0, _width, _height, 0, 0, _width, _height, mask, GL_NEAREST);
+	}
+	if (_color._numAttachments > 0) {
+		glNamedFramebufferReadBuffer(_FBO, _color._buffers[0]);
+	}
+}
+
+void Framebuffer::BindColorAsTexture(unsigned index, int textureSlot) const
+{
+	LOG_ASSERT(index < _color._numAttachments, "Color target {} does not exist!", index);
+	_color._textures[index]->Bind(textureSlot);
+}
+
+void Framebuffer::BindDepthAsTexture(int textureSlot) const
+{
+	LOG_ASSERT(_depthActive, "Framebuffer does not have a depth target!");
+	_depth._texture->Bind(textureSlot);
+}
+
+void Framebuffer::UnbindTexture(int textureSlot) const
+{
+	ITexture::Unbind(textureSlot);
+}
+
+void Framebuffer::BlitToBackbuffer(unsigned windowWidth, unsigned windowHeight, unsigned index) const
+{
+	LOG_ASSERT(index < _color._numAttachments, "Color target {} does not exist!", index);
+	GLuint source = IsMultisampled() ? _resolveFBO : _FBO;
+	glNamedFramebufferReadBuffer(source, _color._buffers[index]);
+	GLenum filter = (windowWidth == _width && windowHeight == _height) ? GL_NEAREST : GL_LINEAR;
+	glBlitNamedFramebuffer(source, 0, 0, 0, _width, _height, 0, 0, windowWidth, windowHeight, GL_COLOR_BUFFER_BIT, filter);
+}
+
+bool Framebuffer::CheckFBO() const
+{
+	GLenum status = glCheckNamedFramebufferStatus(_FBO, GL_FRAMEBUFFER);
+	if (status != GL_FRAMEBUFFER_COMPLETE) {
+		LOG_ERROR("Framebuffer is incomplete, status: 0x{:x}", status);
+		return false;
+	}
+	if (_resolveFBO != 0) {
+		status = glCheckNamedFramebufferStatus(_resolveFBO, GL_FRAMEBUFFER);
+		if (status != GL_FRAMEBUFFER_COMPLETE) {
+			LOG_ERROR("Framebuffer resolve target is incomplete, status: 0x{:x}", status);
+			return false;
+		}
+	}
+	return true;
+}
+
+size_t Framebuffer::GetMemoryUsage() const
+{
+	size_t pixels = (size_t)_width * _height;
+	size_t result = 0;
+	for (unsigned ix = 0; ix < _color._numAttachments; ix++) {
+		// Multisampled targets store every sample, plus the resolved texture
+		size_t texel = GetInternalFormatSize(_color._formats[ix]);
+		result += pixels * texel * (IsMultisampled() ? _samples + 1 : 1);
+	}
+	if (_depthActive) {
+		result += pixels * GetInternalFormatSize(_depth._format) * (IsMultisampled() ? _samples + 1 : 1);
+	}
+	return result;
+}
+
+void Framebuffer::DrawFullscreenQuad()
+{
+	if (_fullscreenVAO == 0) {
+		glCreateVertexArrays(1, &_fullscreenVAO);
+	}
+	glBindVertexArray(_fullscreenVAO);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glBindVertexArray(0);
+}
\ No newline at end of file
@@ -8,6 +8,17 @@ struct DepthTarget
 	//Deconstructor for Depth Target
 	//*Unloads texture
 	~DepthTarget();
+	//Unloads the depth texture and any multisampled storage
+	void Unload();
+
+	//The depth texture, this is what gets sampled when binding depth as a texture
+	Texture2D::sptr _texture = nullptr;
+	//The multisampled storage we render into when MSAA is enabled, resolved into _texture
+	GLuint _renderbuffer = 0;
+	//The format of the depth buffer
+	InternalFormat _format = InternalFormat::Unknown;
+	//Whether the framebuffer created the texture (and should re-create it on reshape)
+	bool _owned = true;
 };
 
 struct ColorTarget
@@ -15,14 +26,129 @@ struct ColorTarget
 	//Deconstructor for Color Target
 	//*Unloads all the color targets
 	~ColorTarget();
+	//Unloads all the color textures and any multisampled storage
+	void Unload();
+
+	//The color textures, these are what gets sampled when binding a color target as a texture
+	std::vector<Texture2D::sptr> _textures;
+	//The multisampled storage we render into when MSAA is enabled, resolved into _textures
+	std::vector<GLuint> _renderbuffers;
+	//The format of each of the color targets
+	std::vector<InternalFormat> _formats;
+	//The attachment points of each color target (GL_COLOR_ATTACHMENT0 + index)
+	std::vector<GLenum> _buffers;
+	//Whether the framebuffer created each texture (and should re-create it on reshape)
+	std::vector<bool> _owned;
+	//The number of color targets
+	unsigned int _numAttachments = 0;
 };
 
 class Framebuffer
 {
 public:
+	typedef std::shared_ptr<Framebuffer> sptr;
+	static inline sptr Create() {
+		return std::make_shared<Framebuffer>();
+	}
+
 	Framebuffer();
 	~Framebuffer();
 
+	//We'll disallow moving and copying, since we own OpenGL objects
+	Framebuffer(const Framebuffer& other) = delete;
+	Framebuffer(Framebuffer&& other) = delete;
+	Framebuffer& operator=(const Framebuffer& other) = delete;
+	Framebuffer& operator=(Framebuffer&& other) = delete;
+
+	//Initializes the framebuffer with the given size
+	//*samples is the number of MSAA samples, 1 disables multisampling
+	//*Targets added after this will be created with this size
+	void Init(unsigned width, unsigned height, unsigned samples = 1);
+
+	//Adds a new color target with the given format
+	//*Returns the index of the new color target
+	int AddColorTarget(InternalFormat format);
+	//Adds a depth target with the given format (use a format with stencil for a depth-stencil target)
+	void AddDepthTarget(InternalFormat format = InternalFormat::Depth24Stencil8);
+
+	//Attaches an existing texture as a color target, ex: a texture from a RenderTargetPool
+	//*The texture must be the size of the framebuffer, and the framebuffer can not be multisampled
+	//*Returns the index of the new color target
+	int AttachColorTexture(const Texture2D::sptr& texture);
+	//Attaches an existing depth texture as the depth target
+	//*The texture must be the size of the framebuffer, and the framebuffer can not be multisampled
+	void AttachDepthTexture(const Texture2D::sptr& texture);
+
+	//Resizes the framebuffer, re-creating all the targets that the framebuffer owns
+	void Reshape(unsigned width, unsigned height);
+
+	//Binds the framebuffer as the render target, and sets the viewport to cover it
+	void Bind() const;
+	//Binds the default framebuffer (the window) as the render target
+	void Unbind() const;
+	//Clears all the targets of the framebuffer
+	void Clear(const glm::vec4& color = glm::vec4(0.0f), float depth = 1.0f, int stencil = 0);
+
+	//Copies the multisampled targets into the textures so that they can be sampled
+	//*Does nothing if the framebuffer isn't multisampled
+	void Resolve() const;
+
+	//Binds one of the color targets to a texture slot
+	void BindColorAsTexture(unsigned index, int textureSlot) const;
+	//Binds the depth target to a texture slot
+	void BindDepthAsTexture(int textureSlot) const;
+	//Unbinds the texture from the given slot
+	void UnbindTexture(int textureSlot) const;
+
+	//Copies one of the color targets to the window, scaling it to fit
+	//*If the framebuffer is multisampled, this copies the resolved texture, so call Resolve first
+	void BlitToBackbuffer(unsigned windowWidth, unsigned windowHeight, unsigned index = 0) const;
+
+	//Checks if the framebuffer is complete, logging the reason if it isn't
+	bool CheckFBO() const;
+
+	const Texture2D::sptr& GetColorTexture(unsigned index = 0) const { return _color._textures[index]; }
+	const Texture2D::sptr& GetDepthTexture() const { return _depth._texture; }
+	unsigned GetColorTargetCount() const { return _color._numAttachments; }
+	bool HasDepth() const { return _depthActive; }
+	unsigned GetWidth() const { return _width; }
+	unsigned GetHeight() const { return _height; }
+	unsigned GetSamples() const { return _samples; }
+	GLuint GetHandle() const { return _FBO; }
+	bool IsMultisampled() const { return _samples > 1; }
+
+	//Gets the approximate amount of video memory used by the framebuffer's targets, in bytes
+	size_t GetMemoryUsage() const;
+
+	//Draws a triangle that covers the entire viewport, for running a shader over every pixel
+	//*The vertex shader is expected to generate the positions from gl_VertexID (see shaders/post/fullscreen.vert.glsl)
+	static void DrawFullscreenQuad();
+
 protected:
+	//The framebuffer we render into
+	GLuint _FBO = 0;
+	//When multisampled, the framebuffer holding the textures we resolve into
+	GLuint _resolveFBO = 0;
+
+	unsigned int _width = 0;
+	unsigned int _height = 0;
+	unsigned int _samples = 1;
+
+	bool _isInit = false;
+	bool _depthActive = false;
+
+	DepthTarget _depth;
+	ColorTarget _color;
+
+	//An empty VAO, OpenGL won't draw without one bound even if we have no vertex attributes
+	static GLuint _fullscreenVAO;
 
+	//Creates a texture that can be used as a render target
+	Texture2D::sptr _CreateTargetTexture(InternalFormat format) const;
+	//Creates the storage for a color target and attaches it
+	void _CreateColorTarget(unsigned index);
+	//Creates the storage for the depth target and attaches it
+	void _CreateDepthTarget();
+	//Tells OpenGL which color targets fragment shaders write to
+	void _UpdateDrawBuffers();
 };
\ No newline at end of file
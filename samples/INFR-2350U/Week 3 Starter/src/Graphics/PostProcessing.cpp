@@ -0,0 +1,206 @@
+#include "PostProcessing.h"
+
+#include <Logging.h>
+#include "imgui.h"
+
+Shader::sptr PostEffect::_LoadShader(const char* fragmentPath)
+{
+	Shader::sptr result = Shader::Create();
+	result->LoadShaderPartFromFile("shaders/post/fullscreen.vert.glsl", GL_VERTEX_SHADER);
+	result->LoadShaderPartFromFile(fragmentPath, GL_FRAGMENT_SHADER);
+	result->Link();
+	return result;
+}
+
+void PostEffect::_RenderPass(const Shader::sptr& shader, const Framebuffer::sptr& target)
+{
+	target->Bind();
+	shader->Bind();
+	Framebuffer::DrawFullscreenQuad();
+}
+
+//////////////////////////////////////////// Bloom ////////////////////////////////////////////
+
+BloomEffect::BloomEffect() :
+	PostEffect("Bloom"),
+	Threshold(1.0f),
+	Knee(0.5f),
+	Intensity(0.6f),
+	Radius(1.0f),
+	Iterations(6)
+{
+	_prefilter = _LoadShader("shaders/post/bloom_prefilter.frag.glsl");
+	_downsample = _LoadShader("shaders/post/bloom_downsample.frag.glsl");
+	_upsample = _LoadShader("shaders/post/bloom_upsample.frag.glsl");
+	_composite = _LoadShader("shaders/post/bloom_composite.frag.glsl");
+}
+
+void BloomEffect::Apply(const Texture2D::sptr& input, const Framebuffer::sptr& output, RenderTargetPool& pool)
+{
+	// The bloom chain doesn't need alpha or much precision, so we use a packed float format to halve the memory
+	const InternalFormat chainFormat = InternalFormat::R11G11B10F;
+
+	unsigned width = glm::max(input->GetWidth() / 2, 1u);
+	unsigned height = glm::max(input->GetHeight() / 2, 1u);
+
+	std::vector<Texture2D::sptr> chain;
+	chain.reserve(Iterations);
+
+	// Extract the bright parts of the image into the first level
+	chain.push_back(pool.Acquire(width, height, chainFormat));
+	input->Bind(0);
+	_prefilter->SetUniform("s_Source", 0);
+	_prefilter->SetUniform("u_Threshold", Threshold);
+	_prefilter->SetUniform("u_Knee", glm::max(Knee * Threshold, 0.0001f));
+	_RenderPass(_prefilter, pool.GetFramebuffer(chain.back()));
+
+	// Downsample into smaller and smaller levels, each level spreads the glow further
+	_downsample->SetUniform("s_Source", 0);
+	for (int ix = 1; ix < Iterations && width > 2 && height > 2; ix++) {
+		width /= 2;
+		height /= 2;
+		chain.back()->Bind(0);
+		chain.push_back(pool.Acquire(width, height, chainFormat));
+		_RenderPass(_downsample, pool.GetFramebuffer(chain.back()));
+	}
+
+	// Upsample back up the chain, adding each level into the one above it
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_ONE, GL_ONE);
+	_upsample->SetUniform("s_Source", 0);
+	_upsample->SetUniform("u_Radius", Radius);
+	for (size_t ix = chain.size() - 1; ix > 0; ix--) {
+		chain[ix]->Bind(0);
+		_RenderPass(_upsample, pool.GetFramebuffer(chain[ix - 1]));
+	}
+	glDisable(GL_BLEND);
+
+	// Add the bloom to the original image
+	input->Bind(0);
+	chain[0]->Bind(1);
+	_composite->SetUniform("s_Source", 0);
+	_composite->SetUniform("s_Bloom", 1);
+	_composite->SetUniform("u_Intensity", Intensity);
+	_RenderPass(_composite, output);
+
+	for (const auto& level : chain) {
+		pool.Release(level);
+	}
+}
+
+void BloomEffect::RenderImGui()
+{
+	ImGui::DragFloat("Bloom Threshold", &Threshold, 0.01f, 0.0f, 10.0f);
+	ImGui::SliderFloat("Bloom Knee", &Knee, 0.0f, 1.0f);
+	ImGui::SliderFloat("Bloom Intensity", &Intensity, 0.0f, 4.0f);
+	ImGui::SliderFloat("Bloom Radius", &Radius, 0.5f, 4.0f);
+	ImGui::SliderInt("Bloom Iterations", &Iterations, 1, 10);
+}
+
+//////////////////////////////////////////// Tone Mapping ////////////////////////////////////////////
+
+ToneMapEffect::ToneMapEffect() :
+	PostEffect("Tone Mapping"),
+	Exposure(1.0f),
+	Gamma(1.0f),
+	Operator(ToneMapOperator::ACES)
+{
+	_shader = _LoadShader("shaders/post/tonemap.frag.glsl");
+}
+
+InternalFormat ToneMapEffect::GetOutputFormat(InternalFormat inputFormat) const
+{
+	// After tone mapping everything is in the 0-1 range, so 8 bits per channel is enough
+	return InternalFormat::RGBA8;
+}
+
+void ToneMapEffect::Apply(const Texture2D::sptr& input, const Framebuffer::sptr& output, RenderTargetPool& pool)
+{
+	input->Bind(0);
+	_shader->SetUniform("s_Source", 0);
+	_shader->SetUniform("u_Exposure", Exposure);
+	_shader->SetUniform("u_Gamma", Gamma);
+	_shader->SetUniform("u_Operator", *Operator);
+	_RenderPass(_shader, output);
+}
+
+void ToneMapEffect::RenderImGui()
+{
+	ImGui::DragFloat("Exposure", &Exposure, 0.01f, 0.0f, 10.0f);
+	ImGui::DragFloat("Gamma", &Gamma, 0.01f, 0.5f, 3.0f);
+	const char* operators[] = { "Clamp", "Reinhard", "ACES" };
+	int op = *Operator;
+	if (ImGui::Combo("Operator", &op, operators, 3)) {
+		Operator = (ToneMapOperator)op;
+	}
+}
+
+//////////////////////////////////////////// FXAA ////////////////////////////////////////////
+
+FxaaEffect::FxaaEffect() :
+	PostEffect("FXAA"),
+	EdgeThreshold(0.125f),
+	EdgeThresholdMin(0.0312f),
+	Subpixel(0.75f)
+{
+	_shader = _LoadShader("shaders/post/fxaa.frag.glsl");
+}
+
+void FxaaEffect::Apply(const Texture2D::sptr& input, const Framebuffer::sptr& output, RenderTargetPool& pool)
+{
+	input->Bind(0);
+	_shader->SetUniform("s_Source", 0);
+	_shader->SetUniform("u_EdgeThreshold", EdgeThreshold);
+	_shader->SetUniform("u_EdgeThresholdMin", EdgeThresholdMin);
+	_shader->SetUniform("u_Subpixel", Subpixel);
+	_RenderPass(_shader, output);
+}
+
+void FxaaEffect::RenderImGui()
+{
+	ImGui::SliderFloat("Edge Threshold", &EdgeThreshold, 0.063f, 0.333f);
+	ImGui::SliderFloat("Edge Threshold Min", &EdgeThresholdMin, 0.0f, 0.0833f);
+	ImGui::SliderFloat("Subpixel", &Subpixel, 0.0f, 1.0f);
+}
+
+//////////////////////////////////////////// Chain ////////////////////////////////////////////
+
+RenderGraphHandle PostProcessChain::AddToGraph(RenderGraph& graph, RenderGraphHandle input)
+{
+	RenderGraphHandle current = input;
+	for (const auto& effect : Effects) {
+		if (!effect->Enabled) {
+			continue;
+		}
+		RenderGraphTextureDesc desc = graph.GetTextureDesc(current);
+		desc.Format = effect->GetOutputFormat(desc.Format);
+
+		RenderGraphHandle source = current;
+		PostEffect::sptr pass = effect;
+		graph.AddPass(effect->Name, [&](RenderGraphBuilder& builder) {
+			builder.Read(source);
+			current = builder.Write(builder.CreateTexture(effect->Name, desc));
+		}, [=](RenderGraphContext& context) {
+			// Post effects draw over the whole screen, so depth testing and culling would only get in the way
+			glDisable(GL_DEPTH_TEST);
+			glDisable(GL_CULL_FACE);
+			glDepthMask(GL_FALSE);
+			pass->Apply(context.GetTexture(source), context.GetTarget(), context.GetPool());
+		});
+	}
+	return current;
+}
+
+void PostProcessChain::RenderImGui()
+{
+	for (const auto& effect : Effects) {
+		ImGui::PushID(effect.get());
+		ImGui::Checkbox(effect->Name.c_str(), &effect->Enabled);
+		if (effect->Enabled) {
+			ImGui::Indent();
+			effect->RenderImGui();
+			ImGui::Unindent();
+		}
+		ImGui::PopID();
+	}
+}
\ No newline at end of file
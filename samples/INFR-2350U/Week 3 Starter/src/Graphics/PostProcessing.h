@@ -0,0 +1,155 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <Texture2D.h>
+#include <Shader.h>
+
+#include "Framebuffer.h"
+#include "RenderTargetPool.h"
+#include "RenderGraph.h"
+
+//Base class for a single effect in a post processing chain
+class PostEffect
+{
+public:
+	typedef std::shared_ptr<PostEffect> sptr;
+
+	PostEffect(const std::string& name) : Name(name), Enabled(true) { }
+	virtual ~PostEffect() = default;
+
+	std::string Name;
+	bool        Enabled;
+
+	//Gets the format the effect outputs, given the format of it's input
+	virtual InternalFormat GetOutputFormat(InternalFormat inputFormat) const { return inputFormat; }
+	//Applies the effect to the input texture, rendering the result into the output
+	//*The output is the same size as the input, and has the format from GetOutputFormat
+	//*Effects can acquire scratch targets from the pool, but should release them before returning
+	virtual void Apply(const Texture2D::sptr& input, const Framebuffer::sptr& output, RenderTargetPool& pool) = 0;
+	//Draws ImGui controls for the effect's settings
+	virtual void RenderImGui() { }
+
+protected:
+	//Loads a shader for a fullscreen pass from the given fragment shader
+	static Shader::sptr _LoadShader(const char* fragmentPath);
+	//Runs the shader over every pixel of the target
+	static void _RenderPass(const Shader::sptr& shader, const Framebuffer::sptr& target);
+};
+
+//Adds a glow around bright parts of the image
+//*Bright pixels are extracted into a half resolution target, downsampled into a chain of smaller targets,
+// and then upsampled back up, adding each level into the one above it. The mip chain is acquired from the
+// pool and released before the effect returns
+class BloomEffect : public PostEffect
+{
+public:
+	typedef std::shared_ptr<BloomEffect> sptr;
+
+	BloomEffect();
+	virtual ~BloomEffect() = default;
+
+	//Pixels brighter than this will start to bloom
+	float Threshold;
+	//How gradually pixels near the threshold fade in, as a fraction of the threshold
+	float Knee;
+	//How strongly the bloom is added to the image
+	float Intensity;
+	//The size of the upsample filter, in texels
+	float Radius;
+	//The maximum number of levels in the mip chain
+	int   Iterations;
+
+	void Apply(const Texture2D::sptr& input, const Framebuffer::sptr& output, RenderTargetPool& pool) override;
+	void RenderImGui() override;
+
+protected:
+	Shader::sptr _prefilter;
+	Shader::sptr _downsample;
+	Shader::sptr _upsample;
+	Shader::sptr _composite;
+};
+
+//The curves we can use to map HDR colors into the displayable range
+ENUM(ToneMapOperator, int,
+	Clamp    = 0,
+	Reinhard = 1,
+	ACES     = 2
+);
+
+//Converts an HDR image into a displayable (LDR) image
+class ToneMapEffect : public PostEffect
+{
+public:
+	typedef std::shared_ptr<ToneMapEffect> sptr;
+
+	ToneMapEffect();
+	virtual ~ToneMapEffect() = default;
+
+	//Scales the colors before tone mapping
+	float           Exposure;
+	//The gamma to encode the output with, 1 leaves the output linear
+	float           Gamma;
+	ToneMapOperator Operator;
+
+	InternalFormat GetOutputFormat(InternalFormat inputFormat) const override;
+	void Apply(const Texture2D::sptr& input, const Framebuffer::sptr& output, RenderTargetPool& pool) override;
+	void RenderImGui() override;
+
+protected:
+	Shader::sptr _shader;
+};
+
+//Fast approximate anti-aliasing, smooths out jagged edges by blending along them
+//*Should run after tone mapping, since it detects edges from the displayed brightness
+class FxaaEffect : public PostEffect
+{
+public:
+	typedef std::shared_ptr<FxaaEffect> sptr;
+
+	FxaaEffect();
+	virtual ~FxaaEffect() = default;
+
+	//The minimum contrast needed for a pixel to count as an edge, relative to it's brightness
+	float EdgeThreshold;
+	//The minimum contrast needed for a pixel to count as an edge, this keeps dark areas from being processed
+	float EdgeThresholdMin;
+	//How much to blend pixels that are smaller than an edge (ex: thin lines), 0 disables this
+	float Subpixel;
+
+	void Apply(const Texture2D::sptr& input, const Framebuffer::sptr& output, RenderTargetPool& pool) override;
+	void RenderImGui() override;
+
+protected:
+	Shader::sptr _shader;
+};
+
+//Runs a list of effects over an image, passing the output of each effect into the next
+//*Each effect is added to a render graph as it's own pass, so the intermediate targets are transient textures
+// that share memory, and adding effects does not add render targets unless they need a new size or format
+class PostProcessChain
+{
+public:
+	typedef std::shared_ptr<PostProcessChain> sptr;
+	static inline sptr Create() {
+		return std::make_shared<PostProcessChain>();
+	}
+
+	PostProcessChain() = default;
+	~PostProcessChain() = default;
+
+	std::vector<PostEffect::sptr> Effects;
+
+	//Creates an effect and adds it to the end of the chain
+	template <typename EffectType, typename ... Args>
+	std::shared_ptr<EffectType> AddEffect(Args&&... args) {
+		std::shared_ptr<EffectType> result = std::make_shared<EffectType>(std::forward<Args>(args)...);
+		Effects.push_back(result);
+		return result;
+	}
+
+	//Adds a pass to the graph for each enabled effect, the first effect reads from the input
+	//*Returns the handle to the output of the last effect, or the input if no effects are enabled
+	RenderGraphHandle AddToGraph(RenderGraph& graph, RenderGraphHandle input);
+	//Draws ImGui controls for all the effects in the chain
+	void RenderImGui();
+};
\ No newline at end of file
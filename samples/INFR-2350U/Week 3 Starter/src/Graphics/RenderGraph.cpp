@@ -0,0 +1,613 @@
+#include "RenderGraph.h"
+
+#include <algorithm>
+#include <Logging.h>
+#include "imgui.h"
+
+//////////////////////////////////////////// Builder ////////////////////////////////////////////
+
+RenderGraphHandle RenderGraphBuilder::CreateTexture(const std::string& name, const RenderGraphTextureDesc& desc)
+{
+	LOG_ASSERT(desc.Width > 0 && desc.Height > 0, "Render graph textures must have a size greater than 0!");
+	RenderGraph::Resource resource;
+	resource.Name = name;
+	resource.Type = RenderGraph::ResourceType::Texture;
+	resource.TextureDesc = desc;
+	return _graph->_AddResource(resource);
+}
+
+RenderGraphHandle RenderGraphBuilder::CreateBuffer(const std::string& name, size_t size)
+{
+	LOG_ASSERT(size > 0, "Render graph buffers must have a size greater than 0!");
+	RenderGraph::Resource resource;
+	resource.Name = name;
+	resource.Type = RenderGraph::ResourceType::Buffer;
+	resource.BufferSize = size;
+	return _graph->_AddResource(resource);
+}
+
+RenderGraphHandle RenderGraphBuilder::Read(RenderGraphHandle handle, RenderGraphUsage usage)
+{
+	LOG_ASSERT(handle.IsValid() && handle.Index < (int)_graph->_nodes.size(), "Invalid render graph handle!");
+	_graph->_passes[_pass].Reads.push_back({ handle.Index, usage });
+	return handle;
+}
+
+RenderGraphHandle RenderGraphBuilder::Write(RenderGraphHandle handle, RenderGraphUsage usage)
+{
+	LOG_ASSERT(handle.IsValid() && handle.Index < (int)_graph->_nodes.size(), "Invalid render graph handle!");
+	RenderGraph::Node& previous = _graph->_nodes[handle.Index];
+	RenderGraph::Resource& resource = _graph->_resources[previous.Resource];
+	// Writing to an old version would fork the resource's history, which we have no way to represent
+	LOG_ASSERT(resource.LatestNode == handle.Index, "Writing to an old version of {}, use the handle returned by the last write!", resource.Name);
+	LOG_ASSERT(resource.Type != RenderGraph::ResourceType::Backbuffer || usage == RenderGraphUsage::ColorAttachment || usage == RenderGraphUsage::Transfer,
+		"The backbuffer can only be written as a color attachment or by a blit!");
+
+	RenderGraph::Node node;
+	node.Resource = previous.Resource;
+	node.Version = previous.Version + 1;
+	node.Producer = _pass;
+	node.Previous = handle.Index;
+	_graph->_nodes.push_back(node);
+
+	RenderGraphHandle result;
+	result.Index = (int)_graph->_nodes.size() - 1;
+	resource.LatestNode = result.Index;
+	_graph->_passes[_pass].Writes.push_back({ result.Index, usage });
+	return result;
+}
+
+void RenderGraphBuilder::SideEffect()
+{
+	_graph->_passes[_pass].HasSideEffect = true;
+}
+
+//////////////////////////////////////////// Context ////////////////////////////////////////////
+
+Texture2D::sptr RenderGraphContext::GetTexture(RenderGraphHandle handle) const
+{
+	const RenderGraph::Resource& resource = _graph->_GetResource(handle);
+	switch (resource.Type) {
+		case RenderGraph::ResourceType::Texture:
+			LOG_ASSERT(resource.Texture != nullptr, "{} is not alive during {}, is it declared by the pass?", resource.Name, _graph->_passes[_pass].Name);
+			return resource.Texture;
+		case RenderGraph::ResourceType::Framebuffer:
+			return resource.Target->GetColorTexture(0);
+		default:
+			LOG_ASSERT(false, "{} is not a texture!", resource.Name);
+			return nullptr;
+	}
+}
+
+Framebuffer::sptr RenderGraphContext::GetFramebuffer(RenderGraphHandle handle) const
+{
+	const RenderGraph::Resource& resource = _graph->_GetResource(handle);
+	switch (resource.Type) {
+		case RenderGraph::ResourceType::Texture:
+			LOG_ASSERT(!resource.Imported, "Can not get a framebuffer for imported texture {}", resource.Name);
+			LOG_ASSERT(resource.Texture != nullptr, "{} is not alive during {}, is it declared by the pass?", resource.Name, _graph->_passes[_pass].Name);
+			return _graph->_pool.GetFramebuffer(resource.Texture);
+		case RenderGraph::ResourceType::Framebuffer:
+			return resource.Target;
+		default:
+			LOG_ASSERT(false, "{} is not a texture or framebuffer!", resource.Name);
+			return nullptr;
+	}
+}
+
+GLuint RenderGraphContext::GetBuffer(RenderGraphHandle handle) const
+{
+	const RenderGraph::Resource& resource = _graph->_GetResource(handle);
+	LOG_ASSERT(resource.Type == RenderGraph::ResourceType::Buffer, "{} is not a buffer!", resource.Name);
+	LOG_ASSERT(resource.Buffer != 0, "{} is not alive during {}, is it declared by the pass?", resource.Name, _graph->_passes[_pass].Name);
+	return resource.Buffer;
+}
+
+const Framebuffer::sptr& RenderGraphContext::GetTarget() const
+{
+	return _graph->_passes[_pass].Target;
+}
+
+RenderTargetPool& RenderGraphContext::GetPool() const
+{
+	return _graph->_pool;
+}
+
+//////////////////////////////////////////// Graph ////////////////////////////////////////////
+
+RenderGraph::RenderGraph(RenderTargetPool& pool) :
+	_pool(pool)
+{
+}
+
+RenderGraph::~RenderGraph()
+{
+	for (const CachedBuffer& buffer : _bufferCache) {
+		glDeleteBuffers(1, &buffer.Handle);
+	}
+}
+
+void RenderGraph::Reset()
+{
+	_resources.clear();
+	_nodes.clear();
+	_passes.clear();
+	_order.clear();
+	_isCompiled = false;
+}
+
+RenderGraphHandle RenderGraph::ImportTexture(const std::string& name, const Texture2D::sptr& texture)
+{
+	LOG_ASSERT(texture != nullptr, "Can not import a null texture!");
+	Resource resource;
+	resource.Name = name;
+	resource.Type = ResourceType::Texture;
+	resource.Imported = true;
+	resource.Texture = texture;
+	resource.TextureDesc.Width = texture->GetWidth();
+	resource.TextureDesc.Height = texture->GetHeight();
+	resource.TextureDesc.Format = texture->GetFormat();
+	return _AddResource(resource);
+}
+
+RenderGraphHandle RenderGraph::ImportFramebuffer(const std::string& name, const Framebuffer::sptr& framebuffer)
+{
+	LOG_ASSERT(framebuffer != nullptr, "Can not import a null framebuffer!");
+	Resource resource;
+	resource.Name = name;
+	resource.Type = ResourceType::Framebuffer;
+	resource.Imported = true;
+	resource.Target = framebuffer;
+	resource.TextureDesc.Width = framebuffer->GetWidth();
+	resource.TextureDesc.Height = framebuffer->GetHeight();
+	if (framebuffer->GetColorTargetCount() > 0) {
+		resource.TextureDesc.Format = framebuffer->GetColorTexture(0)->GetFormat();
+	}
+	return _AddResource(resource);
+}
+
+RenderGraphHandle RenderGraph::ImportBackbuffer(const std::string& name, unsigned width, unsigned height)
+{
+	Resource resource;
+	resource.Name = name;
+	resource.Type = ResourceType::Backbuffer;
+	resource.Imported = true;
+	resource.TextureDesc.Width = width;
+	resource.TextureDesc.Height = height;
+	_backbufferWidth = width;
+	_backbufferHeight = height;
+	return _AddResource(resource);
+}
+
+RenderGraphHandle RenderGraph::ImportBuffer(const std::string& name, GLuint buffer, size_t size)
+{
+	LOG_ASSERT(buffer != 0, "Can not import a null buffer!");
+	Resource resource;
+	resource.Name = name;
+	resource.Type = ResourceType::Buffer;
+	resource.Imported = true;
+	resource.Buffer = buffer;
+	resource.BufferSize = size;
+	return _AddResource(resource);
+}
+
+void RenderGraph::AddPass(const std::string& name, const SetupFunc& setup, const ExecuteFunc& execute)
+{
+	LOG_ASSERT(!_isCompiled, "Can not add passes to a graph that has been compiled, call Reset first!");
+	Pass pass;
+	pass.Name = name;
+	pass.Execute = execute;
+	_passes.push_back(pass);
+
+	RenderGraphBuilder builder(this, (int)_passes.size() - 1);
+	setup(builder);
+}
+
+RenderGraphTextureDesc RenderGraph::GetTextureDesc(RenderGraphHandle handle) const
+{
+	const Resource& resource = _GetResource(handle);
+	LOG_ASSERT(resource.Type != ResourceType::Buffer, "{} is not a texture!", resource.Name);
+	return resource.TextureDesc;
+}
+
+void RenderGraph::Compile()
+{
+	LOG_ASSERT(!_isCompiled, "Render graph has already been compiled!");
+
+	// Culling: walk back from every pass whose results can be seen outside of the graph, anything we don't reach
+	// can't affect the frame
+	std::vector<bool> needed(_passes.size(), false);
+	std::vector<int> stack;
+	for (int ix = 0; ix < (int)_passes.size(); ix++) {
+		bool isRoot = _passes[ix].HasSideEffect;
+		for (const Access& write : _passes[ix].Writes) {
+			isRoot |= _resources[_nodes[write.Node].Resource].Imported;
+		}
+		if (isRoot) {
+			stack.push_back(ix);
+		}
+	}
+	while (!stack.empty()) {
+		int pass = stack.back();
+		stack.pop_back();
+		if (needed[pass]) {
+			continue;
+		}
+		needed[pass] = true;
+		for (const Access& read : _passes[pass].Reads) {
+			if (_nodes[read.Node].Producer >= 0) {
+				stack.push_back(_nodes[read.Node].Producer);
+			}
+		}
+		// Writes only touch part of a resource (ex: blending, or drawing over what is already there), so the
+		// pass that produced the previous version is needed as well
+		for (const Access& write : _passes[pass].Writes) {
+			int previous = _nodes[write.Node].Previous;
+			if (previous >= 0 && _nodes[previous].Producer >= 0) {
+				stack.push_back(_nodes[previous].Producer);
+			}
+		}
+	}
+
+	// Ordering: passes can only use handles from passes added before them, so the order they were added in
+	// already has every producer before it's readers, and every reader before the next write
+	_order.clear();
+	for (int ix = 0; ix < (int)_passes.size(); ix++) {
+		_passes[ix].Culled = !needed[ix];
+		if (needed[ix]) {
+			_order.push_back(ix);
+		}
+	}
+
+	// Lifetimes: find the first and last pass that touches each resource
+	for (Resource& resource : _resources) {
+		resource.FirstUse = resource.LastUse = -1;
+	}
+	for (int ix = 0; ix < (int)_order.size(); ix++) {
+		Pass& pass = _passes[_order[ix]];
+		pass.Acquires.clear();
+		pass.Releases.clear();
+		for (const std::vector<Access>* accesses : { &pass.Reads, &pass.Writes }) {
+			for (const Access& access : *accesses) {
+				Resource& resource = _resources[_nodes[access.Node].Resource];
+				if (resource.FirstUse < 0) {
+					resource.FirstUse = ix;
+					if (!resource.Imported && _nodes[access.Node].Version == 0 && access.Usage != RenderGraphUsage::ColorAttachment && access.Usage != RenderGraphUsage::DepthAttachment) {
+						LOG_WARN("{} reads {} before anything has written to it", pass.Name, resource.Name);
+					}
+				}
+				resource.LastUse = ix;
+			}
+		}
+	}
+	size_t aliveBytes = 0;
+	_peakTransientBytes = 0;
+	for (int ix = 0; ix < (int)_order.size(); ix++) {
+		for (int res = 0; res < (int)_resources.size(); res++) {
+			const Resource& resource = _resources[res];
+			if (resource.Imported || resource.FirstUse < 0) {
+				continue;
+			}
+			const size_t bytes = resource.Type == ResourceType::Texture ?
+				(size_t)resource.TextureDesc.Width * resource.TextureDesc.Height * GetInternalFormatSize(resource.TextureDesc.Format) : 0;
+			if (resource.FirstUse == ix) {
+				_passes[_order[ix]].Acquires.push_back(res);
+				aliveBytes += bytes;
+			}
+			if (resource.LastUse == ix) {
+				_passes[_order[ix]].Releases.push_back(res);
+			}
+		}
+		_peakTransientBytes = glm::max(_peakTransientBytes, aliveBytes);
+		for (int res : _passes[_order[ix]].Releases) {
+			const Resource& resource = _resources[res];
+			if (resource.Type == ResourceType::Texture) {
+				aliveBytes -= (size_t)resource.TextureDesc.Width * resource.TextureDesc.Height * GetInternalFormatSize(resource.TextureDesc.Format);
+			}
+		}
+	}
+
+	// Barriers: rendering, blits and copies are synchronized by OpenGL for us, only image and storage buffer stores
+	// need a memory barrier before they can be seen. glMemoryBarrier covers every resource, so once a bit has been
+	// issued it doesn't need to be issued again until there are more stores
+	std::vector<bool> hasStores(_resources.size(), false);
+	std::vector<GLbitfield> flushed(_resources.size(), 0);
+	std::vector<bool> needsResolve(_resources.size(), false);
+	for (int ix = 0; ix < (int)_order.size(); ix++) {
+		Pass& pass = _passes[_order[ix]];
+		pass.Barriers = 0;
+		pass.Resolves.clear();
+		for (const std::vector<Access>* accesses : { &pass.Reads, &pass.Writes }) {
+			for (const Access& access : *accesses) {
+				int res = _nodes[access.Node].Resource;
+				if (hasStores[res]) {
+					pass.Barriers |= _GetBarrierBits(access.Usage) & ~flushed[res];
+				}
+			}
+		}
+		if (pass.Barriers != 0) {
+			for (int res = 0; res < (int)_resources.size(); res++) {
+				flushed[res] |= hasStores[res] ? pass.Barriers : 0;
+			}
+		}
+		// Multisampled framebuffers need to be resolved before they can be sampled or blitted, but we only need
+		// to do it once after the last time they were rendered to
+		for (const Access& read : pass.Reads) {
+			int res = _nodes[read.Node].Resource;
+			if (needsResolve[res] && read.Usage != RenderGraphUsage::ColorAttachment && read.Usage != RenderGraphUsage::DepthAttachment) {
+				pass.Resolves.push_back(res);
+				needsResolve[res] = false;
+			}
+		}
+		for (const Access& write : pass.Writes) {
+			int res = _nodes[write.Node].Resource;
+			hasStores[res] = _IsStorageWrite(write.Usage);
+			flushed[res] = 0;
+			if (_resources[res].Type == ResourceType::Framebuffer && _resources[res].Target->IsMultisampled()) {
+				needsResolve[res] = true;
+			}
+		}
+	}
+
+	_isCompiled = true;
+}
+
+void RenderGraph::Execute()
+{
+	LOG_ASSERT(_isCompiled, "Render graph must be compiled before it is executed!");
+
+	for (int passIx : _order) {
+		Pass& pass = _passes[passIx];
+
+		for (int res : pass.Acquires) {
+			Resource& resource = _resources[res];
+			if (resource.Type == ResourceType::Texture) {
+				resource.Texture = _pool.Acquire(resource.TextureDesc.Width, resource.TextureDesc.Height, resource.TextureDesc.Format);
+			} else if (resource.Type == ResourceType::Buffer) {
+				resource.Buffer = _AcquireBuffer(resource.BufferSize);
+			}
+		}
+		for (int res : pass.Resolves) {
+			_resources[res].Target->Resolve();
+		}
+		if (pass.Barriers != 0) {
+			glMemoryBarrier(pass.Barriers);
+		}
+
+		_ResolveTarget(pass);
+		if (pass.Target != nullptr) {
+			pass.Target->Bind();
+		} else if (pass.RendersToBackbuffer) {
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			glViewport(0, 0, _backbufferWidth, _backbufferHeight);
+		}
+
+		RenderGraphContext context(this, passIx);
+		pass.Execute(context);
+
+		for (int res : pass.Releases) {
+			Resource& resource = _resources[res];
+			if (resource.Type == ResourceType::Texture) {
+				_pool.Release(resource.Texture);
+				resource.Texture = nullptr;
+			} else if (resource.Type == ResourceType::Buffer) {
+				_ReleaseBuffer(resource.Buffer);
+				resource.Buffer = 0;
+			}
+		}
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	// Drop any framebuffers and buffers we haven't needed in a while, the textures in the cached framebuffers
+	// are kept alive until then, even if the pool has let go of them
+	for (auto it = _targetCache.begin(); it != _targetCache.end(); ) {
+		it = _frame - it->LastUsedFrame > 3 ? _targetCache.erase(it) : it + 1;
+	}
+	for (auto it = _bufferCache.begin(); it != _bufferCache.end(); ) {
+		if (!it->InUse && _frame - it->LastUsedFrame > 3) {
+			glDeleteBuffers(1, &it->Handle);
+			it = _bufferCache.erase(it);
+		} else {
+			++it;
+		}
+	}
+	_frame++;
+}
+
+size_t RenderGraph::GetCulledPassCount() const
+{
+	size_t result = 0;
+	for (const Pass& pass : _passes) {
+		result += pass.Culled ? 1 : 0;
+	}
+	return result;
+}
+
+size_t RenderGraph::GetBarrierCount() const
+{
+	size_t result = 0;
+	for (const Pass& pass : _passes) {
+		result += (pass.Barriers != 0 ? 1 : 0) + pass.Resolves.size();
+	}
+	return result;
+}
+
+size_t RenderGraph::GetTransientBytes() const
+{
+	size_t result = 0;
+	for (const Resource& resource : _resources) {
+		if (!resource.Imported && resource.FirstUse >= 0 && resource.Type == ResourceType::Texture) {
+			result += (size_t)resource.TextureDesc.Width * resource.TextureDesc.Height * GetInternalFormatSize(resource.TextureDesc.Format);
+		}
+	}
+	return result;
+}
+
+size_t RenderGraph::GetPeakTransientBytes() const
+{
+	return _peakTransientBytes;
+}
+
+void RenderGraph::RenderImGui()
+{
+	ImGui::Text("Passes: %zu (%zu culled), barriers: %zu", GetPassCount(), GetCulledPassCount(), GetBarrierCount());
+	ImGui::Text("Transient textures: %.1f MB, peak alive: %.1f MB", GetTransientBytes() / (1024.0f * 1024.0f), GetPeakTransientBytes() / (1024.0f * 1024.0f));
+	for (const Pass& pass : _passes) {
+		if (pass.Culled) {
+			ImGui::TextDisabled("  %s (culled)", pass.Name.c_str());
+			continue;
+		}
+		ImGui::Text("  %s", pass.Name.c_str());
+		for (const Access& read : pass.Reads) {
+			ImGui::TextDisabled("    reads %s v%d (%s)", _resources[_nodes[read.Node].Resource].Name.c_str(), _nodes[read.Node].Version, (~read.Usage).c_str());
+		}
+		for (const Access& write : pass.Writes) {
+			ImGui::TextDisabled("    writes %s v%d (%s)", _resources[_nodes[write.Node].Resource].Name.c_str(), _nodes[write.Node].Version, (~write.Usage).c_str());
+		}
+	}
+}
+
+RenderGraphHandle RenderGraph::_AddResource(const Resource& resource)
+{
+	_resources.push_back(resource);
+
+	Node node;
+	node.Resource = (int)_resources.size() - 1;
+	node.Version = 0;
+	_nodes.push_back(node);
+
+	RenderGraphHandle result;
+	result.Index = (int)_nodes.size() - 1;
+	_resources.back().LatestNode = result.Index;
+	return result;
+}
+
+const RenderGraph::Resource& RenderGraph::_GetResource(RenderGraphHandle handle) const
+{
+	LOG_ASSERT(handle.IsValid() && handle.Index < (int)_nodes.size(), "Invalid render graph handle!");
+	return _resources[_nodes[handle.Index].Resource];
+}
+
+void RenderGraph::_ResolveTarget(Pass& pass)
+{
+	pass.Target = nullptr;
+	pass.RendersToBackbuffer = false;
+
+	std::vector<Texture2D::sptr> colors;
+	Texture2D::sptr depth = nullptr;
+	bool hasImportedTexture = false;
+	for (const std::vector<Access>* accesses : { &pass.Reads, &pass.Writes }) {
+		for (const Access& access : *accesses) {
+			if (access.Usage != RenderGraphUsage::ColorAttachment && access.Usage != RenderGraphUsage::DepthAttachment) {
+				continue;
+			}
+			const Resource& resource = _resources[_nodes[access.Node].Resource];
+			switch (resource.Type) {
+				case ResourceType::Backbuffer:
+					pass.RendersToBackbuffer = true;
+					break;
+				case ResourceType::Framebuffer:
+					LOG_ASSERT(pass.Target == nullptr || pass.Target == resource.Target, "{} renders to more than one imported framebuffer!", pass.Name);
+					pass.Target = resource.Target;
+					break;
+				case ResourceType::Texture:
+					hasImportedTexture |= resource.Imported;
+					if (access.Usage == RenderGraphUsage::DepthAttachment) {
+						depth = resource.Texture;
+					} else if (std::find(colors.begin(), colors.end(), resource.Texture) == colors.end()) {
+						colors.push_back(resource.Texture);
+					}
+					break;
+				default:
+					break;
+			}
+		}
+	}
+	LOG_ASSERT((int)pass.RendersToBackbuffer + (int)(pass.Target != nullptr) + (int)(!colors.empty() || depth != nullptr) <= 1,
+		"{} mixes attachments from the backbuffer, imported framebuffers and graph textures!", pass.Name);
+
+	if (colors.empty() && depth == nullptr) {
+		return;
+	}
+	// The common case of a single pooled color target is already cached by the pool
+	if (colors.size() == 1 && depth == nullptr && !hasImportedTexture) {
+		pass.Target = _pool.GetFramebuffer(colors[0]);
+		return;
+	}
+	for (CachedTarget& cached : _targetCache) {
+		if (cached.Colors == colors && cached.Depth == depth) {
+			cached.LastUsedFrame = _frame;
+			pass.Target = cached.Target;
+			return;
+		}
+	}
+
+	const Texture2D::sptr& sizeSource = colors.empty() ? depth : colors[0];
+	CachedTarget cached;
+	cached.Colors = colors;
+	cached.Depth = depth;
+	cached.LastUsedFrame = _frame;
+	cached.Target = Framebuffer::Create();
+	cached.Target->Init(sizeSource->GetWidth(), sizeSource->GetHeight());
+	for (const Texture2D::sptr& color : colors) {
+		cached.Target->AttachColorTexture(color);
+	}
+	if (depth != nullptr) {
+		cached.Target->AttachDepthTexture(depth);
+	}
+	cached.Target->CheckFBO();
+	_targetCache.push_back(cached);
+	pass.Target = cached.Target;
+}
+
+GLuint RenderGraph::_AcquireBuffer(size_t size)
+{
+	// Re-use a free buffer if it's big enough without wasting more than half of it
+	for (CachedBuffer& buffer : _bufferCache) {
+		if (!buffer.InUse && buffer.Size >= size && buffer.Size <= size * 2) {
+			buffer.InUse = true;
+			buffer.LastUsedFrame = _frame;
+			return buffer.Handle;
+		}
+	}
+	CachedBuffer buffer;
+	glCreateBuffers(1, &buffer.Handle);
+	glNamedBufferStorage(buffer.Handle, size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+	buffer.Size = size;
+	buffer.InUse = true;
+	buffer.LastUsedFrame = _frame;
+	_bufferCache.push_back(buffer);
+	return buffer.Handle;
+}
+
+void RenderGraph::_ReleaseBuffer(GLuint handle)
+{
+	for (CachedBuffer& buffer : _bufferCache) {
+		if (buffer.Handle == handle) {
+			buffer.InUse = false;
+			return;
+		}
+	}
+	LOG_ASSERT(false, "Buffer was not acquired by this graph!");
+}
+
+GLbitfield RenderGraph::_GetBarrierBits(RenderGraphUsage usage)
+{
+	switch (usage) {
+		case RenderGraphUsage::Sampled:         return GL_TEXTURE_FETCH_BARRIER_BIT;
+		case RenderGraphUsage::ColorAttachment:
+		case RenderGraphUsage::DepthAttachment: return GL_FRAMEBUFFER_BARRIER_BIT;
+		case RenderGraphUsage::Image:           return GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+		case RenderGraphUsage::StorageBuffer:   return GL_SHADER_STORAGE_BARRIER_BIT;
+		case RenderGraphUsage::UniformBuffer:   return GL_UNIFORM_BARRIER_BIT;
+		case RenderGraphUsage::VertexBuffer:    return GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT;
+		case RenderGraphUsage::IndirectBuffer:  return GL_COMMAND_BARRIER_BIT;
+		case RenderGraphUsage::Transfer:        return GL_TEXTURE_UPDATE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT | GL_PIXEL_BUFFER_BARRIER_BIT;
+		default:                                return 0;
+	}
+}
+
+bool RenderGraph::_IsStorageWrite(RenderGraphUsage usage)
+{
+	return usage == RenderGraphUsage::Image || usage == RenderGraphUsage::StorageBuffer;
+}
\ No newline at end of file
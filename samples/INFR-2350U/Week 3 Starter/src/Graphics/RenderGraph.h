@@ -0,0 +1,276 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <functional>
+#include <EnumToString.h>
+#include <Texture2D.h>
+
+#include "Framebuffer.h"
+#include "RenderTargetPool.h"
+
+class RenderGraph;
+class RenderGraphBuilder;
+class RenderGraphContext;
+
+//How a pass uses a resource, this decides which barriers or resolves need to happen before the pass
+ENUM(RenderGraphUsage, int,
+	Sampled         = 0, //Read through a sampler (ex: texture(s_Source, uv))
+	ColorAttachment = 1, //Rendered to as a color target
+	DepthAttachment = 2, //Rendered to as the depth target
+	Image           = 3, //Read or written with imageLoad / imageStore
+	StorageBuffer   = 4, //Read or written as a shader storage buffer
+	UniformBuffer   = 5, //Read as a uniform buffer
+	VertexBuffer    = 6, //Read as vertex or index data
+	IndirectBuffer  = 7, //Read as the arguments for an indirect draw or dispatch
+	Transfer        = 8  //Read or written by a blit or copy
+);
+
+//A handle to a version of a resource in the graph
+//*Every write to a resource creates a new version, so a pass that reads a handle will always see the
+// results of the pass that produced that handle
+struct RenderGraphHandle
+{
+	int Index = -1;
+
+	bool IsValid() const { return Index >= 0; }
+	bool operator==(const RenderGraphHandle& other) const { return Index == other.Index; }
+	bool operator!=(const RenderGraphHandle& other) const { return Index != other.Index; }
+};
+
+//Describes a texture that the graph will create for us
+struct RenderGraphTextureDesc
+{
+	unsigned       Width  = 1;
+	unsigned       Height = 1;
+	InternalFormat Format = InternalFormat::RGBA8;
+};
+
+//Used by passes when they are added to the graph to declare which resources they read and write
+class RenderGraphBuilder
+{
+public:
+	//Declares a texture that only exists for this frame, the memory is shared with other textures that
+	//are not alive at the same time
+	//*The texture does not exist until a pass writes to it
+	RenderGraphHandle CreateTexture(const std::string& name, const RenderGraphTextureDesc& desc);
+	//Declares a buffer that only exists for this frame
+	//*The buffer does not exist until a pass writes to it
+	RenderGraphHandle CreateBuffer(const std::string& name, size_t size);
+
+	//Declares that the pass reads from the resource
+	RenderGraphHandle Read(RenderGraphHandle handle, RenderGraphUsage usage = RenderGraphUsage::Sampled);
+	//Declares that the pass writes to the resource
+	//*Returns the handle to the new version of the resource, later passes should read from that handle
+	RenderGraphHandle Write(RenderGraphHandle handle, RenderGraphUsage usage = RenderGraphUsage::ColorAttachment);
+
+	//Marks the pass as having effects outside of the graph (ex: drawing UI, reading back data), so it will never be culled
+	void SideEffect();
+
+protected:
+	friend class RenderGraph;
+	RenderGraphBuilder(RenderGraph* graph, int pass) : _graph(graph), _pass(pass) { }
+
+	RenderGraph* _graph;
+	int          _pass;
+};
+
+//Given to passes when they execute, lets them get the actual objects behind their handles
+class RenderGraphContext
+{
+public:
+	//Gets the texture behind a handle (for imported framebuffers, this is the first color target)
+	Texture2D::sptr GetTexture(RenderGraphHandle handle) const;
+	//Gets a framebuffer with the texture as it's only color target, or the imported framebuffer, useful for blits
+	Framebuffer::sptr GetFramebuffer(RenderGraphHandle handle) const;
+	//Gets the OpenGL handle for a buffer
+	GLuint GetBuffer(RenderGraphHandle handle) const;
+
+	//Gets the framebuffer the pass is rendering into, this is already bound when the pass executes
+	//*Will be nullptr if the pass has no attachments, or if it is rendering to the backbuffer
+	const Framebuffer::sptr& GetTarget() const;
+	//Gets the pool the graph allocates it's textures from, passes can use it for scratch targets that are
+	//only needed inside the pass
+	RenderTargetPool& GetPool() const;
+
+protected:
+	friend class RenderGraph;
+	RenderGraphContext(RenderGraph* graph, int pass) : _graph(graph), _pass(pass) { }
+
+	RenderGraph* _graph;
+	int          _pass;
+};
+
+//Orders, culls and allocates resources for the rendering work in a frame
+//*Each frame, passes are added with the resources they read and write, then the graph is compiled and executed:
+//  - Passes that don't contribute to an imported resource or a side effect are culled
+//  - Transient textures are acquired from the pool right before their first use and released right after
+//    their last, so textures that are never alive at the same time share memory
+//  - Memory barriers are only issued where a pass reads something that was written with image or storage
+//    buffer stores, and multisampled framebuffers are only resolved when something samples them
+class RenderGraph
+{
+public:
+	typedef std::shared_ptr<RenderGraph> sptr;
+	static inline sptr Create(RenderTargetPool& pool) {
+		return std::make_shared<RenderGraph>(pool);
+	}
+
+	typedef std::function<void(RenderGraphBuilder&)>  SetupFunc;
+	typedef std::function<void(RenderGraphContext&)> ExecuteFunc;
+
+	RenderGraph(RenderTargetPool& pool);
+	~RenderGraph();
+
+	//We'll disallow moving and copying, since we own OpenGL objects
+	RenderGraph(const RenderGraph& other) = delete;
+	RenderGraph(RenderGraph&& other) = delete;
+	RenderGraph& operator=(const RenderGraph& other) = delete;
+	RenderGraph& operator=(RenderGraph&& other) = delete;
+
+	//Removes all the passes and resources so that the next frame can be declared
+	//*Keeps the cached framebuffers and buffers around so they can be re-used
+	void Reset();
+
+	//Lets the graph use a texture that lives outside of the graph
+	RenderGraphHandle ImportTexture(const std::string& name, const Texture2D::sptr& texture);
+	//Lets the graph use a framebuffer that lives outside of the graph, ex: a multisampled scene target
+	//*Passes that write to the framebuffer render into it directly, and it will be resolved before anything samples it
+	RenderGraphHandle ImportFramebuffer(const std::string& name, const Framebuffer::sptr& framebuffer);
+	//Lets the graph render to the window
+	RenderGraphHandle ImportBackbuffer(const std::string& name, unsigned width, unsigned height);
+	//Lets the graph use a buffer that lives outside of the graph
+	RenderGraphHandle ImportBuffer(const std::string& name, GLuint buffer, size_t size);
+
+	//Adds a pass to the graph
+	//*setup is invoked right away to declare the resources the pass uses
+	//*execute is invoked when the graph is executed, if the pass has not been culled
+	void AddPass(const std::string& name, const SetupFunc& setup, const ExecuteFunc& execute);
+
+	//Gets the description of a texture, works for transient and imported textures and framebuffers
+	RenderGraphTextureDesc GetTextureDesc(RenderGraphHandle handle) const;
+
+	//Culls unused passes, works out resource lifetimes and the barriers needed between passes
+	void Compile();
+	//Runs all the passes that survived culling, in order
+	void Execute();
+
+	size_t GetPassCount() const { return _passes.size(); }
+	size_t GetCulledPassCount() const;
+	//Gets the number of barriers (memory barriers and resolves) issued by the last compile
+	size_t GetBarrierCount() const;
+	//Gets the number of bytes the transient textures would need if they did not share memory
+	size_t GetTransientBytes() const;
+	//Gets the most bytes of transient textures alive at any point in the frame
+	size_t GetPeakTransientBytes() const;
+
+	//Draws ImGui controls showing the passes and resources from the last compile
+	void RenderImGui();
+
+protected:
+	friend class RenderGraphBuilder;
+	friend class RenderGraphContext;
+
+	enum class ResourceType {
+		Texture,
+		Framebuffer,
+		Backbuffer,
+		Buffer
+	};
+
+	//An actual texture, framebuffer or buffer
+	struct Resource
+	{
+		std::string            Name;
+		ResourceType           Type;
+		bool                   Imported = false;
+		RenderGraphTextureDesc TextureDesc;
+		size_t                 BufferSize = 0;
+
+		Texture2D::sptr   Texture = nullptr;
+		Framebuffer::sptr Target = nullptr;
+		GLuint            Buffer = 0;
+
+		//The node for the newest version of the resource, only this version can be written to
+		int LatestNode = -1;
+		//The first and last passes (in execution order) that use the resource, -1 if nothing uses it
+		int FirstUse = -1;
+		int LastUse = -1;
+	};
+
+	//One version of a resource, every write creates a new one
+	struct Node
+	{
+		int Resource;
+		int Version;
+		//The pass that wrote this version, -1 for the initial version
+		int Producer = -1;
+		//The node for the previous version, -1 for the initial version
+		int Previous = -1;
+	};
+
+	struct Access
+	{
+		int              Node;
+		RenderGraphUsage Usage;
+	};
+
+	struct Pass
+	{
+		std::string         Name;
+		ExecuteFunc         Execute;
+		std::vector<Access> Reads;
+		std::vector<Access> Writes;
+		bool                HasSideEffect = false;
+		bool                Culled = false;
+
+		//Filled in by Compile
+		GLbitfield        Barriers = 0;
+		std::vector<int>  Resolves;
+		std::vector<int>  Acquires;
+		std::vector<int>  Releases;
+		Framebuffer::sptr Target = nullptr;
+		bool              RendersToBackbuffer = false;
+	};
+
+	//A framebuffer built from transient textures, kept around for as long as the pool keeps the textures
+	struct CachedTarget
+	{
+		std::vector<Texture2D::sptr> Colors;
+		Texture2D::sptr              Depth;
+		Framebuffer::sptr            Target;
+		uint32_t                     LastUsedFrame;
+	};
+
+	//A buffer for transient buffer resources
+	struct CachedBuffer
+	{
+		GLuint   Handle;
+		size_t   Size;
+		bool     InUse;
+		uint32_t LastUsedFrame;
+	};
+
+	RenderTargetPool&         _pool;
+	std::vector<Resource>     _resources;
+	std::vector<Node>         _nodes;
+	std::vector<Pass>         _passes;
+	std::vector<int>          _order;
+	std::vector<CachedTarget> _targetCache;
+	std::vector<CachedBuffer> _bufferCache;
+	unsigned                  _backbufferWidth = 0;
+	unsigned                  _backbufferHeight = 0;
+	size_t                    _peakTransientBytes = 0;
+	uint32_t                  _frame = 0;
+	bool                      _isCompiled = false;
+
+	RenderGraphHandle _AddResource(const Resource& resource);
+	const Resource& _GetResource(RenderGraphHandle handle) const;
+	//Finds the framebuffer a pass should render into, from the attachments it writes
+	void _ResolveTarget(Pass& pass);
+	GLuint _AcquireBuffer(size_t size);
+	void _ReleaseBuffer(GLuint buffer);
+	//Gets the barrier bits needed before reading a resource in the given way after it was written by a shader store
+	static GLbitfield _GetBarrierBits(RenderGraphUsage usage);
+	//Checks if writing a resource in the given way goes through shader stores, which need barriers before they are visible
+	static bool _IsStorageWrite(RenderGraphUsage usage);
+};
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "RenderTargetPool.h"
+
+#include <Logging.h>
+
+Texture2D::sptr RenderTargetPool::Acquire(unsigned width, unsigned height, InternalFormat format)
+{
+	// The pool only ever holds a handful of textures, so a linear search is plenty fast
+	for (Entry& entry : _entries) {
+		if (!entry.InUse &&
+			entry.Texture->GetWidth() == width &&
+			entry.Texture->GetHeight() == height &&
+			entry.Texture->GetFormat() == format)
+		{
+			entry.InUse = true;
+			entry.LastUsedFrame = _frame;
+			return entry.Texture;
+		}
+	}
+
+	Texture2DDescription desc;
+	desc.Width = width;
+	desc.Height = height;
+	desc.Format = format;
+	desc.GenerateMipMaps = false;
+	desc.MipLevels = 1;
+	desc.MinificationFilter = MinFilter::Linear;
+	desc.MagnificationFilter = MagFilter::Linear;
+	desc.HorizontalWrap = WrapMode::ClampToEdge;
+	desc.VerticalWrap = WrapMode::ClampToEdge;
+	desc.MaxAnisotropic = 1.0f;
+
+	Entry entry;
+	entry.Texture = Texture2D::Create(desc);
+	entry.Target = nullptr;
+	entry.Bytes = (size_t)width * height * GetInternalFormatSize(format);
+	entry.LastUsedFrame = _frame;
+	entry.InUse = true;
+	_entries.push_back(entry);
+
+	_peakBytes = glm::max(_peakBytes, GetAllocatedBytes());
+	return entry.Texture;
+}
+
+void RenderTargetPool::Release(const Texture2D::sptr& texture)
+{
+	Entry* entry = _Find(texture);
+	LOG_ASSERT(entry != nullptr, "Texture was not acquired from this pool!");
+	LOG_ASSERT(entry->InUse, "Texture has already been released!");
+	entry->InUse = false;
+}
+
+Framebuffer::sptr RenderTargetPool::GetFramebuffer(const Texture2D::sptr& texture)
+{
+	Entry* entry = _Find(texture);
+	LOG_ASSERT(entry != nullptr, "Texture was not acquired from this pool!");
+	if (entry->Target == nullptr) {
+		entry->Target = Framebuffer::Create();
+		entry->Target->Init(texture->GetWidth(), texture->GetHeight());
+		entry->Target->AttachColorTexture(texture);
+		entry->Target->CheckFBO();
+	}
+	return entry->Target;
+}
+
+void RenderTargetPool::EndFrame(unsigned maxUnusedFrames)
+{
+	for (auto it = _entries.begin(); it != _entries.end(); ) {
+		if (it->InUse) {
+			LOG_WARN("Render target was not released before the end of the frame");
+		}
+		if (!it->InUse && _frame - it->LastUsedFrame > maxUnusedFrames) {
+			it = _entries.erase(it);
+		} else {
+			++it;
+		}
+	}
+	_frame++;
+}
+
+void RenderTargetPool::Clear()
+{
+	_entries.clear();
+}
+
+size_t RenderTargetPool::GetInUseCount() const
+{
+	size_t result = 0;
+	for (const Entry& entry : _entries) {
+		result += entry.InUse ? 1 : 0;
+	}
+	return result;
+}
+
+size_t RenderTargetPool::GetAllocatedBytes() const
+{
+	size_t result = 0;
+	for (const Entry& entry : _entries) {
+		result += entry.Bytes;
+	}
+	return result;
+}
+
+RenderTargetPool::Entry* RenderTargetPool::_Find(const Texture2D::sptr& texture)
+{
+	for (Entry& entry : _entries) {
+		if (entry.Texture == texture) {
+			return &entry;
+		}
+	}
+	return nullptr;
+}
\ No newline at end of file
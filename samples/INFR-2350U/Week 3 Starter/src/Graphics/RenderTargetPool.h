@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include <Texture2D.h>
+
+#include "Framebuffer.h"
+
+//A pool of transient render targets, shared between passes that only need a texture for part of a frame
+//*Passes acquire a texture, render into it, and release it once the last pass reading it is done. Released
+// textures are handed to later passes asking for the same size and format, so effects alias each other's
+// memory instead of each owning their own targets
+//*Textures that go unused for a few frames (ex: after the window is resized) are freed at the end of a frame
+class RenderTargetPool
+{
+public:
+	typedef std::shared_ptr<RenderTargetPool> sptr;
+	static inline sptr Create() {
+		return std::make_shared<RenderTargetPool>();
+	}
+
+	RenderTargetPool() = default;
+	~RenderTargetPool() = default;
+
+	RenderTargetPool(const RenderTargetPool& other) = delete;
+	RenderTargetPool(RenderTargetPool&& other) = delete;
+	RenderTargetPool& operator=(const RenderTargetPool& other) = delete;
+	RenderTargetPool& operator=(RenderTargetPool&& other) = delete;
+
+	//Gets a texture with the given size and format that no other pass is using
+	//*The texture's contents are undefined, clear it or overwrite every pixel
+	Texture2D::sptr Acquire(unsigned width, unsigned height, InternalFormat format);
+	//Returns a texture to the pool so that later passes can reuse it
+	void Release(const Texture2D::sptr& texture);
+
+	//Gets a framebuffer that renders into the given pooled texture
+	//*The framebuffer is cached along with the texture, so this is cheap to call every frame
+	Framebuffer::sptr GetFramebuffer(const Texture2D::sptr& texture);
+
+	//Ends the frame, freeing any textures that have not been acquired within the last maxUnusedFrames frames
+	void EndFrame(unsigned maxUnusedFrames = 3);
+	//Frees all the textures in the pool, all textures should be released before calling this
+	void Clear();
+
+	//Gets the number of textures allocated by the pool
+	size_t GetTextureCount() const { return _entries.size(); }
+	//Gets the number of textures currently acquired
+	size_t GetInUseCount() const;
+	//Gets the approximate amount of video memory allocated by the pool, in bytes
+	size_t GetAllocatedBytes() const;
+	//Gets the largest number of bytes the pool has had allocated at once
+	size_t GetPeakBytes() const { return _peakBytes; }
+
+protected:
+	struct Entry {
+		Texture2D::sptr   Texture;
+		Framebuffer::sptr Target;
+		size_t            Bytes;
+		uint64_t          LastUsedFrame;
+		bool              InUse;
+	};
+
+	std::vector<Entry> _entries;
+	uint64_t _frame = 0;
+	size_t   _peakBytes = 0;
+
+	Entry* _Find(const Texture2D::sptr& texture);
+};
\ No newline at end of file
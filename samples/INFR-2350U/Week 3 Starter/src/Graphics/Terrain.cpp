@@ -0,0 +1,643 @@
+#include "Terrain.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cfloat>
+#include <GLM/gtc/matrix_transform.hpp>
+#include <FrustumCuller.h>
+#include <VertexTypes.h>
+#include <Logging.h>
+#include "imgui.h"
+
+//Bumped whenever the layout of the pack file changes
+static const uint32_t PackVersion = 1;
+//Past this the node table alone gets too big to keep around
+static const uint32_t MaxLevels = 10;
+
+Terrain::Terrain(const std::string& path, uint32_t maxResidentChunks, int threadCount) :
+	Position(glm::vec3(0.0f)),
+	MaxPixelError(2.0f),
+	MaxUploadsPerFrame(8),
+	FreezeSelection(false),
+	_path(path),
+	_maxResident(std::max(maxResidentChunks, 1u))
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		LOG_ERROR("Could not open terrain pack \"{}\"", path);
+		return;
+	}
+	PackHeader header;
+	file.read((char*)&header, sizeof(PackHeader));
+	if (!file || memcmp(header.Magic, "TERR", 4) != 0 || header.Version != PackVersion) {
+		LOG_ERROR("\"{}\" is not a terrain pack, or was built by a different version", path);
+		return;
+	}
+	if (header.Levels == 0 || header.Levels > MaxLevels || header.NodeSize < 2 || (header.NodeSize & 1) != 0 || (header.NodeSize + 1) * (header.NodeSize + 1) > 65536) {
+		LOG_ERROR("Terrain pack \"{}\" has an unsupported layout ({} levels of {} quads)", path, header.Levels, header.NodeSize);
+		return;
+	}
+
+	const uint32_t nodeCount = _LevelStart(header.Levels);
+	std::vector<NodeInfo> infos(nodeCount);
+	file.read((char*)infos.data(), sizeof(NodeInfo) * nodeCount);
+	if (!file) {
+		LOG_ERROR("Terrain pack \"{}\" is truncated", path);
+		return;
+	}
+	_nodes.resize(nodeCount);
+	for (uint32_t level = 0; level < header.Levels; level++) {
+		const uint32_t side = 1u << level;
+		for (uint32_t y = 0; y < side; y++) {
+			for (uint32_t x = 0; x < side; x++) {
+				const uint32_t ix = _LevelStart(level) + y * side + x;
+				_nodes[ix] = { (uint8_t)level, (uint16_t)x, (uint16_t)y, infos[ix], NodeState::Unloaded, -1, 0 };
+			}
+		}
+	}
+	_split.resize(nodeCount, 0);
+	_requested.resize(nodeCount, 0);
+
+	_nodeSize = header.NodeSize;
+	_worldSize = header.WorldSize;
+	_heightScale = header.HeightScale;
+	_recordSize = (size_t)(_nodeSize + 3) * (_nodeSize + 3) * sizeof(uint16_t);
+	_dataOffset = sizeof(PackHeader) + (uint64_t)nodeCount * sizeof(NodeInfo);
+	_levels = header.Levels;
+
+	// Every chunk gets the same sized slot in one buffer, so they can all be drawn from the same VAO
+	const size_t chunkVertices = (size_t)(_nodeSize + 1) * (_nodeSize + 1);
+	_BuildIndices();
+	_vertexBuffer = VertexBuffer::Create(GL_DYNAMIC_DRAW);
+	_vertexBuffer->LoadData(nullptr, sizeof(Vertex), _maxResident * chunkVertices);
+	_vao = VertexArrayObject::Create();
+	_vao->AddVertexBuffer(_vertexBuffer, {
+		BufferAttribute(0, 3, GL_FLOAT, false, sizeof(Vertex), offsetof(Vertex, Position), AttribUsage::Position),
+		BufferAttribute(2, 2, GL_SHORT, true, sizeof(Vertex), offsetof(Vertex, Normal), AttribUsage::Normal)
+	});
+	_vao->SetIndexBuffer(_indexBuffer);
+	_freeSlots.reserve(_maxResident);
+	for (int32_t slot = (int32_t)_maxResident - 1; slot >= 0; slot--) {
+		_freeSlots.push_back(slot);
+	}
+
+	// The root is loaded up front, so there is always something to draw
+	std::vector<uint16_t> heights;
+	LoadedChunk root;
+	root.Node = 0;
+	_LoadChunk(file, 0, heights, root.Vertices);
+	_Upload(root);
+	_bytesStreamed = _loadedBytes = _recordSize;
+
+	threadCount = std::max(threadCount, 1);
+	for (int ix = 0; ix < threadCount; ix++) {
+		_threads.emplace_back(&Terrain::_WorkerLoop, this);
+	}
+}
+
+Terrain::~Terrain()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+	_wake.notify_all();
+	for (std::thread& thread : _threads) {
+		thread.join();
+	}
+}
+
+bool Terrain::BuildPack(const std::string& path, const std::vector<float>& heights, uint32_t levels, uint32_t nodeSize, float worldSize, float heightScale)
+{
+	if (levels == 0 || levels > MaxLevels || nodeSize < 2 || (nodeSize & 1) != 0 || (nodeSize + 1) * (nodeSize + 1) > 65536) {
+		LOG_ERROR("Terrain packs need 1 to {} levels, and an even node size of at most 254", MaxLevels);
+		return false;
+	}
+	const int64_t resolution = (int64_t)(1u << (levels - 1)) * nodeSize + 1;
+	if (heights.size() != (size_t)(resolution * resolution)) {
+		LOG_ERROR("A terrain with {} levels of {} quads needs a {}x{} heightmap", levels, nodeSize, resolution, resolution);
+		return false;
+	}
+	std::ofstream file(path, std::ios::binary);
+	if (!file) {
+		LOG_ERROR("Could not create terrain pack \"{}\"", path);
+		return false;
+	}
+	auto height = [&](int64_t x, int64_t y) {
+		x = glm::clamp<int64_t>(x, 0, resolution - 1);
+		y = glm::clamp<int64_t>(y, 0, resolution - 1);
+		return heights[y * resolution + x];
+	};
+
+	// Work up from the deepest level, so each node's error can include the error of it's children. That way a
+	// node's error never goes up as we split it, and the selection never flips back and forth between levels
+	std::vector<NodeInfo> infos(_LevelStart(levels));
+	for (int level = (int)levels - 1; level >= 0; level--) {
+		const int64_t step = 1ll << (levels - 1 - level);
+		const uint32_t side = 1u << level;
+		for (uint32_t ny = 0; ny < side; ny++) {
+			for (uint32_t nx = 0; nx < side; nx++) {
+				const int64_t x0 = nx * nodeSize * step, y0 = ny * nodeSize * step;
+				float minHeight = FLT_MAX, maxHeight = -FLT_MAX, error = 0.0f;
+				for (int64_t y = y0; y <= y0 + nodeSize * step; y++) {
+					// The cell of the node's grid this row falls in, and how far across it we are
+					const int64_t cy = std::min((y - y0) / step, (int64_t)nodeSize - 1);
+					const float ty = (float)(y - y0 - cy * step) / step;
+					for (int64_t x = x0; x <= x0 + nodeSize * step; x++) {
+						const float h = heights[y * resolution + x];
+						minHeight = std::min(minHeight, h);
+						maxHeight = std::max(maxHeight, h);
+						if (step > 1) {
+							const int64_t cx = std::min((x - x0) / step, (int64_t)nodeSize - 1);
+							const float tx = (float)(x - x0 - cx * step) / step;
+							const int64_t gx = x0 + cx * step, gy = y0 + cy * step;
+							const float grid = glm::mix(
+								glm::mix(height(gx, gy), height(gx + step, gy), tx),
+								glm::mix(height(gx, gy + step), height(gx + step, gy + step), tx), ty);
+							error = std::max(error, glm::abs(h - grid));
+						}
+					}
+				}
+
+				const uint32_t ix = _LevelStart(level) + ny * side + nx;
+				infos[ix] = { minHeight * heightScale, maxHeight * heightScale, error * heightScale };
+				if (level + 1 < (int)levels) {
+					for (uint32_t child = 0; child < 4; child++) {
+						const uint32_t childIx = _LevelStart(level + 1) + (2 * ny + (child >> 1)) * (side * 2) + 2 * nx + (child & 1);
+						infos[ix].Error = std::max(infos[ix].Error, infos[childIx].Error);
+					}
+				}
+			}
+		}
+	}
+
+	PackHeader header = { { 'T', 'E', 'R', 'R' }, PackVersion, nodeSize, levels, worldSize, heightScale };
+	file.write((const char*)&header, sizeof(PackHeader));
+	file.write((const char*)infos.data(), sizeof(NodeInfo) * infos.size());
+
+	// Each node stores it's grid with an extra sample around the outside, so normals along the edges can be
+	// worked out without needing the neighbouring nodes
+	const int64_t stride = nodeSize + 3;
+	std::vector<uint16_t> record(stride * stride);
+	for (uint32_t level = 0; level < levels; level++) {
+		const int64_t step = 1ll << (levels - 1 - level);
+		const uint32_t side = 1u << level;
+		for (uint32_t ny = 0; ny < side; ny++) {
+			for (uint32_t nx = 0; nx < side; nx++) {
+				const int64_t x0 = nx * nodeSize * step, y0 = ny * nodeSize * step;
+				for (int64_t y = 0; y < stride; y++) {
+					for (int64_t x = 0; x < stride; x++) {
+						const float h = height(x0 + (x - 1) * step, y0 + (y - 1) * step);
+						record[y * stride + x] = (uint16_t)glm::round(glm::clamp(h, 0.0f, 1.0f) * 65535.0f);
+					}
+				}
+				file.write((const char*)record.data(), record.size() * sizeof(uint16_t));
+			}
+		}
+	}
+
+	if (!file) {
+		LOG_ERROR("Failed to write terrain pack \"{}\"", path);
+		return false;
+	}
+	return true;
+}
+
+std::vector<float> Terrain::GenerateHeights(uint32_t resolution, uint32_t seed, float flatRadius, float fadeWidth)
+{
+	// Value noise, random values on a grid that are smoothly blended between
+	auto lattice = [](int32_t x, int32_t y, uint32_t seed) {
+		uint32_t h = (uint32_t)x * 374761393u + (uint32_t)y * 668265263u + seed * 2246822519u;
+		h = (h ^ (h >> 13)) * 1274126177u;
+		return (float)((h ^ (h >> 16)) & 0xFFFFFF) / (float)0xFFFFFF;
+	};
+	auto noise = [&](float x, float y, uint32_t seed) {
+		const float fx = glm::floor(x), fy = glm::floor(y);
+		const int32_t ix = (int32_t)fx, iy = (int32_t)fy;
+		float tx = x - fx, ty = y - fy;
+		tx = tx * tx * (3.0f - 2.0f * tx);
+		ty = ty * ty * (3.0f - 2.0f * ty);
+		return glm::mix(
+			glm::mix(lattice(ix, iy, seed), lattice(ix + 1, iy, seed), tx),
+			glm::mix(lattice(ix, iy + 1, seed), lattice(ix + 1, iy + 1, seed), tx), ty);
+	};
+
+	std::vector<float> heights((size_t)resolution * resolution);
+	const float scale = 1.0f / (float)std::max(resolution - 1, 1u);
+	for (uint32_t y = 0; y < resolution; y++) {
+		for (uint32_t x = 0; x < resolution; x++) {
+			const glm::vec2 uv = glm::vec2(x, y) * scale;
+			// Each octave adds details half the size and half the height of the one before it
+			float value = 0.0f, amplitude = 0.5f, frequency = 4.0f;
+			for (uint32_t octave = 0; octave < 8; octave++) {
+				value += amplitude * noise(uv.x * frequency, uv.y * frequency, seed + octave);
+				amplitude *= 0.5f;
+				frequency *= 2.0f;
+			}
+			// Squaring flattens out the valleys and sharpens the peaks
+			const float fade = glm::smoothstep(flatRadius, flatRadius + fadeWidth, glm::length(uv - 0.5f));
+			heights[(size_t)y * resolution + x] = glm::clamp(value * value * fade, 0.0f, 1.0f);
+		}
+	}
+	return heights;
+}
+
+void Terrain::_BuildIndices()
+{
+	const uint32_t size = _nodeSize, row = _nodeSize + 1;
+	std::vector<uint16_t> indices;
+	indices.reserve(16 * size * size * 6);
+	for (uint32_t mask = 0; mask < 16; mask++) {
+		const size_t start = indices.size();
+		_variantOffsets[mask] = start * sizeof(uint16_t);
+
+		auto vertex = [&](uint32_t x, uint32_t y) {
+			// Odd vertices along an edge that meets a coarser chunk are moved onto the even vertex before them, so
+			// the edge lines up with the coarser chunk's edge. The triangles that touched them stretch or collapse
+			if ((x == 0 && (mask & EdgeLeft)) || (x == size && (mask & EdgeRight))) {
+				y &= ~1u;
+			}
+			if ((y == 0 && (mask & EdgeBottom)) || (y == size && (mask & EdgeTop))) {
+				x &= ~1u;
+			}
+			return (uint16_t)(y * row + x);
+		};
+		auto triangle = [&](uint16_t a, uint16_t b, uint16_t c) {
+			if (a != b && b != c && a != c) {
+				indices.push_back(a);
+				indices.push_back(b);
+				indices.push_back(c);
+			}
+		};
+		for (uint32_t y = 0; y < size; y++) {
+			for (uint32_t x = 0; x < size; x++) {
+				const uint16_t a = vertex(x, y), b = vertex(x + 1, y), c = vertex(x + 1, y + 1), d = vertex(x, y + 1);
+				// Alternating the diagonals keeps the grid symmetric, so the stitched edges fan out evenly
+				if (((x + y) & 1) == 0) {
+					triangle(a, b, c);
+					triangle(a, c, d);
+				} else {
+					triangle(a, b, d);
+					triangle(b, c, d);
+				}
+			}
+		}
+		_variantCounts[mask] = (GLsizei)(indices.size() - start);
+	}
+	_indexBuffer = IndexBuffer::Create();
+	_indexBuffer->LoadData(indices.data(), indices.size());
+}
+
+void Terrain::_WorkerLoop()
+{
+	std::ifstream file(_path, std::ios::binary);
+	std::vector<uint16_t> heights;
+	while (true) {
+		uint32_t node;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wake.wait(lock, [&]() { return _quit || !_queue.empty(); });
+			if (_quit) {
+				return;
+			}
+			node = _queue.front();
+			_queue.pop_front();
+		}
+
+		LoadedChunk chunk;
+		chunk.Node = node;
+		_LoadChunk(file, node, heights, chunk.Vertices);
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		_loadedBytes += _recordSize;
+		_loaded.push_back(std::move(chunk));
+	}
+}
+
+void Terrain::_LoadChunk(std::ifstream& file, uint32_t node, std::vector<uint16_t>& heights, std::vector<Vertex>& vertices) const
+{
+	// Only the node's level and position are read here, which never change after we're created
+	const Node& info = _nodes[node];
+	const uint32_t stride = _nodeSize + 3;
+	heights.resize((size_t)stride * stride);
+	file.clear();
+	file.seekg(_dataOffset + (uint64_t)node * _recordSize);
+	file.read((char*)heights.data(), _recordSize);
+	if (!file) {
+		LOG_WARN("Failed to read terrain chunk {} from \"{}\"", node, _path);
+		std::fill(heights.begin(), heights.end(), (uint16_t)0);
+	}
+
+	const uint32_t step = 1u << (_levels - 1 - info.Level);
+	const float spacing = _worldSize / (float)((1u << (_levels - 1)) * _nodeSize);
+	const float heightScale = _heightScale / 65535.0f;
+	const float slopeScale = heightScale / (2.0f * spacing * step);
+	const uint32_t x0 = info.X * _nodeSize * step, y0 = info.Y * _nodeSize * step;
+	vertices.resize((size_t)(_nodeSize + 1) * (_nodeSize + 1));
+	for (uint32_t y = 0; y <= _nodeSize; y++) {
+		for (uint32_t x = 0; x <= _nodeSize; x++) {
+			const uint16_t* h = &heights[(size_t)(y + 1) * stride + x + 1];
+			Vertex& vertex = vertices[(size_t)y * (_nodeSize + 1) + x];
+			// Positions come from whole sample coordinates, so chunks of different levels put their shared vertices
+			// in exactly the same place
+			vertex.Position = glm::vec3((x0 + x * step) * spacing, (y0 + y * step) * spacing, h[0] * heightScale);
+			const float dx = ((float)h[1] - (float)h[-1]) * slopeScale;
+			const float dy = ((float)h[stride] - (float)h[-(int)stride]) * slopeScale;
+			vertex.Normal = VertexPacking::OctEncode(glm::normalize(glm::vec3(-dx, -dy, 1.0f)));
+		}
+	}
+}
+
+void Terrain::Update(const glm::mat4& view, const glm::mat4& projection, float viewportHeight)
+{
+	if (!IsValid()) {
+		return;
+	}
+	using clock = std::chrono::high_resolution_clock;
+	auto start = clock::now();
+	_UploadChunks();
+	auto uploaded = clock::now();
+	_uploadTime = std::chrono::duration<float, std::milli>(uploaded - start).count();
+	if (FreezeSelection) {
+		return;
+	}
+
+	glm::vec4 planes[6];
+	FrustumCuller::ExtractPlanes(projection * view, planes);
+	const glm::vec3 cameraPos = glm::vec3(glm::inverse(view)[3]);
+
+	// Walk down the tree a level at a time, splitting the nodes that are too coarse for where they are on screen
+	std::fill(_split.begin(), _split.end(), (uint8_t)0);
+	for (uint32_t level = 0; level + 1 < _levels; level++) {
+		const uint32_t begin = _LevelStart(level);
+		const uint32_t end = _LevelStart(level + 1);
+		for (uint32_t ix = begin; ix < end; ix++) {
+			// Only the nodes whose parents were split are in the tree, and some may have been split already to
+			// keep their neighbours within a level of them
+			const int64_t parent = _Parent(ix);
+			if (_split[ix] || (parent >= 0 && !_split[parent])) {
+				continue;
+			}
+			const AxisAlignedBox bounds = _GetBounds(ix);
+			if (!FrustumCuller::TestBox(planes, bounds)) {
+				continue;
+			}
+			// Use the closest point of the node to the camera, so that no part of it is too coarse
+			const float distance = glm::length(cameraPos - glm::clamp(cameraPos, bounds.Min, bounds.Max));
+			const float pixelsPerUnit = VertexArrayObject::GetPixelsPerUnit(projection, viewportHeight, distance);
+			if (_nodes[ix].Info.Error * pixelsPerUnit > MaxPixelError) {
+				_TrySplit(ix);
+			}
+		}
+	}
+
+	_drawCounts.clear();
+	_drawOffsets.clear();
+	_drawBaseVertices.clear();
+	_triangleCount = 0;
+	_CollectLeaves(0, planes);
+	_SubmitRequests();
+	_frame++;
+	_selectTime = std::chrono::duration<float, std::milli>(clock::now() - uploaded).count();
+}
+
+bool Terrain::_TrySplit(uint32_t node)
+{
+	if (_split[node]) {
+		return true;
+	}
+	if (_nodes[node].Level + 1u >= _levels) {
+		return false;
+	}
+	// Our parent and the parents of our neighbours need to be split first, or our children would end up two levels
+	// finer than whatever is next to them
+	const int64_t parent = _Parent(node);
+	if (parent >= 0 && !_TrySplit((uint32_t)parent)) {
+		return false;
+	}
+	static const int offsets[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+	for (const auto& offset : offsets) {
+		const int64_t neighbour = _Neighbour(node, offset[0], offset[1]);
+		const int64_t neighbourParent = neighbour >= 0 ? _Parent((uint32_t)neighbour) : -1;
+		if (neighbourParent >= 0 && !_TrySplit((uint32_t)neighbourParent)) {
+			return false;
+		}
+	}
+
+	bool ready = true;
+	for (uint32_t child = 0; child < 4; child++) {
+		const uint32_t childIx = _Child(node, child);
+		if (_nodes[childIx].State != NodeState::Resident) {
+			_Request(childIx);
+			ready = false;
+		}
+	}
+	if (ready) {
+		_split[node] = 1;
+	}
+	return ready;
+}
+
+void Terrain::_CollectLeaves(uint32_t node, const glm::vec4 planes[6])
+{
+	Node& info = _nodes[node];
+	info.LastUsed = _frame;
+	if (_split[node]) {
+		for (uint32_t child = 0; child < 4; child++) {
+			_CollectLeaves(_Child(node, child), planes);
+		}
+		return;
+	}
+	if (!FrustumCuller::TestBox(planes, _GetBounds(node))) {
+		return;
+	}
+
+	// Any neighbour whose parent isn't split is covered by a chunk one level coarser than us
+	uint32_t mask = 0;
+	static const int offsets[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+	for (uint32_t edge = 0; edge < 4; edge++) {
+		const int64_t neighbour = _Neighbour(node, offsets[edge][0], offsets[edge][1]);
+		const int64_t neighbourParent = neighbour >= 0 ? _Parent((uint32_t)neighbour) : -1;
+		if (neighbourParent >= 0 && !_split[neighbourParent]) {
+			mask |= 1u << edge;
+		}
+	}
+	_drawCounts.push_back(_variantCounts[mask]);
+	_drawOffsets.push_back((const void*)_variantOffsets[mask]);
+	_drawBaseVertices.push_back(info.Slot * (GLint)((_nodeSize + 1) * (_nodeSize + 1)));
+	_triangleCount += _variantCounts[mask] / 3;
+}
+
+void Terrain::_Request(uint32_t node)
+{
+	if (_nodes[node].State != NodeState::Resident && !_requested[node]) {
+		_requested[node] = 1;
+		_requests.push_back(node);
+	}
+}
+
+void Terrain::_SubmitRequests()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		// Anything the workers haven't gotten to yet is dropped, and put back in if we still want it. Requests are
+		// made from the top of the tree down, so the coarse chunks that unlock the most detail load first
+		for (uint32_t node : _queue) {
+			_nodes[node].State = NodeState::Unloaded;
+			_pendingCount--;
+		}
+		_queue.clear();
+		for (uint32_t node : _requests) {
+			_requested[node] = 0;
+			// Queued nodes that aren't in the queue anymore are already being loaded
+			if (_nodes[node].State == NodeState::Unloaded) {
+				_nodes[node].State = NodeState::Queued;
+				_pendingCount++;
+				_queue.push_back(node);
+			}
+		}
+	}
+	_requests.clear();
+	_wake.notify_all();
+}
+
+void Terrain::_UploadChunks()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		for (LoadedChunk& chunk : _loaded) {
+			_uploads.push_back(std::move(chunk));
+		}
+		_loaded.clear();
+		_bytesStreamed = _loadedBytes;
+	}
+
+	int uploads = 0;
+	while (!_uploads.empty() && uploads < MaxUploadsPerFrame) {
+		LoadedChunk chunk = std::move(_uploads.front());
+		_uploads.pop_front();
+		Node& node = _nodes[chunk.Node];
+		_pendingCount--;
+		// If the parent was evicted while this was loading we'd never reach it, so it isn't worth a slot
+		const int64_t parent = _Parent(chunk.Node);
+		if ((parent >= 0 && _nodes[parent].State != NodeState::Resident) || (_freeSlots.empty() && !_Evict())) {
+			node.State = NodeState::Unloaded;
+			continue;
+		}
+		_Upload(chunk);
+		uploads++;
+	}
+}
+
+void Terrain::_Upload(const LoadedChunk& chunk)
+{
+	Node& node = _nodes[chunk.Node];
+	node.Slot = _freeSlots.back();
+	_freeSlots.pop_back();
+	const size_t size = chunk.Vertices.size() * sizeof(Vertex);
+	glNamedBufferSubData(_vertexBuffer->GetHandle(), node.Slot * size, size, chunk.Vertices.data());
+	node.State = NodeState::Resident;
+	// Count it as used, so it isn't evicted by the next chunk before it has had a chance to be drawn
+	node.LastUsed = _frame;
+	_residentCount++;
+}
+
+bool Terrain::_Evict()
+{
+	int64_t best = -1;
+	uint32_t bestUsed = UINT32_MAX;
+	// The root is never evicted, and neither is anything that was used by the last selection
+	for (uint32_t ix = 1; ix < _nodes.size(); ix++) {
+		const Node& node = _nodes[ix];
+		if (node.State != NodeState::Resident || node.LastUsed + 1 >= _frame || node.LastUsed >= bestUsed) {
+			continue;
+		}
+		// Only nodes without loaded children are evicted, so every loaded node's parent stays loaded
+		bool hasChildren = false;
+		for (uint32_t child = 0; child < 4 && node.Level + 1u < _levels; child++) {
+			hasChildren |= _nodes[_Child(ix, child)].State == NodeState::Resident;
+		}
+		if (!hasChildren) {
+			best = ix;
+			bestUsed = node.LastUsed;
+		}
+	}
+	if (best < 0) {
+		return false;
+	}
+	Node& node = _nodes[best];
+	_freeSlots.push_back(node.Slot);
+	node.Slot = -1;
+	node.State = NodeState::Unloaded;
+	_residentCount--;
+	return true;
+}
+
+void Terrain::Render(const Shader::sptr& shader, const glm::mat4& viewProjection) const
+{
+	if (_drawCounts.empty()) {
+		return;
+	}
+	// The chunks are already in the terrain's space, so we only need to move them into place
+	const glm::mat4 model = glm::translate(glm::mat4(1.0f), Position);
+	shader->SetUniformMatrix("u_ModelViewProjection", viewProjection * model);
+	shader->SetUniformMatrix("u_Model", model);
+	_vao->Bind();
+	glMultiDrawElementsBaseVertex(GL_TRIANGLES, _drawCounts.data(), GL_UNSIGNED_SHORT, _drawOffsets.data(), (GLsizei)_drawCounts.size(), _drawBaseVertices.data());
+	VertexArrayObject::UnBind();
+}
+
+size_t Terrain::GetGpuMemoryUsage() const
+{
+	return IsValid() ? _vertexBuffer->GetTotalSize() + _indexBuffer->GetTotalSize() : 0;
+}
+
+int64_t Terrain::_Parent(uint32_t node) const
+{
+	const Node& info = _nodes[node];
+	return info.Level == 0 ? -1 : (int64_t)_Index(info.Level - 1, info.X >> 1, info.Y >> 1);
+}
+
+uint32_t Terrain::_Child(uint32_t node, uint32_t child) const
+{
+	const Node& info = _nodes[node];
+	return _Index(info.Level + 1, info.X * 2 + (child & 1), info.Y * 2 + (child >> 1));
+}
+
+int64_t Terrain::_Neighbour(uint32_t node, int dx, int dy) const
+{
+	const Node& info = _nodes[node];
+	const int64_t side = 1ll << info.Level;
+	const int64_t x = (int64_t)info.X + dx, y = (int64_t)info.Y + dy;
+	if (x < 0 || y < 0 || x >= side || y >= side) {
+		return -1;
+	}
+	return _Index(info.Level, (uint32_t)x, (uint32_t)y);
+}
+
+AxisAlignedBox Terrain::_GetBounds(uint32_t node) const
+{
+	const Node& info = _nodes[node];
+	const float size = _worldSize / (float)(1u << info.Level);
+	return AxisAlignedBox(
+		Position + glm::vec3(info.X * size, info.Y * size, info.Info.MinHeight),
+		Position + glm::vec3((info.X + 1) * size, (info.Y + 1) * size, info.Info.MaxHeight));
+}
+
+void Terrain::RenderImGui()
+{
+	if (!IsValid()) {
+		ImGui::Text("Terrain failed to load from \"%s\"", _path.c_str());
+		return;
+	}
+	const uint64_t fullResolution = (uint64_t)(1u << (_levels - 1)) * _nodeSize;
+	ImGui::Text("%u levels of %ux%u chunks, %.0f units across", _levels, _nodeSize, _nodeSize, _worldSize);
+	ImGui::Text("Chunks: %u drawn, %u / %u loaded, %u loading", GetVisibleChunkCount(), _residentCount, _maxResident, _pendingCount);
+	ImGui::Text("Triangles: %llu (%llu at full resolution)", (unsigned long long)_triangleCount, (unsigned long long)(fullResolution * fullResolution * 2));
+	ImGui::Text("Select: %.3fms, upload: %.3fms", _selectTime, _uploadTime);
+	ImGui::Text("Streamed: %.1f MB, GPU memory: %.1f MB", _bytesStreamed / (1024.0f * 1024.0f), GetGpuMemoryUsage() / (1024.0f * 1024.0f));
+	ImGui::SliderFloat("Terrain Pixel Error", &MaxPixelError, 0.5f, 16.0f);
+	ImGui::SliderInt("Uploads Per Frame", &MaxUploadsPerFrame, 1, 64);
+	ImGui::Checkbox("Freeze Selection", &FreezeSelection);
+}
\ No newline at end of file
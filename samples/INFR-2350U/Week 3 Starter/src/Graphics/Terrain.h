@@ -0,0 +1,227 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <string>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <GLM/glm.hpp>
+#include <Shader.h>
+#include <VertexArrayObject.h>
+
+//A large heightmapped terrain, split into a quadtree of chunks that are streamed in from disk as the camera moves
+//*Every node of the tree is a grid of NodeSize x NodeSize quads over it's area, so each level has 4 times the detail
+// of the one above it. Each frame the tree is walked from the root, and nodes are split while their error would be
+// more than MaxPixelError pixels on screen
+//*Neighbouring chunks are never more than one level apart, so cracks are closed by dropping every other vertex
+// along the edges that meet a coarser chunk. That can only happen 16 ways, so every chunk draws from the same 16
+// index lists, which are all stored in one index buffer
+//*Chunks are loaded into fixed size slots in one big vertex buffer, so all the visible chunks are drawn with one
+// multi-draw call. When the slots run out, the chunks that have gone unused the longest are evicted
+//*Chunks are read from a pack file (see BuildPack) and turned into vertices on worker threads, the main thread only
+// uploads them. A node is only split once all of it's children are loaded, so there are never holes in the terrain
+class Terrain
+{
+public:
+	typedef std::shared_ptr<Terrain> sptr;
+	static inline sptr Create(const std::string& path, uint32_t maxResidentChunks = 512, int threadCount = 2) {
+		return std::make_shared<Terrain>(path, maxResidentChunks, threadCount);
+	}
+
+	//Bits of the stitching mask, set for each edge of a chunk that meets a coarser chunk
+	enum EdgeMask : uint32_t
+	{
+		EdgeLeft   = 1 << 0, // -X
+		EdgeRight  = 1 << 1, // +X
+		EdgeBottom = 1 << 2, // -Y
+		EdgeTop    = 1 << 3  // +Y
+	};
+
+	//A chunk vertex, the normal is octahedral encoded (see VertexPacking)
+	struct Vertex
+	{
+		glm::vec3    Position;
+		glm::i16vec2 Normal;
+	};
+
+	Terrain(const std::string& path, uint32_t maxResidentChunks, int threadCount);
+	~Terrain();
+
+	//We'll disallow moving and copying, since we own OpenGL objects and threads
+	Terrain(const Terrain& other) = delete;
+	Terrain(Terrain&& other) = delete;
+	Terrain& operator=(const Terrain& other) = delete;
+	Terrain& operator=(Terrain&& other) = delete;
+
+	//Builds a pack file from a square heightmap, with heights from 0 to 1
+	//*The heightmap needs (2^(levels - 1) * nodeSize + 1) samples along each side, the deepest level of the tree
+	// uses every sample and each level above it uses every other sample of the one below it
+	static bool BuildPack(const std::string& path, const std::vector<float>& heights, uint32_t levels, uint32_t nodeSize, float worldSize, float heightScale);
+	//Makes a heightmap out of fractal noise, for when we don't have a real one
+	//*Everything within flatRadius of the center (as a fraction of the map size) is flat at 0, and the hills fade in
+	// over the next fadeWidth
+	static std::vector<float> GenerateHeights(uint32_t resolution, uint32_t seed, float flatRadius = 0.0f, float fadeWidth = 0.1f);
+
+	//The world position of the terrain's -X -Y corner
+	glm::vec3 Position;
+	//Nodes are split until their error is below this many pixels on screen
+	float     MaxPixelError;
+	//The most chunks that will be uploaded in a frame, to spread the cost of a lot of chunks arriving at once
+	int       MaxUploadsPerFrame;
+	//Stops the tree from being re-selected, so you can fly around and look at the chunks that were picked
+	bool      FreezeSelection;
+
+	//Picks the chunks to draw for the given camera, uploads chunks that have finished loading and asks for any that are missing
+	void Update(const glm::mat4& view, const glm::mat4& projection, float viewportHeight);
+	//Draws the chunks picked by the last Update, the shader should already be bound
+	void Render(const Shader::sptr& shader, const glm::mat4& viewProjection) const;
+
+	bool IsValid() const { return _levels > 0; }
+	float GetWorldSize() const { return _worldSize; }
+	float GetHeightScale() const { return _heightScale; }
+	uint32_t GetLevelCount() const { return _levels; }
+	uint32_t GetNodeSize() const { return _nodeSize; }
+
+	//Gets the number of chunks drawn by the last Update
+	uint32_t GetVisibleChunkCount() const { return (uint32_t)_drawCounts.size(); }
+	//Gets the number of chunks that are loaded into slots
+	uint32_t GetResidentChunkCount() const { return _residentCount; }
+	uint32_t GetMaxResidentChunks() const { return _maxResident; }
+	//Gets the number of chunks that have been asked for but haven't been uploaded yet
+	uint32_t GetPendingChunkCount() const { return _pendingCount; }
+	//Gets the number of triangles drawn by the last Update
+	uint64_t GetTriangleCount() const { return _triangleCount; }
+	//Gets how long the last Update spent walking the tree and uploading chunks, in milliseconds
+	float GetSelectTime() const { return _selectTime; }
+	float GetUploadTime() const { return _uploadTime; }
+	//Gets the total number of bytes read from the pack file so far
+	uint64_t GetBytesStreamed() const { return _bytesStreamed; }
+	//Gets the size of the vertex and index buffers, in bytes
+	size_t GetGpuMemoryUsage() const;
+
+	//Draws ImGui controls showing the streaming stats
+	void RenderImGui();
+
+protected:
+	//The header at the start of a pack file, followed by a NodeInfo for each node and then each node's heights
+	struct PackHeader
+	{
+		char     Magic[4];
+		uint32_t Version;
+		uint32_t NodeSize;
+		uint32_t Levels;
+		float    WorldSize;
+		float    HeightScale;
+	};
+
+	//What we know about a node without loading it
+	struct NodeInfo
+	{
+		float MinHeight;
+		float MaxHeight;
+		//The largest difference between the node's grid and the full heightmap inside of it, in world units
+		float Error;
+	};
+
+	enum class NodeState : uint8_t
+	{
+		Unloaded,
+		//Waiting for a worker, or being loaded by one
+		Queued,
+		Resident
+	};
+
+	struct Node
+	{
+		uint8_t   Level;
+		uint16_t  X, Y;
+		NodeInfo  Info;
+		NodeState State;
+		int32_t   Slot;
+		uint32_t  LastUsed;
+	};
+
+	//A node that a worker has finished loading, waiting to be uploaded
+	struct LoadedChunk
+	{
+		uint32_t            Node;
+		std::vector<Vertex> Vertices;
+	};
+
+	std::string _path;
+	uint32_t    _nodeSize = 0;
+	uint32_t    _levels = 0;
+	float       _worldSize = 0.0f;
+	float       _heightScale = 0.0f;
+	//Where the first node's heights start in the pack file, and how many bytes each node has
+	uint64_t    _dataOffset = 0;
+	size_t      _recordSize = 0;
+
+	std::vector<Node>    _nodes;
+	//Which nodes are split this frame, rebuilt by every Update
+	std::vector<uint8_t> _split;
+	//Which nodes were asked for this frame, and the order they were asked for in
+	std::vector<uint8_t>  _requested;
+	std::vector<uint32_t> _requests;
+	uint32_t             _frame = 1;
+
+	VertexArrayObject::sptr _vao;
+	VertexBuffer::sptr      _vertexBuffer;
+	IndexBuffer::sptr       _indexBuffer;
+	//Where each stitching variant starts in the index buffer (in bytes), and how many indices it has
+	size_t                  _variantOffsets[16];
+	GLsizei                 _variantCounts[16];
+	std::vector<int32_t>    _freeSlots;
+	uint32_t                _maxResident;
+	uint32_t                _residentCount = 0;
+	uint32_t                _pendingCount = 0;
+
+	//The draw list for the last Update, in the form glMultiDrawElementsBaseVertex wants
+	std::vector<GLsizei>     _drawCounts;
+	std::vector<const void*> _drawOffsets;
+	std::vector<GLint>       _drawBaseVertices;
+
+	uint64_t _triangleCount = 0;
+	float    _selectTime = 0.0f;
+	float    _uploadTime = 0.0f;
+	uint64_t _bytesStreamed = 0;
+
+	//Loading is done by a small pool of workers, that each have their own handle to the pack file
+	std::vector<std::thread> _threads;
+	std::mutex               _mutex;
+	std::condition_variable  _wake;
+	//Nodes waiting for a worker, most important first. This is replaced every frame with the nodes still wanted
+	std::deque<uint32_t>     _queue;
+	std::vector<LoadedChunk> _loaded;
+	uint64_t                 _loadedBytes = 0;
+	bool                     _quit = false;
+	//Loaded chunks that didn't fit in the last frame's uploads
+	std::deque<LoadedChunk>  _uploads;
+
+	void _WorkerLoop();
+	//Reads a node's heights from the pack file and turns them into vertices
+	void _LoadChunk(std::ifstream& file, uint32_t node, std::vector<uint16_t>& heights, std::vector<Vertex>& vertices) const;
+	//Builds the 16 stitching variants of the chunk triangulation
+	void _BuildIndices();
+	void _UploadChunks();
+	void _Upload(const LoadedChunk& chunk);
+	//Frees the slot of the chunk that has gone unused the longest, returns false if every chunk is in use
+	bool _Evict();
+	//Splits a node, first splitting anything it needs to stay within one level of it's neighbours
+	//*Returns false if the node or a node it depends on can't be split yet because it's children aren't loaded
+	bool _TrySplit(uint32_t node);
+	void _Request(uint32_t node);
+	void _SubmitRequests();
+	//Adds a node's visible leaves to the draw list
+	void _CollectLeaves(uint32_t node, const glm::vec4 planes[6]);
+
+	static uint32_t _LevelStart(uint32_t level) { return ((1u << (2 * level)) - 1) / 3; }
+	uint32_t _Index(uint32_t level, uint32_t x, uint32_t y) const { return _LevelStart(level) + y * (1u << level) + x; }
+	int64_t _Parent(uint32_t node) const;
+	uint32_t _Child(uint32_t node, uint32_t child) const;
+	//Gets the node at the same level next to this one, or -1 if it's off the edge of the map
+	int64_t _Neighbour(uint32_t node, int dx, int dy) const;
+	//Gets the world space bounds of a node
+	AxisAlignedBox _GetBounds(uint32_t node) const;
+};
\ No newline at end of file
@@ -159,12 +159,15 @@ void BackendHandler::RenderImGui()
 	}
 }
 
-void BackendHandler::RenderVAO(const Shader::sptr& shader, const VertexArrayObject::sptr& vao, const glm::mat4& viewProjection, const Transform& transform)
+void BackendHandler::RenderVAO(const Shader::sptr& shader, const VertexArrayObject::sptr& vao, const glm::mat4& viewProjection, const Transform& transform, int lod)
 {
-	shader->SetUniformMatrix("u_ModelViewProjection", viewProjection * transform.WorldTransform());
-	shader->SetUniformMatrix("u_Model", transform.WorldTransform());
+	// Quantized meshes need to be scaled back into object space, we can do this for free by applying it to the model matrix
+	const glm::mat4 model = vao->HasQuantizedPositions() ? transform.WorldTransform() * vao->GetDequantizationMatrix() : transform.WorldTransform();
+	shader->SetUniformMatrix("u_ModelViewProjection", viewProjection * model);
+	shader->SetUniformMatrix("u_Model", model);
 	shader->SetUniformMatrix("u_NormalMatrix", transform.WorldNormalMatrix());
-	vao->Render();
+	shader->SetUniform("u_OctahedralNormals", (int)vao->HasOctahedralNormals());
+	vao->Render(lod);
 }
 
 void BackendHandler::SetupShaderForFrame(const Shader::sptr& shader, const glm::mat4& view, const glm::mat4& projection)
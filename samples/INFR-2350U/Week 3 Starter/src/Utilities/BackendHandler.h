@@ -54,7 +54,7 @@ public:
 	static void RenderImGui();
 
 	//Render our VAO
-	static void RenderVAO(const Shader::sptr& shader, const VertexArrayObject::sptr& vao, const glm::mat4& viewProjection, const Transform& transform);
+	static void RenderVAO(const Shader::sptr& shader, const VertexArrayObject::sptr& vao, const glm::mat4& viewProjection, const Transform& transform, int lod = 0);
 	static void SetupShaderForFrame(const Shader::sptr& shader, const glm::mat4& view, const glm::mat4& projection);
 
 	static GLFWwindow* window;
@@ -3,6 +3,7 @@
 #include "Utilities/Util.h"
 
 #include <filesystem>
+#include <chrono>
 #include <json.hpp>
 #include <fstream>
 
@@ -15,18 +16,32 @@
 #include <VertexTypes.h>
 #include <ShaderMaterial.h>
 #include <RendererComponent.h>
+#include <FrustumCuller.h>
 #include <TextureCubeMap.h>
 #include <TextureCubeMapData.h>
+#include <AssetManager.h>
+#include <VirtualFileSystem.h>
 
 #include <Timing.h>
 #include <GameObjectTag.h>
 #include <InputHelpers.h>
 
 #include <IBehaviour.h>
+#include <BehaviourSystem.h>
+#include <FixedTimestep.h>
+#include <PhysicsSystem.h>
 #include <CameraControlBehaviour.h>
 #include <FollowPathBehaviour.h>
 #include <SimpleMoveBehaviour.h>
 
+#include "Graphics/Framebuffer.h"
+#include "Graphics/RenderTargetPool.h"
+#include "Graphics/PostProcessing.h"
+#include "Graphics/RenderGraph.h"
+#include "Graphics/CascadedShadowMap.h"
+#include "Graphics/ClusteredLighting.h"
+#include "Graphics/Terrain.h"
+
 #define NUM_TREES 300
 #define NUM_ROCKS 40
 #define PLANE_X 19.0f
@@ -34,6 +49,24 @@
 #define DNS_X 3.0f
 #define DNS_Y 3.0f
 
+// Tags for finding groups of objects with GameScene::FindWithTags
+enum ObjectTags : uint32_t
+{
+	TAG_FLORA = 1 << 0,
+	TAG_ROCK  = 1 << 1
+};
+
+//Spins an object during fixed updates, to show off interpolating between fixed steps
+struct FixedSpinBehaviour
+{
+	bool  Enabled = true;
+	float DegreesPerSecond = 90.0f;
+
+	void FixedUpdate(entt::handle entity) {
+		entity.get<Transform>().RotateLocalFixed(0.0f, 0.0f, DegreesPerSecond * Timing::Instance().FixedTimeStep);
+	}
+};
+
 int main() {
 	int frameIx = 0;
 	float fpsBuffer[128];
@@ -54,11 +87,35 @@ int main() {
 	{
 		#pragma region Shader and ImGui
 
+		// If the resources have been packed (see the AssetPacker project), everything is read out of the archive instead
+		// of from loose files. Anything that isn't in the archive still falls back to the disk
+		if (std::filesystem::exists("assets.pak")) {
+			VirtualFileSystem::Mount("assets.pak");
+		}
+
+		// Linked programs are cached on disk, so after the first run shaders load without being compiled. Any
+		// shader whose source files change while we are running gets reloaded
+		Shader::EnableBinaryCache("shader_cache");
+		Shader::EnableHotReload(true);
+		// We run from the build's output folder, which only has copies of the resources. Premake tells us where the
+		// originals are, so we watch those instead and edits to them show up right away. Our own res folder goes first,
+		// since it gets copied over the top of the modules' resources
+		#if defined(PROJECT_RES_DIR) && defined(MODULES_DIR)
+		Shader::AddHotReloadSourceDirectory(PROJECT_RES_DIR);
+		std::error_code modulesError;
+		for (const std::filesystem::directory_entry& module : std::filesystem::directory_iterator(MODULES_DIR, modulesError)) {
+			if (std::filesystem::is_directory(module.path() / "res")) {
+				Shader::AddHotReloadSourceDirectory((module.path() / "res").generic_string());
+			}
+		}
+		#endif
+
+		// Textures and meshes are read on worker threads, and finished off on this thread by Update or when we wait on them.
+		// Asking for the same file twice hands back the same asset
+		AssetManager::sptr assets = AssetManager::Create();
+
 		// Load our shaders
-		Shader::sptr shader = Shader::Create();
-		shader->LoadShaderPartFromFile("shaders/vertex_shader.glsl", GL_VERTEX_SHADER);
-		shader->LoadShaderPartFromFile("shaders/frag_blinn_phong_textured.glsl", GL_FRAGMENT_SHADER);
-		shader->Link();
+		Shader::sptr shader = assets->LoadShader("shaders/vertex_shader.glsl", "shaders/frag_blinn_phong_textured.glsl");
 
 		glm::vec3 lightPos = glm::vec3(0.0f, 0.0f, 5.0f);
 		glm::vec3 lightCol = glm::vec3(0.9f, 0.85f, 0.5f);
@@ -114,9 +171,9 @@ int main() {
 				}
 			}
 
-			auto name = controllables[selectedVao].get<GameObjectTag>().Name;
+			const std::string& name = controllables[selectedVao].get<GameObjectTag>().GetName();
 			ImGui::Text(name.c_str());
-			auto behaviour = BehaviourBinding::Get<SimpleMoveBehaviour>(controllables[selectedVao]);
+			auto behaviour = BehaviourSystem::Get<SimpleMoveBehaviour>(controllables[selectedVao]);
 			ImGui::Checkbox("Relative Rotation", &behaviour->Relative);
 
 			ImGui::Text("Q/E -> Yaw\nLeft/Right -> Roll\nUp/Down -> Pitch\nY -> Toggle Mode");
@@ -140,20 +197,164 @@ int main() {
 		glEnable(GL_CULL_FACE);
 		glDepthFunc(GL_LEQUAL); // New 
 
+		#pragma region Post Processing
+
+		// We render the scene into an HDR framebuffer, so that the post effects have colors brighter than 1 to work with
+		int windowWidth, windowHeight;
+		glfwGetFramebufferSize(BackendHandler::window, &windowWidth, &windowHeight);
+		Framebuffer::sptr sceneBuffer = Framebuffer::Create();
+		sceneBuffer->Init(glm::max(windowWidth, 1), glm::max(windowHeight, 1), 4);
+		sceneBuffer->AddColorTarget(InternalFormat::RGBA16F);
+		sceneBuffer->AddDepthTarget(InternalFormat::Depth24Stencil8);
+		sceneBuffer->CheckFBO();
+
+		// All the intermediate targets for our post effects come from this pool, and get reused every frame
+		RenderTargetPool::sptr targetPool = RenderTargetPool::Create();
+		PostProcessChain::sptr postChain = PostProcessChain::Create();
+		postChain->AddEffect<BloomEffect>();
+		postChain->AddEffect<ToneMapEffect>();
+		postChain->AddEffect<FxaaEffect>();
+
+		// The frame is declared as a set of passes each frame, the graph works out what needs to run and which targets can share memory
+		RenderGraph::sptr renderGraph = RenderGraph::Create(*targetPool);
+
+		BackendHandler::imGuiCallbacks.push_back([&]() {
+			if (ImGui::CollapsingHeader("Post Processing"))
+			{
+				postChain->RenderImGui();
+				ImGui::Text("Scene target: %ux%u, %ux MSAA, %.1f MB", sceneBuffer->GetWidth(), sceneBuffer->GetHeight(), sceneBuffer->GetSamples(), sceneBuffer->GetMemoryUsage() / (1024.0f * 1024.0f));
+				ImGui::Text("Pooled targets: %zu, %.1f MB (peak %.1f MB)", targetPool->GetTextureCount(), targetPool->GetAllocatedBytes() / (1024.0f * 1024.0f), targetPool->GetPeakBytes() / (1024.0f * 1024.0f));
+			}
+			if (ImGui::CollapsingHeader("Render Graph"))
+			{
+				renderGraph->RenderImGui();
+			}
+			if (ImGui::CollapsingHeader("Shaders"))
+			{
+				ImGui::Text("Load time: %.1fms, %u from cache, %u compiled", Shader::GetTotalLoadTime(), Shader::GetCacheHits(), Shader::GetCacheMisses());
+				bool hotReload = Shader::IsHotReloadEnabled();
+				if (ImGui::Checkbox("Hot Reload", &hotReload)) {
+					Shader::EnableHotReload(hotReload);
+				}
+				if (ImGui::Button("Clear Binary Cache")) {
+					Shader::ClearBinaryCache();
+				}
+			}
+		});
+
+		#pragma endregion
+
+		#pragma region Shadows
+
+		// The sun casts cascaded shadows, the far cascades only hold the static scenery and are only re-rendered when they need to be
+		glm::vec3 sunCol = glm::vec3(0.8f, 0.75f, 0.65f);
+		shader->SetUniform("u_SunCol", sunCol);
+		CascadedShadowMap::sptr shadowMap = CascadedShadowMap::Create(2048, 4);
+		Shader::sptr shadowShader = Shader::Create();
+		shadowShader->LoadShaderPartFromFile("shaders/shadow_depth.vert.glsl", GL_VERTEX_SHADER);
+		shadowShader->LoadShaderPartFromFile("shaders/shadow_depth.frag.glsl", GL_FRAGMENT_SHADER);
+		shadowShader->Link();
+		// The entity for each shadow caster, since the render group gets re-sorted every frame
+		std::vector<entt::entity> shadowCasters;
+
+		BackendHandler::imGuiCallbacks.push_back([&]() {
+			if (ImGui::CollapsingHeader("Sun and Shadows"))
+			{
+				if (ImGui::ColorEdit3("Sun Col", glm::value_ptr(sunCol))) {
+					shader->SetUniform("u_SunCol", sunCol);
+				}
+				shadowMap->RenderImGui();
+			}
+		});
+
+		#pragma endregion
+
+		#pragma region Clustered Lights
+
+		// Lots of small point lights, drifting around the scene. They are assigned to clusters on the CPU each frame so
+		// each fragment only has to shade the handful of lights that can reach it
+		ClusteredLighting::sptr clusteredLights = ClusteredLighting::Create();
+		int pointLightCount = 256;
+		// Each light circles around a point on the ground, x and y are the center, z is the phase and w is the speed
+		std::vector<glm::vec4> lightOrbits;
+		auto spawnLights = [&](int count) {
+			clusteredLights->Lights.resize(count);
+			lightOrbits.resize(count);
+			for (int ix = 0; ix < count; ix++) {
+				lightOrbits[ix] = glm::vec4(
+					Util::GetRandomNumberBetween(glm::vec2(-PLANE_X, -PLANE_Y), glm::vec2(PLANE_X, PLANE_Y)),
+					Util::GetRandomNumberBetween(0.0f, glm::two_pi<float>()),
+					Util::GetRandomNumberBetween(0.2f, 1.0f));
+				PointLight& light = clusteredLights->Lights[ix];
+				light.Radius = Util::GetRandomNumberBetween(1.0f, 3.0f);
+				light.Color = glm::normalize(Util::GetRandomNumberBetween(glm::vec3(0.1f), glm::vec3(1.0f)));
+				light.Intensity = 2.0f;
+			}
+		};
+		spawnLights(pointLightCount);
+
+		BackendHandler::imGuiCallbacks.push_back([&]() {
+			if (ImGui::CollapsingHeader("Clustered Lights"))
+			{
+				if (ImGui::SliderInt("Point Lights", &pointLightCount, 0, 4096)) {
+					spawnLights(pointLightCount);
+				}
+				clusteredLights->RenderImGui();
+			}
+		});
+
+		#pragma endregion
+
 		#pragma region TEXTURE LOADING
 
-		// Load some textures from files
-		Texture2D::sptr stone = Texture2D::LoadFromFile("images/Stone_001_Diffuse.png");
-		Texture2D::sptr stoneSpec = Texture2D::LoadFromFile("images/Stone_001_Specular.png");
-		Texture2D::sptr grass = Texture2D::LoadFromFile("images/grass.jpg");
-		Texture2D::sptr noSpec = Texture2D::LoadFromFile("images/grassSpec.png");
-		Texture2D::sptr box = Texture2D::LoadFromFile("images/box.bmp");
-		Texture2D::sptr boxSpec = Texture2D::LoadFromFile("images/box-reflections.bmp");
-		Texture2D::sptr simpleFlora = Texture2D::LoadFromFile("images/SimpleFlora.png");
+		// Start loading the models first, so they're simplified on the workers while we wait on the textures
+		auto planeMesh = assets->LoadMeshAsync("models/plane.obj");
+		auto monkeyMesh = assets->LoadMeshAsync("models/monkey_quads.obj", glm::vec4(1.0f), MeshLodSettings::Default());
+		auto pineMesh = assets->LoadMeshAsync("models/simplePine.obj", glm::vec4(1.0f), MeshLodSettings::Default(), VertexCompression::Quantized);
+		auto treeMesh = assets->LoadMeshAsync("models/simpleTree.obj", glm::vec4(1.0f), MeshLodSettings::Default(), VertexCompression::Quantized);
+		auto rockMesh = assets->LoadMeshAsync("models/simpleRock.obj", glm::vec4(1.0f), MeshLodSettings::Default(), VertexCompression::Quantized);
+
+		// Load some textures from files, they're all decoded at the same time and we only wait once we need them
+		auto stoneTex = assets->LoadTextureAsync("images/Stone_001_Diffuse.png");
+		auto stoneSpecTex = assets->LoadTextureAsync("images/Stone_001_Specular.png");
+		auto grassTex = assets->LoadTextureAsync("images/grass.jpg");
+		auto noSpecTex = assets->LoadTextureAsync("images/grassSpec.png");
+		auto boxTex = assets->LoadTextureAsync("images/box.bmp");
+		auto boxSpecTex = assets->LoadTextureAsync("images/box-reflections.bmp");
+		auto simpleFloraTex = assets->LoadTextureAsync("images/SimpleFlora.png");
 
 		// Load the cube map
-		//TextureCubeMap::sptr environmentMap = TextureCubeMap::LoadFromImages("images/cubemaps/skybox/sample.jpg");
-		TextureCubeMap::sptr environmentMap = TextureCubeMap::LoadFromImages("images/cubemaps/skybox/ToonSky.jpg"); 
+		//auto environmentTex = assets->LoadCubeMapAsync("images/cubemaps/skybox/sample.jpg");
+		auto environmentTex = assets->LoadCubeMapAsync("images/cubemaps/skybox/ToonSky.jpg");
+
+		Texture2D::sptr stone = assets->Wait(stoneTex);
+		Texture2D::sptr stoneSpec = assets->Wait(stoneSpecTex);
+		Texture2D::sptr grass = assets->Wait(grassTex);
+		Texture2D::sptr noSpec = assets->Wait(noSpecTex);
+		Texture2D::sptr box = assets->Wait(boxTex);
+		Texture2D::sptr boxSpec = assets->Wait(boxSpecTex);
+		Texture2D::sptr simpleFlora = assets->Wait(simpleFloraTex);
+		TextureCubeMap::sptr environmentMap = assets->Wait(environmentTex);
+
+		float assetBudgetMb = assets->MemoryBudget / (1024.0f * 1024.0f);
+		BackendHandler::imGuiCallbacks.push_back([&]() {
+			if (ImGui::CollapsingHeader("Assets"))
+			{
+				for (int ix = 0; ix < (int)AssetType::Count; ix++) {
+					const AssetManager::TypeStats& stats = assets->GetStats((AssetType)ix);
+					ImGui::Text("%s: %u loaded, %.2f MB (%u hits, %u misses, %u evicted)", AssetManager::GetTypeName((AssetType)ix),
+						stats.Count, stats.Bytes / (1024.0f * 1024.0f), stats.Hits, stats.Misses, stats.Evictions);
+				}
+				ImGui::Text("Total: %.2f MB, %u loading", assets->GetTotalMemory() / (1024.0f * 1024.0f), assets->GetPendingCount());
+				ImGui::Text("Files read: %u from archives, %u loose", VirtualFileSystem::GetArchiveReads(), VirtualFileSystem::GetLooseReads());
+				if (ImGui::DragFloat("Budget (MB)", &assetBudgetMb, 1.0f, 0.0f, 4096.0f)) {
+					assets->MemoryBudget = static_cast<size_t>(assetBudgetMb * 1024.0f * 1024.0f);
+				}
+				if (ImGui::Button("Evict Unused")) {
+					assets->EvictUnused();
+				}
+			}
+		});
 
 		// Creating an empty texture
 		Texture2DDescription desc = Texture2DDescription();  
@@ -170,7 +371,26 @@ int main() {
 		#pragma region Scene Generation
 		
 		// We need to tell our scene system what extra component types we want to support
-		GameScene::RegisterComponentType<RendererComponent>();
+		// Renderers are saved with the IDs of their mesh and material in the asset table, so those need to be added to
+		// GameScene::Assets() before a scene is saved or loaded
+		GameScene::RegisterComponentType<RendererComponent>(nullptr,
+			[](cereal::BinaryOutputArchive& archive, const entt::registry& registry, const std::vector<entt::entity>& entities, const SceneEntityMap& map) {
+				for (entt::entity entity : entities) {
+					const RendererComponent& renderer = registry.get<RendererComponent>(entity);
+					archive(GameScene::Assets().GetId(renderer.Mesh), GameScene::Assets().GetId(renderer.Material), renderer.CastShadows);
+				}
+			},
+			[](cereal::BinaryInputArchive& archive, entt::registry& registry, const std::vector<entt::entity>& entities, const SceneEntityMap& map) {
+				AssetTable::AssetId meshId, materialId;
+				bool castShadows;
+				for (entt::entity entity : entities) {
+					archive(meshId, materialId, castShadows);
+					registry.emplace<RendererComponent>(entity)
+						.SetMesh(GameScene::Assets().Get<VertexArrayObject>(meshId))
+						.SetMaterial(GameScene::Assets().Get<ShaderMaterial>(materialId))
+						.SetCastShadows(castShadows);
+				}
+			});
 		GameScene::RegisterComponentType<BehaviourBinding>();
 		GameScene::RegisterComponentType<Camera>();
 
@@ -182,6 +402,18 @@ int main() {
 		entt::basic_group<entt::entity, entt::exclude_t<>, entt::get_t<Transform>, RendererComponent> renderGroup =
 			scene->Registry().group<RendererComponent>(entt::get_t<Transform>());
 
+		// The culler will test all our renderers against the camera each frame, so we only draw what is on screen
+		FrustumCuller culler;
+		// LODs are selected so that the simplification error is never more than this many pixels on screen
+		float maxLodPixelError = 1.0f;
+		uint64_t trianglesDrawn = 0, trianglesFull = 0;
+		BackendHandler::imGuiCallbacks.push_back([&]() {
+			ImGui::Text("Visible: %u, Culled: %u", culler.GetVisibleCount(), culler.GetCulledCount());
+			ImGui::Text("Triangles: %llu / %llu (%.1f%%)", trianglesDrawn, trianglesFull, trianglesFull > 0 ? 100.0f * trianglesDrawn / trianglesFull : 100.0f);
+			ImGui::Text("Frame time: %.3fms", 1000.0f / ImGui::GetIO().Framerate);
+			ImGui::SliderFloat("LOD Pixel Error", &maxLodPixelError, 0.0f, 8.0f);
+		});
+
 		// Create a material and set some properties for it
 		ShaderMaterial::sptr stoneMat = ShaderMaterial::Create();  
 		stoneMat->Shader = shader;
@@ -211,27 +443,37 @@ int main() {
 		simpleFloraMat->Set("u_Shininess", 8.0f);
 		simpleFloraMat->Set("u_TextureMix", 0.0f);
 
+		// Add our materials to the asset table, so that saved scenes can refer to them
+		GameScene::Assets().Add("materials/stone", stoneMat);
+		GameScene::Assets().Add("materials/grass", grassMat);
+		GameScene::Assets().Add("materials/box", boxMat);
+		GameScene::Assets().Add("materials/simpleFlora", simpleFloraMat);
+
 		GameObject obj1 = scene->CreateEntity("Ground"); 
 		{
-			VertexArrayObject::sptr vao = ObjLoader::LoadFromFile("models/plane.obj");
+			VertexArrayObject::sptr vao = assets->Wait(planeMesh);
+			GameScene::Assets().Add("models/plane.obj", vao);
 			obj1.emplace<RendererComponent>().SetMesh(vao).SetMaterial(grassMat);
 		}
 
 		GameObject obj2 = scene->CreateEntity("monkey_quads");
 		{
-			VertexArrayObject::sptr vao = ObjLoader::LoadFromFile("models/monkey_quads.obj");
+			VertexArrayObject::sptr vao = assets->Wait(monkeyMesh);
+			GameScene::Assets().Add("models/monkey_quads.obj", vao);
 			obj2.emplace<RendererComponent>().SetMesh(vao).SetMaterial(stoneMat);
 			obj2.get<Transform>().SetLocalPosition(0.0f, 0.0f, 2.0f);
 			obj2.get<Transform>().SetLocalRotation(0.0f, 0.0f, -90.0f);
-			BehaviourBinding::BindDisabled<SimpleMoveBehaviour>(obj2);
+			BehaviourSystem::BindDisabled<SimpleMoveBehaviour>(obj2);
 		}
 
 		std::vector<GameObject> randomTrees;
 		{
-			VertexArrayObject::sptr vao = ObjLoader::LoadFromFile("models/simplePine.obj");
+			VertexArrayObject::sptr vao = assets->Wait(pineMesh);
+			GameScene::Assets().Add("models/simplePine.obj", vao);
 			for (int i = 0; i < NUM_TREES/2; i++)
 			{
 				randomTrees.push_back(scene->CreateEntity("simplePine" + (std::to_string(i + 1))));
+				randomTrees[i].get<GameObjectTag>().Tags = TAG_FLORA;
 				randomTrees[i].emplace<RendererComponent>().SetMesh(vao).SetMaterial(simpleFloraMat);
 				//Randomly places
 				randomTrees[i].get<Transform>().SetLocalPosition(glm::vec3(Util::GetRandomNumberBetween(glm::vec2(-PLANE_X, -PLANE_Y), glm::vec2(PLANE_X, PLANE_Y), glm::vec2(-DNS_X, -DNS_Y), glm::vec2(DNS_X, DNS_Y)), 0.0f));
@@ -240,10 +482,12 @@ int main() {
 
 		std::vector<GameObject> randomTrees2;
 		{
-			VertexArrayObject::sptr vao = ObjLoader::LoadFromFile("models/simpleTree.obj");
+			VertexArrayObject::sptr vao = assets->Wait(treeMesh);
+			GameScene::Assets().Add("models/simpleTree.obj", vao);
 			for (int i = 0; i < NUM_TREES/2; i++)
 			{
 				randomTrees2.push_back(scene->CreateEntity("simpleTree" + (std::to_string(i + 1))));
+				randomTrees2[i].get<GameObjectTag>().Tags = TAG_FLORA;
 				randomTrees2[i].emplace<RendererComponent>().SetMesh(vao).SetMaterial(simpleFloraMat);
 				//Randomly places
 				randomTrees2[i].get<Transform>().SetLocalPosition(glm::vec3(Util::GetRandomNumberBetween(glm::vec2(-PLANE_X, -PLANE_Y), glm::vec2(PLANE_X, PLANE_Y), glm::vec2(-DNS_X, -DNS_Y), glm::vec2(DNS_X, DNS_Y)), 0.0f));
@@ -252,10 +496,12 @@ int main() {
 
 		std::vector<GameObject> randomRocks;
 		{
-			VertexArrayObject::sptr vao = ObjLoader::LoadFromFile("models/simpleRock.obj");
+			VertexArrayObject::sptr vao = assets->Wait(rockMesh);
+			GameScene::Assets().Add("models/simpleRock.obj", vao);
 			for (int i = 0; i < NUM_ROCKS; i++)
 			{
 				randomRocks.push_back(scene->CreateEntity("simpleRock" + (std::to_string(i + 1))));
+				randomRocks[i].get<GameObjectTag>().Tags = TAG_ROCK;
 				randomRocks[i].emplace<RendererComponent>().SetMesh(vao).SetMaterial(simpleFloraMat);
 				//Randomly places
 				randomRocks[i].get<Transform>().SetLocalPosition(glm::vec3(Util::GetRandomNumberBetween(glm::vec2(-PLANE_X, -PLANE_Y), glm::vec2(PLANE_X, PLANE_Y), glm::vec2(-DNS_X, -DNS_Y), glm::vec2(DNS_X, DNS_Y)), 0.0f));
@@ -274,7 +520,7 @@ int main() {
 			camera.LookAt(glm::vec3(0));
 			camera.SetFovDegrees(90.0f); // Set an initial FOV
 			camera.SetOrthoHeight(3.0f);
-			BehaviourBinding::Bind<CameraControlBehaviour>(cameraObject);
+			BehaviourSystem::Bind<CameraControlBehaviour>(cameraObject);
 		}
 
 		#pragma endregion 
@@ -301,10 +547,82 @@ int main() {
 			
 			GameObject skyboxObj = scene->CreateEntity("skybox");  
 			skyboxObj.get<Transform>().SetLocalPosition(0.0f, 0.0f, 0.0f);
-			skyboxObj.get_or_emplace<RendererComponent>().SetMesh(meshVao).SetMaterial(skyboxMat);
+			skyboxObj.get_or_emplace<RendererComponent>().SetMesh(meshVao).SetMaterial(skyboxMat).SetCastShadows(false);
+
+			GameScene::Assets().Add("materials/skybox", skyboxMat);
+			GameScene::Assets().Add("meshes/skybox", meshVao);
 		}
 		////////////////////////////////////////////////////////////////////////////////////////
 
+		/////////////////////////////////// TERRAIN //////////////////////////////////////////////
+		#pragma region Terrain
+
+		// A big streamed terrain around the scene, it is drawn on it's own instead of through the render group
+		// since it's chunks change every frame
+		const std::string terrainPath = "terrain.pack";
+		if (!std::filesystem::exists(terrainPath)) {
+			// We don't have a real heightmap, so we make one up. The middle is flat, so the rest of the scene sits on it
+			const auto start = std::chrono::high_resolution_clock::now();
+			Terrain::BuildPack(terrainPath, Terrain::GenerateHeights(2049, 1234, 0.03f, 0.12f), 6, 64, 1024.0f, 120.0f);
+			LOG_INFO("Built terrain pack in {:.0f}ms", std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+		}
+		Terrain::sptr terrain = Terrain::Create(terrainPath);
+		// Center the terrain on the scene, just under the ground plane so the two don't fight
+		terrain->Position = glm::vec3(-terrain->GetWorldSize() * 0.5f, -terrain->GetWorldSize() * 0.5f, -0.05f);
+		bool drawTerrain = terrain->IsValid();
+
+		// The terrain has it's own vertex shader, but is lit the same way as everything else
+		Shader::sptr terrainShader = assets->LoadShader("shaders/terrain_chunk.vert.glsl", "shaders/frag_blinn_phong_textured.glsl");
+
+		ShaderMaterial::sptr terrainMat = ShaderMaterial::Create();
+		terrainMat->Shader = terrainShader;
+		terrainMat->Set("s_Diffuse", grass);
+		terrainMat->Set("s_Specular", noSpec);
+		terrainMat->Set("u_Shininess", 2.0f);
+		terrainMat->Set("u_TextureMix", 0.0f);
+		terrainMat->Set("u_TextureScale", 0.25f);
+
+		// The lighting settings can be changed from ImGui at any time, so the terrain shader picks them up each frame
+		auto applyTerrainLighting = [&]() {
+			terrainShader->SetUniform("u_LightPos", lightPos);
+			terrainShader->SetUniform("u_LightCol", lightCol);
+			terrainShader->SetUniform("u_AmbientLightStrength", lightAmbientPow);
+			terrainShader->SetUniform("u_SpecularLightStrength", lightSpecularPow);
+			terrainShader->SetUniform("u_AmbientCol", ambientCol);
+			terrainShader->SetUniform("u_AmbientStrength", ambientPow);
+			terrainShader->SetUniform("u_LightAttenuationConstant", 1.0f);
+			terrainShader->SetUniform("u_LightAttenuationLinear", lightLinearFalloff);
+			terrainShader->SetUniform("u_LightAttenuationQuadratic", lightQuadraticFalloff);
+			terrainShader->SetUniform("u_SunCol", sunCol);
+		};
+
+		BackendHandler::imGuiCallbacks.push_back([&]() {
+			if (ImGui::CollapsingHeader("Terrain"))
+			{
+				ImGui::Checkbox("Draw Terrain", &drawTerrain);
+				terrain->RenderImGui();
+			}
+		});
+
+		#pragma endregion
+		////////////////////////////////////////////////////////////////////////////////////////
+
+
+		///////////////////////////////////// Scene Tools /////////////////////////////////////////////
+		#pragma region Scene Tools
+
+		BackendHandler::imGuiCallbacks.push_back([&]() {
+			if (ImGui::CollapsingHeader("Scene"))
+			{
+				ImGui::Text("Flora: %u, Rocks: %u", (uint32_t)scene->FindWithTags(TAG_FLORA).size(), (uint32_t)scene->FindWithTags(TAG_ROCK).size());
+				if (ImGui::Button("Save Scene")) {
+					scene->SaveBinary("scene.bin");
+				}
+			}
+		});
+
+		#pragma endregion
+		////////////////////////////////////////////////////////////////////////////////////////
 
 		// We'll use a vector to store all our key press events for now (this should probably be a behaviour eventually)
 		std::vector<KeyPressWatcher> keyToggles;
@@ -318,33 +636,113 @@ int main() {
 			controllables.push_back(obj2);
 
 			keyToggles.emplace_back(GLFW_KEY_KP_ADD, [&]() {
-				BehaviourBinding::Get<SimpleMoveBehaviour>(controllables[selectedVao])->Enabled = false;
+				BehaviourSystem::Get<SimpleMoveBehaviour>(controllables[selectedVao])->Enabled = false;
 				selectedVao++;
 				if (selectedVao >= controllables.size())
 					selectedVao = 0;
-				BehaviourBinding::Get<SimpleMoveBehaviour>(controllables[selectedVao])->Enabled = true;
+				BehaviourSystem::Get<SimpleMoveBehaviour>(controllables[selectedVao])->Enabled = true;
 				});
 			keyToggles.emplace_back(GLFW_KEY_KP_SUBTRACT, [&]() {
-				BehaviourBinding::Get<SimpleMoveBehaviour>(controllables[selectedVao])->Enabled = false;
+				BehaviourSystem::Get<SimpleMoveBehaviour>(controllables[selectedVao])->Enabled = false;
 				selectedVao--;
 				if (selectedVao < 0)
 					selectedVao = controllables.size() - 1;
-				BehaviourBinding::Get<SimpleMoveBehaviour>(controllables[selectedVao])->Enabled = true;
+				BehaviourSystem::Get<SimpleMoveBehaviour>(controllables[selectedVao])->Enabled = true;
 				});
 
 			keyToggles.emplace_back(GLFW_KEY_Y, [&]() {
-				auto behaviour = BehaviourBinding::Get<SimpleMoveBehaviour>(controllables[selectedVao]);
+				auto behaviour = BehaviourSystem::Get<SimpleMoveBehaviour>(controllables[selectedVao]);
 				behaviour->Relative = !behaviour->Relative;
 				});
 		}
 
+		// Compare this between the first run and later ones to see how much the binary cache saves
+		LOG_INFO("Loaded shaders in {:.1f}ms, {} from the binary cache, {} compiled", Shader::GetTotalLoadTime(), Shader::GetCacheHits(), Shader::GetCacheMisses());
+
 		// Initialize our timing instance and grab a reference for our use
 		Timing& time = Timing::Instance();
 		time.LastFrame = glfwGetTime();
 
+		// Gameplay that needs to be consistent (like physics) runs in FixedUpdate at a fixed rate, which can be
+		// lower than the frame rate since objects are interpolated between steps
+		FixedTimestep fixedTimestep = FixedTimestep(1.0f / 30.0f);
+		int fixedStepsThisFrame = 0;
+		{
+			// Give one of the rocks something to do in FixedUpdate, so we can see interpolation at work
+			GameObject spinner = randomRocks[0];
+			spinner.get<Transform>().SetLocalPosition(0.0f, -3.0f, 0.5f);
+			BehaviourSystem::Bind<FixedSpinBehaviour>(spinner);
+			spinner.emplace<TransformInterpolation>();
+		}
+		BackendHandler::imGuiCallbacks.push_back([&]() {
+			if (ImGui::CollapsingHeader("Fixed Timestep"))
+			{
+				float rate = 1.0f / fixedTimestep.StepSize;
+				if (ImGui::SliderFloat("Fixed Rate (Hz)", &rate, 5.0f, 144.0f)) {
+					fixedTimestep.StepSize = 1.0f / rate;
+				}
+				ImGui::SliderInt("Max Steps Per Frame", &fixedTimestep.MaxStepsPerFrame, 1, 20);
+				ImGui::Checkbox("Interpolate", &fixedTimestep.Interpolate);
+				ImGui::Text("Steps this frame: %d, alpha: %.2f", fixedStepsThisFrame, fixedTimestep.GetAlpha());
+				ImGui::Text("Total steps: %llu, dropped time: %.2fs", (unsigned long long)fixedTimestep.GetTotalSteps(), fixedTimestep.GetDroppedTime());
+			}
+		});
+
+		/////////////////////////////////////// Physics ////////////////////////////////////////////
+		#pragma region Physics
+
+		// Simulates everything with a rigid body and a collider, stepped along with FixedUpdate
+		PhysicsSystem::sptr physics = PhysicsSystem::Create(*scene);
+		{
+			// The ground collider is built from the same kind of mesh data we'd draw, and is shared through the asset
+			// table so that saved scenes keep it
+			MeshBuilder<VertexPosNormTexCol> groundMesh;
+			MeshFactory::AddPlane(groundMesh, glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec2(40.0f));
+			obj1.emplace<ColliderComponent>(ColliderComponent::TriangleMesh(groundMesh));
+			obj1.emplace<RigidBodyComponent>().Mass = 0.0f;
+			GameScene::Assets().Add("colliders/ground", obj1.get<ColliderComponent>().Shape);
+		}
+		// The rocks' origins are at their base, so their colliders sit a bit above it
+		const ColliderComponent rockCollider = ColliderComponent::Sphere(0.55f).WithOffset(glm::vec3(0.0f, 0.0f, 0.5f));
+		GameScene::Assets().Add("colliders/rock", rockCollider.Shape);
+		auto dropRocks = [&]() {
+			for (size_t ix = 1; ix < randomRocks.size(); ix++) {
+				GameObject rock = randomRocks[ix];
+				Transform& transform = rock.get<Transform>();
+				const glm::vec3 position = transform.GetLocalPosition();
+				transform.SetLocalPosition(position.x, position.y, Util::GetRandomNumberBetween(2.0f, 6.0f));
+				// Replacing the components makes the system re-create the bodies, starting from where we just put them
+				rock.emplace_or_replace<ColliderComponent>(rockCollider);
+				rock.emplace_or_replace<RigidBodyComponent>().Mass = 5.0f;
+				// We moved the rock outside of a fixed step, so throw away the state it would be interpolated from
+				rock.get_or_emplace<TransformInterpolation>().IsInitialized = false;
+			}
+		};
+		dropRocks();
+
+		BackendHandler::imGuiCallbacks.push_back([&]() {
+			if (ImGui::CollapsingHeader("Physics"))
+			{
+				glm::vec3 gravity = physics->GetGravity();
+				if (ImGui::DragFloat3("Gravity", &gravity.x, 0.1f)) {
+					physics->SetGravity(gravity);
+				}
+				if (ImGui::Button("Drop Rocks")) {
+					dropRocks();
+				}
+				ImGui::Text("Bodies: %u, active: %u", physics->GetBodyCount(), physics->GetActiveBodyCount());
+				ImGui::Text("Step: %.3fms, sync: %.3fms", physics->GetStepTime(), physics->GetSyncTime());
+			}
+		});
+
+		#pragma endregion
+		////////////////////////////////////////////////////////////////////////////////////////
+
 		///// Game loop /////
 		while (!glfwWindowShouldClose(BackendHandler::window)) {
 			glfwPollEvents();
+			Shader::PollHotReload();
+			assets->Update();
 
 			// Update the timing
 			time.CurrentFrame = glfwGetTime();
@@ -377,12 +775,25 @@ int main() {
 					}
 				}
 			});
+			// Update the behaviours stored in the behaviour system, one type at a time
+			BehaviourSystem::Update(scene->Registry());
+
+			// Run as many fixed steps as we need to catch up with the frame time
+			fixedStepsThisFrame = fixedTimestep.Update(*scene, time.DeltaTime, [&](float stepSize) {
+				scene->Registry().view<BehaviourBinding>().each([&](entt::entity entity, BehaviourBinding& binding) {
+					for (const auto& behaviour : binding.Behaviours) {
+						if (behaviour->Enabled) {
+							behaviour->FixedUpdate(entt::handle(scene->Registry(), entity));
+						}
+					}
+				});
+				BehaviourSystem::FixedUpdate(scene->Registry());
+				physics->Step(stepSize);
+			});
 
-			// Clear the screen
-			glClearColor(0.08f, 0.17f, 0.31f, 1.0f);
-			glEnable(GL_DEPTH_TEST);
-			glClearDepth(1.0f);
-			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			// Keep our scene target the same size as the window
+			glfwGetFramebufferSize(BackendHandler::window, &windowWidth, &windowHeight);
+			sceneBuffer->Reshape(windowWidth, windowHeight);
 
 			// Update all world matrices for this frame
 			scene->Registry().view<Transform>().each([](entt::entity entity, Transform& t) {
@@ -394,48 +805,180 @@ int main() {
 			glm::mat4 view = glm::inverse(camTransform.LocalTransform());
 			glm::mat4 projection = cameraObject.get<Camera>().GetProjection();
 			glm::mat4 viewProjection = projection * view;
-						
-			// Sort the renderers by shader and material, we will go for a minimizing context switches approach here,
-			// but you could for instance sort front to back to optimize for fill rate if you have intensive fragment shaders
-			renderGroup.sort<RendererComponent>([](const RendererComponent& l, const RendererComponent& r) {
-				// Sort by render layer first, higher numbers get drawn last
-				if (l.Material->RenderLayer < r.Material->RenderLayer) return true;
-				if (l.Material->RenderLayer > r.Material->RenderLayer) return false;
-
-				// Sort by shader pointer next (so materials using the same shader run sequentially where possible)
-				if (l.Material->Shader < r.Material->Shader) return true;
-				if (l.Material->Shader > r.Material->Shader) return false;
-
-				// Sort by material pointer last (so we can minimize switching between materials)
-				if (l.Material < r.Material) return true;
-				if (l.Material > r.Material) return false;
-				
-				return false;
-			});
 
-			// Start by assuming no shader or material is applied
-			Shader::sptr current = nullptr;
-			ShaderMaterial::sptr currentMat = nullptr;
-
-			// Iterate over the render group components and draw them
-			renderGroup.each( [&](entt::entity e, RendererComponent& renderer, Transform& transform) {
-				// If the shader has changed, set up it's uniforms
-				if (current != renderer.Material->Shader) {
-					current = renderer.Material->Shader;
-					current->Bind();
-					BackendHandler::SetupShaderForFrame(current, view, projection);
+			// Update the world bounds of any renderers that moved, and cull them against the camera frustum
+			culler.Clear();
+			culler.Reserve(renderGroup.size());
+			shadowMap->ClearCasters();
+			shadowCasters.clear();
+			renderGroup.each([&](entt::entity e, RendererComponent& renderer, Transform& transform) {
+				renderer.UpdateWorldBounds(transform.WorldTransform());
+				culler.Add(renderer.WorldBounds);
+				// Anything without behaviours or a moving rigid body never moves, so it can go in the cached shadow cascades
+				if (renderer.CastShadows) {
+					const RigidBodyComponent* body = scene->Registry().try_get<RigidBodyComponent>(e);
+					const bool isStatic = !scene->Registry().has<BehaviourBinding>(e) && !BehaviourSystem::HasAny(scene->Registry(), e) && (body == nullptr || body->IsStatic());
+					shadowMap->AddCaster(renderer.WorldBounds, isStatic);
+					shadowCasters.push_back(e);
 				}
-				// If the material has changed, apply it
-				if (currentMat != renderer.Material) {
-					currentMat = renderer.Material;
-					currentMat->Apply();
+			});
+			culler.Cull(viewProjection);
+
+			// Fit the shadow cascades around the camera, and give the shader this frame's cascades
+			shadowMap->Update(view, projection);
+			shadowMap->Apply(shader);
+			shader->SetUniform("u_SunDir", -glm::normalize(shadowMap->LightDirection));
+			shadowMap->Apply(terrainShader);
+			terrainShader->SetUniform("u_SunDir", -glm::normalize(shadowMap->LightDirection));
+
+			// Move the point lights along their orbits, and sort them into the clusters for this frame
+			for (size_t ix = 0; ix < lightOrbits.size(); ix++) {
+				const glm::vec4& orbit = lightOrbits[ix];
+				const float angle = orbit.z + (float)time.CurrentFrame * orbit.w;
+				clusteredLights->Lights[ix].Position = glm::vec3(orbit.x + glm::cos(angle), orbit.y + glm::sin(angle), 0.5f + 0.25f * glm::sin(angle * 3.0f));
+			}
+			clusteredLights->Assign(view, projection);
+			// Pick a level of detail for everything on screen, based on how large the mesh's error would be in pixels
+			const int viewportHeight = sceneBuffer->GetHeight();
+			const glm::vec3 cameraPos = camTransform.GetLocalPosition();
+			uint32_t cullIndex = 0;
+			trianglesDrawn = trianglesFull = 0;
+			renderGroup.each([&](entt::entity e, RendererComponent& renderer, Transform& transform) {
+				renderer.IsVisible = culler.IsVisible(cullIndex++);
+				if (renderer.IsVisible) {
+					const glm::mat4& world = transform.WorldTransform();
+					const float scale = glm::max(glm::length(glm::vec3(world[0])), glm::max(glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2]))));
+					const float distance = glm::length(renderer.WorldBounds.GetCenter() - cameraPos);
+					const float pixelsPerUnit = VertexArrayObject::GetPixelsPerUnit(projection, (float)viewportHeight, distance, scale);
+					renderer.LodLevel = renderer.Mesh->SelectLod(pixelsPerUnit, maxLodPixelError);
+					trianglesDrawn += renderer.Mesh->GetTriangleCount(renderer.LodLevel);
+					trianglesFull += renderer.Mesh->GetTriangleCount(0);
 				}
-				// Render the mesh
-				BackendHandler::RenderVAO(renderer.Material->Shader, renderer.Mesh, viewProjection, transform);
+			});
+			// Pick the terrain chunks for this frame, this also uploads the chunks that have finished streaming in
+			if (drawTerrain) {
+				terrain->Update(view, projection, (float)viewportHeight);
+			}
+						
+			// Declare this frame's passes, the graph culls anything that doesn't end up on screen, orders the passes
+			// and hands out the transient targets
+			renderGraph->Reset();
+			RenderGraphHandle backbuffer = renderGraph->ImportBackbuffer("Backbuffer", windowWidth, windowHeight);
+			if (windowWidth > 0 && windowHeight > 0) {
+				// Shadows go first, the cached cascades are kept between frames so the pass is never culled
+				renderGraph->AddPass("Shadows", [&](RenderGraphBuilder& builder) {
+					builder.SideEffect();
+				}, [&](RenderGraphContext& context) {
+					shadowMap->Render(shadowShader, [&](uint32_t caster, const glm::mat4& lightViewProjection, float pixelsPerUnit) {
+						const RendererComponent& renderer = scene->Registry().get<RendererComponent>(shadowCasters[caster]);
+						const Transform& transform = scene->Registry().get<Transform>(shadowCasters[caster]);
+						const glm::mat4& world = transform.WorldTransform();
+						const float scale = glm::max(glm::length(glm::vec3(world[0])), glm::max(glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2]))));
+						const int lod = renderer.Mesh->SelectLod(pixelsPerUnit * scale, maxLodPixelError);
+						BackendHandler::RenderVAO(shadowShader, renderer.Mesh, lightViewProjection, transform, lod);
+					});
+				});
+
+				// Send the lights and this frame's clusters to the GPU
+				RenderGraphHandle lightBuffer = renderGraph->ImportBuffer("Lights", clusteredLights->GetLightBuffer(), clusteredLights->GetLightBufferSize());
+				RenderGraphHandle clusterBuffer = renderGraph->ImportBuffer("Clusters", clusteredLights->GetClusterBuffer(), clusteredLights->GetClusterBufferSize());
+				RenderGraphHandle indexBuffer = renderGraph->ImportBuffer("Light Indices", clusteredLights->GetIndexBuffer(), clusteredLights->GetIndexBufferSize());
+				renderGraph->AddPass("Light Upload", [&](RenderGraphBuilder& builder) {
+					lightBuffer = builder.Write(lightBuffer, RenderGraphUsage::Transfer);
+					clusterBuffer = builder.Write(clusterBuffer, RenderGraphUsage::Transfer);
+					indexBuffer = builder.Write(indexBuffer, RenderGraphUsage::Transfer);
+				}, [&](RenderGraphContext& context) {
+					clusteredLights->Upload();
+					clusteredLights->Apply(shader, sceneBuffer->GetWidth(), sceneBuffer->GetHeight());
+					clusteredLights->Apply(terrainShader, sceneBuffer->GetWidth(), sceneBuffer->GetHeight());
+				});
+
+				// Everything is drawn into the HDR scene target, the graph will resolve it's MSAA samples before the post effects read it
+				RenderGraphHandle sceneColor = renderGraph->ImportFramebuffer("Scene", sceneBuffer);
+				renderGraph->AddPass("Scene", [&](RenderGraphBuilder& builder) {
+					builder.Read(lightBuffer, RenderGraphUsage::StorageBuffer);
+					builder.Read(clusterBuffer, RenderGraphUsage::StorageBuffer);
+					builder.Read(indexBuffer, RenderGraphUsage::StorageBuffer);
+					sceneColor = builder.Write(sceneColor);
+				}, [&](RenderGraphContext& context) {
+					glEnable(GL_DEPTH_TEST);
+					glEnable(GL_CULL_FACE);
+					glDepthMask(GL_TRUE);
+					sceneBuffer->Clear(glm::vec4(0.08f, 0.17f, 0.31f, 1.0f), 1.0f);
+
+					// The terrain goes first, it covers a lot of the screen so it hides plenty of what comes after it
+					if (drawTerrain) {
+						BackendHandler::SetupShaderForFrame(terrainShader, view, projection);
+						applyTerrainLighting();
+						terrainMat->Apply();
+						terrain->Render(terrainShader, viewProjection);
+					}
+
+					// Sort the renderers by shader and material, we will go for a minimizing context switches approach here,
+					// but you could for instance sort front to back to optimize for fill rate if you have intensive fragment shaders
+					renderGroup.sort<RendererComponent>([](const RendererComponent& l, const RendererComponent& r) {
+						// Sort by render layer first, higher numbers get drawn last
+						if (l.Material->RenderLayer < r.Material->RenderLayer) return true;
+						if (l.Material->RenderLayer > r.Material->RenderLayer) return false;
+
+						// Sort by shader pointer next (so materials using the same shader run sequentially where possible)
+						if (l.Material->Shader < r.Material->Shader) return true;
+						if (l.Material->Shader > r.Material->Shader) return false;
+
+						// Sort by material pointer last (so we can minimize switching between materials)
+						if (l.Material < r.Material) return true;
+						if (l.Material > r.Material) return false;
+				
+						return false;
+					});
+
+					// Start by assuming no shader or material is applied
+					Shader::sptr current = nullptr;
+					ShaderMaterial::sptr currentMat = nullptr;
+
+					// Iterate over the render group components and draw them
+					renderGroup.each( [&](entt::entity e, RendererComponent& renderer, Transform& transform) {
+						// Skip anything outside of the camera's view
+						if (!renderer.IsVisible) {
+							return;
+						}
+						// If the shader has changed, set up it's uniforms
+						if (current != renderer.Material->Shader) {
+							current = renderer.Material->Shader;
+							current->Bind();
+							BackendHandler::SetupShaderForFrame(current, view, projection);
+						}
+						// If the material has changed, apply it
+						if (currentMat != renderer.Material) {
+							currentMat = renderer.Material;
+							currentMat->Apply();
+						}
+						// Render the mesh
+						BackendHandler::RenderVAO(renderer.Material->Shader, renderer.Mesh, viewProjection, transform, renderer.LodLevel);
+					});
+				});
+
+				// Run the post effects, then copy the result to the screen
+				RenderGraphHandle result = postChain->AddToGraph(*renderGraph, sceneColor);
+				renderGraph->AddPass("Present", [&](RenderGraphBuilder& builder) {
+					builder.Read(result, RenderGraphUsage::Transfer);
+					backbuffer = builder.Write(backbuffer, RenderGraphUsage::Transfer);
+				}, [&](RenderGraphContext& context) {
+					context.GetFramebuffer(result)->BlitToBackbuffer(windowWidth, windowHeight);
+				});
+			}
+
+			// Draw our ImGui content on top of everything
+			renderGraph->AddPass("ImGui", [&](RenderGraphBuilder& builder) {
+				backbuffer = builder.Write(backbuffer);
+				builder.SideEffect();
+			}, [&](RenderGraphContext& context) {
+				BackendHandler::RenderImGui();
 			});
 
-			// Draw our ImGui content
-			BackendHandler::RenderImGui();
+			renderGraph->Compile();
+			renderGraph->Execute();
+			targetPool->EndFrame();
 
 			scene->Poll();
 			glfwSwapBuffers(BackendHandler::window);